@@ -29,6 +29,7 @@ extern "C" {
 			strcpy_s(avcMSG, 512, "Opening dimensional portal between FAST and RLSimion\n");
 			tinyxml2::XMLDocument configFile;
 			const char* pipeName;
+			tinyxml2::XMLElement *pSharedMemoryNode;
 
 			printf("Loading Dimensional portal config file: %s\n", accINFILE);
 			if (configFile.LoadFile(accINFILE) == tinyxml2::XML_NO_ERROR)
@@ -36,8 +37,20 @@ extern "C" {
 				tinyxml2::XMLElement *pNode;
 				pNode = configFile.FirstChildElement("FAST-DIMENSIONAL-PORTAL");
 				pipeName= pNode->FirstChildElement("PIPE-NAME")->GetText();
-				
-				if (g_FASTWorldPortal.connectToNamedPipeServer(pipeName))
+				pSharedMemoryNode = pNode->FirstChildElement("SHARED-MEMORY-NAME");
+
+				//RLSimion only passes the name of the shared memory channel if it wants us to use it
+				if (pSharedMemoryNode)
+				{
+					if (g_FASTWorldPortal.connectToSharedMemoryServer(pSharedMemoryNode->GetText()))
+						printf("Connected to master process via shared memory %s\n", pSharedMemoryNode->GetText());
+					else
+					{
+						printf("Failed to connect to master process via shared memory %s\n", pSharedMemoryNode->GetText());
+						*aviFAIL = -1;
+					}
+				}
+				else if (g_FASTWorldPortal.connectToNamedPipeServer(pipeName))
 					printf("Connected to master process via pipe %s\n", pipeName);
 				else
 				{
@@ -65,6 +78,7 @@ extern "C" {
 		{
 			//Last call
 			g_FASTWorldPortal.disconnectFromNamedPipeServer();
+			g_FASTWorldPortal.disconnectFromSharedMemoryServer();
 		}
 	}
 }
\ No newline at end of file
@@ -170,14 +170,30 @@ void FASTWorldPortal::disconnectFromNamedPipeServer()
 	m_namedPipeClient.closeConnection();
 }
 
+bool FASTWorldPortal::connectToSharedMemoryServer(const char* name)
+{
+	return m_sharedMemoryClient.connectToServer(name, false); //bAddPrefix= false because we are reading the full name from xml config file
+}
+
+void FASTWorldPortal::disconnectFromSharedMemoryServer()
+{
+	m_sharedMemoryClient.closeConnection();
+}
+
 void FASTWorldPortal::sendState()
 {
 	double *pValues= s->getValueVector();
-	m_namedPipeClient.writeBuffer(pValues, (int) s->getNumVars()*sizeof(double));
+	if (m_sharedMemoryClient.isConnected())
+		m_sharedMemoryClient.writeBuffer(pValues, (int) s->getNumVars()*sizeof(double));
+	else
+		m_namedPipeClient.writeBuffer(pValues, (int) s->getNumVars()*sizeof(double));
 }
 
 void FASTWorldPortal::receiveAction()
 {
 	double *pValues = a->getValueVector();
-	m_namedPipeClient.readToBuffer(pValues, (int) a->getNumVars() * sizeof(double));
+	if (m_sharedMemoryClient.isConnected())
+		m_sharedMemoryClient.readToBuffer(pValues, (int) a->getNumVars() * sizeof(double));
+	else
+		m_namedPipeClient.readToBuffer(pValues, (int) a->getNumVars() * sizeof(double));
 }
\ No newline at end of file
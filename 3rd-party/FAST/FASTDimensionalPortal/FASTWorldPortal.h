@@ -2,6 +2,7 @@
 
 #include "../../../RLSimion/Common/named-var-set.h"
 #include "../../../tools/System/NamedPipe.h"
+#include "../../../tools/System/SharedMemoryChannel.h"
 
 #include <map>
 
@@ -19,6 +20,7 @@ class FASTActionDescriptor : public Descriptor
 class FASTWorldPortal
 {
 	NamedPipeClient m_namedPipeClient;
+	SharedMemoryClient m_sharedMemoryClient;
 
 	double m_lastTime;
 	double m_elapsedTime;
@@ -46,4 +48,8 @@ public:
 
 	bool connectToNamedPipeServer(const char* name);
 	void disconnectFromNamedPipeServer();
+
+	//if connected, the shared memory channel is used instead of the named pipe
+	bool connectToSharedMemoryServer(const char* name);
+	void disconnectFromSharedMemoryServer();
 };
@@ -3,6 +3,7 @@
 #include "../Lib/deep-functions.h"
 #include "../../tools/System/CrossPlatform.h"
 #include <vector>
+#include <string.h>
 
 #include "CNTKLibrary.h"
 using namespace CNTK;
@@ -22,6 +23,7 @@ CntkNetwork::CntkNetwork(vector<string> inputStateVariables, vector<string> inpu
 
 	m_outputBuffer = vector<double>(numOutputs);
 	m_stateBuffer = vector<double>(m_inputStateVariables.size());
+	m_stateNormalizer = NamedVarSetNormalizer(m_inputStateVariables);
 }
 
 unsigned int CntkNetwork::getNumOutputs()
@@ -158,6 +160,9 @@ CNTK::FunctionPtr CntkNetwork::initNetworkFromInputLayer(CNTK::FunctionPtr input
 
 void CntkNetwork::_train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate)
 {
+	if (m_bFrozen)
+		return;
+
 	//Reset the learning rate for this next batch
 	m_learner->SetLearningRateSchedule(CNTK::TrainingParameterPerSampleSchedule(learningRate));
 
@@ -173,13 +178,10 @@ void CntkNetwork::_train(DeepMinibatch* pMinibatch, const vector<double>& target
 
 void CntkNetwork::_clone(const CntkNetwork* pSource, bool bFreezeWeights)
 {
-	ParameterCloningMethod cloneMethod;
-	if (bFreezeWeights)
-		cloneMethod = ParameterCloningMethod::Freeze;
-	else
-		cloneMethod = ParameterCloningMethod::Clone;
-
-	m_fullNetworkLearnerFunction = pSource->m_fullNetworkLearnerFunction->Clone(cloneMethod);
+	//The parameters are always cloned (never frozen as constants) so that target networks can be updated in place with
+	//_softUpdate(). Frozen clones aren't trained, so their weights don't change unless they are soft-updated
+	m_fullNetworkLearnerFunction = pSource->m_fullNetworkLearnerFunction->Clone(ParameterCloningMethod::Clone);
+	m_bFrozen = bFreezeWeights;
 
 	for (auto input : m_fullNetworkLearnerFunction->Arguments())
 	{
@@ -194,8 +196,17 @@ void CntkNetwork::_clone(const CntkNetwork* pSource, bool bFreezeWeights)
 
 	m_outputBuffer = vector<double>(m_numOutputs);
 	m_stateBuffer = vector<double>(m_inputStateVariables.size());
-	m_trainer = pSource->m_trainer;
-	m_learner = pSource->m_learner;
+	if (bFreezeWeights)
+	{
+		m_trainer = nullptr;
+		m_learner = nullptr;
+	}
+	else
+	{
+		//clones that can be trained get their own learner, bound to their own parameters
+		CNTK::FunctionPtr lossFunction = m_fullNetworkLearnerFunction->FindByName(m_lossVariableId);
+		m_trainer = trainer(m_networkOutput, lossFunction, lossFunction, m_learnerDefinition);
+	}
 }
 
 void CntkNetwork::_evaluate(const vector<double>& s, vector<double>& output)
@@ -220,25 +231,124 @@ void CntkNetwork::_evaluate(const vector<double>& s, vector<double>& output)
 	cpuArrayOutput->CopyFrom(*outputValue->Data());
 }
 
+/// <summary>
+/// Binds the input state and the output of the network to m_stateBuffer and m_outputBuffer (a batch of one sample), so
+/// that the same values and maps are used in every single-tuple evaluation instead of creating new ones
+/// </summary>
+void CntkNetwork::initInferenceContext()
+{
+	CNTK::NDArrayViewPtr stateView = CNTK::MakeSharedObject<CNTK::NDArrayView>(m_inputState.Shape().AppendShape({ 1, 1 })
+		, m_stateBuffer, true);
+	CNTK::NDArrayViewPtr outputView = CNTK::MakeSharedObject<CNTK::NDArrayView>(m_networkOutput->Output().Shape().AppendShape({ 1, 1 })
+		, m_outputBuffer, false);
+
+	m_inferenceInputs = { { m_inputState, CNTK::MakeSharedObject<CNTK::Value>(stateView) } };
+	m_inferenceOutputs = { { m_networkOutput->Output(), CNTK::MakeSharedObject<CNTK::Value>(outputView) } };
+}
+
 vector<double>& CntkNetwork::_evaluate(const State* s)
 {
+	if (m_inferenceOutputs.empty())
+		initInferenceContext();
+
+	//the output is written directly to m_outputBuffer
 	stateToVector(s, m_stateBuffer);
-	_evaluate(m_stateBuffer, m_outputBuffer);
+	m_networkOutput->Evaluate(m_inferenceInputs, m_inferenceOutputs, CNTK::DeviceDescriptor::UseDefaultDevice());
 	return m_outputBuffer;
 }
 
 void CntkNetwork::stateToVector(const State* s, vector<double>& stateVector)
 {
-	const vector<string>& stateVars = getInputStateVariables();
-	size_t numStateVars = stateVars.size();
+	m_stateNormalizer.normalize(s, stateVector.data());
+}
 
-	for (size_t i = 0; i < numStateVars; i++)
-		stateVector[i] = s->getNormalized(stateVars[i].c_str());
+/// <summary>
+/// Packs the values of a batch given as structures of arrays (see StateActionFunction::evaluateBatch()) as a minibatch:
+/// the normalized values of the variables of each sample, one sample after another
+/// </summary>
+void CntkNetwork::batchToVector(const double* const* pValues, const vector<string>& variables, size_t numSamples
+	, const NamedVarSet* pVarSet, vector<double>& outVector)
+{
+	size_t numVars = variables.size();
+	outVector.resize(numSamples * numVars);
+	for (size_t i = 0; i < numVars; i++)
+	{
+		const char* varName = variables[i].c_str();
+		for (size_t sample = 0; sample < numSamples; sample++)
+			outVector[sample * numVars + i] = pVarSet->normalize(varName, pValues[i][sample]);
+	}
 }
 
+/// <summary>
+/// Evaluates a batch of states with a single call to the network, instead of one call per sample
+/// </summary>
+void CntkNetwork::_evaluateBatch(const double* const* pStateValues, size_t numSamples, const State* s, double* pOutput)
+{
+	batchToVector(pStateValues, m_inputStateVariables, numSamples, s, m_batchStateBuffer);
+	m_batchOutputBuffer.resize(numSamples * m_numOutputs);
+	_evaluate(m_batchStateBuffer, m_batchOutputBuffer);
+	memcpy(pOutput, m_batchOutputBuffer.data(), m_batchOutputBuffer.size() * sizeof(double));
+}
+
+/// <summary>
+/// Moves the parameters of this network toward those of the source network, in place: theta = alpha * theta_source
+/// + (1 - alpha) * theta. With alpha = 1 the parameters are copied (a hard update). Both networks must have the same
+/// architecture (i.e., one is a clone of the other); otherwise, nothing is done
+/// </summary>
 void CntkNetwork::_softUpdate(CntkNetwork* pSource, double alpha)
 {
+	if (pSource == nullptr || pSource == this)
+		return;
 
+	//pair the parameters of both networks only the first time: the graphs are the same, so they are listed in the same order
+	if (pSource != m_pSoftUpdateSource)
+	{
+		m_softUpdateTargetValues.clear();
+		m_softUpdateSourceValues.clear();
+		m_pSoftUpdateSource = nullptr;
+
+		vector<CNTK::Parameter> parameters = m_fullNetworkLearnerFunction->Parameters();
+		vector<CNTK::Parameter> sourceParameters = pSource->m_fullNetworkLearnerFunction->Parameters();
+		if (parameters.size() != sourceParameters.size())
+			return;
+		for (size_t i = 0; i < parameters.size(); i++)
+		{
+			if (parameters[i].Shape() != sourceParameters[i].Shape())
+			{
+				m_softUpdateTargetValues.clear();
+				m_softUpdateSourceValues.clear();
+				return;
+			}
+			m_softUpdateTargetValues.push_back(parameters[i].Value());
+			m_softUpdateSourceValues.push_back(sourceParameters[i].Value());
+		}
+		m_pSoftUpdateSource = pSource;
+	}
+
+	for (size_t i = 0; i < m_softUpdateTargetValues.size(); i++)
+	{
+		CNTK::NDArrayViewPtr target = m_softUpdateTargetValues[i];
+		CNTK::NDArrayViewPtr source = m_softUpdateSourceValues[i];
+		if (alpha == 1.0)
+		{
+			target->CopyFrom(*source);
+			continue;
+		}
+
+		//parameters stored in the GPU are blended in a copy in the CPU
+		bool bInCPU = target->Device().Type() == CNTK::DeviceKind::CPU && source->Device().Type() == CNTK::DeviceKind::CPU;
+		CNTK::NDArrayViewPtr cpuTarget = bInCPU ? target : target->DeepClone(CNTK::DeviceDescriptor::CPUDevice(), false);
+		CNTK::NDArrayViewPtr cpuSource = bInCPU ? source : source->DeepClone(CNTK::DeviceDescriptor::CPUDevice(), true);
+
+		double* pTarget = cpuTarget->WritableDataBuffer<double>();
+		const double* pSourceValues = cpuSource->DataBuffer<double>();
+		const size_t size = cpuTarget->Shape().TotalSize();
+		for (size_t j = 0; j < size; j++)
+			pTarget[j] = alpha * pSourceValues[j] + (1.0 - alpha) * pTarget[j];
+
+		if (!bInCPU)
+			target->CopyFrom(*cpuTarget);
+	}
 }
 
 // CntkDiscreteQFunctionNetwork
@@ -272,6 +382,11 @@ vector<double>& CntkDiscreteQFunctionNetwork::evaluate(const State* s, const Act
 {
 	return CntkNetwork::_evaluate(s);
 }
+void CntkDiscreteQFunctionNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	CntkNetwork::_evaluateBatch(pStateValues, numSamples, s, pOutput);
+}
 void CntkDiscreteQFunctionNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
 {
 	CntkNetwork::_softUpdate((CntkNetwork*) pSource, alpha);
@@ -287,6 +402,7 @@ CntkContinuousQFunctionNetwork::CntkContinuousQFunctionNetwork(vector<string> in
 	// 1. We use the action as input and we need the gradient wrt to it
 	// 2. We use a merge layer to merge state and action inputs
 	m_actionBuffer = vector<double>(getInputActionVariables().size());
+	m_actionNormalizer = NamedVarSetNormalizer(m_inputActionVariables);
 
 	m_inputState = CNTK::InputVariable({ getInputStateVariables().size() }
 		, CNTK::DataType::Double, false, m_stateInputVariableId);
@@ -320,6 +436,9 @@ IDeepNetwork* CntkContinuousQFunctionNetwork::clone(bool bFreezeWeights) const
 
 void CntkContinuousQFunctionNetwork::train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate)
 {
+	if (m_bFrozen)
+		return;
+
 	//Reset the learning rate for this next batch
 	m_learner->ResetLearningRate(CNTK::TrainingParameterPerSampleSchedule(learningRate));
 
@@ -358,21 +477,35 @@ void CntkContinuousQFunctionNetwork::evaluate(const vector<double>& s, const vec
 
 void CntkContinuousQFunctionNetwork::actionToVector(const Action* a, vector<double>& actionVector)
 {
-	const vector<string>& actionVars = getInputActionVariables();
-	size_t numActionVars = actionVars.size();
-
-	for (size_t i = 0; i < numActionVars; i++)
-		actionVector[i] = a->getNormalized(actionVars[i].c_str());
+	m_actionNormalizer.normalize(a, actionVector.data());
 }
 
 vector<double>& CntkContinuousQFunctionNetwork::evaluate(const State* s, const Action* a)
 {
+	if (m_inferenceOutputs.empty())
+	{
+		initInferenceContext();
+		CNTK::NDArrayViewPtr actionView = CNTK::MakeSharedObject<CNTK::NDArrayView>(m_inputAction.Shape().AppendShape({ 1, 1 })
+			, m_actionBuffer, true);
+		m_inferenceInputs[m_inputAction] = CNTK::MakeSharedObject<CNTK::Value>(actionView);
+	}
+
 	stateToVector(s, m_stateBuffer);
 	actionToVector(a, m_actionBuffer);
-	evaluate(m_stateBuffer, m_actionBuffer, m_outputBuffer);
+	m_networkOutput->Evaluate(m_inferenceInputs, m_inferenceOutputs, CNTK::DeviceDescriptor::UseDefaultDevice());
 	return m_outputBuffer;
 }
 
+void CntkContinuousQFunctionNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues
+	, size_t numSamples, State* s, Action* a, double* pOutput)
+{
+	batchToVector(pStateValues, m_inputStateVariables, numSamples, s, m_batchStateBuffer);
+	batchToVector(pActionValues, m_inputActionVariables, numSamples, a, m_batchActionBuffer);
+	m_batchOutputBuffer.resize(numSamples);
+	evaluate(m_batchStateBuffer, m_batchActionBuffer, m_batchOutputBuffer);
+	memcpy(pOutput, m_batchOutputBuffer.data(), numSamples * sizeof(double));
+}
+
 void CntkContinuousQFunctionNetwork::gradientWrtAction(const vector<double>& s, const vector<double>&a, vector<double>& gradient)
 {
 	unordered_map<Variable, ValuePtr> arguments = {};
@@ -429,6 +562,11 @@ vector<double>& CntkVFunctionNetwork::evaluate(const State* s, const Action* a)
 {
 	return CntkNetwork::_evaluate(s);
 }
+void CntkVFunctionNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	CntkNetwork::_evaluateBatch(pStateValues, numSamples, s, pOutput);
+}
 
 void CntkVFunctionNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
 {
@@ -455,8 +593,10 @@ IDeepNetwork* CntkDeterministicPolicyNetwork::clone(bool bFreezeWeights) const
 		, m_outputActionVariables, m_networkLayersDefinition, m_learnerDefinition, m_useNormalization);
 	pClone->_clone(this, bFreezeWeights);
 
-	//Fix the output: with deterministic policy networks, the layer named "output" is not the real output because we are using an additional sigmoid function after it
-	pClone->m_networkOutput = pClone->m_fullNetworkLearnerFunction->FindByName(m_actionScaleFunctionId)->Output();
+	//Fix the output: with deterministic policy networks, the layer named "output" is not the real output if we are using an additional sigmoid function after it
+	CNTK::FunctionPtr scaleFunction = pClone->m_fullNetworkLearnerFunction->FindByName(m_actionScaleFunctionId);
+	if (scaleFunction)
+		pClone->m_networkOutput = scaleFunction->Output();
 	return pClone;
 }
 unsigned int CntkDeterministicPolicyNetwork::getNumOutputs()
@@ -475,6 +615,11 @@ vector<double>& CntkDeterministicPolicyNetwork::evaluate(const State* s, const A
 {
 	return CntkNetwork::_evaluate(s);
 }
+void CntkDeterministicPolicyNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	CntkNetwork::_evaluateBatch(pStateValues, numSamples, s, pOutput);
+}
 
 void CntkDeterministicPolicyNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
 {
@@ -483,6 +628,9 @@ void CntkDeterministicPolicyNetwork::softUpdate(IDeepNetwork* pSource, double al
 
 void CntkDeterministicPolicyNetwork::applyGradient(DeepMinibatch* pMinibatch, const vector<double>& gradient)
 {
+	if (m_bFrozen)
+		return;
+
 	//Similar to the actual training function in https://github.com/Microsoft/CNTK/blob/94e6582d2f63ce3bb048b9da01679abeacda877f/Source/CNTKv2LibraryDll/Trainer.cpp#L193
 	//but with a different root value (taken from the minibatch) that, in the case of DDPG, should be -dQ(s,a)/da
 	//Forward pass
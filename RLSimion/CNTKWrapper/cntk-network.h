@@ -3,7 +3,9 @@
 #include "CNTKLibrary.h"
 #include "../Lib/deep-network.h"
 #include "../Lib/deep-layer.h"
+#include "../Common/named-var-set.h"
 #include <string>
+#include <unordered_map>
 using namespace std;
 
 class DeepNetworkDefinition;
@@ -34,6 +36,8 @@ protected:
 	CNTK::FunctionPtr m_fullNetworkLearnerFunction;
 	CNTK::LearnerPtr m_learner;
 	CNTK::TrainerPtr m_trainer;
+	//frozen networks have no trainer and ignore training calls
+	bool m_bFrozen = false;
 
 	CNTK::TrainerPtr trainer(CNTK::FunctionPtr networkOutput, CNTK::FunctionPtr lossFunction, CNTK::FunctionPtr evalFunction, string learnerDefinition);
 	CNTK::FunctionPtr mergeLayer(CNTK::Variable var1, CNTK::Variable var2);
@@ -50,12 +54,29 @@ protected:
 	void _clone(const CntkNetwork* pSource, bool bFreezeWeights = true);
 	void _softUpdate(CntkNetwork* pSource, double alpha);
 
-	//used for single-tuple evaluations
+	//values of the parameters of this network and the source network of the last soft update, paired in the same order
+	CntkNetwork* m_pSoftUpdateSource = nullptr;
+	vector<CNTK::NDArrayViewPtr> m_softUpdateTargetValues;
+	vector<CNTK::NDArrayViewPtr> m_softUpdateSourceValues;
+
+	//used for single-tuple evaluations. The input and output values are bound to m_stateBuffer and m_outputBuffer the
+	//first time a state is evaluated, so that acting only normalizes the state and runs the forward pass
 	vector<double>& _evaluate(const State* s);
 	vector<double> m_outputBuffer;
 	vector<double> m_stateBuffer;
+	NamedVarSetNormalizer m_stateNormalizer;
+	unordered_map<CNTK::Variable, CNTK::ValuePtr> m_inferenceInputs;
+	unordered_map<CNTK::Variable, CNTK::ValuePtr> m_inferenceOutputs;
+	void initInferenceContext();
 	void stateToVector(const State* s, vector<double>& stateVector);
 
+	//used for batch evaluations: the samples are packed in a single minibatch and evaluated with one call
+	vector<double> m_batchStateBuffer;
+	vector<double> m_batchOutputBuffer;
+	void batchToVector(const double* const* pValues, const vector<string>& variables, size_t numSamples
+		, const NamedVarSet* pVarSet, vector<double>& outVector);
+	void _evaluateBatch(const double* const* pStateValues, size_t numSamples, const State* s, double* pOutput);
+
 	CntkNetwork(vector<string> inputStateVariables, vector<string> inputActionVariables
 		, size_t numOutputs, string networkLayersDefinition, string learnerDefinition, bool useNormalization);
 public:
@@ -79,6 +100,8 @@ public:
 	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
 	void evaluate(const vector<double>& s, vector<double>& output);
 	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
 	void softUpdate(IDeepNetwork* pSource, double alpha);
 };
 
@@ -86,6 +109,8 @@ class CntkContinuousQFunctionNetwork : public IContinuousQFunctionNetwork, CntkN
 {
 	CNTK::Variable m_inputAction;
 	vector<double> m_actionBuffer;
+	vector<double> m_batchActionBuffer;
+	NamedVarSetNormalizer m_actionNormalizer;
 	void actionToVector(const Action* a, vector<double>& stateVector);
 public:
 	CntkContinuousQFunctionNetwork(vector<string> inputStateVariables, vector<string> inputActionVariables
@@ -99,6 +124,8 @@ public:
 	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
 	void evaluate(const vector<double>& s, const vector<double>& a, vector<double>& output);
 	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
 	void gradientWrtAction(const vector<double>& s, const vector<double>&a, vector<double>& gradient);
 	void softUpdate(IDeepNetwork* pSource, double alpha);
 };
@@ -116,6 +143,8 @@ public:
 	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
 	void evaluate(const vector<double>& s, vector<double>& output);
 	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
 	void softUpdate(IDeepNetwork* pSource, double alpha);
 };
 
@@ -133,6 +162,8 @@ public:
 	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
 	void evaluate(const vector<double>& s, vector<double>& output);
 	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
 	void softUpdate(IDeepNetwork* pSource, double alpha);
 	void applyGradient(DeepMinibatch* pMinibatch, const vector<double>& gradient);
 };
\ No newline at end of file
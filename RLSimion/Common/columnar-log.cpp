@@ -0,0 +1,599 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "columnar-log.h"
+#include "../../tools/System/CrossPlatform.h"
+#include <string.h>
+#include <algorithm>
+#include <limits>
+
+ColumnarEpisodeHeader::ColumnarEpisodeHeader()
+{
+	memset(padding, 0, sizeof(padding));
+}
+
+namespace ColumnEncoding
+{
+	uint64_t toBits(double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(double));
+		return bits;
+	}
+
+	double fromBits(uint64_t bits)
+	{
+		double value;
+		memcpy(&value, &bits, sizeof(double));
+		return value;
+	}
+
+	//x must be != 0
+	int countLeadingZeros(uint64_t x)
+	{
+#if defined(__GNUC__)
+		return __builtin_clzll(x);
+#else
+		int n = 0;
+		while (!(x & 0x8000000000000000ull)) { x <<= 1; n++; }
+		return n;
+#endif
+	}
+
+	int countTrailingZeros(uint64_t x)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctzll(x);
+#else
+		int n = 0;
+		while (!(x & 1)) { x >>= 1; n++; }
+		return n;
+#endif
+	}
+
+	class BitWriter
+	{
+		vector<char>& m_out;
+		uint64_t m_buffer = 0;
+		int m_numBits = 0;
+	public:
+		BitWriter(vector<char>& out) : m_out(out) {}
+
+		void write(uint64_t value, int numBits)
+		{
+			if (numBits > 32)
+			{
+				write(value >> 32, numBits - 32);
+				write(value & 0xffffffffull, 32);
+				return;
+			}
+			m_buffer = (m_buffer << numBits) | (value & ((1ull << numBits) - 1));
+			m_numBits += numBits;
+			while (m_numBits >= 8)
+			{
+				m_out.push_back((char)(m_buffer >> (m_numBits - 8)));
+				m_numBits -= 8;
+			}
+		}
+		void flush()
+		{
+			if (m_numBits > 0)
+				m_out.push_back((char)(m_buffer << (8 - m_numBits)));
+			m_numBits = 0;
+		}
+	};
+
+	class BitReader
+	{
+		const unsigned char* m_pData;
+		size_t m_dataSize;
+		size_t m_bytePosition = 0;
+		uint64_t m_buffer = 0;
+		int m_numBits = 0;
+	public:
+		bool m_bError = false;
+
+		BitReader(const char* pData, size_t dataSize) : m_pData((const unsigned char*)pData), m_dataSize(dataSize) {}
+
+		uint64_t read(int numBits)
+		{
+			if (numBits > 32)
+			{
+				uint64_t high = read(numBits - 32);
+				return (high << 32) | read(32);
+			}
+			while (m_numBits < numBits)
+			{
+				if (m_bytePosition >= m_dataSize)
+				{
+					m_bError = true;
+					return 0;
+				}
+				m_buffer = (m_buffer << 8) | m_pData[m_bytePosition++];
+				m_numBits += 8;
+			}
+			m_numBits -= numBits;
+			return (m_buffer >> m_numBits) & ((1ull << numBits) - 1);
+		}
+	};
+
+	//Each value is XOR-ed with the previous one. Because consecutive values of a variable tend to be similar,
+	//the result has many leading (and often trailing) zeros, and only the bits in between are written:
+	//  '0': same value as the previous one
+	//  '10' + bits: the meaningful bits fit in the same window used by the previous value
+	//  '11' + 5 bits (leading zeros) + 6 bits (number of meaningful bits - 1) + bits
+	void encode(const double* pValues, size_t numValues, vector<char>& out)
+	{
+		if (numValues == 0) return;
+
+		BitWriter writer(out);
+		uint64_t previous = toBits(pValues[0]);
+		writer.write(previous, 64);
+
+		int previousLeading = -1, previousTrailing = 0;
+		for (size_t i = 1; i < numValues; i++)
+		{
+			uint64_t current = toBits(pValues[i]);
+			uint64_t xorValue = current ^ previous;
+			if (xorValue == 0)
+				writer.write(0, 1);
+			else
+			{
+				int leading = std::min(31, countLeadingZeros(xorValue));
+				int trailing = countTrailingZeros(xorValue);
+				if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing)
+				{
+					writer.write(2, 2);
+					writer.write(xorValue >> previousTrailing, 64 - previousLeading - previousTrailing);
+				}
+				else
+				{
+					int numMeaningfulBits = 64 - leading - trailing;
+					writer.write(3, 2);
+					writer.write(leading, 5);
+					writer.write(numMeaningfulBits - 1, 6);
+					writer.write(xorValue >> trailing, numMeaningfulBits);
+					previousLeading = leading;
+					previousTrailing = trailing;
+				}
+			}
+			previous = current;
+		}
+		writer.flush();
+	}
+
+	bool decode(const char* pData, size_t dataSize, size_t numValues, double* pOutValues)
+	{
+		if (numValues == 0) return true;
+
+		BitReader reader(pData, dataSize);
+		uint64_t previous = reader.read(64);
+		pOutValues[0] = fromBits(previous);
+
+		int previousLeading = 0, previousTrailing = 0;
+		for (size_t i = 1; i < numValues && !reader.m_bError; i++)
+		{
+			if (reader.read(1) != 0)
+			{
+				if (reader.read(1) != 0)
+				{
+					previousLeading = (int)reader.read(5);
+					int numMeaningfulBits = (int)reader.read(6) + 1;
+					previousTrailing = 64 - previousLeading - numMeaningfulBits;
+					if (previousTrailing < 0) return false;
+				}
+				previous ^= reader.read(64 - previousLeading - previousTrailing) << previousTrailing;
+			}
+			pOutValues[i] = fromBits(previous);
+		}
+		return !reader.m_bError;
+	}
+
+	//Compressed format: a sequence of
+	//  token: 4 bits with the length of the literal run, 4 bits with the length of the match - 4 (15 means
+	//         the length continues in the next bytes, each adding up to 255)
+	//  literals
+	//  offset of the match (2 bytes, little endian), except in the last sequence, which only has literals
+	#define LZ_MIN_MATCH 4
+	#define LZ_HASH_BITS 14
+	#define LZ_MAX_OFFSET 65535
+
+	uint32_t read32(const char* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(uint32_t));
+		return value;
+	}
+
+	void writeLength(size_t length, vector<char>& out)
+	{
+		while (length >= 255)
+		{
+			out.push_back((char)255);
+			length -= 255;
+		}
+		out.push_back((char)length);
+	}
+
+	void writeSequence(const char* pLiterals, size_t numLiterals, size_t offset, size_t matchLength, vector<char>& out)
+	{
+		size_t matchCode = matchLength >= LZ_MIN_MATCH ? matchLength - LZ_MIN_MATCH : 0;
+		unsigned char token = (unsigned char)((std::min(numLiterals, (size_t)15) << 4) | std::min(matchCode, (size_t)15));
+		out.push_back((char)token);
+		if (numLiterals >= 15)
+			writeLength(numLiterals - 15, out);
+		out.insert(out.end(), pLiterals, pLiterals + numLiterals);
+		if (matchLength == 0) //last sequence
+			return;
+		out.push_back((char)(offset & 0xff));
+		out.push_back((char)(offset >> 8));
+		if (matchCode >= 15)
+			writeLength(matchCode - 15, out);
+	}
+
+	void compress(const char* pData, size_t dataSize, vector<char>& out)
+	{
+		vector<size_t> hashTable(1 << LZ_HASH_BITS, std::numeric_limits<size_t>::max());
+		size_t anchor = 0, position = 0;
+		while (position + LZ_MIN_MATCH <= dataSize)
+		{
+			uint32_t sequence = read32(pData + position);
+			size_t hash = (size_t)((sequence * 2654435761u) >> (32 - LZ_HASH_BITS));
+			size_t candidate = hashTable[hash];
+			hashTable[hash] = position;
+
+			if (candidate != std::numeric_limits<size_t>::max() && position - candidate <= LZ_MAX_OFFSET
+				&& read32(pData + candidate) == sequence)
+			{
+				size_t matchLength = LZ_MIN_MATCH;
+				while (position + matchLength < dataSize && pData[candidate + matchLength] == pData[position + matchLength])
+					matchLength++;
+				writeSequence(pData + anchor, position - anchor, position - candidate, matchLength, out);
+				position += matchLength;
+				anchor = position;
+			}
+			else position++;
+		}
+		writeSequence(pData + anchor, dataSize - anchor, 0, 0, out);
+	}
+
+	bool readLength(const unsigned char*& p, const unsigned char* pEnd, size_t& length)
+	{
+		unsigned char byte;
+		do
+		{
+			if (p >= pEnd) return false;
+			byte = *p++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	bool decompress(const char* pData, size_t dataSize, char* pOut, size_t outSize)
+	{
+		const unsigned char* p = (const unsigned char*)pData;
+		const unsigned char* pEnd = p + dataSize;
+		size_t outPosition = 0;
+		while (p < pEnd)
+		{
+			unsigned char token = *p++;
+			size_t numLiterals = token >> 4;
+			if (numLiterals == 15 && !readLength(p, pEnd, numLiterals)) return false;
+			if (numLiterals > (size_t)(pEnd - p) || numLiterals > outSize - outPosition) return false;
+			memcpy(pOut + outPosition, p, numLiterals);
+			p += numLiterals;
+			outPosition += numLiterals;
+
+			if (p == pEnd) break; //last sequence
+
+			if (pEnd - p < 2) return false;
+			size_t offset = (size_t)p[0] | ((size_t)p[1] << 8);
+			p += 2;
+			size_t matchLength = token & 15;
+			if (matchLength == 15 && !readLength(p, pEnd, matchLength)) return false;
+			matchLength += LZ_MIN_MATCH;
+			if (offset == 0 || offset > outPosition || matchLength > outSize - outPosition) return false;
+			//byte by byte: the match may overlap the bytes being written
+			for (size_t i = 0; i < matchLength; i++, outPosition++)
+				pOut[outPosition] = pOut[outPosition - offset];
+		}
+		return outPosition == outSize;
+	}
+}
+
+void ColumnarLogWriter::beginEpisode(long long int episodeType, long long int episodeIndex, long long int episodeSubIndex, size_t numVariables)
+{
+	m_episodeHeader = ColumnarEpisodeHeader();
+	m_episodeHeader.episodeType = episodeType;
+	m_episodeHeader.episodeIndex = episodeIndex;
+	m_episodeHeader.episodeSubIndex = episodeSubIndex;
+	m_episodeHeader.numVariablesLogged = numVariables;
+	m_episodeHeader.numColumns = NumStepColumns + numVariables;
+
+	//keep the memory allocated in previous episodes
+	m_columns.resize((size_t)m_episodeHeader.numColumns);
+	for (vector<double>& column : m_columns)
+		column.clear();
+}
+
+void ColumnarLogWriter::addStep(long long int stepIndex, double experimentRealTime, double episodeSimTime, double episodeRealTime, const double* pValues)
+{
+	m_columns[StepIndexColumn].push_back((double)stepIndex);
+	m_columns[ExperimentRealTimeColumn].push_back(experimentRealTime);
+	m_columns[EpisodeSimTimeColumn].push_back(episodeSimTime);
+	m_columns[EpisodeRealTimeColumn].push_back(episodeRealTime);
+	for (size_t i = NumStepColumns; i < m_columns.size(); i++)
+		m_columns[i].push_back(pValues[i - NumStepColumns]);
+	m_episodeHeader.numSteps++;
+}
+
+template <typename T>
+void append(vector<char>& out, const T& value)
+{
+	const char* pValue = (const char*)&value;
+	out.insert(out.end(), pValue, pValue + sizeof(T));
+}
+
+void ColumnarLogWriter::endEpisode(long long int fileOffset, vector<char>& out)
+{
+	size_t blockStart = out.size();
+
+	ColumnarEpisodeInfo episodeInfo;
+	episodeInfo.index.offset = fileOffset;
+	episodeInfo.index.episodeType = m_episodeHeader.episodeType;
+	episodeInfo.index.episodeIndex = m_episodeHeader.episodeIndex;
+	episodeInfo.index.episodeSubIndex = m_episodeHeader.episodeSubIndex;
+	episodeInfo.index.numSteps = m_episodeHeader.numSteps;
+	episodeInfo.index.numColumns = m_episodeHeader.numColumns;
+
+	append(out, m_episodeHeader);
+
+	for (size_t column = 0; column < m_columns.size(); column++)
+	{
+		const vector<double>& values = m_columns[column];
+
+		ColumnIndex columnIndex;
+		columnIndex.offset = fileOffset + (long long int)(out.size() - blockStart);
+		if (!values.empty())
+		{
+			columnIndex.min = *std::min_element(values.begin(), values.end());
+			columnIndex.max = *std::max_element(values.begin(), values.end());
+			double sum = 0.0;
+			for (double value : values) sum += value;
+			columnIndex.mean = sum / (double)values.size();
+		}
+		episodeInfo.columns.push_back(columnIndex);
+
+		m_encodedColumn.clear();
+		ColumnEncoding::encode(values.data(), values.size(), m_encodedColumn);
+
+		ColumnChunkHeader chunkHeader;
+		chunkHeader.columnIndex = column;
+		chunkHeader.numValues = values.size();
+		chunkHeader.encodedSize = m_encodedColumn.size();
+
+		size_t chunkHeaderPosition = out.size();
+		append(out, chunkHeader);
+		size_t dataPosition = out.size();
+		ColumnEncoding::compress(m_encodedColumn.data(), m_encodedColumn.size(), out);
+		if (out.size() - dataPosition < m_encodedColumn.size())
+			chunkHeader.flags = COLUMN_XOR_ENCODED | COLUMN_COMPRESSED;
+		else
+		{
+			//not worth it
+			out.resize(dataPosition);
+			out.insert(out.end(), m_encodedColumn.begin(), m_encodedColumn.end());
+			chunkHeader.flags = COLUMN_XOR_ENCODED;
+		}
+		chunkHeader.storedSize = out.size() - dataPosition;
+		memcpy(&out[chunkHeaderPosition], &chunkHeader, sizeof(ColumnChunkHeader));
+	}
+
+	m_episodes.push_back(episodeInfo);
+}
+
+void ColumnarLogWriter::writeIndex(long long int fileOffset, vector<char>& out)
+{
+	ColumnarLogIndexHeader indexHeader;
+	indexHeader.numEpisodes = m_episodes.size();
+	append(out, indexHeader);
+	for (const ColumnarEpisodeInfo& episode : m_episodes)
+	{
+		append(out, episode.index);
+		for (const ColumnIndex& column : episode.columns)
+			append(out, column);
+	}
+
+	ColumnarLogTrailer trailer;
+	trailer.indexOffset = fileOffset;
+	append(out, trailer);
+}
+
+ColumnarLogReader::~ColumnarLogReader()
+{
+	close();
+}
+
+int ColumnarLogReader::getFileVersion(const char* filename)
+{
+	FILE* pFile;
+	long long int header[3];
+	CrossPlatform::Fopen_s(&pFile, filename, "rb");
+	if (!pFile) return -1;
+	size_t numRead = fread(header, sizeof(long long int), 3, pFile);
+	fclose(pFile);
+	if (numRead != 3 || header[0] != 1) return -1; //EXPERIMENT_HEADER
+	return (int)header[1];
+}
+
+bool ColumnarLogReader::open(const char* filename)
+{
+	close();
+
+	CrossPlatform::Fopen_s(&m_pFile, filename, "rb");
+	if (!m_pFile) return false;
+
+	//experiment header: magic number, file version, number of episodes, padding
+	long long int header[COLUMNAR_LOG_HEADER_MAX_SIZE];
+	if (fread(header, sizeof(header), 1, m_pFile) != 1 || header[0] != 1 || header[1] != COLUMNAR_LOG_FILE_VERSION)
+	{
+		close();
+		return false;
+	}
+	m_numEpisodesInHeader = header[2];
+
+	if (!readIndex() && !scanEpisodes())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ColumnarLogReader::close()
+{
+	if (m_pFile)
+		fclose(m_pFile);
+	m_pFile = nullptr;
+	m_episodes.clear();
+}
+
+bool ColumnarLogReader::readIndex()
+{
+	ColumnarLogTrailer trailer;
+	if (CrossPlatform::Fseek64(m_pFile, -(long long int)sizeof(ColumnarLogTrailer), SEEK_END) != 0
+		|| fread(&trailer, sizeof(ColumnarLogTrailer), 1, m_pFile) != 1 || trailer.magicNumber != COLUMNAR_LOG_TRAILER)
+		return false;
+
+	ColumnarLogIndexHeader indexHeader;
+	if (CrossPlatform::Fseek64(m_pFile, trailer.indexOffset, SEEK_SET) != 0
+		|| fread(&indexHeader, sizeof(ColumnarLogIndexHeader), 1, m_pFile) != 1 || indexHeader.magicNumber != COLUMNAR_LOG_INDEX_HEADER)
+		return false;
+
+	m_episodes.resize((size_t)indexHeader.numEpisodes);
+	for (ColumnarEpisodeInfo& episode : m_episodes)
+	{
+		if (fread(&episode.index, sizeof(ColumnarEpisodeIndex), 1, m_pFile) != 1)
+			return false;
+		episode.columns.resize((size_t)episode.index.numColumns);
+		if (!episode.columns.empty()
+			&& fread(episode.columns.data(), sizeof(ColumnIndex), episode.columns.size(), m_pFile) != episode.columns.size())
+			return false;
+	}
+	return true;
+}
+
+bool ColumnarLogReader::scanEpisodes()
+{
+	//no index: read the episode blocks one after another, stopping at the first incomplete one
+	m_episodes.clear();
+	long long int offset = sizeof(long long int) * COLUMNAR_LOG_HEADER_MAX_SIZE;
+	ColumnarEpisodeHeader episodeHeader;
+	ColumnChunkHeader chunkHeader;
+	vector<double> values;
+
+	while (CrossPlatform::Fseek64(m_pFile, offset, SEEK_SET) == 0
+		&& fread(&episodeHeader, sizeof(ColumnarEpisodeHeader), 1, m_pFile) == 1
+		&& episodeHeader.magicNumber == COLUMNAR_LOG_EPISODE_HEADER)
+	{
+		ColumnarEpisodeInfo episode;
+		episode.index.offset = offset;
+		episode.index.episodeType = episodeHeader.episodeType;
+		episode.index.episodeIndex = episodeHeader.episodeIndex;
+		episode.index.episodeSubIndex = episodeHeader.episodeSubIndex;
+		episode.index.numSteps = episodeHeader.numSteps;
+		episode.index.numColumns = episodeHeader.numColumns;
+		m_episodes.push_back(episode);
+
+		long long int columnOffset = offset + sizeof(ColumnarEpisodeHeader);
+		bool bComplete = true;
+		for (long long int column = 0; column < episodeHeader.numColumns && bComplete; column++)
+		{
+			ColumnIndex columnIndex;
+			columnIndex.offset = columnOffset;
+			m_episodes.back().columns.push_back(columnIndex);
+
+			if (CrossPlatform::Fseek64(m_pFile, columnOffset, SEEK_SET) != 0
+				|| fread(&chunkHeader, sizeof(ColumnChunkHeader), 1, m_pFile) != 1
+				|| chunkHeader.magicNumber != COLUMN_CHUNK_HEADER || !readColumn(m_episodes.size() - 1, (size_t)column, values))
+				bComplete = false;
+			else
+			{
+				//the summaries are only in the index, so we have to calculate them
+				ColumnIndex& summary = m_episodes.back().columns.back();
+				if (!values.empty())
+				{
+					summary.min = *std::min_element(values.begin(), values.end());
+					summary.max = *std::max_element(values.begin(), values.end());
+					double sum = 0.0;
+					for (double value : values) sum += value;
+					summary.mean = sum / (double)values.size();
+				}
+				columnOffset += sizeof(ColumnChunkHeader) + chunkHeader.storedSize;
+			}
+		}
+		if (!bComplete)
+		{
+			m_episodes.pop_back();
+			break;
+		}
+		offset = columnOffset;
+	}
+	return true;
+}
+
+ColumnSummary ColumnarLogReader::getSummary(size_t episode, size_t column) const
+{
+	const ColumnIndex& columnIndex = m_episodes[episode].columns[column];
+	ColumnSummary summary = { columnIndex.min, columnIndex.max, columnIndex.mean };
+	return summary;
+}
+
+bool ColumnarLogReader::readColumn(size_t episode, size_t column, vector<double>& outValues)
+{
+	if (!m_pFile || episode >= m_episodes.size() || column >= m_episodes[episode].columns.size())
+		return false;
+
+	ColumnChunkHeader chunkHeader;
+	if (CrossPlatform::Fseek64(m_pFile, m_episodes[episode].columns[column].offset, SEEK_SET) != 0
+		|| fread(&chunkHeader, sizeof(ColumnChunkHeader), 1, m_pFile) != 1 || chunkHeader.magicNumber != COLUMN_CHUNK_HEADER)
+		return false;
+
+	m_storedData.resize((size_t)chunkHeader.storedSize);
+	if (!m_storedData.empty() && fread(m_storedData.data(), 1, m_storedData.size(), m_pFile) != m_storedData.size())
+		return false;
+
+	const vector<char>* pEncodedData = &m_storedData;
+	if (chunkHeader.flags & COLUMN_COMPRESSED)
+	{
+		m_encodedData.resize((size_t)chunkHeader.encodedSize);
+		if (!ColumnEncoding::decompress(m_storedData.data(), m_storedData.size(), m_encodedData.data(), m_encodedData.size()))
+			return false;
+		pEncodedData = &m_encodedData;
+	}
+
+	outValues.resize((size_t)chunkHeader.numValues);
+	return ColumnEncoding::decode(pEncodedData->data(), pEncodedData->size(), outValues.size(), outValues.data());
+}
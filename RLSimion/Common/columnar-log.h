@@ -0,0 +1,171 @@
+#pragma once
+
+#include <vector>
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+using namespace std;
+
+//Version 3 of the binary experiment log. Instead of writing a step header and the values of every logged
+//step one after another (version 2), the steps of an episode are kept in memory and written once the
+//episode ends, one column per variable:
+//
+//  ExperimentHeader (fileVersion= 3)
+//  Episode block, for each episode:
+//    ColumnarEpisodeHeader
+//    ColumnChunkHeader + data, for each column (step index, the three times in the step header, then the variables)
+//  Index: ColumnarLogIndexHeader, then for each episode: ColumnarEpisodeIndex + a ColumnIndex per column
+//  ColumnarLogTrailer: offset of the index
+//
+//Each column is encoded XOR-ing every value with the previous one (as in Facebook's Gorilla) and the result is
+//compressed with a small LZ77 block compressor if that makes it smaller. Readers use the index at the end to read
+//only the columns of the episodes they need. If the index is missing (i.e., the experiment crashed), the episode
+//blocks can still be read sequentially
+
+#define COLUMNAR_LOG_FILE_VERSION 3
+
+#define COLUMNAR_LOG_HEADER_MAX_SIZE 16
+#define COLUMNAR_LOG_EPISODE_HEADER 2 //same as in version 2
+#define COLUMN_CHUNK_HEADER 5
+#define COLUMNAR_LOG_INDEX_HEADER 6
+#define COLUMNAR_LOG_TRAILER 7
+
+//Columns stored for every step before the logged variables (the contents of a version 2 step header)
+enum StepColumn { StepIndexColumn = 0, ExperimentRealTimeColumn, EpisodeSimTimeColumn, EpisodeRealTimeColumn, NumStepColumns };
+
+//flags of the column chunks
+#define COLUMN_XOR_ENCODED 1
+#define COLUMN_COMPRESSED 2
+
+struct ColumnarEpisodeHeader
+{
+	long long int magicNumber = COLUMNAR_LOG_EPISODE_HEADER;
+	long long int episodeType = 0;
+	long long int episodeIndex = 0;
+	long long int numVariablesLogged = 0;
+	long long int episodeSubIndex = 0;
+	long long int numSteps = 0;
+	long long int numColumns = 0;
+
+	long long int padding[COLUMNAR_LOG_HEADER_MAX_SIZE - 7];
+	ColumnarEpisodeHeader();
+};
+
+struct ColumnChunkHeader
+{
+	long long int magicNumber = COLUMN_CHUNK_HEADER;
+	long long int columnIndex = 0;
+	long long int numValues = 0;
+	long long int flags = 0;
+	long long int encodedSize = 0; //size after XOR-encoding
+	long long int storedSize = 0; //size in the file, after compression
+};
+
+struct ColumnIndex
+{
+	long long int offset = 0; //offset of the ColumnChunkHeader in the file
+	double min = 0.0;
+	double max = 0.0;
+	double mean = 0.0;
+};
+
+struct ColumnarEpisodeIndex
+{
+	long long int offset = 0; //offset of the ColumnarEpisodeHeader in the file
+	long long int episodeType = 0;
+	long long int episodeIndex = 0;
+	long long int episodeSubIndex = 0;
+	long long int numSteps = 0;
+	long long int numColumns = 0;
+};
+
+struct ColumnarLogIndexHeader
+{
+	long long int magicNumber = COLUMNAR_LOG_INDEX_HEADER;
+	long long int numEpisodes = 0;
+};
+
+struct ColumnarLogTrailer
+{
+	long long int indexOffset = 0;
+	long long int magicNumber = COLUMNAR_LOG_TRAILER;
+};
+
+namespace ColumnEncoding
+{
+	//XOR-encodes numValues doubles and appends the bit stream to out
+	void encode(const double* pValues, size_t numValues, vector<char>& out);
+	//decodes numValues doubles from the encoded data. Returns false if the data is corrupt
+	bool decode(const char* pData, size_t dataSize, size_t numValues, double* pOutValues);
+
+	//LZ77 block compression (LZ4-like: literal runs and back-references within a 64Kb window).
+	//compress() appends the compressed data to out
+	void compress(const char* pData, size_t dataSize, vector<char>& out);
+	//decompress() needs the size of the decompressed data and returns false if the data is corrupt
+	bool decompress(const char* pData, size_t dataSize, char* pOut, size_t outSize);
+}
+
+struct ColumnSummary
+{
+	double min, max, mean;
+};
+
+struct ColumnarEpisodeInfo
+{
+	ColumnarEpisodeIndex index;
+	vector<ColumnIndex> columns;
+};
+
+//Buffers the steps of an episode and encodes them as an episode block once the episode ends. It doesn't write
+//files itself: the caller writes the returned blocks (so that it can use an asynchronous writer) and passes the
+//offset at which each block starts so that the index can be built
+class ColumnarLogWriter
+{
+	ColumnarEpisodeHeader m_episodeHeader;
+	vector<vector<double>> m_columns;
+	vector<ColumnarEpisodeInfo> m_episodes;
+	vector<char> m_encodedColumn;
+public:
+	ColumnarLogWriter() {}
+	virtual ~ColumnarLogWriter() {}
+
+	void beginEpisode(long long int episodeType, long long int episodeIndex, long long int episodeSubIndex, size_t numVariables);
+	void addStep(long long int stepIndex, double experimentRealTime, double episodeSimTime, double episodeRealTime, const double* pValues);
+	//encodes the episode and appends the block to out. fileOffset is the offset in the file at which the block will be written
+	void endEpisode(long long int fileOffset, vector<char>& out);
+
+	//appends the index and the trailer to out. fileOffset is the offset at which they will be written
+	void writeIndex(long long int fileOffset, vector<char>& out);
+};
+
+//Reads version 3 log files. Only the headers and the index are read when the file is opened; columns are read
+//from the file when requested
+class ColumnarLogReader
+{
+	FILE* m_pFile = nullptr;
+	long long int m_numEpisodesInHeader = 0;
+	vector<ColumnarEpisodeInfo> m_episodes;
+	vector<char> m_storedData, m_encodedData;
+
+	bool readIndex();
+	bool scanEpisodes();
+public:
+	ColumnarLogReader() {}
+	virtual ~ColumnarLogReader();
+
+	//returns the file version read from the experiment header of a log file (2 or 3), or -1 if it can't be read
+	static int getFileVersion(const char* filename);
+
+	bool open(const char* filename);
+	void close();
+
+	size_t getNumEpisodes() const { return m_episodes.size(); }
+	const ColumnarEpisodeInfo& getEpisodeInfo(size_t episode) const { return m_episodes[episode]; }
+	size_t getNumSteps(size_t episode) const { return (size_t)m_episodes[episode].index.numSteps; }
+	size_t getNumColumns(size_t episode) const { return m_episodes[episode].columns.size(); }
+	//min/max/mean of a column, read from the index
+	ColumnSummary getSummary(size_t episode, size_t column) const;
+
+	//reads a single column of an episode (one value per step). Returns false if it can't be read
+	bool readColumn(size_t episode, size_t column, vector<double>& outValues);
+};
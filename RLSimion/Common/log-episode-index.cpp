@@ -0,0 +1,241 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "log-episode-index.h"
+#include "../../tools/System/CrossPlatform.h"
+#include <string.h>
+#include <limits>
+
+//version 2 headers, as written by the logger: 16 64-bit values each
+#define LOG_HEADER_SIZE 16
+#define LOG_EXPERIMENT_HEADER 1
+#define LOG_EPISODE_HEADER 2
+#define LOG_STEP_HEADER 3
+#define LOG_EPISODE_END_HEADER 4
+
+ExperimentLogReader::~ExperimentLogReader()
+{
+	close();
+}
+
+/// <summary>
+/// Opens a binary experiment log and reads its episode index: the sidecar index file if there is one, or the headers of
+/// the log file otherwise
+/// </summary>
+/// <param name="logFilename">The binary log file</param>
+/// <returns>False if the log file can't be read</returns>
+bool ExperimentLogReader::open(const char* logFilename)
+{
+	close();
+
+	m_fileVersion = ColumnarLogReader::getFileVersion(logFilename);
+	if (m_fileVersion != 2 && m_fileVersion != COLUMNAR_LOG_FILE_VERSION)
+		return false;
+
+	if (m_fileVersion == COLUMNAR_LOG_FILE_VERSION)
+	{
+		if (!m_columnarReader.open(logFilename))
+			return false;
+	}
+	else
+	{
+		CrossPlatform::Fopen_s(&m_pFile, logFilename, "rb");
+		if (!m_pFile)
+			return false;
+	}
+
+	if (!readIndexFile(string(logFilename) + LOG_EPISODE_INDEX_EXTENSION) && !scanEpisodes())
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ExperimentLogReader::close()
+{
+	if (m_pFile)
+		fclose(m_pFile);
+	m_pFile = nullptr;
+	m_columnarReader.close();
+	m_episodes.clear();
+}
+
+bool ExperimentLogReader::readIndexFile(const string& filename)
+{
+	FILE* pFile;
+	CrossPlatform::Fopen_s(&pFile, filename.c_str(), "rb");
+	if (!pFile)
+		return false;
+
+	LogEpisodeIndexHeader header;
+	if (fread(&header, sizeof(LogEpisodeIndexHeader), 1, pFile) != 1 || header.magicNumber != LOG_EPISODE_INDEX_HEADER
+		|| header.fileVersion != LOG_EPISODE_INDEX_FILE_VERSION || header.logFileVersion != m_fileVersion)
+	{
+		fclose(pFile);
+		return false;
+	}
+	//an incomplete last entry (the experiment crashed while writing it) is ignored
+	LogEpisodeIndexEntry entry;
+	while (fread(&entry, sizeof(LogEpisodeIndexEntry), 1, pFile) == 1)
+		m_episodes.push_back(entry);
+	fclose(pFile);
+	return true;
+}
+
+/// <summary>
+/// Builds the index from the log file. Version 3 logs have their own index at the end of the file. In version 2 logs, the
+/// headers are read one after another, skipping the logged values
+/// </summary>
+bool ExperimentLogReader::scanEpisodes()
+{
+	m_episodes.clear();
+	if (m_fileVersion == COLUMNAR_LOG_FILE_VERSION)
+	{
+		for (size_t episode = 0; episode < m_columnarReader.getNumEpisodes(); episode++)
+		{
+			const ColumnarEpisodeIndex& columnarIndex = m_columnarReader.getEpisodeInfo(episode).index;
+			LogEpisodeIndexEntry entry;
+			entry.offset = columnarIndex.offset;
+			entry.episodeType = columnarIndex.episodeType;
+			entry.episodeIndex = columnarIndex.episodeIndex;
+			entry.episodeSubIndex = columnarIndex.episodeSubIndex;
+			entry.numSteps = columnarIndex.numSteps;
+			entry.numVariablesLogged = columnarIndex.numColumns - NumStepColumns;
+			entry.rewardSum = entry.avgReward = std::numeric_limits<double>::quiet_NaN();
+			m_episodes.push_back(entry);
+		}
+		return true;
+	}
+
+	long long int header[LOG_HEADER_SIZE];
+	long long int offset = sizeof(header);
+	LogEpisodeIndexEntry* pEntry = nullptr;
+	while (CrossPlatform::Fseek64(m_pFile, offset, SEEK_SET) == 0 && fread(header, sizeof(header), 1, m_pFile) == 1)
+	{
+		if (header[0] == LOG_EPISODE_HEADER)
+		{
+			m_episodes.push_back(LogEpisodeIndexEntry());
+			pEntry = &m_episodes.back();
+			pEntry->offset = offset;
+			pEntry->episodeType = header[1];
+			pEntry->episodeIndex = header[2];
+			pEntry->numVariablesLogged = header[3];
+			pEntry->episodeSubIndex = header[4];
+			pEntry->rewardSum = pEntry->avgReward = std::numeric_limits<double>::quiet_NaN();
+			offset += sizeof(header);
+		}
+		else if (header[0] == LOG_STEP_HEADER && pEntry)
+		{
+			pEntry->numSteps++;
+			offset += sizeof(header) + pEntry->numVariablesLogged * sizeof(double);
+		}
+		else if (header[0] == LOG_EPISODE_END_HEADER && pEntry)
+		{
+			pEntry = nullptr;
+			offset += sizeof(header);
+		}
+		else break; //corrupt or incomplete
+	}
+	return true;
+}
+
+vector<size_t> ExperimentLogReader::findEpisodes(long long int episodeType) const
+{
+	vector<size_t> episodes;
+	for (size_t episode = 0; episode < m_episodes.size(); episode++)
+	{
+		if (m_episodes[episode].episodeType == episodeType)
+			episodes.push_back(episode);
+	}
+	return episodes;
+}
+
+/// <summary>
+/// Reads all the steps of an episode, seeking its offset in the log file
+/// </summary>
+/// <param name="episode">Index of the episode (in [0, getNumEpisodes()))</param>
+/// <param name="outValues">Output buffer: NumStepColumns + numVariablesLogged values per step</param>
+/// <returns>False if the episode can't be read</returns>
+bool ExperimentLogReader::readEpisode(size_t episode, vector<double>& outValues)
+{
+	outValues.clear();
+	if (episode >= m_episodes.size())
+		return false;
+	const LogEpisodeIndexEntry& entry = m_episodes[episode];
+	const size_t numColumns = NumStepColumns + (size_t)entry.numVariablesLogged;
+
+	if (m_fileVersion == COLUMNAR_LOG_FILE_VERSION)
+	{
+		//episode blocks are written in order, so the offsets in the log's own index are sorted
+		size_t columnarEpisode = 0, first = 0, last = m_columnarReader.getNumEpisodes();
+		while (first < last)
+		{
+			columnarEpisode = first + (last - first) / 2;
+			long long int offset = m_columnarReader.getEpisodeInfo(columnarEpisode).index.offset;
+			if (offset == entry.offset) break;
+			if (offset < entry.offset) first = columnarEpisode + 1;
+			else last = columnarEpisode;
+		}
+		if (first >= last || m_columnarReader.getNumColumns(columnarEpisode) != numColumns)
+			return false;
+
+		const size_t numSteps = m_columnarReader.getNumSteps(columnarEpisode);
+		outValues.resize(numSteps * numColumns);
+		for (size_t column = 0; column < numColumns; column++)
+		{
+			if (!m_columnarReader.readColumn(columnarEpisode, column, m_columnValues) || m_columnValues.size() != numSteps)
+			{
+				outValues.clear();
+				return false;
+			}
+			for (size_t step = 0; step < numSteps; step++)
+				outValues[step * numColumns + column] = m_columnValues[step];
+		}
+		return true;
+	}
+
+	long long int header[LOG_HEADER_SIZE];
+	if (CrossPlatform::Fseek64(m_pFile, entry.offset, SEEK_SET) != 0 || fread(header, sizeof(header), 1, m_pFile) != 1
+		|| header[0] != LOG_EPISODE_HEADER || header[3] != entry.numVariablesLogged)
+		return false;
+
+	outValues.reserve((size_t)entry.numSteps * numColumns);
+	while (fread(header, sizeof(header), 1, m_pFile) == 1 && header[0] == LOG_STEP_HEADER)
+	{
+		size_t row = outValues.size();
+		outValues.resize(row + numColumns);
+		outValues[row + StepIndexColumn] = (double)header[1];
+		//the three times are doubles
+		memcpy(&outValues[row + ExperimentRealTimeColumn], &header[2], 3 * sizeof(double));
+		if (entry.numVariablesLogged > 0
+			&& fread(&outValues[row + NumStepColumns], sizeof(double), (size_t)entry.numVariablesLogged, m_pFile) != (size_t)entry.numVariablesLogged)
+		{
+			outValues.resize(row);
+			break; //incomplete step
+		}
+	}
+	return true;
+}
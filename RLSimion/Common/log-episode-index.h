@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include "columnar-log.h"
+using namespace std;
+
+//Sidecar index of an experiment log (version 2 or 3), written by the logger next to the binary log file as episodes end:
+//
+//  LogEpisodeIndexHeader
+//  LogEpisodeIndexEntry, for each episode logged
+//
+//Records have a fixed size, so the index of an experiment that crashed is valid up to the last episode that ended. Readers
+//use it to go straight to the episodes they need (i.e., only the evaluation episodes) instead of parsing every header in
+//the log file
+
+#define LOG_EPISODE_INDEX_EXTENSION ".index"
+#define LOG_EPISODE_INDEX_HEADER 8
+#define LOG_EPISODE_INDEX_FILE_VERSION 1
+
+struct LogEpisodeIndexHeader
+{
+	long long int magicNumber = LOG_EPISODE_INDEX_HEADER;
+	long long int fileVersion = LOG_EPISODE_INDEX_FILE_VERSION;
+	long long int logFileVersion = 0; //version of the log file indexed
+	long long int padding[5] = {};
+};
+
+struct LogEpisodeIndexEntry
+{
+	long long int offset = 0; //offset of the episode header in the log file
+	long long int episodeType = 0; //0 for evaluation episodes, 1 for training episodes
+	long long int episodeIndex = 0;
+	long long int episodeSubIndex = 0;
+	long long int numSteps = 0; //number of steps logged
+	long long int numVariablesLogged = 0;
+	//scalar reward summed over all the steps of the episode (not only the ones logged) and averaged per step. NaN if
+	//unknown (the index was rebuilt from the log file)
+	double rewardSum = 0.0;
+	double avgReward = 0.0;
+};
+
+//Random access to the episodes of an experiment log. The sidecar index is read when the log is opened. If there is no
+//index (i.e., the log was written before indices were added), it is rebuilt from the log file: only the headers are read
+class ExperimentLogReader
+{
+	FILE* m_pFile = nullptr;
+	int m_fileVersion = -1;
+	vector<LogEpisodeIndexEntry> m_episodes;
+	ColumnarLogReader m_columnarReader;
+	vector<double> m_columnValues;
+
+	bool readIndexFile(const string& filename);
+	bool scanEpisodes();
+public:
+	ExperimentLogReader() {}
+	virtual ~ExperimentLogReader();
+
+	//logFilename is the binary log file (not the descriptor). Returns false if it can't be read
+	bool open(const char* logFilename);
+	void close();
+	int getFileVersion() const { return m_fileVersion; }
+
+	size_t getNumEpisodes() const { return m_episodes.size(); }
+	const LogEpisodeIndexEntry& getEpisode(size_t episode) const { return m_episodes[episode]; }
+	//indices of the episodes of a type (0 for evaluation episodes, 1 for training episodes)
+	vector<size_t> findEpisodes(long long int episodeType) const;
+
+	//Seeks the episode and reads all its steps. outValues is filled with a row per step: the contents of the step header
+	//(see StepColumn) followed by the variables logged. Returns false if the episode can't be read
+	bool readEpisode(size_t episode, vector<double>& outValues);
+};
@@ -343,4 +343,42 @@ void NamedVarSet::addOffset(double offset)
 	{
 		set(i, this->get(i) + offset);
 	}
-}
\ No newline at end of file
+}
+/// <summary>
+/// Finds the index and the properties of each variable in the descriptor of the set
+/// </summary>
+void NamedVarSetNormalizer::resolve(const NamedVarSet* pVarSet)
+{
+	m_pDescriptor = pVarSet->getDescriptorPtr();
+	m_descriptorSize = m_pDescriptor->size();
+	m_indices.resize(m_variables.size());
+	m_properties.resize(m_variables.size());
+	for (size_t i = 0; i < m_variables.size(); i++)
+	{
+		size_t index = 0;
+		while (index < pVarSet->getNumVars() && strcmp(pVarSet->getProperties(index)->getName(), m_variables[i].c_str()))
+			++index;
+		m_indices[i] = index; //getNumVars() if it isn't in the descriptor
+		m_properties[i] = pVarSet->getProperties(m_variables[i].c_str());
+	}
+}
+
+/// <summary>
+/// Writes the values of the variables normalized in their value ranges (as NamedVarSet::getNormalized())
+/// </summary>
+/// <param name="pVarSet">The set with the values</param>
+/// <param name="pOutput">Output buffer with room for a value per variable</param>
+void NamedVarSetNormalizer::normalize(const NamedVarSet* pVarSet, double* pOutput)
+{
+	if (pVarSet->getDescriptorPtr() != m_pDescriptor || m_pDescriptor->size() != m_descriptorSize)
+		resolve(pVarSet);
+
+	const double* pValues = pVarSet->getValueVector();
+	const size_t numVars = pVarSet->getNumVars();
+	for (size_t i = 0; i < m_variables.size(); i++)
+	{
+		double value = m_indices[i] < numVars ? pValues[m_indices[i]] : pVarSet->get(m_variables[i].c_str());
+		double range = std::max(0.01, m_properties[i]->getRangeWidth());
+		pOutput[i] = (value - m_properties[i]->getMin()) / range;
+	}
+}
@@ -2,6 +2,7 @@
 
 constexpr auto VAR_NAME_MAX_LENGTH = 128;
 #include <vector>
+#include <string>
 
 class WireHandler;
 class NamedVarSet;
@@ -57,9 +58,6 @@ class NamedVarSet
 	Descriptor &m_descriptor;
 	double *m_pValues;
 	size_t m_numVars;
-
-	double normalize(const char* varName, double value) const;
-	double denormalize(const char*, double value) const;
 public:
 	NamedVarSet(Descriptor& descriptor);
 	virtual ~NamedVarSet();
@@ -67,6 +65,7 @@ public:
 	size_t getNumVars() const{ return m_numVars; }
 
 	double* getValueVector(){return m_pValues;}
+	const double* getValueVector() const { return m_pValues; }
 
 	//these two methods return the absolute value
 	double get(size_t i) const;
@@ -82,6 +81,9 @@ public:
 	void set(size_t i, double value);
 	//these two methods accept normalized values that are de-normalized before storing them
 	void setNormalized(const char* varName, double value);
+	//these two methods (de)normalize a value in the value range of a variable without changing the variable
+	double normalize(const char* varName, double value) const;
+	double denormalize(const char*, double value) const;
 
 	//returns the sum of all the values, i.e. used to scalarise a reward vector
 	double getSumValue() const;
@@ -91,10 +93,31 @@ public:
 	NamedVarProperties* getProperties(const char* varName) const;
 	Descriptor& getDescriptor() { return m_descriptor; }
 	Descriptor* getDescriptorPtr() { return &m_descriptor; }
+	const Descriptor* getDescriptorPtr() const { return &m_descriptor; }
 
 	void addOffset(double offset);
 };
 
+//Copies the normalized values of a fixed list of variables to a buffer (i.e., the input of a neural network). The variables
+//are looked up by name only when the first set is given (or a set with a different descriptor), so that the values can
+//then be read by index. Variables not found in the descriptor (wires) are still read by name
+class NamedVarSetNormalizer
+{
+	vector<string> m_variables;
+	const Descriptor* m_pDescriptor = nullptr;
+	size_t m_descriptorSize = 0;
+	vector<size_t> m_indices;
+	vector<const NamedVarProperties*> m_properties;
+
+	void resolve(const NamedVarSet* pVarSet);
+public:
+	NamedVarSetNormalizer() = default;
+	NamedVarSetNormalizer(const vector<string>& variables) : m_variables(variables) {}
+
+	//pOutput[i] = normalized value of the i-th variable
+	void normalize(const NamedVarSet* pVarSet, double* pOutput);
+};
+
 using State= NamedVarSet;
 using Action= NamedVarSet;
 using Reward= NamedVarSet;
@@ -0,0 +1,101 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "state-action-function.h"
+#include "named-var-set.h"
+#include <string.h>
+#include <stdexcept>
+
+StateActionBatchInputs::StateActionBatchInputs(StateActionFunction* pFunction, const double* const* pStateValues
+	, const double* const* pActionValues, State* s, Action* a)
+	: m_pStateValues(pStateValues), m_pActionValues(pActionValues), m_s(s), m_a(a)
+{
+	//find the variables by name once, instead of once per sample
+	for (const string& name : pFunction->getInputStateVariables())
+	{
+		size_t i = 0;
+		while (i < s->getNumVars() && strcmp(s->getDescriptor()[i].getName(), name.c_str()))
+			++i;
+		if (i == s->getNumVars())
+			throw std::runtime_error(string("Input state variable not found in the batch's state: ") + name);
+		m_stateVariables.push_back(i);
+	}
+	for (const string& name : pFunction->getInputActionVariables())
+	{
+		size_t i = 0;
+		while (i < a->getNumVars() && strcmp(a->getDescriptor()[i].getName(), name.c_str()))
+			++i;
+		if (i == a->getNumVars())
+			throw std::runtime_error(string("Input action variable not found in the batch's action: ") + name);
+		m_actionVariables.push_back(i);
+	}
+}
+
+void StateActionBatchInputs::set(size_t sample)
+{
+	for (size_t i = 0; i < m_stateVariables.size(); ++i)
+		m_s->set(m_stateVariables[i], m_pStateValues[i][sample]);
+	for (size_t i = 0; i < m_actionVariables.size(); ++i)
+		m_a->set(m_actionVariables[i], m_pActionValues[i][sample]);
+}
+
+bool StateActionBatchInputs::sameStateAsPrevious(size_t sample) const
+{
+	if (sample == 0) return false;
+	for (size_t i = 0; i < m_stateVariables.size(); ++i)
+		if (m_pStateValues[i][sample] != m_pStateValues[i][sample - 1]) return false;
+	return true;
+}
+
+bool StateActionBatchInputs::sameActionAsPrevious(size_t sample) const
+{
+	if (sample == 0) return false;
+	for (size_t i = 0; i < m_actionVariables.size(); ++i)
+		if (m_pActionValues[i][sample] != m_pActionValues[i][sample - 1]) return false;
+	return true;
+}
+
+/// <summary>
+/// Evaluates a batch of inputs one by one. Functions that can do better (i.e. share work between samples) override it
+/// </summary>
+/// <param name="pStateValues">Values of the input state variables: pStateValues[i][j] is the value of the i-th input state variable in the j-th sample</param>
+/// <param name="pActionValues">Values of the input action variables</param>
+/// <param name="numSamples">Number of samples in the batch</param>
+/// <param name="s">State used to evaluate the function. Variables that are not inputs of the function keep their values</param>
+/// <param name="a">Action used to evaluate the function</param>
+/// <param name="pOutput">Output buffer with room for numSamples * getNumOutputs() values</param>
+void StateActionFunction::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	StateActionBatchInputs inputs(this, pStateValues, pActionValues, s, a);
+	const size_t numOutputs = getNumOutputs();
+	for (size_t sample = 0; sample < numSamples; ++sample)
+	{
+		inputs.set(sample);
+		const vector<double>& output = evaluate(s, a);
+		for (size_t i = 0; i < numOutputs; ++i)
+			pOutput[sample * numOutputs + i] = output[i];
+	}
+}
@@ -11,6 +11,20 @@ class NamedVarSet;
 using State = NamedVarSet;
 using Action = NamedVarSet;
 
+//Evaluation of a fixed batch of inputs with a copy of the parameters the function had when update() was last called, so
+//that it can be done from another thread while the function keeps learning (i.e., to log or draw the function)
+class StateActionFunctionSnapshot
+{
+public:
+	virtual ~StateActionFunctionSnapshot() {}
+
+	//copies the current parameters of the function. It must be called from the thread that updates the function and
+	//never while evaluate() is running
+	virtual void update() = 0;
+	//evaluates the batch with the copied parameters. pOutput is filled as in StateActionFunction::evaluateBatch()
+	virtual void evaluate(double* pOutput) = 0;
+};
+
 class StateActionFunction
 {
 public:
@@ -19,6 +33,39 @@ public:
 	virtual vector<double>& evaluate(const State* s, const Action* a) = 0;
 	virtual const vector<string>& getInputStateVariables() = 0;
 	virtual const vector<string>& getInputActionVariables() = 0;
+
+	//Evaluates numSamples inputs given as structures of arrays: pStateValues[i][j] is the value of the i-th variable in
+	//getInputStateVariables() in the j-th sample (the same goes for pActionValues and getInputActionVariables()). The
+	//rest of the variables are taken from s and a, which are also used as scratch. pOutput is filled with numSamples rows
+	//of getNumOutputs() values. The default implementation evaluates the samples one by one
+	virtual void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+
+	//Creates a snapshot to evaluate the same batch (same arguments as evaluateBatch()) from another thread. The caller
+	//owns the snapshot and has to call update() before evaluating it. Returns nullptr if the function doesn't support it
+	virtual StateActionFunctionSnapshot* createSnapshot(const double* const* pStateValues, const double* const* pActionValues
+		, size_t numSamples, State* s, Action* a) { return nullptr; }
+};
+
+//Copies the inputs of the samples of a batch (as given to StateActionFunction::evaluateBatch()) to a state and an action
+class StateActionBatchInputs
+{
+	const double* const* m_pStateValues;
+	const double* const* m_pActionValues;
+	State* m_s;
+	Action* m_a;
+	vector<size_t> m_stateVariables, m_actionVariables;
+public:
+	StateActionBatchInputs(StateActionFunction* pFunction, const double* const* pStateValues, const double* const* pActionValues
+		, State* s, Action* a);
+
+	//sets the input variables of the sample-th sample in s and a
+	void set(size_t sample);
+
+	//whether the input state (or action) variables of the sample-th sample have the same values as in the previous one,
+	//so that whatever was calculated from them can be reused
+	bool sameStateAsPrevious(size_t sample) const;
+	bool sameActionAsPrevious(size_t sample) const;
 };
 
-#endif //__STATE_ACTION_FUNCTION
\ No newline at end of file
+#endif //__STATE_ACTION_FUNCTION__
@@ -43,8 +43,10 @@ DDPG::DDPG(ConfigNode * pConfigNode)
 	m_noiseSignals = MULTI_VALUE_FACTORY<Noise>(pConfigNode, "Exploration-Noise", "Noise signals added to each of the outputs of the deterministic policy");
 	m_criticQFunction= CHILD_OBJECT<DeepContinuousQFunction>(pConfigNode, "Q-Value-Function", "Value function learned by the critic");
 	m_tau = DOUBLE_PARAM(pConfigNode, "Tau", "Parameter controlling the soft-updates of the online network", 0.001);
+	m_replayBuffer = CHILD_OBJECT<DeepReplayBuffer>(pConfigNode, "Replay-Buffer", "Buffer the minibatches are drawn from", true);
 
-	CNTK::WrapperLoader::SetRequirements();
+	if (usesCntk())
+		CNTK::WrapperLoader::SetRequirements();
 }
 
 DDPG::~DDPG()
@@ -61,12 +63,19 @@ DDPG::~DDPG()
 	if (m_pActorTargetNetwork != nullptr)
 		m_pActorTargetNetwork->destroy();
 
-	CNTK::WrapperLoader::UnLoad();
+	if (usesCntk())
+		CNTK::WrapperLoader::UnLoad();
+}
+
+bool DDPG::usesCntk()
+{
+	return m_actorPolicy->usesCntk() || m_criticQFunction->usesCntk();
 }
 
 void DDPG::deferredLoadStep()
 {
-	CNTK::WrapperLoader::Load();
+	if (usesCntk())
+		CNTK::WrapperLoader::Load();
 
 	//Initialize the actor
 	m_pActorMinibatch = m_actorPolicy->getMinibatch();
@@ -76,6 +85,7 @@ void DDPG::deferredLoadStep()
 
 	m_pi_s = vector<double>(m_actorPolicy->getNumOutputs() * m_pActorMinibatch->size());
 	m_pi_s_p = vector<double>(m_actorPolicy->getNumOutputs() * m_pActorMinibatch->size());
+	m_actorStateNormalizer = NamedVarSetNormalizer(m_actorPolicy->getInputStateVariables());
 
 	//Initialise the critic
 	m_pCriticMinibatch = m_criticQFunction->getMinibatch();
@@ -84,6 +94,31 @@ void DDPG::deferredLoadStep()
 	SimionApp::get()->registerStateActionFunction("Q", m_pCriticOnlineNetwork);
 
 	m_Q_pi_s_p = vector<double>(m_pCriticMinibatch->size());
+
+	//both networks are trained with the same tuples
+	m_replayBuffer->initialize({ m_actorPolicy.ptr(), m_criticQFunction.ptr() }, m_pCriticMinibatch->size());
+}
+
+/// <summary>
+/// Saves the online and target networks of the actor and the critic (with the state of their learners) to a checkpoint
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void DDPG::saveCheckpoint(CheckpointWriter& writer)
+{
+	if (!m_pActorOnlineNetwork->saveCheckpoint(writer, "Actor-Online") || !m_pActorTargetNetwork->saveCheckpoint(writer, "Actor-Target")
+		|| !m_pCriticOnlineNetwork->saveCheckpoint(writer, "Critic-Online") || !m_pCriticTargetNetwork->saveCheckpoint(writer, "Critic-Target"))
+		Logger::logMessage(MessageType::Warning, "DDPG: only native networks can be saved in checkpoints");
+}
+
+/// <summary>
+/// Restores the networks of the actor and the critic from a checkpoint
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+void DDPG::loadCheckpoint(const CheckpointReader& reader)
+{
+	if (!m_pActorOnlineNetwork->loadCheckpoint(reader, "Actor-Online") || !m_pActorTargetNetwork->loadCheckpoint(reader, "Actor-Target")
+		|| !m_pCriticOnlineNetwork->loadCheckpoint(reader, "Critic-Online") || !m_pCriticTargetNetwork->loadCheckpoint(reader, "Critic-Target"))
+		Logger::logMessage(MessageType::Warning, "DDPG: the networks couldn't be loaded from the checkpoint");
 }
 
 /// <summary>
@@ -110,7 +145,7 @@ double DDPG::selectAction(const State * s, Action * a)
 		//if there are less noise signals than output action variables, just use the last one
 		noiseSignalIndex = std::min(i, m_noiseSignals.size() - 1);
 
-		noise = m_noiseSignals[i]->getSample();
+		noise = m_noiseSignals[noiseSignalIndex]->getSample();
 		a->set(m_actorPolicy->getUsedActionVariables()[i].c_str()
 			, policyOutput[i] + noise);
 	}
@@ -118,6 +153,42 @@ double DDPG::selectAction(const State * s, Action * a)
 	return 1.0;
 }
 
+/// <summary>
+/// Batch version of selectAction(): the states of all the environments are evaluated in a single forward pass and the
+/// noise of each action variable is sampled for all the environments at once
+/// </summary>
+/// <param name="s">The state of each environment</param>
+/// <param name="a">The output action of each environment</param>
+/// <param name="probabilities">The probability of each action</param>
+void DDPG::selectActions(const vector<const State*>& s, const vector<Action*>& a, vector<double>& probabilities)
+{
+	size_t numEnvironments = s.size();
+	size_t numStateVariables = m_actorPolicy->getInputStateVariables().size();
+	size_t numOutputs = m_actorPolicy->getNumOutputs();
+	m_batchStates.resize(numEnvironments * numStateVariables);
+	m_batchPolicyOutput.resize(numEnvironments * numOutputs);
+	for (size_t i = 0; i < numEnvironments; i++)
+		m_actorStateNormalizer.normalize(s[i], &m_batchStates[i * numStateVariables]);
+	m_pActorTargetNetwork->evaluate(m_batchStates, m_batchPolicyOutput);
+	probabilities.assign(numEnvironments, 1.0);
+
+	if (SimionApp::get()->pExperiment->isEvaluationEpisode())
+	{
+		for (size_t i = 0; i < numEnvironments; i++)
+			m_actorPolicy->vectorToAction(m_batchPolicyOutput, i, a[i]);
+		return;
+	}
+
+	m_batchNoise.resize(numEnvironments);
+	const vector<string>& actionVariables = m_actorPolicy->getUsedActionVariables();
+	for (size_t i = 0; i < actionVariables.size(); i++)
+	{
+		//if there are less noise signals than output action variables, just use the last one
+		m_noiseSignals[std::min(i, m_noiseSignals.size() - 1)]->getSamples(m_batchNoise.data(), numEnvironments);
+		for (size_t env = 0; env < numEnvironments; env++)
+			a[env]->set(actionVariables[i].c_str(), m_batchPolicyOutput[env * numOutputs + i] + m_batchNoise[env]);
+	}
+}
 
 /// <summary>
 /// Updates the critic and actor using the DDPG algorithm
@@ -128,15 +199,29 @@ double DDPG::selectAction(const State * s, Action * a)
 /// <param name="r">Reward</param>
 double DDPG::update(const State * s, const Action * a, const State * s_p, double r, double behaviorProb)
 {
-	if (!m_pActorMinibatch->isFull() && !m_pCriticMinibatch->isFull())
+	if (m_replayBuffer->bUsing())
+	{
+		m_replayBuffer->addTuple(s, a, s_p, r);
+
+		size_t numUpdates = m_replayBuffer->getNumUpdatesDue();
+		for (size_t i = 0; i < numUpdates; i++)
+		{
+			const vector<DeepMinibatch*>& minibatches = m_replayBuffer->nextMinibatches();
+			updateCritic(minibatches[0], minibatches[1]);
+			updateActor(minibatches[0], minibatches[1]);
+
+			m_numUpdates++;
+		}
+	}
+	else if (!m_pActorMinibatch->isFull() && !m_pCriticMinibatch->isFull())
 	{
 		m_pActorMinibatch->addTuple(s, a, s_p, r);
 		m_pCriticMinibatch->addTuple(s, a, s_p, r);
 	}
 	else
 	{
-		updateCritic(s, a, s_p, r);
-		updateActor(s, a, s_p, r);
+		updateCritic(m_pActorMinibatch, m_pCriticMinibatch);
+		updateActor(m_pActorMinibatch, m_pCriticMinibatch);
 
 		m_numUpdates++;
 
@@ -147,62 +232,45 @@ double DDPG::update(const State * s, const Action * a, const State * s_p, double
 	return 0.0;
 }
 
-void DDPG::updateActor(const State* s, const Action* a, const State* s_p, double r)
+void DDPG::updateActor(DeepMinibatch* pActorMinibatch, DeepMinibatch* pCriticMinibatch)
 {
-	SimGod* pSimGod = SimionApp::get()->pSimGod.ptr();
-
-	double gamma = SimionApp::get()->pSimGod->getGamma();
-
 	//get pi(s)
-	m_pActorTargetNetwork->evaluate( m_pActorMinibatch->s(), m_pi_s);
+	m_pActorTargetNetwork->evaluate(pActorMinibatch->s(), m_pi_s);
 
 	//gradient = critic->gradient(s, pi(s))
-	m_pCriticTargetNetwork->gradientWrtAction( m_pCriticMinibatch->s(), m_pi_s, m_pActorMinibatch->target());
+	m_pCriticTargetNetwork->gradientWrtAction(pCriticMinibatch->s(), m_pi_s, pActorMinibatch->target());
 
 	//gradient = -gradient
-	for (size_t i = 0; i < m_pActorMinibatch->target().size(); i++)
-		m_pActorMinibatch->target()[i] *= -1.0;
+	for (size_t i = 0; i < pActorMinibatch->target().size(); i++)
+		pActorMinibatch->target()[i] *= -1.0;
 
-	m_pActorOnlineNetwork->applyGradient(m_pActorMinibatch, m_pActorMinibatch->target());
+	m_pActorOnlineNetwork->applyGradient(pActorMinibatch, pActorMinibatch->target());
 
-	if (m_numUpdates % m_targetFunctionUpdateFreq == 0)
-	{
-		m_pActorTargetNetwork->destroy();
-		m_pActorTargetNetwork = (IDeterministicPolicyNetwork*) m_pActorOnlineNetwork->clone();
-	}
-
-	//m_pActorTargetNetwork->softUpdate(m_pActorOnlineNetwork);
+	//move the target weights toward the online weights
+	m_pActorTargetNetwork->softUpdate(m_pActorOnlineNetwork, m_tau.get());
 }
 
-void DDPG::updateCritic(const State* s, const Action* a, const State* s_p, double r)
+void DDPG::updateCritic(DeepMinibatch* pActorMinibatch, DeepMinibatch* pCriticMinibatch)
 {
-	SimGod* pSimGod = SimionApp::get()->pSimGod.ptr();
-
-	double gamma = pSimGod->getGamma();
+	double gamma = SimionApp::get()->pSimGod->getGamma();
 
 	//calculate pi(s_p)
-	m_pActorTargetNetwork->evaluate(m_pActorMinibatch->s_p(), m_pi_s_p);
+	m_pActorTargetNetwork->evaluate(pActorMinibatch->s_p(), m_pi_s_p);
 
-	m_pCriticTargetNetwork->evaluate(m_pCriticMinibatch->s_p(), m_pi_s_p, m_Q_pi_s_p);
+	m_pCriticTargetNetwork->evaluate(pCriticMinibatch->s_p(), m_pi_s_p, m_Q_pi_s_p);
 
 	//for each tuple in the minibatch
-	for (int i = 0; i < m_pCriticMinibatch->size(); i++)
+	for (int i = 0; i < pCriticMinibatch->size(); i++)
 	{
 		//calculate targetvalue= r + gamma*Q(s_p,a)
-		m_pCriticMinibatch->target()[i] = r + gamma * m_Q_pi_s_p[i];
+		pCriticMinibatch->target()[i] = pCriticMinibatch->r()[i] + gamma * m_Q_pi_s_p[i];
 	}
 
 	//update the network finally
-	m_pCriticOnlineNetwork->train(m_pCriticMinibatch, m_pCriticMinibatch->target(), m_criticQFunction->getLearningRate());
+	m_pCriticOnlineNetwork->train(pCriticMinibatch, pCriticMinibatch->target(), m_criticQFunction->getLearningRate());
 
 	//move the target weights toward the online weights
-	//m_pCriticTargetNetwork->softUpdate(m_pCriticOnlineNetwork);
-
-	if (m_numUpdates % m_targetFunctionUpdateFreq == 0)
-	{
-		m_pCriticTargetNetwork->destroy();
-		m_pCriticTargetNetwork = (IContinuousQFunctionNetwork*) m_pCriticOnlineNetwork->clone();
-	}
+	m_pCriticTargetNetwork->softUpdate(m_pCriticOnlineNetwork, m_tau.get());
 }
 
-#endif
+#endif
\ No newline at end of file
@@ -2,6 +2,9 @@
 #if defined(__linux__) || defined(_WIN64)
 #include "simion.h"
 #include "deferred-load.h"
+#include "checkpoint.h"
+#include "../Common/named-var-set.h"
+#include "deep-replay-buffer.h"
 
 class Noise;
 class IDeepNetwork;
@@ -21,7 +24,7 @@ class IDeterministicPolicyNetwork;
 //Keras implementation:
 //https://yanpanlau.github.io/2016/10/11/Torcs-Keras.html
 
-class DDPG : public Simion, DeferredLoad
+class DDPG : public Simion, DeferredLoad, Checkpointable
 {
 	//Actor
 	DeepMinibatch* m_pActorMinibatch = nullptr;
@@ -31,6 +34,11 @@ class DDPG : public Simion, DeferredLoad
 	MULTI_VALUE_FACTORY<Noise> m_noiseSignals;
 	vector<double> m_pi_s;
 	vector<double> m_pi_s_p;
+	//used to select the actions of several environments at once
+	NamedVarSetNormalizer m_actorStateNormalizer;
+	vector<double> m_batchStates;
+	vector<double> m_batchPolicyOutput;
+	vector<double> m_batchNoise;
 	//Critic
 	DeepMinibatch* m_pCriticMinibatch = nullptr;
 	IContinuousQFunctionNetwork* m_pCriticOnlineNetwork = nullptr;
@@ -40,14 +48,19 @@ class DDPG : public Simion, DeferredLoad
 
 	DOUBLE_PARAM m_tau;
 
+	//if used, minibatches are drawn from the replay buffer instead of being filled with consecutive tuples
+	CHILD_OBJECT<DeepReplayBuffer> m_replayBuffer;
+
 	size_t m_numUpdates = 0;
-	size_t m_targetFunctionUpdateFreq = 10;
 
 	//update policy network
-	void updateActor(const State* s, const Action* a, const State* s_p, double r);
+	void updateActor(DeepMinibatch* pActorMinibatch, DeepMinibatch* pCriticMinibatch);
 
 	//update q network
-	void updateCritic(const State* s, const Action* a, const State* s_p, double r);
+	void updateCritic(DeepMinibatch* pActorMinibatch, DeepMinibatch* pCriticMinibatch);
+
+	//true if either network is implemented with CNTK
+	bool usesCntk();
 
 public:
 	~DDPG();
@@ -56,8 +69,15 @@ public:
 	//heavy-weight initialization
 	virtual void deferredLoadStep();
 
+	//only the native networks can be saved in checkpoints
+	virtual void saveCheckpoint(CheckpointWriter& writer);
+	virtual void loadCheckpoint(const CheckpointReader& reader);
+
 	//selects an action according to the learned policy's network
 	virtual double selectAction(const State *s, Action *a);
+	//selects the actions of several environments with a single evaluation of the policy's network. The exploration noise
+	//of all the environments is generated at once, with its own state in each environment
+	virtual void selectActions(const vector<const State*>& s, const vector<Action*>& a, vector<double>& probabilities);
 
 	//updates the critic network and the actor's policy network (both the target and the prediction network)
 	virtual double update(const State *s, const Action *a, const State *s_p, double r, double behaviorProb);
@@ -38,6 +38,7 @@
 #include <algorithm>
 #include "config.h"
 #include "deep-network.h"
+#include "deep-kernels.h"
 #include "cntk-wrapper-loader.h"
 
 DQN::~DQN()
@@ -45,7 +46,8 @@ DQN::~DQN()
 	if (m_pTargetQNetwork) m_pTargetQNetwork->destroy();
 	if (m_pOnlineQNetwork) m_pOnlineQNetwork->destroy();
 	if (m_pMinibatch) delete m_pMinibatch;
-	CNTK::WrapperLoader::UnLoad();
+	if (m_pQFunction->usesCntk())
+		CNTK::WrapperLoader::UnLoad();
 }
 
 DQN::DQN(ConfigNode* pConfigNode)
@@ -53,9 +55,11 @@ DQN::DQN(ConfigNode* pConfigNode)
 	m_pQFunction = CHILD_OBJECT<DeepDiscreteQFunction>(pConfigNode, "Q-Network", "The definition of the Q-function learned by the agent");
 
 	//Only register dependencies. The wrapper is loaded on the deferred load step
-	CNTK::WrapperLoader::SetRequirements();
+	if (m_pQFunction->usesCntk())
+		CNTK::WrapperLoader::SetRequirements();
 
 	m_policy = CHILD_OBJECT_FACTORY<DiscreteDeepPolicy>(pConfigNode, "Policy", "The policy");
+	m_replayBuffer = CHILD_OBJECT<DeepReplayBuffer>(pConfigNode, "Replay-Buffer", "Buffer the minibatches are drawn from", true);
 }
 
 void DQN::deferredLoadStep()
@@ -63,7 +67,8 @@ void DQN::deferredLoadStep()
 	//we defer all the heavy-weight initializing stuff and anything that depends on the SimGod
 	
 	//Load Cntk if we must
-	CNTK::WrapperLoader::Load();
+	if (m_pQFunction->usesCntk())
+		CNTK::WrapperLoader::Load();
 
 	//create the networks
 	m_pOnlineQNetwork = m_pQFunction->getNetworkInstance();
@@ -71,13 +76,14 @@ void DQN::deferredLoadStep()
 	m_pTargetQNetwork = (IDiscreteQFunctionNetwork*) m_pOnlineQNetwork->clone();
 
 	m_pMinibatch = m_pQFunction->getMinibatch();
+	m_replayBuffer->initialize({ m_pQFunction.ptr() }, m_pMinibatch->size());
 
 	//initialize the policy
 	m_policy->initialize(m_pQFunction.ptr());
 
 	//auxiliary vectors
 	m_Q_s_p = vector<double>(m_pQFunction->getNumOutputs() * m_pMinibatch->size());
-	m_argMaxIndex = vector<int>(m_pMinibatch->size());
+	m_actionIndices = vector<size_t>(m_pMinibatch->size());
 }
 
 /// <summary>
@@ -92,9 +98,38 @@ double DQN::selectAction(const State * s, Action * a)
 	return 1.0;
 }
 
-IDiscreteQFunctionNetwork* DQN::getTargetNetwork()
+/// <summary>
+/// Saves the online and target networks (with the state of their learners) to a checkpoint
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void DQN::saveCheckpoint(CheckpointWriter& writer)
+{
+	if (!m_pOnlineQNetwork->saveCheckpoint(writer, "Online") || !m_pTargetQNetwork->saveCheckpoint(writer, "Target"))
+		Logger::logMessage(MessageType::Warning, "DQN: only native networks can be saved in checkpoints");
+}
+
+/// <summary>
+/// Restores the online and target networks from a checkpoint
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+void DQN::loadCheckpoint(const CheckpointReader& reader)
 {
-	return m_pTargetQNetwork;
+	if (!m_pOnlineQNetwork->loadCheckpoint(reader, "Online") || !m_pTargetQNetwork->loadCheckpoint(reader, "Target"))
+		Logger::logMessage(MessageType::Warning, "DQN: the networks couldn't be loaded from the checkpoint");
+}
+
+/// <summary>
+/// Selects the actions of several environments stepped together. The policy evaluates the online network once with
+/// all the states
+/// </summary>
+/// <param name="s">The state of each environment</param>
+/// <param name="a">The output action of each environment</param>
+/// <param name="probabilities">The probability of each action</param>
+void DQN::selectActions(const vector<const State*>& s, const vector<Action*>& a, vector<double>& probabilities)
+{
+	m_policy->selectActions(m_pOnlineQNetwork, s, a);
+
+	probabilities.assign(s.size(), 1.0);
 }
 
 /// <summary>
@@ -106,75 +141,87 @@ IDiscreteQFunctionNetwork* DQN::getTargetNetwork()
 /// <param name="r">Reward</param>
 double DQN::update(const State * s, const Action * a, const State * s_p, double r, double behaviorProb)
 {
-	if (!m_pMinibatch->isFull())
+	if (m_replayBuffer->bUsing())
 	{
-		m_pMinibatch->addTuple(s, a, s_p, r);
-	}
+		m_replayBuffer->addTuple(s, a, s_p, r);
 
-	if (m_pMinibatch->isFull())
+		size_t numUpdates = m_replayBuffer->getNumUpdatesDue();
+		for (size_t i = 0; i < numUpdates; i++)
+			train(m_replayBuffer->nextMinibatches()[0]);
+	}
+	else
 	{
-		//Minibatch is full: ready for training
-		double gamma = SimionApp::get()->pSimGod->getGamma();
-
-		//Calculate arg max a' Q(s_p,a') for all the tuples in the minibatch (target/online-weights)
-		getTargetNetwork()->evaluate(m_pMinibatch->s_p(), m_Q_s_p);
-
-		//Find the index of the action with max Q-value for each tuple in the minibatch
-		for (int i = 0; i < m_pMinibatch->size(); i++)
+		if (!m_pMinibatch->isFull())
 		{
-			//calculate arg max Q(s_p, a)
-			vector<double>::iterator itBegin = m_Q_s_p.begin() + i * m_pQFunction->getNumOutputs();
-			vector<double>::iterator itEnd = m_Q_s_p.begin() + (i + 1) * m_pQFunction->getNumOutputs();
-			m_argMaxIndex[i] = (int)distance(itBegin, max_element(itBegin, itEnd));
+			m_pMinibatch->addTuple(s, a, s_p, r);
 		}
 
-		//estimate Q(s_p, argMaxQ; target-weights or online-weights)
-		//THIS is the only real difference between DQN and Double-DQN
-		//We do the prediction step again only if using Double-DQN (the prediction network
-		//will be different to the online network)
-		if (getTargetNetwork() != m_pTargetQNetwork)
-			getTargetNetwork()->evaluate(m_pMinibatch->s(), m_Q_s_p);
-
-		//get the value of Q(s) for each tuple
-		m_pOnlineQNetwork->evaluate(m_pMinibatch->s(), m_pMinibatch->target());
-
-		//for each tuple in the minibatch
-		for (int i = 0; i < m_pMinibatch->size(); i++)
+		if (m_pMinibatch->isFull())
 		{
-			//calculate targetvalue= r + gamma*Q(s_p,a)
-			double targetValue = m_pMinibatch->r()[i] + gamma * m_Q_s_p[i * m_pQFunction->getNumOutputs() + m_argMaxIndex[i]];
+			//Minibatch is full: ready for training
+			train(m_pMinibatch);
 
-			//change the target value only for the selected action, the rest remain the same
-			//store the index of the action taken
-			size_t selectedActionId = m_policy->getActionIndex( m_pMinibatch->a() , i );
-			m_pMinibatch->target() [i * m_pQFunction->getNumOutputs() + selectedActionId ] = targetValue;
+			m_pMinibatch->clear();
 		}
-
-		//train the network
-		m_pOnlineQNetwork->train(m_pMinibatch, m_pMinibatch->target(), m_pQFunction->getLearningRate());
-
-		m_pMinibatch->clear();
 	}
 
 	SimGod* pSimGod = SimionApp::get()->pSimGod.ptr();
 
+	//copy the online weights to the target network, in place
 	if (pSimGod->bUpdateFrozenWeightsNow())
+		m_pTargetQNetwork->softUpdate(m_pOnlineQNetwork, 1.0);
+
+	return 1.0; //TODO: Estimate the TD-error??
+}
+
+/// <summary>
+/// Trains the online network with the targets r + gamma * Q(s_p, arg max a' Q(s_p,a')) of the tuples in the minibatch.
+/// In DQN, a' is selected and evaluated with the target network. In Double DQN, a' is selected with the online network
+/// and evaluated with the target network (van Hasselt et al., 2016)
+/// </summary>
+/// <param name="pMinibatch">A full minibatch</param>
+void DQN::train(DeepMinibatch* pMinibatch)
+{
+	double gamma = SimionApp::get()->pSimGod->getGamma();
+	size_t numTuples = pMinibatch->size();
+	size_t numOutputs = m_pQFunction->getNumOutputs();
+
+	//the index of the action taken in each tuple: only its target is changed
+	for (size_t i = 0; i < numTuples; i++)
+		m_actionIndices[i] = m_policy->getActionIndex(pMinibatch->a(), (int)i);
+
+	//Q(s_p,a'; target-weights)
+	m_pTargetQNetwork->evaluate(pMinibatch->s_p(), m_Q_s_p);
+
+	if (!isDoubleDQN())
+	{
+		//the targets are Q(s) except for the action taken
+		m_pOnlineQNetwork->evaluate(pMinibatch->s(), pMinibatch->target());
+		DeepKernels::qLearningTargets(numTuples, numOutputs, m_Q_s_p.data(), m_Q_s_p.data(), pMinibatch->r().data()
+			, gamma, m_actionIndices.data(), pMinibatch->target().data());
+	}
+	else
 	{
-		if (m_pTargetQNetwork)
-			m_pTargetQNetwork->destroy();
-			m_pTargetQNetwork = (IDiscreteQFunctionNetwork*) m_pOnlineQNetwork->clone();
+		//Q(s) and Q(s_p) with the online weights in a single evaluation: s and s_p are stacked as a minibatch twice as large
+		const vector<double>& states = pMinibatch->s();
+		const vector<double>& nextStates = pMinibatch->s_p();
+		m_s_and_s_p.resize(states.size() + nextStates.size());
+		std::copy(states.begin(), states.end(), m_s_and_s_p.begin());
+		std::copy(nextStates.begin(), nextStates.end(), m_s_and_s_p.begin() + states.size());
+		m_onlineQ_s_and_s_p.resize(2 * numTuples * numOutputs);
+		m_pOnlineQNetwork->evaluate(m_s_and_s_p, m_onlineQ_s_and_s_p);
+
+		std::copy(m_onlineQ_s_and_s_p.begin(), m_onlineQ_s_and_s_p.begin() + numTuples * numOutputs, pMinibatch->target().begin());
+		DeepKernels::qLearningTargets(numTuples, numOutputs, &m_onlineQ_s_and_s_p[numTuples * numOutputs], m_Q_s_p.data()
+			, pMinibatch->r().data(), gamma, m_actionIndices.data(), pMinibatch->target().data());
 	}
 
-	return 1.0; //TODO: Estimate the TD-error??
+	//train the network
+	m_pOnlineQNetwork->train(pMinibatch, pMinibatch->target(), m_pQFunction->getLearningRate());
 }
 
 
 DoubleDQN::DoubleDQN(ConfigNode* pParameters): DQN (pParameters)
 {}
 
-IDiscreteQFunctionNetwork* DoubleDQN::getTargetNetwork()
-{
-	return m_pOnlineQNetwork;
-}
-
 #endif
\ No newline at end of file
@@ -5,14 +5,16 @@
 #include "simion.h"
 #include "parameters.h"
 #include "deferred-load.h"
+#include "checkpoint.h"
 #include "deep-functions.h"
+#include "deep-replay-buffer.h"
 
 class INetwork;
 class DiscreteDeepPolicy;
 class IMinibatch;
 class ConfigNode;
 
-class DQN : public Simion, DeferredLoad
+class DQN : public Simion, DeferredLoad, Checkpointable
 {
 	/*
 	Deep Reinforcement Learning with Double Deep Q-Learning
@@ -24,13 +26,22 @@ protected:
 	IDiscreteQFunctionNetwork* m_pTargetQNetwork = nullptr;
 	IDiscreteQFunctionNetwork* m_pOnlineQNetwork = nullptr;
 	DeepMinibatch* m_pMinibatch = nullptr;
+	//if used, minibatches are drawn from the replay buffer instead of being filled with consecutive tuples
+	CHILD_OBJECT<DeepReplayBuffer> m_replayBuffer;
 
 	vector<double> m_Q_s_p;
-	vector<int> m_argMaxIndex;
+	vector<size_t> m_actionIndices;
+	//Double DQN evaluates the online network with s and s_p in a single batch: Q(s) for the targets, Q(s_p) to select a'
+	vector<double> m_s_and_s_p;
+	vector<double> m_onlineQ_s_and_s_p;
 
 	CHILD_OBJECT_FACTORY<DiscreteDeepPolicy> m_policy;
 
-	virtual IDiscreteQFunctionNetwork* getTargetNetwork();
+	//true if the action in the targets is selected with the online network instead of the target network
+	virtual bool isDoubleDQN() { return false; }
+
+	//trains the online network with the tuples in the minibatch
+	void train(DeepMinibatch* pMinibatch);
 	
 public:
 	~DQN();
@@ -38,8 +49,14 @@ public:
 
 	virtual void deferredLoadStep();
 
+	//only the native networks can be saved in checkpoints
+	virtual void saveCheckpoint(CheckpointWriter& writer);
+	virtual void loadCheckpoint(const CheckpointReader& reader);
+
 	//selects an according to the learned policy pi(a|s)
 	virtual double selectAction(const State *s, Action *a);
+	//selects the actions of several environments with a single evaluation of the online network
+	virtual void selectActions(const vector<const State*>& s, const vector<Action*>& a, vector<double>& probabilities);
 
 	//updates the critic and the actor
 	virtual double update(const State *s, const Action *a, const State *s_p, double r, double behaviorProb);
@@ -50,7 +67,7 @@ class DoubleDQN : public DQN
 public:
 	DoubleDQN(ConfigNode* pParameters);
 	
-	virtual IDiscreteQFunctionNetwork* getTargetNetwork();
+	virtual bool isDoubleDQN() { return true; }
 };
 
 #endif
\ No newline at end of file
@@ -85,6 +85,7 @@ SimionApp::SimionApp(ConfigNode* pConfigNode)
 
 	//m_bValidOfflineTraining = ;
 	m_offlineTrainingSampleFile = FILE_PATH_PARAM(pConfigNode, "Offline-Training-File", "Sample file used for training. Leave blank if you want to use online training", "");
+	m_offlineTrainingSampleOrder = ENUM_PARAM<SampleOrder>(pConfigNode, "Offline-Training-Sample-Order", "Order in which samples are drawn from the sample file: shuffled once per pass through the file (shuffled), at random with replacement (random) or in the order they were saved (sequential)", SampleOrder::shuffled);
 
 	m_bValidOfflineTraining = m_offlineTrainingSampleFile.get() != nullptr && strlen(m_offlineTrainingSampleFile.get()) > 0;
 	if (m_bValidOfflineTraining)
@@ -101,7 +102,11 @@ SimionApp::~SimionApp()
 	if (pMemManager != nullptr) delete pMemManager;
 	if (m_pRenderer != nullptr) delete m_pRenderer;
 
+	//the function log is written from a background thread that uses the samplers
+	if (pLogger.ptr()) pLogger->closeFunctionLogFile();
 	for (FunctionSampler* sampler : m_pFunctionSamplers) delete sampler;
+	//stops the thread that prefetches samples
+	if (m_pOfflineSampleFile != nullptr) delete m_pOfflineSampleFile;
 	for (pair<string, Wire*> p : m_wires) delete p.second;
 
 	m_pAppInstance = 0;
@@ -186,6 +191,7 @@ void SimionApp::setConfigFile(string configFile)
 	m_configFile = configFile;
 
 	pLogger->setOutputFilenames();
+	pSimGod->setOutputFilenames();
 }
 
 string SimionApp::getConfigFile()
@@ -323,7 +329,7 @@ void SimionApp::run()
 
 	//load the sample file used in offline-training. Do it before the deferred load so that data from the file can be used in value function initializations, i.e. DQN
 	if (m_bValidOfflineTraining)
-		m_pOfflineSampleFile = new SampleFile(m_offlineTrainingSampleFile.get());
+		m_pOfflineSampleFile = new SampleFile(m_offlineTrainingSampleFile.get(), m_offlineTrainingSampleOrder.get());
 
 	//load stuff we don't want to be loaded in the constructors for faster construction
 	pSimGod->deferredLoad();
@@ -357,6 +363,9 @@ void SimionApp::run()
 				runOfflineTrainingEpisode(s, a, s_p);
 			else
 				runOnlineTrainingEpisode(s, a, s_p);
+
+			//save a checkpoint of the learned functions if it's due
+			pSimGod->onTrainingEpisodeEnd();
 		}
 	}
 
@@ -493,15 +502,14 @@ void SimionApp::initRenderer(string sceneFile, State* s, Action* a)
 
 	//stats
 	Meter2D* pMeter2D;
-	IStats* pStat;
+	Stats& stats = pLogger->getStats();
 	Vector2D origin = Vector2D(0.025, 0.9);
 	Vector2D size = Vector2D(0.95, 0.04);
 	Vector2D offset = Vector2D(0.0, 0.05);
 	double depth = 0.25;
-	for (unsigned int i = 0; i < pLogger->getNumStats(); ++i)
+	for (unsigned int i = 0; i < stats.size(); ++i)
 	{
-		pStat = pLogger->getStats(i);
-		pMeter2D = new Meter2D(string(pStat->getSubkey()), origin, size, depth);
+		pMeter2D = new Meter2D(stats.getSubkey(i), origin, size, depth);
 		m_pStatsUIMeters.push_back(pMeter2D);
 		m_pRenderer->add2DGraphicObject(pMeter2D, pMetersViewPort);
 		origin -= offset;
@@ -667,11 +675,11 @@ void SimionApp::update2DMeters(State* s, Action* a)
 	//2D METERS
 	//update stats
 	unsigned int statIndex = 0;
+	Stats& stats = pLogger->getStats();
 	for (Meter2D* pMeter2D : m_pStatsUIMeters)
 	{
-		IStats* pStat = pLogger->getStats(statIndex);
-		pMeter2D->setValue(pStat->get());
-		pMeter2D->setValueRange(Range(pStat->getStatsInfo()->getMin(), pStat->getStatsInfo()->getMax()));
+		pMeter2D->setValue(stats.getValue(statIndex));
+		pMeter2D->setValueRange(Range(stats.getMin(statIndex), stats.getMax(statIndex)));
 		++statIndex;
 	}
 	//update state
@@ -143,6 +143,7 @@ private:
 
 	bool m_bValidOfflineTraining;
 	FILE_PATH_PARAM m_offlineTrainingSampleFile;
+	ENUM_PARAM<SampleOrder> m_offlineTrainingSampleOrder;
 
 	void runEvaluationEpisode(State* s, Action* a, State* s_p);
 	void runOnlineTrainingEpisode(State* s, Action* a, State* s_p);
@@ -23,180 +23,376 @@
 	SOFTWARE.
 */
 
-#ifdef _WIN64
-#include "async-deep-simion.h"	
+#include "async-deep-simion.h"
 
-#include "SimGod.h"
+#if defined(__linux__) || defined(_WIN64)
+
+#include "simgod.h"
+#include "logger.h"
 #include "worlds/world.h"
 #include "app.h"
-#include "featuremap.h"
-#include "features.h"
-#include "noise.h"
-#include "deep-vfa-policy.h"
-#include "parameters-numeric.h"
-#include "q-learners.h"
-#include "experience-replay.h"
-#include "critic.h"
-
-#include "../tools/CNTKWrapper/CNTKWrapper.h"
-
+#include "experiment.h"
+#include "config.h"
+#include "deep-discrete-q-policy.h"
+#include "deep-minibatch.h"
+#include "deep-native-network.h"
+#include "deep-kernels.h"
+#include "../Common/named-var-set.h"
 #include <algorithm>
-/*
+
 AsyncQLearning::AsyncQLearning(ConfigNode* pConfigNode)
 {
-	CNTKWrapperClient::Load();
+	m_pQFunction = CHILD_OBJECT<DeepDiscreteQFunction>(pConfigNode, "Q-Network", "The definition of the Q-function learned by the agent. Only the native backend is supported");
 	m_policy = CHILD_OBJECT_FACTORY<DiscreteDeepPolicy>(pConfigNode, "Policy", "The policy");
-	m_predictionQNetwork = NN_DEFINITION(pConfigNode, "neural-network", "Neural Network Architecture");
-	m_outputAction = ACTION_VARIABLE(pConfigNode, "Output-Action", "The output action variable");
-	m_experienceReplay = CHILD_OBJECT<ExperienceReplay>(pConfigNode, "experience-replay", "Experience replay", false);
-
-	m_iAsyncUpdate = INT_PARAM(pConfigNode, "i-async-update", "Steps before the network's weights are updated by the optimizer with the accumulated DeltaTheta", 1);
-	m_iTarget = INT_PARAM(pConfigNode, "i-target", "Steps before the target network's weights are updated", 1);
-
-	m_pStateOutFeatures = new FeatureList("state-input");
-
-	m_numberOfStateVars = SimGod::getGlobalStateFeatureMap()->getTotalNumFeatures();
-	if (m_numberOfStateVars == 0)
-		Logger::logMessage(MessageType::Error, "Invalid State-Map chosen (it will return 0 features at most, but at least 1 has to be returned)");
-
-	if (dynamic_cast<DiscreteActionFeatureMap*>(SimGod::getGlobalActionFeatureMap().get()) == nullptr)
-		Logger::logMessage(MessageType::Error, "The CDiscreteEpsilonGreedyDeepPolicy requires a CDiscreteActionFeatureMap as the action-feature-map.");
-
-	m_pGrid = ((SingleDimensionDiscreteActionVariableGrid*)
-		(((DiscreteActionFeatureMap*)SimGod::getGlobalActionFeatureMap().get())->returnGrid()[m_outputAction.get()]));
+	m_numActorLearners = INT_PARAM(pConfigNode, "Num-Actor-Learners", "Number of actor-learners simulating their own episodes in background threads, besides the main one. If 0, one less than the number of hardware threads", 0);
+	m_asyncUpdateSteps = INT_PARAM(pConfigNode, "Async-Update-Steps", "Number of steps each actor-learner accumulates before pushing a gradient to the shared parameters", 5);
+	m_targetUpdateSteps = INT_PARAM(pConfigNode, "Target-Update-Steps", "Number of steps (done by all the actor-learners) between updates of the target network", 10000);
+	m_numParameterShards = INT_PARAM(pConfigNode, "Num-Parameter-Shards", "Number of parts of the shared parameters, each updated with its own lock", 16);
+	m_pConfigNode = pConfigNode;
+
+	m_numSteps = 0;
+	m_learningRate = 0.0;
+	m_bExit = false;
+	m_bRunActorLearners = false;
+}
 
-	if (m_pGrid->getNumCenters() != m_predictionQNetwork.getNetwork()->getTotalSize());
-		Logger::logMessage(MessageType::Error, "Output of the network has not the same size as the discrete action grid has centers/discrete values");
+AsyncQLearning::~AsyncQLearning()
+{
+	stopActorLearnerThreads();
 
-	m_numberOfActions = m_predictionQNetwork.getNetwork()->getTargetOutput().Shape().TotalSize();
-	m_stateVector = std::vector<float>(m_numberOfStateVars, 0.0);
-	m_actionValuePredictionVector = std::vector<float>(m_numberOfActions);
+	for (ActorLearner* pActorLearner : m_actorLearners)
+	{
+		if (pActorLearner->pOnlineNetwork) pActorLearner->pOnlineNetwork->destroy();
+		if (pActorLearner->pTargetNetwork) pActorLearner->pTargetNetwork->destroy();
+		if (pActorLearner->pMinibatch) delete pActorLearner->pMinibatch;
+		if (pActorLearner->s) delete pActorLearner->s;
+		if (pActorLearner->a) delete pActorLearner->a;
+		if (pActorLearner->s_p) delete pActorLearner->s_p;
+		delete pActorLearner;
+	}
+}
 
-	m_minibatch_s = std::vector<float>(m_numberOfStateVars * m_experienceReplay->getMaxUpdateBatchSize(), 0.0);
-	m_minibatch_Q_s = std::vector<float>(m_numberOfActions * m_experienceReplay->getMaxUpdateBatchSize(), 0.0);
+void AsyncQLearning::deferredLoadStep()
+{
+	if (m_pQFunction->usesCntk())
+		Logger::logMessage(MessageType::Error, "AsyncQLearning only supports the native deep network backend");
+
+	//the network of the main actor-learner is the one registered and the one that initializes the shared parameters
+	ActorLearner* pMainActorLearner = createActorLearner(0, m_policy.sharedPtr());
+	SimionApp::get()->registerStateActionFunction("Q", pMainActorLearner->pOnlineNetwork);
+	m_parameterServer.initialize(pMainActorLearner->parameters.data(), pMainActorLearner->parameters.size()
+		, pMainActorLearner->pOnlineNetwork->getLearnerType(), (size_t)std::max(1, m_numParameterShards.get()));
+
+	//the background actor-learners simulate their own episodes, which can't be done if the agent learns from a sample file
+	size_t numActorLearners = (size_t)std::max(0, m_numActorLearners.get());
+	if (numActorLearners == 0)
+		numActorLearners = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	if (SimionApp::get()->getSampleFile() != nullptr && numActorLearners > 0)
+	{
+		Logger::logMessage(MessageType::Warning, "AsyncQLearning: training from a sample file, only the main actor-learner is used");
+		numActorLearners = 0;
+	}
 
-	m_pMinibatchExperienceTuples = new ExperienceTuple*[m_experienceReplay->getMaxUpdateBatchSize()];
-	m_pMinibatchChosenActionTargetValues = new double[m_experienceReplay->getMaxUpdateBatchSize()];
-	m_pMinibatchActionId = new int[m_experienceReplay->getMaxUpdateBatchSize()];
+	World* pWorld = SimionApp::get()->pWorld.ptr();
+	for (size_t i = 1; i <= numActorLearners; i++)
+	{
+		std::shared_ptr<DiscreteDeepPolicy> pPolicy = DiscreteDeepPolicy::getInstance(m_pConfigNode->getChild("Policy"));
+		pPolicy->initialize(m_pQFunction.ptr());
+
+		ActorLearner* pActorLearner = createActorLearner(i, pPolicy);
+		pActorLearner->pOnlineNetwork->setParameters(pMainActorLearner->parameters.data());
+		pActorLearner->pTargetNetwork->setParameters(pMainActorLearner->parameters.data());
+		pActorLearner->pDynamicModel = pWorld->createDynamicModelCopy();
+		pActorLearner->s = pActorLearner->pDynamicModel->getStateInstance();
+		pActorLearner->a = pActorLearner->pDynamicModel->getActionInstance();
+		pActorLearner->s_p = pActorLearner->pDynamicModel->getStateInstance();
+	}
 
-	CNTKWrapperClient::Load();
-	m_pTargetQNetwork = m_predictionQNetwork.getNetwork()->clone();
+	m_policy->initialize(m_pQFunction.ptr());
 }
 
-AsyncQLearning::~AsyncQLearning()
+/// <summary>
+/// Creates an actor-learner with new networks, and adds it to the list
+/// </summary>
+/// <param name="index">Index of the actor-learner</param>
+/// <param name="pPolicy">The policy used by the actor-learner. Each thread must use its own instance</param>
+/// <returns>The new actor-learner</returns>
+AsyncQLearning::ActorLearner* AsyncQLearning::createActorLearner(size_t index, std::shared_ptr<DiscreteDeepPolicy> pPolicy)
 {
-	CNTKWrapperClient::UnLoad();
+	ActorLearner* pActorLearner = new ActorLearner();
+	m_actorLearners.push_back(pActorLearner);
+
+	pActorLearner->index = index;
+	pActorLearner->pPolicy = pPolicy;
+	pActorLearner->pOnlineNetwork = dynamic_cast<NativeDiscreteQFunctionNetwork*>(m_pQFunction->getNetworkInstance());
+	pActorLearner->pTargetNetwork = (NativeDiscreteQFunctionNetwork*)pActorLearner->pOnlineNetwork->clone(true);
+	pActorLearner->pMinibatch = new DeepMinibatch((size_t)std::max(1, m_asyncUpdateSteps.get()), m_pQFunction.ptr());
+	pActorLearner->Q_s_p = vector<double>(m_pQFunction->getNumOutputs() * pActorLearner->pMinibatch->size());
+	pActorLearner->actionIndices = vector<size_t>(pActorLearner->pMinibatch->size());
+	pActorLearner->gradient = vector<double>(pActorLearner->pOnlineNetwork->getNumParameters());
+	pActorLearner->parameters = vector<double>(pActorLearner->pOnlineNetwork->getNumParameters());
+	pActorLearner->pOnlineNetwork->getParameters(pActorLearner->parameters.data());
+	return pActorLearner;
 }
 
-double AsyncQLearning::selectAction(const State * s, Action * a)
+/// <summary>
+/// Saves the shared parameters and the state of their learner to a checkpoint
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void AsyncQLearning::saveCheckpoint(CheckpointWriter& writer)
 {
-	SimionApp::get()->pSimGod->getGlobalStateFeatureMap()->getFeatures(s, m_pStateOutFeatures);
+	m_parameterServer.saveCheckpoint(writer);
+}
 
-	//TODO: use sparse representation
-	for (int i = 0; i < m_pStateOutFeatures->m_numFeatures; i++)
+/// <summary>
+/// Loads the shared parameters from a checkpoint and copies them to the networks of all the actor-learners. Only called
+/// before the actor-learner threads are started
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+void AsyncQLearning::loadCheckpoint(const CheckpointReader& reader)
+{
+	if (!m_parameterServer.loadCheckpoint(reader))
+	{
+		Logger::logMessage(MessageType::Warning, "AsyncQLearning: the shared parameters couldn't be loaded from the checkpoint");
+		return;
+	}
+	for (ActorLearner* pActorLearner : m_actorLearners)
 	{
-		auto item = m_pStateOutFeatures->m_pFeatures[i];
-		m_stateVector[item.m_index] = item.m_factor;
+		pActorLearner->targetVersion = m_parameterServer.pullTargetParameters(pActorLearner->parameters.data());
+		pActorLearner->pTargetNetwork->setParameters(pActorLearner->parameters.data());
+		m_parameterServer.pullParameters(pActorLearner->parameters.data());
+		pActorLearner->pOnlineNetwork->setParameters(pActorLearner->parameters.data());
 	}
+}
 
-	std::unordered_map<std::string, std::vector<double>&> inputMap =
-		{ { "state-input", m_stateVector } };
+/// <summary>
+/// Starts the threads of the background actor-learners. Everything they need from the app is copied to them before
+/// </summary>
+void AsyncQLearning::startActorLearnerThreads()
+{
+	World* pWorld = SimionApp::get()->pWorld.ptr();
+	Experiment* pExperiment = SimionApp::get()->pExperiment.ptr();
+	double gamma = SimionApp::get()->pSimGod->getGamma();
+	for (ActorLearner* pActorLearner : m_actorLearners)
+	{
+		pActorLearner->gamma = gamma;
+		pActorLearner->pWorld = pWorld;
+		pActorLearner->pExperiment = pExperiment;
+	}
 
-	m_predictionQNetwork.getNetwork()->predict(inputMap, m_actionValuePredictionVector);
+	m_bActorLearnerThreadsStarted = true;
+	m_bRunActorLearners = true;
+	for (size_t i = 1; i < m_actorLearners.size(); i++)
+		m_actorLearners[i]->thread = std::thread(&AsyncQLearning::actorLearnerLoop, this, m_actorLearners[i]);
+}
 
-	int resultingActionIndex = m_policy->selectAction(m_actionValuePredictionVector);
+/// <summary>
+/// Returns once all the background actor-learners have finished their current step and are waiting to be resumed
+/// </summary>
+void AsyncQLearning::pauseActorLearnerThreads()
+{
+	std::unique_lock<std::mutex> lock(m_runMutex);
+	m_bRunActorLearners = false;
+	size_t numBackgroundActorLearners = m_bActorLearnerThreadsStarted ? m_actorLearners.size() - 1 : 0;
+	m_runCondition.wait(lock, [this, numBackgroundActorLearners]() { return m_numIdleActorLearners == numBackgroundActorLearners; });
+}
 
-	double actionValue = m_pGrid->getCenters()[resultingActionIndex];
-	a->set(m_outputAction.get(), actionValue);
+void AsyncQLearning::resumeActorLearnerThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_runMutex);
+		m_bRunActorLearners = true;
+	}
+	m_runCondition.notify_all();
+}
 
-	return 1.0;
+void AsyncQLearning::stopActorLearnerThreads()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_runMutex);
+		m_bExit = true;
+	}
+	m_runCondition.notify_all();
+	for (ActorLearner* pActorLearner : m_actorLearners)
+	{
+		if (pActorLearner->thread.joinable())
+			pActorLearner->thread.join();
+	}
 }
 
-double AsyncQLearning::update(const State * s, const Action * a, const State * s_p, double r, double behaviorProb)
+/// <summary>
+/// Called by the background actor-learners when they are paused. Blocks them until they are resumed or stopped
+/// </summary>
+/// <returns>False if the actor-learner must exit</returns>
+bool AsyncQLearning::waitUntilResumed()
 {
-	double gamma = SimionApp::get()->pSimGod->getGamma();
+	std::unique_lock<std::mutex> lock(m_runMutex);
+	m_numIdleActorLearners++;
+	m_runCondition.notify_all();
+	m_runCondition.wait(lock, [this]() { return m_bRunActorLearners || m_bExit; });
+	m_numIdleActorLearners--;
+	return !m_bExit;
+}
 
-	m_experienceReplay->addTuple(s, a, s_p, r, 1.0);
+/// <summary>
+/// Pauses the background actor-learners at the end of every training episode, so that they don't learn during
+/// evaluation episodes and the checkpoints are consistent. They are resumed by the next update
+/// </summary>
+void AsyncQLearning::onTrainingEpisodeEnd()
+{
+	pauseActorLearnerThreads();
+}
 
-	//don't update anything if the experience replay buffer does not contain enough elements for at least one minibatch
-	if (m_experienceReplay->getUpdateBatchSize() != m_experienceReplay->getMaxUpdateBatchSize())
-		return 0.0;
+/// <summary>
+/// Stops the background actor-learners after the last training episode, while the app still exists
+/// </summary>
+void AsyncQLearning::onExperimentEnd()
+{
+	stopActorLearnerThreads();
+}
 
-	for (int i = 0; i < m_experienceReplay->getMaxUpdateBatchSize(); i++)
+/// <summary>
+/// Loop of the background actor-learners: episodes are simulated with their own copy of the dynamic model, as
+/// World::executeAction() does, and the actor-learner is updated with every tuple. Between steps, the actor-learner waits
+/// while it is paused, and exits once it is stopped
+/// </summary>
+/// <param name="pActorLearner">The actor-learner of the thread</param>
+void AsyncQLearning::actorLearnerLoop(ActorLearner* pActorLearner)
+{
+	//terminal states set by the reward function of this thread's model are redirected to this flag
+	bool bTerminalState = false;
+	Experiment::setThreadTerminalState(&bTerminalState);
+
+	const int numIntegrationSteps = std::max(1, pActorLearner->pWorld->getNumIntegrationSteps());
+	const double dt = pActorLearner->pWorld->getDT() / (double)numIntegrationSteps;
+	const unsigned int numStepsPerEpisode = pActorLearner->pExperiment->getNumSteps();
+	DynamicModel* pDynamicModel = pActorLearner->pDynamicModel.get();
+	State* s = pActorLearner->s;
+	Action* a = pActorLearner->a;
+	State* s_p = pActorLearner->s_p;
+
+	try
 	{
-		m_pMinibatchExperienceTuples[i] = m_experienceReplay->getRandomTupleFromBuffer();
-
-		//get Q(s_p) for entire minibatch
-		SimionApp::get()->pSimGod->getGlobalStateFeatureMap()->getFeatures(m_pMinibatchExperienceTuples[i]->s_p, m_pStateOutFeatures);
-		for (int n = 0; n < m_pStateOutFeatures->m_numFeatures; n++)
-			m_minibatch_s[m_pStateOutFeatures->m_pFeatures[n].m_index + i*m_numberOfStateVars] = m_pStateOutFeatures->m_pFeatures[n].m_factor;
+		while (!m_bExit)
+		{
+			bTerminalState = false;
+			pDynamicModel->reset(s);
+			for (unsigned int step = 0; step < numStepsPerEpisode && !bTerminalState && !m_bExit; step++)
+			{
+				if (!m_bRunActorLearners && !waitUntilResumed())
+					break;
+
+				pActorLearner->pPolicy->selectAction(pActorLearner->pOnlineNetwork, s, a);
+
+				s_p->copy(s);
+				for (int i = 0; i < numIntegrationSteps && !bTerminalState; i++)
+					pDynamicModel->executeAction(s_p, a, dt);
+				double r = pDynamicModel->getReward(s, a, s_p);
+
+				update(pActorLearner, s, a, s_p, r);
+				s->copy(s_p);
+			}
+		}
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(m_exceptionMutex);
+		if (!m_actorLearnerException)
+			m_actorLearnerException = std::current_exception();
+	}
+	Experiment::setThreadTerminalState(nullptr);
 
-		m_pMinibatchActionId[i] = m_pGrid->getClosestValue(m_pMinibatchExperienceTuples[i]->a->get(m_outputAction.get()));
+	//a finished actor-learner must not be waited for when the rest are paused
+	{
+		std::lock_guard<std::mutex> lock(m_runMutex);
+		m_numIdleActorLearners++;
 	}
+	m_runCondition.notify_all();
+}
 
-	std::unordered_map<std::string, std::vector<double>&> inputMap
-		= { { "state-input", m_minibatch_s } };
-	m_pTargetQNetwork->predict(inputMap, m_minibatch_Q_s);
+/// <summary>
+/// Selects an action with the network of the main actor-learner
+/// </summary>
+/// <param name="s">State</param>
+/// <param name="a">Output action</param>
+double AsyncQLearning::selectAction(const State * s, Action * a)
+{
+	m_policy->selectAction(m_actorLearners[0]->pOnlineNetwork, s, a);
 
+	return 1.0;
+}
 
-	//create vector of target values for the entire minibatch
-	for (int i = 0; i < m_experienceReplay->getMaxUpdateBatchSize(); i++)
+/// <summary>
+/// Updates the actor-learner of the main thread with a tuple of the experiment. The background actor-learners are started
+/// with the first update and resumed with the first update of every training episode, and exceptions thrown by them are
+/// rethrown here
+/// </summary>
+/// <param name="s">Initial state</param>
+/// <param name="a">Action</param>
+/// <param name="s_p">Resultant state</param>
+/// <param name="r">Reward</param>
+double AsyncQLearning::update(const State * s, const Action * a, const State * s_p, double r, double behaviorProb)
+{
 	{
-		int argmaxQ = std::distance(m_minibatch_Q_s.begin() + i*m_numberOfActions,
-			std::max_element(m_minibatch_Q_s.begin() + i*m_numberOfActions, m_minibatch_Q_s.begin() + (i + 1)*m_numberOfActions));
-		m_pMinibatchChosenActionTargetValues[i] = m_pMinibatchExperienceTuples[i]->r + gamma * m_minibatch_Q_s[i*m_numberOfActions + argmaxQ];
+		std::lock_guard<std::mutex> lock(m_exceptionMutex);
+		if (m_actorLearnerException)
+			std::rethrow_exception(m_actorLearnerException);
 	}
+	m_learningRate = m_pQFunction->getLearningRate();
+	if (!m_bActorLearnerThreadsStarted)
+		startActorLearnerThreads();
+	else if (!m_bRunActorLearners)
+		resumeActorLearnerThreads();
 
+	update(m_actorLearners[0], s, a, s_p, r);
 
-	//get Q(s) for entire minibatch
-	for (int i = 0; i < m_experienceReplay->getMaxUpdateBatchSize(); i++)
-	{
-		SimionApp::get()->pSimGod->getGlobalStateFeatureMap()->getFeatures(m_pMinibatchExperienceTuples[i]->s, m_pStateOutFeatures);
-		for (int n = 0; n < m_pStateOutFeatures->m_numFeatures; n++)
-			m_minibatch_s[m_pStateOutFeatures->m_pFeatures[n].m_index + i*m_numberOfStateVars] = m_pStateOutFeatures->m_pFeatures[n].m_factor;
-	}
-	m_predictionQNetwork.getNetwork()->predict(inputMap, m_minibatch_Q_s);
+	return 1.0;
+}
 
-	for (int i = 0; i < m_experienceReplay->getMaxUpdateBatchSize(); i++)
-		m_minibatch_Q_s[m_pMinibatchActionId[i] + i*m_numberOfActions] = m_pMinibatchChosenActionTargetValues[i];
+/// <summary>
+/// Adds a tuple to the minibatch of an actor-learner. Once it is full, the gradient of the loss with the targets
+/// r + gamma * max_a' Q(s_p,a'; target-weights) is pushed to the shared parameters and the online network of the
+/// actor-learner is synchronized with them
+/// </summary>
+/// <param name="pActorLearner">The actor-learner</param>
+/// <param name="s">Initial state</param>
+/// <param name="a">Action</param>
+/// <param name="s_p">Resultant state</param>
+/// <param name="r">Reward</param>
+void AsyncQLearning::update(ActorLearner* pActorLearner, const State* s, const Action* a, const State* s_p, double r)
+{
+	DeepMinibatch* pMinibatch = pActorLearner->pMinibatch;
+	pMinibatch->addTuple(s, a, s_p, r);
 
-	//calculate the weights changes of the network finally
-	std::unordered_map<CNTK::Variable, CNTK::ValuePtr> gradients;
-	std::static_pointer_cast<Network>(m_predictionQNetwork.getNetwork())
-		->gradients(inputMap, m_minibatch_Q_s, gradients);
+	if (++m_numSteps % (size_t)std::max(1, m_targetUpdateSteps.get()) == 0)
+		m_parameterServer.updateTarget();
 
-	//aggregate the weights
-	for each (auto tuple in m_aggregatedGradients)
-	{
-		auto leftInput = CNTK::InputVariable(tuple.first.Shape(), CNTK::DataType::Float);
-		auto rightInput = CNTK::InputVariable(tuple.first.Shape(), CNTK::DataType::Float);
-		auto add = CNTK::Plus(leftInput, rightInput);
-		std::unordered_map<CNTK::Variable, CNTK::ValuePtr> inputMap = { { leftInput , tuple.second },{ rightInput,gradients[tuple.first] } };
-		std::unordered_map<CNTK::Variable, CNTK::ValuePtr> outputMap = { { add , tuple.second } };
-		add->Evaluate(inputMap, outputMap);
-	}
+	if (!pMinibatch->isFull())
+		return;
 
-	if (SimionApp::get()->pExperiment->getExperimentStep() % m_iTarget.get() == 0)
+	if (pActorLearner->targetVersion != m_parameterServer.getTargetVersion())
 	{
-		//update the target network
-		for (int i = 0; i < m_pTargetQNetwork->getNetworkFunctionPtr()->Parameters().size(); i++)
-		{
-			m_pTargetQNetwork->getNetworkFunctionPtr()->Parameters()[i].SetValue(m_predictionQNetwork.getNetwork()->getNetworkFunctionPtr()->Parameters()[i].Value());
-		}
+		pActorLearner->targetVersion = m_parameterServer.pullTargetParameters(pActorLearner->parameters.data());
+		pActorLearner->pTargetNetwork->setParameters(pActorLearner->parameters.data());
 	}
 
-	if (SimionApp::get()->pExperiment->getStep() % m_iAsyncUpdate.get() == 0 || SimionApp::get()->pExperiment->isLastStep())
-	{
-		//update prediction network using the aggregated gradients inside the buffer
-		m_predictionQNetwork.getNetwork()->getTrainer()->ParameterLearners()[0]->Update(m_aggregatedGradientValues, m_aggregatedGradientCount);
+	size_t numOutputs = m_pQFunction->getNumOutputs();
 
-		//reset the gradient buffer
-		for each (auto view in m_aggregatedGradientValues)
-		{
-			view.second->SetValue(0.0);
-		}
-	}
+	//only the target of the action taken is changed
+	for (size_t i = 0; i < pMinibatch->size(); i++)
+		pActorLearner->actionIndices[i] = pActorLearner->pPolicy->getActionIndex(pMinibatch->a(), (int)i);
+	pActorLearner->pTargetNetwork->evaluate(pMinibatch->s_p(), pActorLearner->Q_s_p);
+	pActorLearner->pOnlineNetwork->evaluate(pMinibatch->s(), pMinibatch->target());
+	DeepKernels::qLearningTargets(pMinibatch->size(), numOutputs, pActorLearner->Q_s_p.data(), pActorLearner->Q_s_p.data()
+		, pMinibatch->r().data(), pActorLearner->gamma, pActorLearner->actionIndices.data(), pMinibatch->target().data());
+
+	pActorLearner->pOnlineNetwork->computeGradient(pMinibatch, pMinibatch->target(), pActorLearner->gradient.data());
+	m_parameterServer.pushGradient(pActorLearner->gradient.data(), m_learningRate, pActorLearner->index);
+
+	m_parameterServer.pullParameters(pActorLearner->parameters.data());
+	pActorLearner->pOnlineNetwork->setParameters(pActorLearner->parameters.data());
+
+	pMinibatch->clear();
 }
-*/
 
-#endif
\ No newline at end of file
+#endif
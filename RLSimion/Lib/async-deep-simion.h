@@ -1,58 +1,123 @@
 #pragma once
-#ifdef _WIN64
+#if defined(__linux__) || defined(_WIN64)
 
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <memory>
 #include "simion.h"
 #include "parameters.h"
-#include "deep-vfa-policy.h"
+#include "deferred-load.h"
+#include "checkpoint.h"
+#include "deep-functions.h"
+#include "deep-parameter-server.h"
 
+class DiscreteDeepPolicy;
+class DynamicModel;
+class NativeDiscreteQFunctionNetwork;
+class DeepMinibatch;
+class ConfigNode;
+class World;
+class Experiment;
 
-class SingleDimensionDiscreteActionVariableGrid;
-class ExperienceReplay;
-class ExperienceTuple;
-/*
-class AsyncQLearning : public Simion
+class AsyncQLearning : public Simion, DeferredLoad, Checkpointable
 {
-protected:
-	ACTION_VARIABLE m_outputAction;
-	CHILD_OBJECT<ExperienceReplay> m_experienceReplay;
-	NN_DEFINITION m_predictionQNetwork;
-	
-	CHILD_OBJECT_FACTORY<DiscreteDeepPolicy> m_policy;
-	FeatureList* m_pStateOutFeatures;
-	SingleDimensionDiscreteActionVariableGrid* m_pGrid;
+	/*
+	Asynchronous Methods for Deep Reinforcement Learning (asynchronous one-step Q-learning)
+	Volodymyr Mnih, Adria Puigdomenech Badia, Mehdi Mirza, Alex Graves, Timothy P. Lillicrap, Tim Harley, David Silver,
+	Koray Kavukcuoglu
+	Proceedings of the 33rd International Conference on Machine Learning (ICML 2016)
+	*/
 
-	int m_numberOfActions;
-	int m_numberOfStateVars;
-	std::vector<double> m_stateVector;
-	std::vector<double> m_actionValuePredictionVector;
+	//Each actor-learner has its own copy of the online and target networks and accumulates Async-Update-Steps tuples
+	//before computing a gradient with them, which is pushed to the shared parameters. The actor-learner of the main thread
+	//learns from the tuples of the experiment, the rest simulate episodes with their own copy of the dynamic model in a
+	//background thread
+	struct ActorLearner
+	{
+		size_t index = 0;
+		NativeDiscreteQFunctionNetwork* pOnlineNetwork = nullptr;
+		NativeDiscreteQFunctionNetwork* pTargetNetwork = nullptr;
+		size_t targetVersion = 0;
+		DeepMinibatch* pMinibatch = nullptr;
+		vector<double> Q_s_p;
+		vector<size_t> actionIndices;
+		vector<double> gradient;
+		vector<double> parameters;
+		std::shared_ptr<DiscreteDeepPolicy> pPolicy;
+		//copied when the threads are started, so that the actor-learners don't need SimionApp::get() to learn
+		double gamma = 0.0;
 
-	std::vector<double> m_minibatch_s;
-	std::vector<double> m_minibatch_Q_s;
+		//only used by the actor-learners with their own thread
+		World* pWorld = nullptr;
+		Experiment* pExperiment = nullptr;
+		std::shared_ptr<DynamicModel> pDynamicModel;
+		State* s = nullptr;
+		Action* a = nullptr;
+		State* s_p = nullptr;
+		std::thread thread;
+	};
 
-	int* m_pMinibatchActionId;
+	CHILD_OBJECT<DeepDiscreteQFunction> m_pQFunction;
+	CHILD_OBJECT_FACTORY<DiscreteDeepPolicy> m_policy;
+	INT_PARAM m_numActorLearners;
+	INT_PARAM m_asyncUpdateSteps;
+	INT_PARAM m_targetUpdateSteps;
+	INT_PARAM m_numParameterShards;
+	//used to create the policies of the background actor-learners
+	ConfigNode* m_pConfigNode = nullptr;
 
-	ExperienceTuple** m_pMinibatchExperienceTuples;
-	double* m_pMinibatchChosenActionTargetValues;
-	
-	INT_PARAM m_iTarget;
-	INT_PARAM m_iAsyncUpdate;
+	DeepParameterServer m_parameterServer;
+	//the first one is the actor-learner of the main thread
+	vector<ActorLearner*> m_actorLearners;
+	//steps done by all the actor-learners, used to update the target parameters
+	std::atomic<size_t> m_numSteps;
 
-	INetwork* m_pTargetQNetwork;
+	//the value of the learning rate schedule, evaluated by the main thread on every update
+	std::atomic<double> m_learningRate;
 
-	unsigned int m_aggregatedGradientCount;
-	std::unordered_map<CNTK::Parameter, CNTK::NDArrayViewPtr> m_aggregatedGradientValues;
-	std::unordered_map<CNTK::Parameter, CNTK::ValuePtr> m_aggregatedGradients;
+	//the background actor-learners only simulate episodes during training episodes: they are paused at the end of every
+	//training episode, resumed by the first update of the next one and stopped after the last one
+	bool m_bActorLearnerThreadsStarted = false;
+	std::atomic<bool> m_bExit;
+	std::atomic<bool> m_bRunActorLearners;
+	std::mutex m_runMutex;
+	std::condition_variable m_runCondition;
+	//paused or finished background actor-learners
+	size_t m_numIdleActorLearners = 0;
+	std::mutex m_exceptionMutex;
+	std::exception_ptr m_actorLearnerException;
 
+	ActorLearner* createActorLearner(size_t index, std::shared_ptr<DiscreteDeepPolicy> pPolicy);
+	void startActorLearnerThreads();
+	void pauseActorLearnerThreads();
+	void resumeActorLearnerThreads();
+	void stopActorLearnerThreads();
+	bool waitUntilResumed();
+	void actorLearnerLoop(ActorLearner* pActorLearner);
+	void update(ActorLearner* pActorLearner, const State* s, const Action* a, const State* s_p, double r);
 public:
-	AsyncQLearning(ConfigNode *pParameters);
+	AsyncQLearning(ConfigNode* pConfigNode);
 	~AsyncQLearning();
 
-	//selects an according to the selected policy and the prediction of the Q network
+	virtual void deferredLoadStep();
+
+	//the shared parameters are saved in checkpoints. Loaded checkpoints are copied to the networks of every actor-learner
+	virtual void saveCheckpoint(CheckpointWriter& writer);
+	virtual void loadCheckpoint(const CheckpointReader& reader);
+
+	//selects an action with the policy and the network of the main thread
 	virtual double selectAction(const State *s, Action *a);
 
-	//updates the target network and sometimes the prediction network
+	//updates the shared parameters with the tuples of the experiment
 	virtual double update(const State *s, const Action *a, const State *s_p, double r, double behaviorProb);
-};*/
-#endif
 
+	//the background actor-learners are paused during evaluation episodes and stopped once the experiment ends
+	virtual void onTrainingEpisodeEnd();
+	virtual void onExperimentEnd();
+};
+
+#endif
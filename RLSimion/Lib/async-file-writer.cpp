@@ -0,0 +1,186 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "async-file-writer.h"
+#include "../../tools/System/CrossPlatform.h"
+#include <string.h>
+#include <algorithm>
+
+AsyncFileWriter::AsyncFileWriter(size_t blockSize, size_t numBlocks)
+{
+	m_blockSize = blockSize;
+	m_blocks = std::vector<Block>(std::max((size_t)2, numBlocks));
+	m_head = 0;
+	m_tail = 0;
+	m_bWriteError = false;
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+	close();
+}
+
+bool AsyncFileWriter::open(const char* filename, LogOverflowPolicy overflowPolicy)
+{
+	close();
+
+	CrossPlatform::Fopen_s(&m_pFile, filename, "wb");
+	if (!m_pFile)
+		return false;
+	//blocks are big enough: we don't want the C runtime copying them again to its own buffer
+	setvbuf(m_pFile, nullptr, _IONBF, 0);
+
+	m_overflowPolicy = overflowPolicy;
+	for (Block& block : m_blocks)
+	{
+		block.data.resize(m_blockSize);
+		block.size = 0;
+	}
+	m_head = 0;
+	m_tail = 0;
+	m_bExit = false;
+	m_bWriteError = false;
+	m_numBytesWritten = 0;
+	m_numDroppedRecords = 0;
+
+	m_writerThread = std::thread(&AsyncFileWriter::writerLoop, this);
+	return true;
+}
+
+void AsyncFileWriter::close()
+{
+	if (!m_pFile)
+		return;
+
+	flush();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_blockReady.notify_one();
+	m_writerThread.join();
+
+	fclose(m_pFile);
+	m_pFile = nullptr;
+}
+
+bool AsyncFileWriter::ownsCurrentBlock() const
+{
+	return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire) < m_blocks.size();
+}
+
+size_t AsyncFileWriter::getFreeSpace() const
+{
+	size_t head = m_head.load(std::memory_order_relaxed);
+	size_t numPendingBlocks = head - m_tail.load(std::memory_order_acquire);
+	if (numPendingBlocks >= m_blocks.size())
+		return 0;
+	return (m_blockSize - m_blocks[head % m_blocks.size()].size) + (m_blocks.size() - numPendingBlocks - 1) * m_blockSize;
+}
+
+void AsyncFileWriter::publishCurrentBlock()
+{
+	m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	//the writer thread checks m_head with the mutex locked before waiting, so locking it here makes
+	//sure the notification isn't lost
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+	}
+	m_blockReady.notify_one();
+}
+
+void AsyncFileWriter::waitForFreeBlock()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_blockWritten.wait(lock, [this] { return ownsCurrentBlock(); });
+}
+
+bool AsyncFileWriter::write(const void* pBuffer, size_t numBytes, bool bCanBeDropped)
+{
+	if (!m_pFile)
+		return false;
+
+	if (bCanBeDropped && m_overflowPolicy == LogOverflowPolicy::drop && numBytes > getFreeSpace())
+	{
+		m_numDroppedRecords++;
+		return false;
+	}
+
+	const char* pData = (const char*)pBuffer;
+	while (numBytes > 0)
+	{
+		if (!ownsCurrentBlock())
+			waitForFreeBlock();
+
+		Block& block = m_blocks[m_head.load(std::memory_order_relaxed) % m_blocks.size()];
+		size_t numBytesCopied = std::min(numBytes, m_blockSize - block.size);
+		memcpy(&block.data[block.size], pData, numBytesCopied);
+		block.size += numBytesCopied;
+		pData += numBytesCopied;
+		numBytes -= numBytesCopied;
+		m_numBytesWritten += numBytesCopied;
+
+		if (block.size == m_blockSize)
+			publishCurrentBlock();
+	}
+	return true;
+}
+
+void AsyncFileWriter::flush()
+{
+	if (!m_pFile || !ownsCurrentBlock())
+		return;
+	if (m_blocks[m_head.load(std::memory_order_relaxed) % m_blocks.size()].size > 0)
+		publishCurrentBlock();
+}
+
+void AsyncFileWriter::writerLoop()
+{
+	size_t tail = m_tail.load();
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_blockReady.wait(lock, [&] { return m_bExit || m_head.load(std::memory_order_acquire) != tail; });
+			if (m_bExit && m_head.load(std::memory_order_acquire) == tail)
+				return;
+		}
+
+		while (m_head.load(std::memory_order_acquire) != tail)
+		{
+			Block& block = m_blocks[tail % m_blocks.size()];
+			if (fwrite(block.data.data(), 1, block.size, m_pFile) != block.size)
+				m_bWriteError = true;
+			block.size = 0;
+
+			tail++;
+			m_tail.store(tail, std::memory_order_release);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+			}
+			m_blockWritten.notify_all();
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stdio.h>
+
+enum class LogOverflowPolicy { backPressure, drop };
+
+//Writes a file from a background thread so that the caller only pays for a memcpy. Data is copied
+//into a ring of fixed-size blocks: once a block is full it is handed to the writer thread, which
+//writes it with a single unbuffered fwrite call. Only the producer moves the head of the ring and
+//only the writer thread moves the tail, so no locks are taken while copying. The mutex is only used
+//to wake up the other thread, once per block.
+//If the writer thread falls behind and the ring is full, writes marked as droppable are either
+//discarded as a whole (LogOverflowPolicy::drop) or the caller waits until there is enough free
+//space (LogOverflowPolicy::backPressure). Writes that are not droppable always wait
+class AsyncFileWriter
+{
+	struct Block
+	{
+		std::vector<char> data;
+		size_t size = 0;
+	};
+
+	FILE* m_pFile = nullptr;
+	LogOverflowPolicy m_overflowPolicy = LogOverflowPolicy::backPressure;
+
+	size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	//number of blocks handed to the writer thread (head) and number of blocks written (tail). The
+	//producer fills the block m_head % numBlocks, as long as it hasn't been handed over yet
+	std::atomic<size_t> m_head;
+	std::atomic<size_t> m_tail;
+
+	std::thread m_writerThread;
+	std::mutex m_mutex;
+	std::condition_variable m_blockReady;
+	std::condition_variable m_blockWritten;
+	bool m_bExit = false;
+
+	size_t m_numBytesWritten = 0;
+	size_t m_numDroppedRecords = 0;
+	std::atomic<bool> m_bWriteError;
+
+	bool ownsCurrentBlock() const;
+	size_t getFreeSpace() const;
+	void publishCurrentBlock();
+	void waitForFreeBlock();
+	void writerLoop();
+public:
+	AsyncFileWriter(size_t blockSize = 256 * 1024, size_t numBlocks = 16);
+	virtual ~AsyncFileWriter();
+
+	bool open(const char* filename, LogOverflowPolicy overflowPolicy = LogOverflowPolicy::backPressure);
+	bool isOpen() const { return m_pFile != nullptr; }
+
+	//Copies the buffer to the ring. Returns false if it was dropped (only if bCanBeDropped is true and
+	//the overflow policy is drop) or the file isn't open. The buffer is either written as a whole or not
+	//at all, so records that can be dropped must be written in a single call
+	bool write(const void* pBuffer, size_t numBytes, bool bCanBeDropped = false);
+
+	//Hands the partially filled block to the writer thread without waiting for it to be written
+	void flush();
+	//Writes everything pending, stops the writer thread and closes the file
+	void close();
+
+	//bytes accepted by write() so far, which is the offset in the file at which the next write will begin
+	size_t getNumBytesWritten() const { return m_numBytesWritten; }
+	size_t getNumDroppedRecords() const { return m_numDroppedRecords; }
+	bool hasWriteErrors() const { return m_bWriteError.load(); }
+};
@@ -0,0 +1,189 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "async-message-sender.h"
+#include "../../tools/System/NamedPipe.h"
+
+/// <summary>
+/// Constructor
+/// </summary>
+/// <param name="maxNumQueuedMessages">Number of messages queued before messages start being dropped (or the caller waits)</param>
+AsyncMessageSender::AsyncMessageSender(size_t maxNumQueuedMessages)
+{
+	m_maxNumQueuedMessages = maxNumQueuedMessages;
+}
+
+AsyncMessageSender::~AsyncMessageSender()
+{
+	close();
+}
+
+/// <summary>
+/// Starts sending messages through the pipe. The pipe must be connected and must not be written by anyone else until
+/// close() is called. Does nothing if the sender is already open, or if it was closed
+/// </summary>
+void AsyncMessageSender::open(NamedPipe* pPipe)
+{
+	lock_guard<mutex> lock(m_mutex);
+	if (m_bClosed || m_senderThread.joinable())
+		return;
+
+	m_pPipe = pPipe;
+	m_senderThread = thread(&AsyncMessageSender::senderLoop, this);
+}
+
+bool AsyncMessageSender::isClosed()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_bClosed;
+}
+
+void AsyncMessageSender::setOverflowPolicy(LogOverflowPolicy policy)
+{
+	lock_guard<mutex> lock(m_mutex);
+	m_overflowPolicy = policy;
+}
+
+/// <summary>
+/// Queues a progress message. If the previous one hasn't been sent yet, it is removed: only the latest progress is of
+/// interest, and it must not be sent before the messages queued after the previous one
+/// </summary>
+void AsyncMessageSender::sendProgress(const char* message)
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		if (m_bClosed)
+			return;
+		if (m_bProgressPending)
+			m_queue.erase(m_queue.begin() + m_progressIndex);
+		m_progressIndex = m_queue.size();
+		m_queue.push_back(message);
+		m_bProgressPending = true;
+	}
+	m_messageQueued.notify_one();
+}
+
+/// <summary>
+/// Queues a message. Only messages that can be dropped are affected by the overflow policy
+/// </summary>
+/// <param name="message">The message</param>
+/// <param name="bCanBeDropped">Whether the message can be dropped if the queue is full</param>
+/// <returns>False if the message was dropped or the sender is closed</returns>
+bool AsyncMessageSender::send(const char* message, bool bCanBeDropped)
+{
+	{
+		unique_lock<mutex> lock(m_mutex);
+		if (m_bClosed)
+			return false;
+		if (bCanBeDropped && getNumQueuedMessages() >= m_maxNumQueuedMessages)
+		{
+			if (m_overflowPolicy == LogOverflowPolicy::drop)
+			{
+				m_numDroppedMessages++;
+				return false;
+			}
+			m_messagesSent.wait(lock, [this] { return getNumQueuedMessages() < m_maxNumQueuedMessages; });
+		}
+		m_queue.push_back(message);
+	}
+	m_messageQueued.notify_one();
+	return true;
+}
+
+/// <summary>
+/// Waits until every message queued so far (and the pending progress message) has been written to the pipe
+/// </summary>
+void AsyncMessageSender::flush()
+{
+	unique_lock<mutex> lock(m_mutex);
+	if (!m_senderThread.joinable())
+		return;
+	m_messagesSent.wait(lock, [this] { return m_queue.empty() && m_numMessagesBeingSent == 0; });
+}
+
+/// <summary>
+/// Sends the messages queued and stops the sender thread. Messages sent afterwards are discarded, and the sender can't be
+/// opened again (i.e., by a message logged while the app is being destroyed)
+/// </summary>
+void AsyncMessageSender::close()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_bClosed = true;
+	}
+	if (!m_senderThread.joinable())
+		return;
+
+	flush();
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_messageQueued.notify_one();
+	m_senderThread.join();
+	m_pPipe = nullptr;
+}
+
+size_t AsyncMessageSender::getNumDroppedMessages()
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_numDroppedMessages;
+}
+
+void AsyncMessageSender::writeMessage(const string& message)
+{
+	m_pPipe->writeBuffer(message.c_str(), (int)message.size() + 1);
+}
+
+/// <summary>
+/// Takes all the messages queued at once and writes them in order without holding the lock, so that the control loop can
+/// keep queueing messages while the pipe is being written
+/// </summary>
+void AsyncMessageSender::senderLoop()
+{
+	deque<string> messages;
+	unique_lock<mutex> lock(m_mutex);
+	while (true)
+	{
+		m_messageQueued.wait(lock, [this] { return m_bExit || !m_queue.empty(); });
+		if (m_queue.empty())
+			return; //m_bExit is set and there is nothing left to send
+
+		messages.swap(m_queue);
+		m_bProgressPending = false;
+		m_numMessagesBeingSent = messages.size();
+		lock.unlock();
+		//there's room in the queue again
+		m_messagesSent.notify_all();
+
+		for (const string& message : messages)
+			writeMessage(message);
+		messages.clear();
+
+		lock.lock();
+		m_numMessagesBeingSent = 0;
+		m_messagesSent.notify_all();
+	}
+}
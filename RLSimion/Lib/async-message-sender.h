@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "async-file-writer.h" //LogOverflowPolicy enum type is defined there
+using namespace std;
+
+class NamedPipe;
+
+//Sends messages through a named pipe (i.e., to the Herd agent) from a background thread, so that the control loop
+//doesn't wait for the other end to read them. Messages are sent in the same order they were queued. Progress messages
+//are coalesced: a new one replaces the one that hasn't been sent yet and takes its place at the end of the queue. The
+//rest are queued in a bounded queue. If the queue is full, messages that can be dropped (i.e., info messages) are either
+//discarded (LogOverflowPolicy::drop) or the caller waits until there is room for them (LogOverflowPolicy::backPressure).
+//Messages that can't be dropped (warnings, errors, evaluations) are always queued. Once closed, the sender can't be
+//opened again and new messages are discarded
+class AsyncMessageSender
+{
+	NamedPipe* m_pPipe = nullptr;
+	LogOverflowPolicy m_overflowPolicy = LogOverflowPolicy::drop;
+	size_t m_maxNumQueuedMessages;
+
+	deque<string> m_queue;
+	//position in m_queue of the progress message that hasn't been sent yet
+	size_t m_progressIndex = 0;
+	bool m_bProgressPending = false;
+	size_t m_numMessagesBeingSent = 0;
+	size_t m_numDroppedMessages = 0;
+
+	thread m_senderThread;
+	mutex m_mutex;
+	condition_variable m_messageQueued;
+	condition_variable m_messagesSent;
+	bool m_bExit = false;
+	bool m_bClosed = false;
+
+	void senderLoop();
+	//progress messages don't count for the limit of the queue
+	size_t getNumQueuedMessages() const { return m_queue.size() - (m_bProgressPending ? 1 : 0); }
+protected:
+	//called from the sender thread
+	virtual void writeMessage(const string& message);
+public:
+	AsyncMessageSender(size_t maxNumQueuedMessages = 256);
+	virtual ~AsyncMessageSender();
+
+	//starts the sender thread, unless it is already running or the sender was closed. Messages are written to the pipe
+	//(each one followed by a '\0')
+	void open(NamedPipe* pPipe);
+	bool isClosed();
+	void setOverflowPolicy(LogOverflowPolicy policy);
+
+	//replaces the progress message waiting to be sent, if any
+	void sendProgress(const char* message);
+	//queues a message. Returns false if it was dropped
+	bool send(const char* message, bool bCanBeDropped);
+
+	//waits until all the messages queued have been sent
+	void flush();
+	//sends everything pending and stops the sender thread for good. The pipe isn't closed
+	void close();
+
+	size_t getNumDroppedMessages();
+};
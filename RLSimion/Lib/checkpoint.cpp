@@ -0,0 +1,200 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "checkpoint.h"
+#include "simgod.h"
+#include "../../tools/System/CrossPlatform.h"
+#include <string.h>
+#ifdef _WIN32
+#include <process.h>
+#define getProcessId _getpid
+#else
+#include <unistd.h>
+#define getProcessId getpid
+#endif
+
+namespace
+{
+	const char checkpointMagic[8] = { 'S','I','M','C','K','P','T','1' };
+	const size_t headerSize = 16;
+
+	size_t paddedLength(size_t length) { return (length + 7) / 8 * 8; }
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+	if (m_pFile)
+	{
+		//not closed: the temporary file is discarded
+		fclose(m_pFile);
+		remove(m_tempFilename.c_str());
+	}
+}
+
+/// <summary>
+/// Creates the temporary file the checkpoint is written to and writes the header. The name of the temporary file includes
+/// the id of the process, so that processes writing the same checkpoint (i.e., the initial weights of a network shared by
+/// the experiments of a sweep) don't write to the same file
+/// </summary>
+/// <param name="filename">Name of the checkpoint</param>
+/// <returns>False if the file couldn't be created</returns>
+bool CheckpointWriter::open(const string& filename)
+{
+	m_filename = filename;
+	m_numEntries = 0;
+	m_bError = false;
+	m_tempFilename = filename + ".tmp-" + std::to_string(getProcessId());
+	CrossPlatform::Fopen_s(&m_pFile, m_tempFilename.c_str(), "wb");
+	if (!m_pFile)
+		return false;
+	fwrite(checkpointMagic, 1, sizeof(checkpointMagic), m_pFile);
+	fwrite(&m_numEntries, sizeof(m_numEntries), 1, m_pFile);
+	return true;
+}
+
+void CheckpointWriter::add(const string& name, const double* pValues, size_t numValues)
+{
+	if (!m_pFile)
+		return;
+	string fullName = m_prefix + name;
+	unsigned long long nameLength = fullName.size();
+	unsigned long long numValues64 = numValues;
+	const char padding[8] = {};
+
+	bool bOk = fwrite(&nameLength, sizeof(nameLength), 1, m_pFile) == 1
+		&& fwrite(fullName.data(), 1, fullName.size(), m_pFile) == fullName.size()
+		&& fwrite(padding, 1, paddedLength(fullName.size()) - fullName.size(), m_pFile) == paddedLength(fullName.size()) - fullName.size()
+		&& fwrite(&numValues64, sizeof(numValues64), 1, m_pFile) == 1
+		&& (numValues == 0 || fwrite(pValues, sizeof(double), numValues, m_pFile) == numValues);
+	if (!bOk)
+		m_bError = true;
+	m_numEntries++;
+}
+
+/// <summary>
+/// Writes the number of entries in the header and replaces the checkpoint with the temporary file
+/// </summary>
+/// <returns>False if any write failed. In that case, the previous checkpoint (if any) is kept</returns>
+bool CheckpointWriter::close()
+{
+	if (!m_pFile)
+		return false;
+	bool bOk = !m_bError && fseek(m_pFile, sizeof(checkpointMagic), SEEK_SET) == 0
+		&& fwrite(&m_numEntries, sizeof(m_numEntries), 1, m_pFile) == 1;
+	bOk = (fclose(m_pFile) == 0) && bOk;
+	m_pFile = nullptr;
+
+	if (bOk)
+		bOk = CrossPlatform::RenameReplacing(m_tempFilename.c_str(), m_filename.c_str());
+	if (!bOk)
+		remove(m_tempFilename.c_str());
+	return bOk;
+}
+
+/// <summary>
+/// Maps the checkpoint in memory and indexes its entries
+/// </summary>
+/// <param name="filename">Name of the checkpoint</param>
+/// <returns>False if the file couldn't be read or it isn't a valid checkpoint</returns>
+bool CheckpointReader::open(const string& filename)
+{
+	m_entries.clear();
+	if (!m_file.open(filename.c_str()))
+		return false;
+
+	const char* pData = m_file.getData();
+	const size_t size = m_file.getSize();
+	unsigned long long numEntries;
+	if (size < headerSize || memcmp(pData, checkpointMagic, sizeof(checkpointMagic)) != 0)
+	{
+		m_file.close();
+		return false;
+	}
+	memcpy(&numEntries, pData + sizeof(checkpointMagic), sizeof(numEntries));
+
+	size_t offset = headerSize;
+	for (unsigned long long i = 0; i < numEntries; i++)
+	{
+		unsigned long long nameLength, numValues;
+		if (offset + sizeof(nameLength) > size)
+			break;
+		memcpy(&nameLength, pData + offset, sizeof(nameLength));
+		offset += sizeof(nameLength);
+		if (nameLength > size - offset || paddedLength((size_t)nameLength) + sizeof(numValues) > size - offset)
+			break;
+		string name(pData + offset, (size_t)nameLength);
+		offset += paddedLength((size_t)nameLength);
+		memcpy(&numValues, pData + offset, sizeof(numValues));
+		offset += sizeof(numValues);
+		if (numValues > (size - offset) / sizeof(double))
+			break;
+		m_entries[name] = { (const double*)(pData + offset), (size_t)numValues };
+		offset += (size_t)numValues * sizeof(double);
+	}
+	if (m_entries.size() != numEntries)
+	{
+		//truncated or corrupted
+		m_entries.clear();
+		m_file.close();
+		return false;
+	}
+	return true;
+}
+
+const double* CheckpointReader::get(const string& name, size_t& numValues) const
+{
+	auto it = m_entries.find(m_prefix + name);
+	if (it == m_entries.end())
+	{
+		numValues = 0;
+		return nullptr;
+	}
+	numValues = it->second.numValues;
+	return it->second.pValues;
+}
+
+bool CheckpointReader::read(const string& name, double* pOutput, size_t numValues) const
+{
+	size_t numEntryValues;
+	const double* pValues = get(name, numEntryValues);
+	if (!pValues || numEntryValues != numValues)
+		return false;
+	if (numValues > 0)
+		memcpy(pOutput, pValues, numValues * sizeof(double));
+	return true;
+}
+
+/// <summary>
+/// Registers the object in the SimGod so that it is saved and loaded with the checkpoints of the experiment
+/// </summary>
+Checkpointable::Checkpointable()
+{
+	SimGod::registerCheckpointable(this);
+}
+
+Checkpointable::~Checkpointable()
+{
+	SimGod::unregisterCheckpointable(this);
+}
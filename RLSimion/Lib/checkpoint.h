@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../../tools/System/MemoryMappedFile.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+//Checkpoints are binary files with named arrays of doubles (i.e., the parameters of a network or the state of its learner).
+//Every entry is: the length of the name (uint64), the name padded with zeros to a multiple of 8 bytes, the number of values
+//(uint64) and the values, so that values are always 8-byte aligned and can be used directly from the mapped file.
+//The file starts with "SIMCKPT1" and the number of entries (uint64)
+
+//Writes a checkpoint entry by entry. The file is written with a temporary name and renamed when it is closed, so an
+//interrupted write never replaces the last complete checkpoint
+class CheckpointWriter
+{
+	FILE* m_pFile = nullptr;
+	string m_filename;
+	string m_tempFilename;
+	string m_prefix;
+	unsigned long long m_numEntries = 0;
+	bool m_bError = false;
+public:
+	CheckpointWriter() = default;
+	virtual ~CheckpointWriter();
+
+	bool open(const string& filename);
+	//writes the number of entries and renames the file. Returns false if anything went wrong
+	bool close();
+
+	//prepended to the names of the entries added from now on
+	void setPrefix(const string& prefix) { m_prefix = prefix; }
+
+	void add(const string& name, const double* pValues, size_t numValues);
+	void add(const string& name, const vector<double>& values) { add(name, values.data(), values.size()); }
+};
+
+//Reads a checkpoint mapped in memory. Entries are indexed when the file is opened and their values aren't copied
+class CheckpointReader
+{
+	MemoryMappedFile m_file;
+	string m_prefix;
+	struct Entry
+	{
+		const double* pValues;
+		size_t numValues;
+	};
+	unordered_map<string, Entry> m_entries;
+public:
+	CheckpointReader() = default;
+
+	//returns false if the file can't be read or it isn't a valid checkpoint
+	bool open(const string& filename);
+	bool isOpen() const { return m_file.isOpen(); }
+	size_t getNumEntries() const { return m_entries.size(); }
+
+	//prepended to the names of the entries read from now on
+	void setPrefix(const string& prefix) { m_prefix = prefix; }
+
+	//the values of an entry in the mapped file (valid while the reader is open), or nullptr if there is no such entry
+	const double* get(const string& name, size_t& numValues) const;
+	//copies the values of an entry. Returns false if there is no such entry or it doesn't have numValues values
+	bool read(const string& name, double* pOutput, size_t numValues) const;
+	bool read(const string& name, vector<double>& output) const { return read(name, output.data(), output.size()); }
+};
+
+//Objects with learned parameters that are saved in checkpoints and restored when an experiment is warm-started. Just by
+//deriving from this class, objects register themselves in the SimGod (as DeferredLoad objects do) and are identified by
+//the order in which they were created, which is the same in every run of the same experiment
+class Checkpointable
+{
+public:
+	Checkpointable();
+	virtual ~Checkpointable();
+
+	//the names of the entries are prefixed by the caller with the identifier of the object
+	virtual void saveCheckpoint(CheckpointWriter& writer) = 0;
+	virtual void loadCheckpoint(const CheckpointReader& reader) = 0;
+};
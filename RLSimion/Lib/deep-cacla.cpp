@@ -13,13 +13,15 @@
 #include "app.h"
 #include "simion.h"
 #include "experiment.h"
+#include "logger.h"
 
 DeepCACLA::DeepCACLA(ConfigNode* pConfigNode)
 {
 	m_actorPolicy = CHILD_OBJECT<DeepDeterministicPolicy>(pConfigNode, "Policy", "Neural Network used to represent the actors policy");
 	m_noiseSignals = MULTI_VALUE_FACTORY<Noise>(pConfigNode, "Exploration-Noise", "Noise signals added to each of the outputs of the deterministic policy");
 	m_criticVFunction= CHILD_OBJECT<DeepVFunction>(pConfigNode, "Value-Function", "Value function learned by the critic");
-	CNTK::WrapperLoader::SetRequirements();
+	if (usesCntk())
+		CNTK::WrapperLoader::SetRequirements();
 }
 
 
@@ -32,13 +34,20 @@ DeepCACLA::~DeepCACLA()
 	if (m_pCriticOnlineNetwork) m_pCriticOnlineNetwork->destroy();
 	if (m_pCriticTargetNetwork) m_pCriticTargetNetwork->destroy();
 
-	CNTK::WrapperLoader::UnLoad();
+	if (usesCntk())
+		CNTK::WrapperLoader::UnLoad();
+}
+
+bool DeepCACLA::usesCntk()
+{
+	return m_actorPolicy->usesCntk() || m_criticVFunction->usesCntk();
 }
 
 
 void DeepCACLA::deferredLoadStep()
 {
-	CNTK::WrapperLoader::Load();
+	if (usesCntk())
+		CNTK::WrapperLoader::Load();
 
 	//Initialize the actor
 	m_pActorMinibatch = m_actorPolicy->getMinibatch();
@@ -55,6 +64,28 @@ void DeepCACLA::deferredLoadStep()
 	m_V_s = vector<double>(m_pCriticMinibatch->size());
 }
 
+/// <summary>
+/// Saves the actor and the online and target networks of the critic (with the state of their learners) to a checkpoint
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void DeepCACLA::saveCheckpoint(CheckpointWriter& writer)
+{
+	if (!m_pActorNetwork->saveCheckpoint(writer, "Actor") || !m_pCriticOnlineNetwork->saveCheckpoint(writer, "Critic-Online")
+		|| !m_pCriticTargetNetwork->saveCheckpoint(writer, "Critic-Target"))
+		Logger::logMessage(MessageType::Warning, "DeepCACLA: only native networks can be saved in checkpoints");
+}
+
+/// <summary>
+/// Restores the networks of the actor and the critic from a checkpoint
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+void DeepCACLA::loadCheckpoint(const CheckpointReader& reader)
+{
+	if (!m_pActorNetwork->loadCheckpoint(reader, "Actor") || !m_pCriticOnlineNetwork->loadCheckpoint(reader, "Critic-Online")
+		|| !m_pCriticTargetNetwork->loadCheckpoint(reader, "Critic-Target"))
+		Logger::logMessage(MessageType::Warning, "DeepCACLA: the networks couldn't be loaded from the checkpoint");
+}
+
 double DeepCACLA::update(const State *s, const Action *a, const State *s_p, double r, double probability)
 {
 	static int numCriticUpdates = 0;
@@ -107,11 +138,7 @@ double DeepCACLA::update(const State *s, const Action *a, const State *s_p, doub
 	SimGod* pSimGod = SimionApp::get()->pSimGod.ptr();
 
 	if (numCriticUpdates % 50 == 0 && pSimGod->bUpdateFrozenWeightsNow())
-	{
-		if (m_pCriticTargetNetwork)
-			m_pCriticTargetNetwork->destroy();
-		m_pCriticTargetNetwork = (IVFunctionNetwork*)m_pCriticOnlineNetwork->clone();
-	}
+		m_pCriticTargetNetwork->softUpdate(m_pCriticOnlineNetwork, 1.0);
 	return 0.0;
 }
 
@@ -3,6 +3,7 @@
 #include "simion.h"
 #include "parameters-numeric.h"
 #include "deferred-load.h"
+#include "checkpoint.h"
 
 #include <vector>
 using namespace std;
@@ -16,7 +17,7 @@ class Noise;
 class DeepMinibatch;
 
 
-class DeepCACLA : public Simion, DeferredLoad
+class DeepCACLA : public Simion, DeferredLoad, Checkpointable
 {
 	//Actor
 	DeepMinibatch* m_pActorMinibatch= nullptr;
@@ -30,6 +31,9 @@ class DeepCACLA : public Simion, DeferredLoad
 	CHILD_OBJECT<DeepVFunction> m_criticVFunction;
 	vector<double> m_V_s_p;
 	vector<double> m_V_s;
+
+	//true if either network is implemented with CNTK
+	bool usesCntk();
 public:
 	DeepCACLA(ConfigNode* pConfigNode);
 	virtual ~DeepCACLA();
@@ -39,6 +43,10 @@ public:
 	virtual double selectAction(const State *s, Action *a);
 
 	void deferredLoadStep();
+
+	//only the native networks can be saved in checkpoints
+	virtual void saveCheckpoint(CheckpointWriter& writer);
+	virtual void loadCheckpoint(const CheckpointReader& reader);
 };
 
 #endif
\ No newline at end of file
@@ -64,6 +64,7 @@ void DiscreteDeepPolicy::initialize(DeepDiscreteQFunction* pQFunctionDefinition)
 	m_stateVector = vector<double>(pQFunctionDefinition->getInputStateVariables().size());
 	m_argMaxAction = vector<double>(pQFunctionDefinition->getNumOutputActions());
 	m_outputActionVariables = pQFunctionDefinition->getUsedActionVariables();
+	m_stateNormalizer = NamedVarSetNormalizer(pQFunctionDefinition->getInputStateVariables());
 
 	//We use normalized values, but if we are using a sample file, the range of each variable may be different
 	//We store the discretized values for each action in a single vector: [a0_0, a0_1...a0_n, a1_0, a1_1, ...]
@@ -141,7 +142,18 @@ void DiscreteDeepPolicy::greedyActionSelection(IDiscreteQFunctionNetwork* pNetwo
 {
 	vector<double>& qValues = pNetwork->evaluate(s, a);
 
-	size_t maxQActionIndex= std::distance(qValues.begin(), std::max_element(qValues.begin(), qValues.end()));
+	greedyActionSelection(qValues.data(), qValues.size(), a);
+}
+
+/// <summary>
+/// Sets the discrete action with the highest Q-value
+/// </summary>
+/// <param name="pQValues">Q-values of all the discrete actions</param>
+/// <param name="numQValues">Number of discrete actions</param>
+/// <param name="a">Output action</param>
+void DiscreteDeepPolicy::greedyActionSelection(const double* pQValues, size_t numQValues, Action* a)
+{
+	size_t maxQActionIndex= std::distance(pQValues, std::max_element(pQValues, pQValues + numQValues));
 
 	size_t actionVarIndex;
 
@@ -170,6 +182,27 @@ void DiscreteDeepPolicy::randomActionSelection(IDiscreteQFunctionNetwork* pNetwo
 }
 
 
+/// <summary>
+/// Evaluates the network once with the states of all the environments. The Q-values are left in m_batchQValues
+/// </summary>
+/// <param name="pNetwork">Network used to represent Q(s,a)</param>
+/// <param name="s">The state of each environment</param>
+void DiscreteDeepPolicy::evaluateBatch(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s)
+{
+	size_t numStateVariables = m_stateVector.size();
+	m_batchStates.resize(s.size() * numStateVariables);
+	m_batchQValues.resize(s.size() * pNetwork->getNumOutputs());
+	for (size_t i = 0; i < s.size(); i++)
+		m_stateNormalizer.normalize(s[i], &m_batchStates[i * numStateVariables]);
+	pNetwork->evaluate(m_batchStates, m_batchQValues);
+}
+
+void DiscreteDeepPolicy::selectActions(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s, const vector<Action*>& a)
+{
+	for (size_t i = 0; i < s.size(); i++)
+		selectAction(pNetwork, s[i], a[i]);
+}
+
 DiscreteEpsilonGreedyDeepPolicy::DiscreteEpsilonGreedyDeepPolicy(ConfigNode * pConfigNode) : DiscreteDeepPolicy(pConfigNode)
 {
 	m_epsilon = CHILD_OBJECT_FACTORY<NumericValue>(pConfigNode, "epsilon", "Epsilon");
@@ -203,6 +236,29 @@ void DiscreteEpsilonGreedyDeepPolicy::selectAction(IDiscreteQFunctionNetwork* pN
 		greedyActionSelection(pNetwork, s, a);
 }
 
+/// <summary>
+/// Epsilon-greedy selection of the actions of several environments. The network is evaluated once with all the states,
+/// even if some of the actions are finally random
+/// </summary>
+/// <param name="pNetwork">Network used to represent Q(s,a)</param>
+/// <param name="s">The state of each environment</param>
+/// <param name="a">The output action of each environment</param>
+void DiscreteEpsilonGreedyDeepPolicy::selectActions(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s, const vector<Action*>& a)
+{
+	evaluateBatch(pNetwork, s);
+
+	bool bEvaluation = SimionApp::get()->pExperiment->isEvaluationEpisode();
+	double eps = m_epsilon->get();
+	size_t numOutputs = pNetwork->getNumOutputs();
+	for (size_t i = 0; i < s.size(); i++)
+	{
+		if (!bEvaluation && getRandomValue() < eps)
+			randomActionSelection(pNetwork, s[i], a[i]);
+		else
+			greedyActionSelection(&m_batchQValues[i * numOutputs], numOutputs, a[i]);
+	}
+}
+
 /// <summary>
 /// Deep-RL version of the Soft-Max action selection policy
 /// </summary>
@@ -278,7 +334,36 @@ void NoisePlusGreedyDeepPolicy::selectAction(IDiscreteQFunctionNetwork* pNetwork
 		//if there are less noise signals than output action variables, just use the last one
 		noiseSignalIndex = std::min(i, m_noiseSignals.size() - 1);
 		
-		noise = m_noiseSignals[i]->getSample();
+		noise = m_noiseSignals[noiseSignalIndex]->getSample();
 		a->set(m_outputActionVariables[i].c_str(), a->get(m_outputActionVariables[i].c_str()) + noise);
 	}
+}
+
+/// <summary>
+/// Batch version of selectAction(). In evaluation episodes, the greedy actions of every environment are selected with a
+/// single evaluation of the network. Otherwise, as selectAction() does, the network isn't evaluated and noise is just added
+/// to the current actions, generating the noise of every environment at once for each action variable
+/// </summary>
+/// <param name="pNetwork">Network used to represent Q(s,a)</param>
+/// <param name="s">The state of each environment</param>
+/// <param name="a">The output action of each environment</param>
+void NoisePlusGreedyDeepPolicy::selectActions(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s, const vector<Action*>& a)
+{
+	if (SimionApp::get()->pExperiment->isEvaluationEpisode())
+	{
+		evaluateBatch(pNetwork, s);
+		size_t numOutputs = pNetwork->getNumOutputs();
+		for (size_t i = 0; i < s.size(); i++)
+			greedyActionSelection(&m_batchQValues[i * numOutputs], numOutputs, a[i]);
+		return;
+	}
+
+	m_batchNoise.resize(s.size());
+	for (size_t i = 0; i < m_outputActionVariables.size(); i++)
+	{
+		const char* actionVariableName = m_outputActionVariables[i].c_str();
+		m_noiseSignals[std::min(i, m_noiseSignals.size() - 1)]->getSamples(m_batchNoise.data(), s.size());
+		for (size_t env = 0; env < s.size(); env++)
+			a[env]->set(actionVariableName, a[env]->get(actionVariableName) + m_batchNoise[env]);
+	}
 }
\ No newline at end of file
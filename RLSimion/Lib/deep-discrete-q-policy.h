@@ -28,6 +28,7 @@
 using namespace std;
 
 #include "parameters-numeric.h"
+#include "../Common/named-var-set.h"
 
 class Noise;
 
@@ -56,6 +57,14 @@ protected:
 
 	void randomActionSelection(IDiscreteQFunctionNetwork* pNetwork, const State* s, Action* a);
 	void greedyActionSelection(IDiscreteQFunctionNetwork* pNetwork, const State* s, Action* a);
+	void greedyActionSelection(const double* pQValues, size_t numQValues, Action* a);
+
+	//used to select the actions of several environments with a single evaluation of the network: the normalized states
+	//are packed as a minibatch and the Q-values of environment i are m_batchQValues[i * numOutputs...]
+	NamedVarSetNormalizer m_stateNormalizer;
+	vector<double> m_batchStates;
+	vector<double> m_batchQValues;
+	void evaluateBatch(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s);
 
 	size_t getActionVariableIndex(double value, size_t outputVariableIndex);
 public:
@@ -68,6 +77,9 @@ public:
 	size_t getActionIndex(const vector<double>& action, int actionOffset);
 
 	virtual void selectAction(IDiscreteQFunctionNetwork* pNetwork, const State* s, Action* a) = 0;
+	//selects the actions of several environments stepped together (a[i] for s[i]). By default, selectAction() is called
+	//for each of them. Policies that use the network override it to evaluate all the states at once
+	virtual void selectActions(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s, const vector<Action*>& a);
 };
 
 class DiscreteEpsilonGreedyDeepPolicy : public DiscreteDeepPolicy
@@ -78,6 +90,7 @@ public:
 	DiscreteEpsilonGreedyDeepPolicy(ConfigNode* pConfigNode);
 
 	virtual void selectAction(IDiscreteQFunctionNetwork* pNetwork, const State* s, Action* a);
+	virtual void selectActions(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s, const vector<Action*>& a);
 };
 
 class DiscreteSoftmaxDeepPolicy : public DiscreteDeepPolicy
@@ -103,8 +116,10 @@ public:
 class NoisePlusGreedyDeepPolicy : public DiscreteDeepPolicy
 {
 	MULTI_VALUE_FACTORY<Noise> m_noiseSignals;
+	vector<double> m_batchNoise;
 public:
 	NoisePlusGreedyDeepPolicy(ConfigNode* pConfigNode);
 
 	virtual void selectAction(IDiscreteQFunctionNetwork* pNetwork, const State* s, Action* a);
+	virtual void selectActions(IDiscreteQFunctionNetwork* pNetwork, const vector<const State*>& s, const vector<Action*>& a);
 };
\ No newline at end of file
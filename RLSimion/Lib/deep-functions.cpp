@@ -2,6 +2,11 @@
 #include "../Common/named-var-set.h"
 #include "deep-minibatch.h"
 #include "cntk-wrapper-loader.h"
+#include "deep-native-network.h"
+#include "deep-network-cache.h"
+#include "logger.h"
+#include "app.h"
+#include "experiment.h"
 
 DeepNetworkDefinition::DeepNetworkDefinition(ConfigNode* pConfigNode)
 {
@@ -9,6 +14,12 @@ DeepNetworkDefinition::DeepNetworkDefinition(ConfigNode* pConfigNode)
 	m_learner = CHILD_OBJECT_FACTORY<DeepLearner>(pConfigNode, "Learner", "Learner used for this Neural Network");
 	m_useMinibatchNormalization = BOOL_PARAM(pConfigNode, "Use-Normalization", "Use minibatch normalization", false);
 	m_minibatchSize = INT_PARAM(pConfigNode, "Minibatch-Size", "Number of tuples in each minibatch used in updates", 100);
+	m_backend = ENUM_PARAM<DeepBackend>(pConfigNode, "Backend", "Implementation of the Neural Network: CNTK or the native CPU implementation", DeepBackend::CNTK);
+	m_precision = ENUM_PARAM<DeepPrecision>(pConfigNode, "Precision", "Precision of the weights and computations of native networks: Double or Single (faster)", DeepPrecision::Double);
+	m_initialWeightsDir = DIR_PATH_PARAM(pConfigNode, "Initial-Weights-Dir", "Directory where the initial weights of the native networks are saved/loaded, so that all the experiments with the same network definition start from the same weights. Leave blank to initialize them on every run", "");
+
+	if (m_backend.get() == DeepBackend::CNTK && m_precision.get() == DeepPrecision::Single)
+		Logger::logMessage(MessageType::Warning, "Single precision is only supported by the native deep network backend. CNTK networks will use double precision");
 }
 
 void DeepNetworkDefinition::stateToVector(const State* s, vector<double>& v, size_t numTuples)
@@ -69,6 +80,35 @@ bool DeepNetworkDefinition::useNormalization()
 	return m_useMinibatchNormalization.get();
 }
 
+bool DeepNetworkDefinition::usesCntk()
+{
+	return m_backend.get() == DeepBackend::CNTK;
+}
+
+/// <summary>
+/// Returns a string with everything that determines how a native network built from this definition is initialized,
+/// including the random seed of the experiment: runs with different seeds don't share their initial weights
+/// </summary>
+/// <param name="networkType">Type of the network (i.e, "Discrete-Q-Function")</param>
+/// <param name="outputVariables">Output variables of the network, if any</param>
+string DeepNetworkDefinition::getNetworkKey(const string& networkType, const vector<string>& outputVariables)
+{
+	string key = networkType + "|";
+	for (const string& variable : m_inputStateVariables)
+		key += variable + ",";
+	key += "|";
+	for (const string& variable : m_inputActionVariables)
+		key += variable + ",";
+	key += "|";
+	for (const string& variable : outputVariables)
+		key += variable + ",";
+	key += "|" + std::to_string(m_numOutputs) + "|" + getLayersDefinition() + "|" + getLearnerDefinition()
+		+ "|" + std::to_string((int)m_useMinibatchNormalization.get()) + "|" + std::to_string((int)m_precision.get());
+	if (SimionApp::get())
+		key += "|seed=" + std::to_string(SimionApp::get()->pExperiment->getRandomSeed());
+	return key;
+}
+
 DeepMinibatch* DeepNetworkDefinition::getMinibatch()
 {
 	return new DeepMinibatch(m_minibatchSize.get(), this);
@@ -107,6 +147,11 @@ DeepDiscreteQFunction::DeepDiscreteQFunction(ConfigNode* pConfigNode) : DeepNetw
 
 IDiscreteQFunctionNetwork* DeepDiscreteQFunction::getNetworkInstance()
 {
+	if (!usesCntk())
+		return (IDiscreteQFunctionNetwork*)DeepNetworkCache::getInstance(getNetworkKey("Discrete-Q-Function", m_outputActionVariables)
+			, [this]() { return new NativeDiscreteQFunctionNetwork(m_inputStateVariables, m_totalNumActionSteps
+				, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get(), m_precision.get()); }
+			, m_initialWeightsDir.get());
 	return CNTK::WrapperLoader::getDiscreteQFunctionNetwork(m_inputStateVariables, m_totalNumActionSteps
 		, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get());
 }
@@ -134,6 +179,11 @@ DeepContinuousQFunction::DeepContinuousQFunction(ConfigNode* pConfigNode) : Deep
 
 IContinuousQFunctionNetwork* DeepContinuousQFunction::getNetworkInstance()
 {
+	if (!usesCntk())
+		return (IContinuousQFunctionNetwork*)DeepNetworkCache::getInstance(getNetworkKey("Continuous-Q-Function", {})
+			, [this]() { return new NativeContinuousQFunctionNetwork(m_inputStateVariables, m_inputActionVariables
+				, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get(), m_precision.get()); }
+			, m_initialWeightsDir.get());
 	return CNTK::WrapperLoader::getContinuousQFunctionNetwork(m_inputStateVariables, m_inputActionVariables
 		, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get());
 }
@@ -154,6 +204,11 @@ DeepVFunction::DeepVFunction(ConfigNode* pConfigNode) : DeepNetworkDefinition(pC
 
 IVFunctionNetwork* DeepVFunction::getNetworkInstance()
 {
+	if (!usesCntk())
+		return (IVFunctionNetwork*)DeepNetworkCache::getInstance(getNetworkKey("V-Function", {})
+			, [this]() { return new NativeVFunctionNetwork(m_inputStateVariables
+				, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get(), m_precision.get()); }
+			, m_initialWeightsDir.get());
 	return CNTK::WrapperLoader::getVFunctionNetwork(m_inputStateVariables
 		, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get());
 }
@@ -181,6 +236,11 @@ DeepDeterministicPolicy::DeepDeterministicPolicy(ConfigNode* pConfigNode) : Deep
 
 IDeterministicPolicyNetwork* DeepDeterministicPolicy::getNetworkInstance()
 {
+	if (!usesCntk())
+		return (IDeterministicPolicyNetwork*)DeepNetworkCache::getInstance(getNetworkKey("Deterministic-Policy", m_outputActionVariables)
+			, [this]() { return new NativeDeterministicPolicyNetwork(m_inputStateVariables, m_outputActionVariables
+				, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get(), m_precision.get()); }
+			, m_initialWeightsDir.get());
 	return CNTK::WrapperLoader::getDeterministicPolicyNetwork(m_inputStateVariables, m_outputActionVariables
 		, getLayersDefinition(), getLearnerDefinition(), m_useMinibatchNormalization.get());
 }
\ No newline at end of file
@@ -25,12 +25,15 @@ protected:
 	CHILD_OBJECT_FACTORY<DeepLearner> m_learner;
 	BOOL_PARAM m_useMinibatchNormalization;
 	INT_PARAM m_minibatchSize;
+	ENUM_PARAM<DeepBackend> m_backend;
+	ENUM_PARAM<DeepPrecision> m_precision;
+	DIR_PATH_PARAM m_initialWeightsDir;
 
 	size_t m_numOutputs = 0;
 	vector<string> m_inputStateVariables;
 	vector<string> m_inputActionVariables;
 
-	DeepNetworkDefinition() {}
+	DeepNetworkDefinition() { m_initialWeightsDir.set(""); }
 public:
 	DeepNetworkDefinition(ConfigNode* pConfigNode);
 
@@ -42,6 +45,10 @@ public:
 	string getLayersDefinition();
 	string getLearnerDefinition();
 	bool useNormalization();
+	//false if the networks are native, so CNTKWrapper doesn't need to be loaded
+	bool usesCntk();
+	//identifies the native networks built from this definition in the DeepNetworkCache
+	string getNetworkKey(const string& networkType, const vector<string>& outputVariables);
 
 	void stateToVector(const State* s, vector<double>& v, size_t numTuples);
 	void actionToVector(const Action* s, vector<double>& v, size_t numTuples);
@@ -0,0 +1,297 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "deep-kernels.h"
+#include <cmath>
+#include <string.h>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+	#define RESTRICT __restrict
+#else
+	#define RESTRICT __restrict__
+#endif
+
+//blocks of B used at once: 64 rows x 512 columns of doubles (256Kb, 128Kb in single precision) fit in L2
+#define GEMM_K_BLOCK_SIZE 64
+#define GEMM_N_BLOCK_SIZE 512
+
+namespace DeepKernels
+{
+	/// <summary>
+	/// Adds A(i,k)*B(k,:) to four rows of C at once, for k in [k0,k1) and the columns in [j0,j1)
+	/// </summary>
+	template <typename Real>
+	void gemmRows4(size_t N, size_t K, const Real* A, size_t rowStrideA, size_t colStrideA, const Real* B
+		, Real* C, size_t k0, size_t k1, size_t j0, size_t j1)
+	{
+		Real* RESTRICT c0 = C;
+		Real* RESTRICT c1 = C + N;
+		Real* RESTRICT c2 = C + 2 * N;
+		Real* RESTRICT c3 = C + 3 * N;
+		for (size_t k = k0; k < k1; k++)
+		{
+			const Real a0 = A[k * colStrideA];
+			const Real a1 = A[rowStrideA + k * colStrideA];
+			const Real a2 = A[2 * rowStrideA + k * colStrideA];
+			const Real a3 = A[3 * rowStrideA + k * colStrideA];
+			const Real* RESTRICT b = B + k * N;
+			for (size_t j = j0; j < j1; j++)
+			{
+				const Real bValue = b[j];
+				c0[j] += a0 * bValue;
+				c1[j] += a1 * bValue;
+				c2[j] += a2 * bValue;
+				c3[j] += a3 * bValue;
+			}
+		}
+	}
+
+	template <typename Real>
+	void gemmRow(size_t N, const Real* A, size_t colStrideA, const Real* B, Real* C, size_t k0, size_t k1, size_t j0, size_t j1)
+	{
+		Real* RESTRICT c = C;
+		for (size_t k = k0; k < k1; k++)
+		{
+			const Real a = A[k * colStrideA];
+			const Real* RESTRICT b = B + k * N;
+			for (size_t j = j0; j < j1; j++)
+				c[j] += a * b[j];
+		}
+	}
+
+	/// <summary>
+	/// C += op(A) * B, where A(i,k) = A[i * rowStrideA + k * colStrideA], so that the same loops can be used with A and A^T
+	/// </summary>
+	template <typename Real>
+	void blockedGemm(size_t M, size_t N, size_t K, const Real* A, size_t rowStrideA, size_t colStrideA, const Real* B, Real* C)
+	{
+		for (size_t j0 = 0; j0 < N; j0 += GEMM_N_BLOCK_SIZE)
+		{
+			size_t j1 = std::min(N, j0 + GEMM_N_BLOCK_SIZE);
+			for (size_t k0 = 0; k0 < K; k0 += GEMM_K_BLOCK_SIZE)
+			{
+				size_t k1 = std::min(K, k0 + GEMM_K_BLOCK_SIZE);
+				size_t i = 0;
+				for (; i + 4 <= M; i += 4)
+					gemmRows4(N, K, A + i * rowStrideA, rowStrideA, colStrideA, B, C + i * N, k0, k1, j0, j1);
+				for (; i < M; i++)
+					gemmRow(N, A + i * rowStrideA, colStrideA, B, C + i * N, k0, k1, j0, j1);
+			}
+		}
+	}
+
+	template <typename Real>
+	void gemm(size_t M, size_t N, size_t K, const Real* A, const Real* B, Real* C, bool bAccumulate)
+	{
+		if (!bAccumulate)
+			memset(C, 0, M * N * sizeof(Real));
+		blockedGemm(M, N, K, A, K, 1, B, C);
+	}
+
+	template <typename Real>
+	void gemmTransposedA(size_t M, size_t N, size_t K, const Real* A, const Real* B, Real* C, bool bAccumulate)
+	{
+		if (!bAccumulate)
+			memset(C, 0, M * N * sizeof(Real));
+		blockedGemm(M, N, K, A, 1, M, B, C);
+	}
+
+	template <typename Real>
+	void transpose(size_t rows, size_t cols, const Real* A, Real* At)
+	{
+		const size_t blockSize = 32;
+		for (size_t i0 = 0; i0 < rows; i0 += blockSize)
+		{
+			for (size_t j0 = 0; j0 < cols; j0 += blockSize)
+			{
+				size_t i1 = std::min(rows, i0 + blockSize), j1 = std::min(cols, j0 + blockSize);
+				for (size_t i = i0; i < i1; i++)
+					for (size_t j = j0; j < j1; j++)
+						At[j * rows + i] = A[i * cols + j];
+			}
+		}
+	}
+
+	template <typename Real>
+	void addBias(size_t M, size_t N, const Real* bias, Real* C)
+	{
+		for (size_t i = 0; i < M; i++)
+		{
+			Real* RESTRICT c = C + i * N;
+			for (size_t j = 0; j < N; j++)
+				c[j] += bias[j];
+		}
+	}
+
+	template <typename Real>
+	void sumRows(size_t M, size_t N, const Real* delta, Real* biasGradient)
+	{
+		//the sums are accumulated in double precision, a block of columns at a time
+		const size_t blockSize = 64;
+		double sums[blockSize];
+		for (size_t j0 = 0; j0 < N; j0 += blockSize)
+		{
+			size_t j1 = std::min(N, j0 + blockSize);
+			for (size_t j = j0; j < j1; j++) sums[j - j0] = 0.0;
+			for (size_t i = 0; i < M; i++)
+			{
+				const Real* RESTRICT d = delta + i * N;
+				for (size_t j = j0; j < j1; j++)
+					sums[j - j0] += d[j];
+			}
+			for (size_t j = j0; j < j1; j++) biasGradient[j] = (Real)sums[j - j0];
+		}
+	}
+
+	template <typename Real>
+	void activation(Activation activation, size_t M, size_t N, const Real* x, Real* y)
+	{
+		const size_t size = M * N;
+		const Real zero = 0, one = 1;
+		switch (activation)
+		{
+		case Activation::ELU:
+			for (size_t i = 0; i < size; i++) y[i] = x[i] > zero ? x[i] : std::exp(x[i]) - one;
+			break;
+		case Activation::ReLU:
+			for (size_t i = 0; i < size; i++) y[i] = std::max(x[i], zero);
+			break;
+		case Activation::Sigmoid:
+			for (size_t i = 0; i < size; i++) y[i] = one / (one + std::exp(-x[i]));
+			break;
+		case Activation::SoftPlus:
+			//log(1+e^x) computed so that it doesn't overflow with large inputs
+			for (size_t i = 0; i < size; i++) y[i] = std::max(x[i], zero) + std::log1p(std::exp(-std::fabs(x[i])));
+			break;
+		case Activation::Tanh:
+			for (size_t i = 0; i < size; i++) y[i] = std::tanh(x[i]);
+			break;
+		case Activation::SoftMax:
+			for (size_t row = 0; row < M; row++)
+			{
+				const Real* xRow = x + row * N;
+				Real* yRow = y + row * N;
+				Real maxValue = *std::max_element(xRow, xRow + N);
+				double sum = 0.0;
+				for (size_t j = 0; j < N; j++)
+				{
+					yRow[j] = std::exp(xRow[j] - maxValue);
+					sum += yRow[j];
+				}
+				for (size_t j = 0; j < N; j++)
+					yRow[j] = (Real)(yRow[j] / sum);
+			}
+			break;
+		case Activation::Linear:
+		default:
+			if (x != y)
+				memcpy(y, x, size * sizeof(Real));
+		}
+	}
+
+	template <typename Real>
+	void activationGradient(Activation activation, size_t M, size_t N, const Real* y, Real* delta)
+	{
+		const size_t size = M * N;
+		const Real zero = 0, one = 1;
+		switch (activation)
+		{
+		case Activation::ELU:
+			//f'(x) = 1 if x > 0, e^x = y + 1 otherwise
+			for (size_t i = 0; i < size; i++) delta[i] *= y[i] > zero ? one : y[i] + one;
+			break;
+		case Activation::ReLU:
+			for (size_t i = 0; i < size; i++) delta[i] = y[i] > zero ? delta[i] : zero;
+			break;
+		case Activation::Sigmoid:
+			for (size_t i = 0; i < size; i++) delta[i] *= y[i] * (one - y[i]);
+			break;
+		case Activation::SoftPlus:
+			//f'(x) = sigmoid(x) = 1 - e^-y
+			for (size_t i = 0; i < size; i++) delta[i] *= -std::expm1(-y[i]);
+			break;
+		case Activation::Tanh:
+			for (size_t i = 0; i < size; i++) delta[i] *= one - y[i] * y[i];
+			break;
+		case Activation::SoftMax:
+			//delta_j = y_j * (delta_j - sum_k(delta_k * y_k))
+			for (size_t row = 0; row < M; row++)
+			{
+				const Real* yRow = y + row * N;
+				Real* deltaRow = delta + row * N;
+				double dot = 0.0;
+				for (size_t j = 0; j < N; j++)
+					dot += deltaRow[j] * yRow[j];
+				for (size_t j = 0; j < N; j++)
+					deltaRow[j] = (Real)(yRow[j] * (deltaRow[j] - dot));
+			}
+			break;
+		case Activation::Linear:
+		default:
+			break;
+		}
+	}
+
+	template <typename Real>
+	void qLearningTargets(size_t M, size_t N, const Real* Q_s_p_select, const Real* Q_s_p_evaluate, const Real* r
+		, Real gamma, const size_t* actions, Real* target)
+	{
+		for (size_t i = 0; i < M; i++)
+		{
+			//the first action with the highest value, as std::max_element() does
+			const Real* selectRow = Q_s_p_select + i * N;
+			size_t argMax = 0;
+			Real maxValue = selectRow[0];
+			for (size_t j = 1; j < N; j++)
+			{
+				if (selectRow[j] > maxValue)
+				{
+					maxValue = selectRow[j];
+					argMax = j;
+				}
+			}
+			target[i * N + actions[i]] = r[i] + gamma * Q_s_p_evaluate[i * N + argMax];
+		}
+	}
+
+	//single and double precision versions are used by the native networks
+	template void gemm<double>(size_t, size_t, size_t, const double*, const double*, double*, bool);
+	template void gemm<float>(size_t, size_t, size_t, const float*, const float*, float*, bool);
+	template void gemmTransposedA<double>(size_t, size_t, size_t, const double*, const double*, double*, bool);
+	template void gemmTransposedA<float>(size_t, size_t, size_t, const float*, const float*, float*, bool);
+	template void transpose<double>(size_t, size_t, const double*, double*);
+	template void transpose<float>(size_t, size_t, const float*, float*);
+	template void addBias<double>(size_t, size_t, const double*, double*);
+	template void addBias<float>(size_t, size_t, const float*, float*);
+	template void sumRows<double>(size_t, size_t, const double*, double*);
+	template void sumRows<float>(size_t, size_t, const float*, float*);
+	template void activation<double>(Activation, size_t, size_t, const double*, double*);
+	template void activation<float>(Activation, size_t, size_t, const float*, float*);
+	template void activationGradient<double>(Activation, size_t, size_t, const double*, double*);
+	template void activationGradient<float>(Activation, size_t, size_t, const float*, float*);
+	template void qLearningTargets<double>(size_t, size_t, const double*, const double*, const double*, double, const size_t*, double*);
+	template void qLearningTargets<float>(size_t, size_t, const float*, const float*, const float*, float, const size_t*, float*);
+}
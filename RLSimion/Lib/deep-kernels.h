@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+#include "deep-layer.h"
+
+//Dense linear algebra used by the native neural networks (see NativeNetwork). Matrices are row-major and contiguous.
+//The products are written so that the innermost loop is an axpy over a row of the output (c[j] += a * b[j]): it has no
+//reductions, so the compiler can vectorize it without reordering floating-point sums. They are blocked so that the block
+//of B being used stays in cache, and four rows of C are updated at once so that each value of B loaded is used four times.
+//All of them are defined for float and double. Sums over rows (bias gradients, SoftMax) are accumulated in double precision
+namespace DeepKernels
+{
+	//C(MxN) = A(MxK) * B(KxN), or C += A*B if bAccumulate is true
+	template <typename Real>
+	void gemm(size_t M, size_t N, size_t K, const Real* A, const Real* B, Real* C, bool bAccumulate = false);
+	//C(MxN) = A^T * B, where A is (KxM) and B is (KxN), or C += A^T*B if bAccumulate is true
+	template <typename Real>
+	void gemmTransposedA(size_t M, size_t N, size_t K, const Real* A, const Real* B, Real* C, bool bAccumulate = false);
+	//At(colsxrows) = A(rowsxcols)^T
+	template <typename Real>
+	void transpose(size_t rows, size_t cols, const Real* A, Real* At);
+
+	//adds the bias to each of the M rows of C(MxN)
+	template <typename Real>
+	void addBias(size_t M, size_t N, const Real* bias, Real* C);
+	//biasGradient(N) = sum of the M rows of delta(MxN)
+	template <typename Real>
+	void sumRows(size_t M, size_t N, const Real* delta, Real* biasGradient);
+
+	//y = f(x), element-wise except SoftMax, which is applied to each of the M rows of N values
+	template <typename Real>
+	void activation(Activation activation, size_t M, size_t N, const Real* x, Real* y);
+	//delta = delta * f'(x), given y = f(x). In SoftMax, the whole Jacobian of each row is used
+	template <typename Real>
+	void activationGradient(Activation activation, size_t M, size_t N, const Real* y, Real* delta);
+
+	//Q-learning targets of a minibatch of M tuples with N discrete actions, in a single pass: for each tuple i, the action
+	//with the highest value in the row i of Q_s_p_select(MxN) is used to read Q_s_p_evaluate(MxN), and
+	//target[i][actions[i]] = r[i] + gamma * Q_s_p_evaluate[i][argmax]. The rest of the row of target(MxN) is unchanged.
+	//In DQN both Q matrices are the same (the target network on s_p), in Double DQN the action is selected with the online
+	//network
+	template <typename Real>
+	void qLearningTargets(size_t M, size_t N, const Real* Q_s_p_select, const Real* Q_s_p_evaluate, const Real* r
+		, Real gamma, const size_t* actions, Real* target);
+
+	//Allocator of the buffers used by the kernels, aligned to cache lines (64 bytes) so that rows are loaded with aligned
+	//vector instructions and no two buffers share a line
+	template <typename T>
+	class AlignedAllocator
+	{
+	public:
+		static const size_t alignment = 64;
+		typedef T value_type;
+
+		AlignedAllocator() {}
+		template <typename U> AlignedAllocator(const AlignedAllocator<U>&) {}
+		template <typename U> struct rebind { typedef AlignedAllocator<U> other; };
+
+		T* allocate(size_t n)
+		{
+			void* p = nullptr;
+#if defined(_MSC_VER)
+			p = _aligned_malloc(n * sizeof(T), alignment);
+#else
+			if (posix_memalign(&p, alignment, n * sizeof(T)) != 0) p = nullptr;
+#endif
+			if (p == nullptr)
+				throw std::bad_alloc();
+			return (T*)p;
+		}
+		void deallocate(T* p, size_t)
+		{
+#if defined(_MSC_VER)
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+		template <typename U> bool operator==(const AlignedAllocator<U>&) const { return true; }
+		template <typename U> bool operator!=(const AlignedAllocator<U>&) const { return false; }
+	};
+}
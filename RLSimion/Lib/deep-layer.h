@@ -1,6 +1,10 @@
 #pragma once
 
 enum class Activation { Linear, ELU, ReLU, Sigmoid, SoftMax, SoftPlus, Tanh };
+//Implementation of the deep networks: CNTK (through CNTKWrapper) or the native CPU networks (see NativeNetwork)
+enum class DeepBackend { CNTK, Native };
+//Precision of the values of the native networks. CNTK networks are always built in double precision
+enum class DeepPrecision { Double, Single };
 class ConfigNode;
 
 #include <string>
@@ -3,6 +3,7 @@
 
 #include "../Common/named-var-set.h"
 #include <vector>
+#include <algorithm>
 using namespace std;
 
 class DeepNetworkDefinition;
@@ -39,4 +40,6 @@ public:
 	bool isFull() const;
 	size_t size() const { return m_size; }
 	size_t numTuples() const;
+	//used when the vectors have been filled directly (i.e., by the replay buffer)
+	void setNumTuples(size_t numTuples) { m_numTuples = std::min(numTuples, m_size); }
 };
\ No newline at end of file
@@ -0,0 +1,809 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "deep-native-network.h"
+#include "deep-kernels.h"
+#include "deep-minibatch.h"
+#include "deep-functions.h"
+#include "logger.h"
+#include "checkpoint.h"
+#include "../Common/named-var-set.h"
+#include "../../tools/System/CrossPlatform.h"
+#include <cmath>
+#include <random>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+
+// NativeMlp
+
+template <typename Real>
+void NativeMlp<Real>::init(const vector<NativeLayer>& layers, size_t numParameters, NativeLearnerType learnerType)
+{
+	this->layers = layers;
+	parameters = Buffer(numParameters, (Real)0);
+	gradient = Buffer(numParameters, (Real)0);
+	if (learnerType != NativeLearnerType::SGD)
+		moment1 = Buffer(numParameters, (Real)0);
+	if (learnerType == NativeLearnerType::Adam)
+		moment2 = Buffer(numParameters, (Real)0);
+	activations = vector<Buffer>(layers.size() + 1);
+	deltas = vector<Buffer>(layers.size() + 1);
+}
+
+template <typename Real>
+void NativeMlp<Real>::resize(size_t numSamples)
+{
+	if (numSamples == this->numSamples)
+		return;
+	this->numSamples = numSamples;
+	size_t numInputs = layers.front().numInputs;
+	activations[0].resize(numSamples * numInputs);
+	deltas[0].resize(numSamples * numInputs);
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		activations[i + 1].resize(numSamples * layers[i].numOutputs);
+		deltas[i + 1].resize(numSamples * layers[i].numOutputs);
+	}
+}
+
+template <typename Real>
+Real* NativeMlp<Real>::getInputBuffer(size_t numSamples)
+{
+	resize(numSamples);
+	pInput = activations[0].data();
+	return activations[0].data();
+}
+
+template <typename Real>
+void NativeMlp<Real>::setInput(const Real* pInput, size_t numSamples)
+{
+	resize(numSamples);
+	this->pInput = pInput;
+}
+
+/// <summary>
+/// Forward pass. The output of each layer is kept to be used in the backward pass
+/// </summary>
+template <typename Real>
+const Real* NativeMlp<Real>::forward()
+{
+	for (size_t i = 0; i < layers.size(); i++)
+	{
+		const NativeLayer& layer = layers[i];
+		Real* pOutput = activations[i + 1].data();
+		DeepKernels::gemm(numSamples, layer.numOutputs, layer.numInputs, i == 0 ? pInput : activations[i].data()
+			, &parameters[layer.weightsOffset], pOutput);
+		DeepKernels::addBias(numSamples, layer.numOutputs, &parameters[layer.biasesOffset], pOutput);
+		DeepKernels::activation(layer.activation, numSamples, layer.numOutputs, pOutput, pOutput);
+	}
+	return activations.back().data();
+}
+
+template <typename Real>
+void NativeMlp<Real>::squaredErrorGradient(const double* pTarget)
+{
+	const Real* pOutput = activations.back().data();
+	Real* pOutputGradient = deltas.back().data();
+	for (size_t i = 0; i < deltas.back().size(); i++)
+		pOutputGradient[i] = (Real)2 * (pOutput[i] - (Real)pTarget[i]);
+}
+
+/// <summary>
+/// Backward pass from the gradient of the loss wrt the output of the network (one row per sample). If bParameterGradient
+/// is true, the gradient wrt the parameters (summed over the samples) is left in gradient. If bInputGradient is true,
+/// the gradient wrt the input is left in deltas[0]
+/// </summary>
+template <typename Real>
+void NativeMlp<Real>::backward(const Real* pOutputGradient, bool bParameterGradient, bool bInputGradient)
+{
+	if (pOutputGradient != deltas.back().data())
+		memcpy(deltas.back().data(), pOutputGradient, deltas.back().size() * sizeof(Real));
+	for (size_t l = layers.size(); l-- > 0;)
+	{
+		const NativeLayer& layer = layers[l];
+		Real* pDelta = deltas[l + 1].data();
+		DeepKernels::activationGradient(layer.activation, numSamples, layer.numOutputs, activations[l + 1].data(), pDelta);
+		if (bParameterGradient)
+		{
+			DeepKernels::gemmTransposedA(layer.numInputs, layer.numOutputs, numSamples, l == 0 ? pInput : activations[l].data()
+				, pDelta, &gradient[layer.weightsOffset]);
+			DeepKernels::sumRows(numSamples, layer.numOutputs, pDelta, &gradient[layer.biasesOffset]);
+		}
+		if (l == 0 && !bInputGradient)
+			break;
+		//dX = delta * W^T
+		transposedWeights.resize(layer.numInputs * layer.numOutputs);
+		DeepKernels::transpose(layer.numInputs, layer.numOutputs, &parameters[layer.weightsOffset], transposedWeights.data());
+		DeepKernels::gemm(numSamples, layer.numInputs, layer.numOutputs, pDelta, transposedWeights.data(), deltas[l].data());
+	}
+}
+
+/// <summary>
+/// Updates the parameters with the gradient. As in CNTK's learners with per-sample learning rates, the gradient is the sum
+/// over the samples in the minibatch. The update of each parameter is computed in double precision
+/// </summary>
+template <typename Real>
+void NativeMlp<Real>::updateParameters(NativeLearnerType learnerType, double learningRate)
+{
+	if (learnerType == NativeLearnerType::Adam)
+		numLearnerUpdates++;
+	updateParameters(learnerType, learningRate, numLearnerUpdates, parameters.size(), parameters.data(), gradient.data()
+		, moment1.data(), moment2.data());
+}
+
+/// <summary>
+/// Updates numParameters parameters with their gradient and the learner's moments (only used by MomentumSGD and Adam).
+/// numLearnerUpdates is the number of updates done with these moments, including this one
+/// </summary>
+template <typename Real>
+void NativeMlp<Real>::updateParameters(NativeLearnerType learnerType, double learningRate, size_t numLearnerUpdates
+	, size_t numParameters, Real* pParameters, const Real* pGradient, Real* pMoment1, Real* pMoment2)
+{
+	switch (learnerType)
+	{
+	case NativeLearnerType::SGD:
+		for (size_t i = 0; i < numParameters; i++)
+			pParameters[i] = (Real)(pParameters[i] - learningRate * pGradient[i]);
+		break;
+	case NativeLearnerType::MomentumSGD:
+	{
+		//unit-gain momentum: m = beta*m + (1-beta)*g
+		const double momentum = 0.9;
+		for (size_t i = 0; i < numParameters; i++)
+		{
+			double moment = momentum * pMoment1[i] + (1.0 - momentum) * pGradient[i];
+			pMoment1[i] = (Real)moment;
+			pParameters[i] = (Real)(pParameters[i] - learningRate * moment);
+		}
+		break;
+	}
+	case NativeLearnerType::Adam:
+	default:
+	{
+		const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+		const double correctedLearningRate = learningRate * sqrt(1.0 - pow(beta2, (double)numLearnerUpdates))
+			/ (1.0 - pow(beta1, (double)numLearnerUpdates));
+		for (size_t i = 0; i < numParameters; i++)
+		{
+			double g = pGradient[i];
+			double m1 = beta1 * pMoment1[i] + (1.0 - beta1) * g;
+			double m2 = beta2 * pMoment2[i] + (1.0 - beta2) * g * g;
+			pMoment1[i] = (Real)m1;
+			pMoment2[i] = (Real)m2;
+			pParameters[i] = (Real)(pParameters[i] - correctedLearningRate * m1 / (sqrt(m2) + epsilon));
+		}
+		break;
+	}
+	}
+}
+
+/// <summary>
+/// theta = alpha * theta_source + (1 - alpha) * theta, in place. With alpha = 1 the parameters are copied (a hard update)
+/// </summary>
+template <typename Real>
+void NativeMlp<Real>::softUpdate(const NativeMlp<Real>& source, double alpha)
+{
+	if (alpha == 1.0)
+	{
+		memcpy(parameters.data(), source.parameters.data(), parameters.size() * sizeof(Real));
+		return;
+	}
+	const Real* pSourceParameters = source.parameters.data();
+	Real* pParameters = parameters.data();
+	for (size_t i = 0; i < parameters.size(); i++)
+		pParameters[i] = (Real)(alpha * pSourceParameters[i] + (1.0 - alpha) * pParameters[i]);
+}
+
+/// <summary>
+/// Saves the parameters and the state of the learner (converted to double precision) as entries named "name/..."
+/// </summary>
+template <typename Real>
+void NativeMlp<Real>::saveCheckpoint(CheckpointWriter& writer, const string& name) const
+{
+	writer.add(name + "/parameters", vector<double>(parameters.begin(), parameters.end()));
+	writer.add(name + "/moment1", vector<double>(moment1.begin(), moment1.end()));
+	writer.add(name + "/moment2", vector<double>(moment2.begin(), moment2.end()));
+	double learnerUpdates = (double)numLearnerUpdates;
+	writer.add(name + "/learner-updates", &learnerUpdates, 1);
+}
+
+/// <summary>
+/// Loads the parameters saved by saveCheckpoint(). The state of the learner is only loaded if it was saved by the same
+/// learner, so that a network can be warm-started with a different one
+/// </summary>
+/// <returns>False if the parameters aren't in the checkpoint or there is a different number of them</returns>
+template <typename Real>
+bool NativeMlp<Real>::loadCheckpoint(const CheckpointReader& reader, const string& name)
+{
+	size_t numValues;
+	const double* pValues = reader.get(name + "/parameters", numValues);
+	if (!pValues || numValues != parameters.size())
+		return false;
+	std::copy(pValues, pValues + numValues, parameters.begin());
+
+	const double* pMoment1 = reader.get(name + "/moment1", numValues);
+	if (pMoment1 && numValues == moment1.size())
+	{
+		const double* pMoment2 = reader.get(name + "/moment2", numValues);
+		double learnerUpdates;
+		if (pMoment2 && numValues == moment2.size() && reader.read(name + "/learner-updates", &learnerUpdates, 1))
+		{
+			std::copy(pMoment1, pMoment1 + moment1.size(), moment1.begin());
+			std::copy(pMoment2, pMoment2 + moment2.size(), moment2.begin());
+			numLearnerUpdates = (size_t)learnerUpdates;
+		}
+	}
+	return true;
+}
+
+template class NativeMlp<double>;
+template class NativeMlp<float>;
+
+// NativeNetwork
+
+NativeNetwork::NativeNetwork(vector<string> inputStateVariables, vector<string> inputActionVariables, size_t numOutputs
+	, string networkLayersDefinition, string learnerDefinition, bool useNormalization, DeepPrecision precision)
+{
+	m_inputStateVariables = inputStateVariables;
+	m_inputActionVariables = inputActionVariables;
+	m_numInputs = inputStateVariables.size() + inputActionVariables.size();
+	m_numOutputs = numOutputs;
+	m_precision = precision;
+
+	vector<NativeLayer> layers;
+	size_t numParameters = 0;
+	initLayers(networkLayersDefinition, useNormalization, layers, numParameters);
+	m_learnerType = learnerTypeFromDefinition(learnerDefinition);
+
+	//seeded with rand() so that the experiment's random seed determines the initial weights (the same in either precision).
+	//Each network has its own generator, so networks can be built from different threads
+	std::mt19937 randomGenerator((unsigned int)rand());
+	vector<double> initialParameters(numParameters, 0.0);
+	for (const NativeLayer& layer : layers)
+	{
+		double limit = sqrt(6.0 / (double)(layer.numInputs + layer.numOutputs));
+		std::uniform_real_distribution<double> distribution(-limit, limit);
+		for (size_t i = 0; i < layer.numInputs * layer.numOutputs; i++)
+			initialParameters[layer.weightsOffset + i] = distribution(randomGenerator);
+	}
+	if (m_precision == DeepPrecision::Single)
+		m_mlpSingle.init(layers, numParameters, m_learnerType);
+	else
+		m_mlp.init(layers, numParameters, m_learnerType);
+	setParameters(initialParameters.data());
+
+	m_outputBuffer = vector<double>(numOutputs);
+	m_stateNormalizer = NamedVarSetNormalizer(m_inputStateVariables);
+}
+
+unsigned int NativeNetwork::getNumOutputs()
+{
+	return (unsigned int)m_numOutputs;
+}
+
+const vector<string>& NativeNetwork::getInputStateVariables()
+{
+	return m_inputStateVariables;
+}
+
+const vector<string>& NativeNetwork::getInputActionVariables()
+{
+	return m_inputActionVariables;
+}
+
+size_t NativeNetwork::getNumParameters() const
+{
+	return m_precision == DeepPrecision::Single ? m_mlpSingle.parameters.size() : m_mlp.parameters.size();
+}
+
+void NativeNetwork::getParameters(double* pOutput) const
+{
+	if (m_precision == DeepPrecision::Single)
+		std::copy(m_mlpSingle.parameters.begin(), m_mlpSingle.parameters.end(), pOutput);
+	else
+		std::copy(m_mlp.parameters.begin(), m_mlp.parameters.end(), pOutput);
+}
+
+void NativeNetwork::setParameters(const double* pParameters)
+{
+	if (m_precision == DeepPrecision::Single)
+		std::copy(pParameters, pParameters + m_mlpSingle.parameters.size(), m_mlpSingle.parameters.begin());
+	else
+		std::copy(pParameters, pParameters + m_mlp.parameters.size(), m_mlp.parameters.begin());
+}
+
+/// <summary>
+/// Parses the layers definition ("activation,units;activation,units;...") and adds the linear output layer. The weights are
+/// initialized with Glorot's uniform initialization and the biases with zeros, as CNTKWrapper does
+/// </summary>
+void NativeNetwork::initLayers(const string& networkLayersDefinition, bool useNormalization, vector<NativeLayer>& layers
+	, size_t& numParameters)
+{
+	if (useNormalization)
+		Logger::logMessage(MessageType::Warning, "Batch normalization is not supported by the native deep network backend and will be ignored");
+
+	size_t numLayerInputs = m_numInputs;
+	vector<string> layerDefinitions = CrossPlatform::split(networkLayersDefinition, DeepNetworkDefinition::layerDefinitionDelimiter);
+	for (const string& layerDefinition : layerDefinitions)
+	{
+		vector<string> layerParameters = CrossPlatform::split(layerDefinition, DeepNetworkDefinition::layerParameterDelimiter);
+		if (layerParameters.size() != 2) //for now, only 2 parameters: activation and #units
+			continue;
+		NativeLayer layer;
+		layer.activation = DeepLayer::activationFromFunctionName(layerParameters[0]);
+		layer.numInputs = numLayerInputs;
+		layer.numOutputs = (size_t)std::max(1, atoi(layerParameters[1].c_str()));
+		layers.push_back(layer);
+		numLayerInputs = layer.numOutputs;
+	}
+	NativeLayer outputLayer;
+	outputLayer.numInputs = numLayerInputs;
+	outputLayer.numOutputs = m_numOutputs;
+	layers.push_back(outputLayer);
+
+	numParameters = 0;
+	for (NativeLayer& layer : layers)
+	{
+		layer.weightsOffset = numParameters;
+		numParameters += layer.numInputs * layer.numOutputs;
+		layer.biasesOffset = numParameters;
+		numParameters += layer.numOutputs;
+	}
+}
+
+NativeLearnerType NativeNetwork::learnerTypeFromDefinition(const string& learnerDefinition)
+{
+	vector<string> learnerParameters = CrossPlatform::split(learnerDefinition, DeepNetworkDefinition::learnerParameterDelimiter);
+	if (!learnerParameters.empty() && learnerParameters[0] == "SGD")
+		return NativeLearnerType::SGD;
+	else if (!learnerParameters.empty() && learnerParameters[0] == "MomentumSGD")
+		return NativeLearnerType::MomentumSGD;
+	return NativeLearnerType::Adam;
+}
+
+/// <summary>
+/// Resizes the buffers of the layers for a batch of numSamples samples and returns the input buffer, which must be filled
+/// with the input of each sample, one after another, before calling forward()
+/// </summary>
+double* NativeNetwork::getInputBuffer(size_t numSamples)
+{
+	m_numSamples = numSamples;
+	if (m_precision == DeepPrecision::Single)
+	{
+		m_mlpSingle.getInputBuffer(numSamples);
+		m_inputBuffer.resize(numSamples * m_numInputs);
+		m_bInputBufferUsed = true;
+		return m_inputBuffer.data();
+	}
+	return m_mlp.getInputBuffer(numSamples);
+}
+
+void NativeNetwork::setInput(const double* pInput, size_t numSamples)
+{
+	m_numSamples = numSamples;
+	if (m_precision == DeepPrecision::Single)
+	{
+		float* pSingleInput = m_mlpSingle.getInputBuffer(numSamples);
+		for (size_t i = 0; i < numSamples * m_numInputs; i++)
+			pSingleInput[i] = (float)pInput[i];
+		m_bInputBufferUsed = false;
+	}
+	else
+		m_mlp.setInput(pInput, numSamples);
+}
+
+void NativeNetwork::convertInputBuffer()
+{
+	if (!m_bInputBufferUsed)
+		return;
+	float* pSingleInput = m_mlpSingle.activations[0].data();
+	for (size_t i = 0; i < m_numSamples * m_numInputs; i++)
+		pSingleInput[i] = (float)m_inputBuffer[i];
+	m_bInputBufferUsed = false;
+}
+
+const double* NativeNetwork::forward()
+{
+	if (m_precision == DeepPrecision::Single)
+	{
+		convertInputBuffer();
+		const float* pOutput = m_mlpSingle.forward();
+		m_forwardOutput.resize(m_numSamples * m_numOutputs);
+		for (size_t i = 0; i < m_forwardOutput.size(); i++)
+			m_forwardOutput[i] = pOutput[i];
+		return m_forwardOutput.data();
+	}
+	return m_mlp.forward();
+}
+
+void NativeNetwork::backward(const double* pOutputGradient, bool bParameterGradient, bool bInputGradient)
+{
+	if (m_precision == DeepPrecision::Single)
+	{
+		float* pSingleOutputGradient = m_mlpSingle.deltas.back().data();
+		for (size_t i = 0; i < m_numSamples * m_numOutputs; i++)
+			pSingleOutputGradient[i] = (float)pOutputGradient[i];
+		m_mlpSingle.backward(pSingleOutputGradient, bParameterGradient, bInputGradient);
+	}
+	else
+		m_mlp.backward(pOutputGradient, bParameterGradient, bInputGradient);
+}
+
+const double* NativeNetwork::getInputGradient()
+{
+	if (m_precision == DeepPrecision::Single)
+	{
+		const NativeMlp<float>::Buffer& inputGradient = m_mlpSingle.deltas[0];
+		m_inputGradient.assign(inputGradient.begin(), inputGradient.end());
+		return m_inputGradient.data();
+	}
+	return m_mlp.deltas[0].data();
+}
+
+void NativeNetwork::updateParameters()
+{
+	if (m_bFrozen)
+		return;
+	if (m_precision == DeepPrecision::Single)
+		m_mlpSingle.updateParameters(m_learnerType, m_learningRate);
+	else
+		m_mlp.updateParameters(m_learnerType, m_learningRate);
+}
+
+void NativeNetwork::setStateInput(const vector<double>& s)
+{
+	setInput(s.data(), s.size() / m_numInputs);
+}
+
+void NativeNetwork::_evaluate(const vector<double>& s, vector<double>& output)
+{
+	setStateInput(s);
+	const double* pOutput = forward();
+	if (output.size() < m_numSamples * m_numOutputs)
+		output.resize(m_numSamples * m_numOutputs);
+	memcpy(output.data(), pOutput, m_numSamples * m_numOutputs * sizeof(double));
+}
+
+void NativeNetwork::lossGradient(const vector<double>& target)
+{
+	if (m_precision == DeepPrecision::Single)
+	{
+		convertInputBuffer();
+		m_mlpSingle.forward();
+		m_mlpSingle.squaredErrorGradient(target.data());
+		m_mlpSingle.backward(m_mlpSingle.deltas.back().data(), true, false);
+	}
+	else
+	{
+		m_mlp.forward();
+		m_mlp.squaredErrorGradient(target.data());
+		m_mlp.backward(m_mlp.deltas.back().data(), true, false);
+	}
+}
+
+/// <summary>
+/// Trains the network with the squared error between the outputs and the targets of the samples in the last input set.
+/// The gradient of the loss is computed in the precision of the network
+/// </summary>
+void NativeNetwork::_train(const vector<double>& target, double learningRate)
+{
+	m_learningRate = learningRate;
+	lossGradient(target);
+	updateParameters();
+}
+
+/// <summary>
+/// Copies to pGradient (getNumParameters() values) the gradient of the squared error of the samples in the last input set
+/// wrt the parameters, which aren't updated
+/// </summary>
+void NativeNetwork::_computeGradient(const vector<double>& target, double* pGradient)
+{
+	lossGradient(target);
+	if (m_precision == DeepPrecision::Single)
+		std::copy(m_mlpSingle.gradient.begin(), m_mlpSingle.gradient.end(), pGradient);
+	else
+		std::copy(m_mlp.gradient.begin(), m_mlp.gradient.end(), pGradient);
+}
+
+/// <summary>
+/// theta = alpha * theta_source + (1 - alpha) * theta, in place. With alpha = 1 the parameters are copied (a hard update).
+/// Networks with a different architecture or precision are ignored
+/// </summary>
+void NativeNetwork::_softUpdate(const NativeNetwork* pSource, double alpha)
+{
+	if (!pSource || pSource == this || pSource->m_precision != m_precision
+		|| pSource->getNumParameters() != getNumParameters())
+		return;
+	if (m_precision == DeepPrecision::Single)
+		m_mlpSingle.softUpdate(pSource->m_mlpSingle, alpha);
+	else
+		m_mlp.softUpdate(pSource->m_mlp, alpha);
+}
+
+bool NativeNetwork::_saveCheckpoint(CheckpointWriter& writer, const string& name) const
+{
+	if (m_precision == DeepPrecision::Single)
+		m_mlpSingle.saveCheckpoint(writer, name);
+	else
+		m_mlp.saveCheckpoint(writer, name);
+	return true;
+}
+
+bool NativeNetwork::_loadCheckpoint(const CheckpointReader& reader, const string& name)
+{
+	if (m_precision == DeepPrecision::Single)
+		return m_mlpSingle.loadCheckpoint(reader, name);
+	return m_mlp.loadCheckpoint(reader, name);
+}
+
+vector<double>& NativeNetwork::_evaluate(const State* s)
+{
+	m_stateNormalizer.normalize(s, getInputBuffer(1));
+	memcpy(m_outputBuffer.data(), forward(), m_numOutputs * sizeof(double));
+	return m_outputBuffer;
+}
+
+/// <summary>
+/// Packs the values of a batch given as structures of arrays (see StateActionFunction::evaluateBatch()) as a minibatch:
+/// the normalized values of the variables of each sample, one sample after another
+/// </summary>
+void NativeNetwork::batchToVector(const double* const* pValues, const vector<string>& variables, size_t numSamples
+	, const NamedVarSet* pVarSet, vector<double>& outVector)
+{
+	size_t numVars = variables.size();
+	outVector.resize(numSamples * numVars);
+	for (size_t i = 0; i < numVars; i++)
+	{
+		const char* varName = variables[i].c_str();
+		for (size_t sample = 0; sample < numSamples; sample++)
+			outVector[sample * numVars + i] = pVarSet->normalize(varName, pValues[i][sample]);
+	}
+}
+
+void NativeNetwork::_evaluateBatch(const double* const* pStateValues, size_t numSamples, const State* s, double* pOutput)
+{
+	batchToVector(pStateValues, m_inputStateVariables, numSamples, s, m_batchStateBuffer);
+	m_batchOutputBuffer.resize(numSamples * m_numOutputs);
+	_evaluate(m_batchStateBuffer, m_batchOutputBuffer);
+	memcpy(pOutput, m_batchOutputBuffer.data(), numSamples * m_numOutputs * sizeof(double));
+}
+
+// NativeDiscreteQFunctionNetwork
+
+NativeDiscreteQFunctionNetwork::NativeDiscreteQFunctionNetwork(vector<string> inputStateVariables, size_t numActionSteps
+	, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+	, DeepPrecision precision)
+	: NativeNetwork(inputStateVariables, {}, numActionSteps, networkLayersDefinition, learnerDefinition, useNormalization, precision)
+{}
+void NativeDiscreteQFunctionNetwork::destroy() { delete this; }
+IDeepNetwork* NativeDiscreteQFunctionNetwork::clone(bool bFreezeWeights) const
+{
+	NativeDiscreteQFunctionNetwork* pClone = new NativeDiscreteQFunctionNetwork(*this);
+	pClone->m_bFrozen = bFreezeWeights;
+	return pClone;
+}
+void NativeDiscreteQFunctionNetwork::train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate)
+{
+	setStateInput(pMinibatch->s());
+	NativeNetwork::_train(target, learningRate);
+}
+void NativeDiscreteQFunctionNetwork::computeGradient(DeepMinibatch* pMinibatch, const vector<double>& target, double* pGradient)
+{
+	setStateInput(pMinibatch->s());
+	NativeNetwork::_computeGradient(target, pGradient);
+}
+void NativeDiscreteQFunctionNetwork::evaluate(const vector<double>& s, vector<double>& output)
+{
+	NativeNetwork::_evaluate(s, output);
+}
+vector<double>& NativeDiscreteQFunctionNetwork::evaluate(const State* s, const Action* a)
+{
+	return NativeNetwork::_evaluate(s);
+}
+void NativeDiscreteQFunctionNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	NativeNetwork::_evaluateBatch(pStateValues, numSamples, s, pOutput);
+}
+void NativeDiscreteQFunctionNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
+{
+	NativeNetwork::_softUpdate(dynamic_cast<NativeDiscreteQFunctionNetwork*>(pSource), alpha);
+}
+
+// NativeContinuousQFunctionNetwork
+
+NativeContinuousQFunctionNetwork::NativeContinuousQFunctionNetwork(vector<string> inputStateVariables, vector<string> inputActionVariables
+	, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+	, DeepPrecision precision)
+	: NativeNetwork(inputStateVariables, inputActionVariables, 1, networkLayersDefinition, learnerDefinition, useNormalization, precision)
+{
+	m_actionNormalizer = NamedVarSetNormalizer(m_inputActionVariables);
+}
+
+/// <summary>
+/// The input of the network is the state and the action of each sample, one after the other
+/// </summary>
+void NativeContinuousQFunctionNetwork::setStateActionInput(const vector<double>& s, const vector<double>& a)
+{
+	const size_t numStateVars = m_inputStateVariables.size();
+	const size_t numActionVars = m_inputActionVariables.size();
+	const size_t numSamples = numStateVars > 0 ? s.size() / numStateVars : a.size() / numActionVars;
+	double* pInput = getInputBuffer(numSamples);
+	for (size_t sample = 0; sample < numSamples; sample++)
+	{
+		memcpy(pInput, &s[sample * numStateVars], numStateVars * sizeof(double));
+		memcpy(pInput + numStateVars, &a[sample * numActionVars], numActionVars * sizeof(double));
+		pInput += m_numInputs;
+	}
+}
+
+void NativeContinuousQFunctionNetwork::destroy() { delete this; }
+IDeepNetwork* NativeContinuousQFunctionNetwork::clone(bool bFreezeWeights) const
+{
+	NativeContinuousQFunctionNetwork* pClone = new NativeContinuousQFunctionNetwork(*this);
+	pClone->m_bFrozen = bFreezeWeights;
+	return pClone;
+}
+void NativeContinuousQFunctionNetwork::train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate)
+{
+	setStateActionInput(pMinibatch->s(), pMinibatch->a());
+	NativeNetwork::_train(target, learningRate);
+}
+void NativeContinuousQFunctionNetwork::evaluate(const vector<double>& s, const vector<double>& a, vector<double>& output)
+{
+	setStateActionInput(s, a);
+	const double* pOutput = forward();
+	if (output.size() < m_numSamples)
+		output.resize(m_numSamples);
+	memcpy(output.data(), pOutput, m_numSamples * sizeof(double));
+}
+vector<double>& NativeContinuousQFunctionNetwork::evaluate(const State* s, const Action* a)
+{
+	double* pInput = getInputBuffer(1);
+	m_stateNormalizer.normalize(s, pInput);
+	m_actionNormalizer.normalize(a, pInput + m_inputStateVariables.size());
+	m_outputBuffer[0] = *forward();
+	return m_outputBuffer;
+}
+void NativeContinuousQFunctionNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues
+	, size_t numSamples, State* s, Action* a, double* pOutput)
+{
+	batchToVector(pStateValues, m_inputStateVariables, numSamples, s, m_batchStateBuffer);
+	batchToVector(pActionValues, m_inputActionVariables, numSamples, a, m_batchActionBuffer);
+	m_batchOutputBuffer.resize(numSamples);
+	evaluate(m_batchStateBuffer, m_batchActionBuffer, m_batchOutputBuffer);
+	memcpy(pOutput, m_batchOutputBuffer.data(), numSamples * sizeof(double));
+}
+
+/// <summary>
+/// dQ(s,a)/da of each sample, backpropagating a unit gradient from the output to the action inputs
+/// </summary>
+void NativeContinuousQFunctionNetwork::gradientWrtAction(const vector<double>& s, const vector<double>&a, vector<double>& gradient)
+{
+	setStateActionInput(s, a);
+	forward();
+	m_outputGradient.assign(m_numSamples, 1.0);
+	backward(m_outputGradient.data(), false, true);
+
+	const size_t numStateVars = m_inputStateVariables.size();
+	const size_t numActionVars = m_inputActionVariables.size();
+	if (gradient.size() < m_numSamples * numActionVars)
+		gradient.resize(m_numSamples * numActionVars);
+	const double* pInputGradient = getInputGradient();
+	for (size_t sample = 0; sample < m_numSamples; sample++)
+		memcpy(&gradient[sample * numActionVars], pInputGradient + sample * m_numInputs + numStateVars, numActionVars * sizeof(double));
+}
+void NativeContinuousQFunctionNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
+{
+	NativeNetwork::_softUpdate(dynamic_cast<NativeContinuousQFunctionNetwork*>(pSource), alpha);
+}
+
+// NativeVFunctionNetwork
+
+NativeVFunctionNetwork::NativeVFunctionNetwork(vector<string> inputStateVariables, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+	, DeepPrecision precision)
+	: NativeNetwork(inputStateVariables, {}, 1, networkLayersDefinition, learnerDefinition, useNormalization, precision)
+{}
+void NativeVFunctionNetwork::destroy() { delete this; }
+IDeepNetwork* NativeVFunctionNetwork::clone(bool bFreezeWeights) const
+{
+	NativeVFunctionNetwork* pClone = new NativeVFunctionNetwork(*this);
+	pClone->m_bFrozen = bFreezeWeights;
+	return pClone;
+}
+void NativeVFunctionNetwork::train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate)
+{
+	setStateInput(pMinibatch->s());
+	NativeNetwork::_train(target, learningRate);
+}
+void NativeVFunctionNetwork::evaluate(const vector<double>& s, vector<double>& output)
+{
+	NativeNetwork::_evaluate(s, output);
+}
+vector<double>& NativeVFunctionNetwork::evaluate(const State* s, const Action* a)
+{
+	return NativeNetwork::_evaluate(s);
+}
+void NativeVFunctionNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	NativeNetwork::_evaluateBatch(pStateValues, numSamples, s, pOutput);
+}
+void NativeVFunctionNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
+{
+	NativeNetwork::_softUpdate(dynamic_cast<NativeVFunctionNetwork*>(pSource), alpha);
+}
+
+// NativeDeterministicPolicyNetwork
+
+NativeDeterministicPolicyNetwork::NativeDeterministicPolicyNetwork(vector<string> inputStateVariables, vector<string> outputActionVariables
+	, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+	, DeepPrecision precision)
+	: NativeNetwork(inputStateVariables, {}, outputActionVariables.size(), networkLayersDefinition, learnerDefinition, useNormalization, precision)
+{
+	m_outputActionVariables = outputActionVariables;
+}
+void NativeDeterministicPolicyNetwork::destroy() { delete this; }
+IDeepNetwork* NativeDeterministicPolicyNetwork::clone(bool bFreezeWeights) const
+{
+	NativeDeterministicPolicyNetwork* pClone = new NativeDeterministicPolicyNetwork(*this);
+	pClone->m_bFrozen = bFreezeWeights;
+	return pClone;
+}
+void NativeDeterministicPolicyNetwork::train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate)
+{
+	setStateInput(pMinibatch->s());
+	NativeNetwork::_train(target, learningRate);
+}
+void NativeDeterministicPolicyNetwork::evaluate(const vector<double>& s, vector<double>& output)
+{
+	NativeNetwork::_evaluate(s, output);
+}
+vector<double>& NativeDeterministicPolicyNetwork::evaluate(const State* s, const Action* a)
+{
+	return NativeNetwork::_evaluate(s);
+}
+void NativeDeterministicPolicyNetwork::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	NativeNetwork::_evaluateBatch(pStateValues, numSamples, s, pOutput);
+}
+void NativeDeterministicPolicyNetwork::softUpdate(IDeepNetwork* pSource, double alpha)
+{
+	NativeNetwork::_softUpdate(dynamic_cast<NativeDeterministicPolicyNetwork*>(pSource), alpha);
+}
+
+/// <summary>
+/// Backpropagates the gradient given for the output of each sample in the minibatch (i.e., -dQ(s,a)/da in DDPG) instead of
+/// the gradient of a loss function, and updates the parameters with the current learner
+/// </summary>
+void NativeDeterministicPolicyNetwork::applyGradient(DeepMinibatch* pMinibatch, const vector<double>& gradient)
+{
+	setStateInput(pMinibatch->s());
+	forward();
+	backward(gradient.data(), true, false);
+	updateParameters();
+}
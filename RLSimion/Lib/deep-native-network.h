@@ -0,0 +1,266 @@
+#pragma once
+
+#include "deep-network.h"
+#include "deep-layer.h"
+#include "deep-kernels.h"
+#include "../Common/named-var-set.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+struct NativeLayer
+{
+	size_t numInputs = 0;
+	size_t numOutputs = 0;
+	Activation activation = Activation::Linear;
+	size_t weightsOffset = 0; //weights (numInputs x numOutputs) in the parameters
+	size_t biasesOffset = 0; //biases (numOutputs) in the parameters
+};
+enum class NativeLearnerType { SGD, MomentumSGD, Adam };
+
+//Parameters, learner state and buffers of a native network in a given precision (float or double). Buffers are aligned and
+//reused between calls: they are only resized when the number of samples changes
+template <typename Real>
+class NativeMlp
+{
+public:
+	typedef vector<Real, DeepKernels::AlignedAllocator<Real>> Buffer;
+
+	vector<NativeLayer> layers;
+	Buffer parameters;
+	Buffer gradient;
+	Buffer moment1;
+	Buffer moment2;
+	size_t numLearnerUpdates = 0;
+
+	//one row per sample. The input is read from pInput: either activations[0] or a buffer owned by the caller (set with
+	//setInput()). activations[i+1] is the output of the i-th layer and deltas[i] the gradient of the loss wrt activations[i]
+	size_t numSamples = 0;
+	const Real* pInput = nullptr;
+	vector<Buffer> activations;
+	vector<Buffer> deltas;
+	Buffer transposedWeights;
+
+	void init(const vector<NativeLayer>& layers, size_t numParameters, NativeLearnerType learnerType);
+	void resize(size_t numSamples);
+	Real* getInputBuffer(size_t numSamples);
+	//the input isn't copied: it must be valid until the next forward() and backward() have been done
+	void setInput(const Real* pInput, size_t numSamples);
+
+	const Real* forward();
+	//d(y-t)^2/dy = 2(y-t), computed in the precision of the network after forward() and left in deltas.back()
+	void squaredErrorGradient(const double* pTarget);
+	void backward(const Real* pOutputGradient, bool bParameterGradient, bool bInputGradient);
+	void updateParameters(NativeLearnerType learnerType, double learningRate);
+	//the update of the learner on a range of parameters (numLearnerUpdates counts this update too). It is used to update the
+	//whole network and the shards of the parameters shared by several networks (DeepParameterServer)
+	static void updateParameters(NativeLearnerType learnerType, double learningRate, size_t numLearnerUpdates
+		, size_t numParameters, Real* pParameters, const Real* pGradient, Real* pMoment1, Real* pMoment2);
+	void softUpdate(const NativeMlp<Real>& source, double alpha);
+
+	//parameters and learner state, saved in double precision
+	void saveCheckpoint(CheckpointWriter& writer, const string& name) const;
+	bool loadCheckpoint(const CheckpointReader& reader, const string& name);
+};
+
+//Self-contained CPU implementation of the deep networks (multi-layer perceptrons), used instead of CNTK when the
+//backend of a network definition is DeepBackend::Native. It needs no external libraries, so networks are created in
+//milliseconds, and small batches don't pay the overhead of a general-purpose framework.
+//The networks are built as CNTKWrapper builds them: the hidden layers given by the layers definition and a linear output
+//layer, trained minimizing the squared error with the learner given by the learner definition (SGD, MomentumSGD or Adam).
+//The weights, the learner state and the computations are either in double or single precision (DeepPrecision): only one
+//of m_mlp and m_mlpSingle is used. The interface is always in double precision: in single precision, inputs are converted
+//once when they are copied to the network and outputs when they are copied out
+class NativeNetwork
+{
+protected:
+	vector<string> m_inputStateVariables;
+	vector<string> m_inputActionVariables;
+	size_t m_numInputs = 0;
+	size_t m_numOutputs = 0;
+
+	DeepPrecision m_precision = DeepPrecision::Double;
+	NativeMlp<double> m_mlp;
+	NativeMlp<float> m_mlpSingle;
+	//frozen networks (i.e., target networks) are never trained
+	bool m_bFrozen = false;
+
+	NativeLearnerType m_learnerType = NativeLearnerType::Adam;
+	double m_learningRate = 0.0001;
+
+	//single precision: inputs written by the caller with getInputBuffer() and converted in forward(), and outputs converted
+	//back to double precision
+	bool m_bInputBufferUsed = false;
+	vector<double> m_inputBuffer;
+	vector<double> m_forwardOutput;
+	vector<double> m_inputGradient;
+	void convertInputBuffer();
+
+	size_t m_numSamples = 0;
+
+	void initLayers(const string& networkLayersDefinition, bool useNormalization, vector<NativeLayer>& layers, size_t& numParameters);
+	NativeLearnerType learnerTypeFromDefinition(const string& learnerDefinition);
+
+	//buffer for the input of numSamples samples, one after another. It must be filled before calling forward()
+	double* getInputBuffer(size_t numSamples);
+	//in double precision the input is used without copying it, so it must be valid until forward() and backward() are done
+	void setInput(const double* pInput, size_t numSamples);
+	const double* forward();
+	void backward(const double* pOutputGradient, bool bParameterGradient, bool bInputGradient);
+	//gradient of the loss wrt the input, after backward() with bInputGradient = true
+	const double* getInputGradient();
+	void updateParameters();
+	//forward and backward passes with the squared error between the outputs and the targets of the last input set. The
+	//gradient wrt the parameters is left in the gradient buffer of the network
+	void lossGradient(const vector<double>& target);
+
+	//base functionality for the networks, in which the input is only the state
+	void setStateInput(const vector<double>& s);
+	void _evaluate(const vector<double>& s, vector<double>& output);
+	void _train(const vector<double>& target, double learningRate);
+	void _computeGradient(const vector<double>& target, double* pGradient);
+	void _softUpdate(const NativeNetwork* pSource, double alpha);
+	bool _saveCheckpoint(CheckpointWriter& writer, const string& name) const;
+	bool _loadCheckpoint(const CheckpointReader& reader, const string& name);
+
+	//used for single-tuple evaluations: the normalized inputs are written directly to the input of the network, so that
+	//evaluating a state doesn't allocate memory once the buffers have been sized
+	vector<double> m_outputBuffer;
+	NamedVarSetNormalizer m_stateNormalizer;
+	vector<double>& _evaluate(const State* s);
+
+	//used for batch evaluations
+	vector<double> m_batchStateBuffer;
+	vector<double> m_batchOutputBuffer;
+	void batchToVector(const double* const* pValues, const vector<string>& variables, size_t numSamples
+		, const NamedVarSet* pVarSet, vector<double>& outVector);
+	void _evaluateBatch(const double* const* pStateValues, size_t numSamples, const State* s, double* pOutput);
+
+	NativeNetwork(vector<string> inputStateVariables, vector<string> inputActionVariables, size_t numOutputs
+		, string networkLayersDefinition, string learnerDefinition, bool useNormalization, DeepPrecision precision);
+public:
+	unsigned int getNumOutputs();
+	const vector<string>& getInputStateVariables();
+	const vector<string>& getInputActionVariables();
+
+	DeepPrecision getPrecision() const { return m_precision; }
+	NativeLearnerType getLearnerType() const { return m_learnerType; }
+	size_t getNumParameters() const;
+	//the parameters are copied (and converted if the network uses single precision)
+	void getParameters(double* pOutput) const;
+	void setParameters(const double* pParameters);
+};
+
+class NativeDiscreteQFunctionNetwork final : public IDiscreteQFunctionNetwork, NativeNetwork
+{
+public:
+	NativeDiscreteQFunctionNetwork(vector<string> inputStateVariables, size_t numActionSteps
+		, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+		, DeepPrecision precision = DeepPrecision::Double);
+
+	unsigned int getNumOutputs() { return NativeNetwork::getNumOutputs(); }
+	const vector<string>& getInputStateVariables() { return NativeNetwork::getInputStateVariables(); }
+	const vector<string>& getInputActionVariables() { return NativeNetwork::getInputActionVariables(); }
+	using NativeNetwork::getPrecision;
+	using NativeNetwork::getNumParameters;
+	using NativeNetwork::getParameters;
+	using NativeNetwork::setParameters;
+	using NativeNetwork::getLearnerType;
+	void destroy();
+	IDeepNetwork* clone(bool bFreezeWeights = true) const;
+	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
+	//the gradient of the loss wrt the parameters (as in train(), without updating them), used by the actor-learners of
+	//AsyncQLearning to update the parameters shared by all of them
+	void computeGradient(DeepMinibatch* pMinibatch, const vector<double>& target, double* pGradient);
+	void evaluate(const vector<double>& s, vector<double>& output);
+	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+	void softUpdate(IDeepNetwork* pSource, double alpha);
+	bool saveCheckpoint(CheckpointWriter& writer, const string& name) const { return NativeNetwork::_saveCheckpoint(writer, name); }
+	bool loadCheckpoint(const CheckpointReader& reader, const string& name) { return NativeNetwork::_loadCheckpoint(reader, name); }
+};
+
+class NativeContinuousQFunctionNetwork final : public IContinuousQFunctionNetwork, NativeNetwork
+{
+	vector<double> m_batchActionBuffer;
+	vector<double> m_outputGradient;
+	NamedVarSetNormalizer m_actionNormalizer;
+	void setStateActionInput(const vector<double>& s, const vector<double>& a);
+public:
+	NativeContinuousQFunctionNetwork(vector<string> inputStateVariables, vector<string> inputActionVariables
+		, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+		, DeepPrecision precision = DeepPrecision::Double);
+
+	unsigned int getNumOutputs() { return 1; }
+	const vector<string>& getInputStateVariables() { return NativeNetwork::getInputStateVariables(); }
+	const vector<string>& getInputActionVariables() { return NativeNetwork::getInputActionVariables(); }
+	using NativeNetwork::getPrecision;
+	using NativeNetwork::getNumParameters;
+	using NativeNetwork::getParameters;
+	using NativeNetwork::setParameters;
+	void destroy();
+	IDeepNetwork* clone(bool bFreezeWeights = true) const;
+	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
+	void evaluate(const vector<double>& s, const vector<double>& a, vector<double>& output);
+	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+	void gradientWrtAction(const vector<double>& s, const vector<double>&a, vector<double>& gradient);
+	void softUpdate(IDeepNetwork* pSource, double alpha);
+	bool saveCheckpoint(CheckpointWriter& writer, const string& name) const { return NativeNetwork::_saveCheckpoint(writer, name); }
+	bool loadCheckpoint(const CheckpointReader& reader, const string& name) { return NativeNetwork::_loadCheckpoint(reader, name); }
+};
+
+class NativeVFunctionNetwork final : public IVFunctionNetwork, NativeNetwork
+{
+public:
+	NativeVFunctionNetwork(vector<string> inputStateVariables, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+		, DeepPrecision precision = DeepPrecision::Double);
+
+	unsigned int getNumOutputs() { return 1; }
+	const vector<string>& getInputStateVariables() { return NativeNetwork::getInputStateVariables(); }
+	const vector<string>& getInputActionVariables() { return NativeNetwork::getInputActionVariables(); }
+	using NativeNetwork::getPrecision;
+	using NativeNetwork::getNumParameters;
+	using NativeNetwork::getParameters;
+	using NativeNetwork::setParameters;
+	void destroy();
+	IDeepNetwork* clone(bool bFreezeWeights = true) const;
+	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
+	void evaluate(const vector<double>& s, vector<double>& output);
+	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+	void softUpdate(IDeepNetwork* pSource, double alpha);
+	bool saveCheckpoint(CheckpointWriter& writer, const string& name) const { return NativeNetwork::_saveCheckpoint(writer, name); }
+	bool loadCheckpoint(const CheckpointReader& reader, const string& name) { return NativeNetwork::_loadCheckpoint(reader, name); }
+};
+
+class NativeDeterministicPolicyNetwork final : public IDeterministicPolicyNetwork, NativeNetwork
+{
+	vector<string> m_outputActionVariables;
+public:
+	NativeDeterministicPolicyNetwork(vector<string> inputStateVariables, vector<string> outputActionVariables
+		, string networkLayersDefinition, string learnerDefinition, bool useNormalization
+		, DeepPrecision precision = DeepPrecision::Double);
+
+	unsigned int getNumOutputs() { return NativeNetwork::getNumOutputs(); }
+	const vector<string>& getInputStateVariables() { return NativeNetwork::getInputStateVariables(); }
+	const vector<string>& getInputActionVariables() { return NativeNetwork::getInputActionVariables(); }
+	using NativeNetwork::getPrecision;
+	using NativeNetwork::getNumParameters;
+	using NativeNetwork::getParameters;
+	using NativeNetwork::setParameters;
+	void destroy();
+	IDeepNetwork* clone(bool bFreezeWeights = true) const;
+	void train(DeepMinibatch* pMinibatch, const vector<double>& target, double learningRate);
+	void evaluate(const vector<double>& s, vector<double>& output);
+	vector<double>& evaluate(const State* s, const Action* a);
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+	void softUpdate(IDeepNetwork* pSource, double alpha);
+	bool saveCheckpoint(CheckpointWriter& writer, const string& name) const { return NativeNetwork::_saveCheckpoint(writer, name); }
+	bool loadCheckpoint(const CheckpointReader& reader, const string& name) { return NativeNetwork::_loadCheckpoint(reader, name); }
+	void applyGradient(DeepMinibatch* pMinibatch, const vector<double>& gradient);
+};
@@ -0,0 +1,120 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "deep-network-cache.h"
+#include "deep-network.h"
+#include "checkpoint.h"
+#include "logger.h"
+#include <stdio.h>
+
+std::mutex DeepNetworkCache::m_mutex;
+unordered_map<string, unique_ptr<IDeepNetwork, DeepNetworkCache::NetworkDeleter>> DeepNetworkCache::m_prototypes;
+
+void DeepNetworkCache::NetworkDeleter::operator()(IDeepNetwork* pNetwork) const
+{
+	pNetwork->destroy();
+}
+
+/// <summary>
+/// Returns a copy of the prototype network of a definition, creating the prototype the first time
+/// </summary>
+/// <param name="key">Identifier of the definition of the network</param>
+/// <param name="create">Creates a network with the definition. Only called if there is no prototype yet</param>
+/// <param name="initialWeightsDir">Directory where the initial weights are persisted. Leave blank to not persist them</param>
+/// <returns>A new trainable network, owned by the caller</returns>
+IDeepNetwork* DeepNetworkCache::getInstance(const string& key, const std::function<IDeepNetwork*()>& create
+	, const string& initialWeightsDir)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	IDeepNetwork* pPrototype;
+	auto it = m_prototypes.find(key);
+	if (it != m_prototypes.end())
+		pPrototype = it->second.get();
+	else
+		pPrototype = createPrototype(key, create, initialWeightsDir);
+
+	return pPrototype->clone(false);
+}
+
+/// <summary>
+/// Creates the prototype of a definition. If the initial weights of the definition were persisted, they are loaded.
+/// Otherwise, the weights of the new network are persisted
+/// </summary>
+IDeepNetwork* DeepNetworkCache::createPrototype(const string& key, const std::function<IDeepNetwork*()>& create
+	, const string& initialWeightsDir)
+{
+	IDeepNetwork* pPrototype = create();
+	m_prototypes[key] = unique_ptr<IDeepNetwork, NetworkDeleter>(pPrototype);
+
+	if (initialWeightsDir.empty())
+		return pPrototype;
+
+	//the name of the entries is the key itself, so two definitions whose files have the same name are never mixed up
+	string filename = getInitialWeightsFilename(initialWeightsDir, key);
+	{
+		CheckpointReader reader;
+		if (reader.open(filename) && pPrototype->loadCheckpoint(reader, key))
+			return pPrototype;
+	}
+	CheckpointWriter writer;
+	bool bSaved = writer.open(filename) && pPrototype->saveCheckpoint(writer, key);
+	bSaved = writer.close() && bSaved;
+	if (!bSaved)
+		Logger::logMessage(MessageType::Warning, (string("Couldn't save the initial weights of the network to ") + filename).c_str());
+	return pPrototype;
+}
+
+/// <summary>
+/// The name of the file is a 64-bit FNV-1a hash of the key, which is the same in every platform and run
+/// </summary>
+string DeepNetworkCache::getInitialWeightsFilename(const string& initialWeightsDir, const string& key)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (unsigned char c : key)
+	{
+		hash ^= c;
+		hash *= 1099511628211ull;
+	}
+	char hashString[17];
+	snprintf(hashString, sizeof(hashString), "%016llx", hash);
+
+	string directory = initialWeightsDir;
+	if (directory.back() != '/' && directory.back() != '\\')
+		directory += '/';
+	return directory + "network-" + hashString + ".ckpt";
+}
+
+size_t DeepNetworkCache::getNumPrototypes()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_prototypes.size();
+}
+
+void DeepNetworkCache::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_prototypes.clear();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+using namespace std;
+
+class IDeepNetwork;
+
+//Process-wide cache of native networks, keyed by their definition (type, inputs, outputs, layers, learner, precision).
+//The first network of each definition is kept as a prototype and the networks handed out are copies of it, so layers
+//are only parsed and weights only initialized once per definition. Optionally, the initial weights of the prototypes are
+//persisted in a directory (one checkpoint per definition): every run with the same definition and random seed, i.e. the
+//experiments of a parameter sweep, starts from the same weights and skips the initialization. The seed is part of the key
+//(see DeepNetworkDefinition::getNetworkKey()), so runs with different seeds start from different weights
+class DeepNetworkCache
+{
+	struct NetworkDeleter
+	{
+		void operator()(IDeepNetwork* pNetwork) const;
+	};
+	static std::mutex m_mutex;
+	static unordered_map<string, unique_ptr<IDeepNetwork, NetworkDeleter>> m_prototypes;
+
+	static IDeepNetwork* createPrototype(const string& key, const std::function<IDeepNetwork*()>& create
+		, const string& initialWeightsDir);
+public:
+	//a new network (owned by the caller) with the weights of the prototype of the key. If there is none, create() is
+	//called to build it, and its initial weights are loaded from/saved to initialWeightsDir (if not empty)
+	static IDeepNetwork* getInstance(const string& key, const std::function<IDeepNetwork*()>& create
+		, const string& initialWeightsDir = "");
+
+	//file where the initial weights of the networks with this key are persisted
+	static string getInitialWeightsFilename(const string& initialWeightsDir, const string& key);
+
+	static size_t getNumPrototypes();
+	static void clear();
+};
@@ -2,6 +2,8 @@
 
 #include "../Common/state-action-function.h"
 class DeepMinibatch;
+class CheckpointWriter;
+class CheckpointReader;
 
 #include <vector>
 using namespace std;
@@ -17,6 +19,11 @@ public:
 
 	virtual vector<double>& evaluate(const State* s, const Action* a) = 0;
 	virtual void softUpdate(IDeepNetwork* pSourceNetwork, double alpha) = 0;
+
+	//saves/loads the parameters and the state of the learner as entries named "name/...". They return false if the network
+	//doesn't support checkpoints or, when loading, the entries are missing or were saved from a different architecture
+	virtual bool saveCheckpoint(CheckpointWriter& writer, const string& name) const { return false; }
+	virtual bool loadCheckpoint(const CheckpointReader& reader, const string& name) { return false; }
 };
 
 class IDiscreteQFunctionNetwork : public IDeepNetwork
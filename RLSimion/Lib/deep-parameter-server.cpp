@@ -0,0 +1,165 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "deep-parameter-server.h"
+#include "checkpoint.h"
+#include <algorithm>
+
+DeepParameterServer::DeepParameterServer()
+{
+	m_numUpdates = 0;
+	m_targetVersion = 0;
+}
+
+/// <summary>
+/// Copies the initial parameters, also to the target parameters, and splits them in numShards shards of (almost) the
+/// same size
+/// </summary>
+/// <param name="pParameters">Initial parameters</param>
+/// <param name="numParameters">Number of parameters</param>
+/// <param name="learnerType">Learner used to apply the gradients</param>
+/// <param name="numShards">Number of shards, each with its own lock. There are at most as many shards as parameters</param>
+void DeepParameterServer::initialize(const double* pParameters, size_t numParameters, NativeLearnerType learnerType
+	, size_t numShards)
+{
+	m_parameters.assign(pParameters, pParameters + numParameters);
+	m_targetParameters = m_parameters;
+	m_learnerType = learnerType;
+	m_moment1.assign(learnerType == NativeLearnerType::SGD ? 0 : numParameters, 0.0);
+	m_moment2.assign(learnerType == NativeLearnerType::Adam ? numParameters : 0, 0.0);
+
+	numShards = std::max((size_t)1, std::min(numShards, numParameters));
+	m_shards = vector<Shard>(numShards);
+	for (size_t i = 0; i < numShards; i++)
+	{
+		m_shards[i].begin = numParameters * i / numShards;
+		m_shards[i].end = numParameters * (i + 1) / numShards;
+	}
+	m_numUpdates = 0;
+	m_targetVersion = 0;
+}
+
+/// <summary>
+/// Applies a gradient (getNumParameters() values) to the parameters, one shard after another. Each shard keeps its own
+/// learner state, so the update of each shard is the same it would be if it was the only one
+/// </summary>
+/// <param name="pGradient">Gradient of the loss wrt the parameters</param>
+/// <param name="learningRate">Learning rate</param>
+/// <param name="firstShard">The first shard updated</param>
+void DeepParameterServer::pushGradient(const double* pGradient, double learningRate, size_t firstShard)
+{
+	const size_t numShards = m_shards.size();
+	for (size_t i = 0; i < numShards; i++)
+	{
+		Shard& shard = m_shards[(firstShard + i) % numShards];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		if (m_learnerType == NativeLearnerType::Adam)
+			shard.numLearnerUpdates++;
+		NativeMlp<double>::updateParameters(m_learnerType, learningRate, shard.numLearnerUpdates, shard.end - shard.begin
+			, &m_parameters[shard.begin], &pGradient[shard.begin]
+			, m_moment1.empty() ? nullptr : &m_moment1[shard.begin], m_moment2.empty() ? nullptr : &m_moment2[shard.begin]);
+	}
+	m_numUpdates++;
+}
+
+void DeepParameterServer::pullParameters(double* pOutput)
+{
+	for (Shard& shard : m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		std::copy(m_parameters.begin() + shard.begin, m_parameters.begin() + shard.end, pOutput + shard.begin);
+	}
+}
+
+void DeepParameterServer::updateTarget()
+{
+	std::lock_guard<std::mutex> targetLock(m_targetMutex);
+	pullParameters(m_targetParameters.data());
+	m_targetVersion++;
+}
+
+size_t DeepParameterServer::pullTargetParameters(double* pOutput)
+{
+	std::lock_guard<std::mutex> targetLock(m_targetMutex);
+	std::copy(m_targetParameters.begin(), m_targetParameters.end(), pOutput);
+	return m_targetVersion.load();
+}
+
+/// <summary>
+/// Saves the parameters, the target parameters and the state of the learner. All the locks are held while saving, so the
+/// checkpoint is consistent even if other threads are pushing gradients
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void DeepParameterServer::saveCheckpoint(CheckpointWriter& writer)
+{
+	std::lock_guard<std::mutex> targetLock(m_targetMutex);
+	vector<std::unique_lock<std::mutex>> shardLocks;
+	for (Shard& shard : m_shards)
+		shardLocks.emplace_back(shard.mutex);
+
+	vector<double> shardLearnerUpdates(m_shards.size());
+	for (size_t i = 0; i < m_shards.size(); i++)
+		shardLearnerUpdates[i] = (double)m_shards[i].numLearnerUpdates;
+
+	writer.add("parameters", m_parameters);
+	writer.add("target-parameters", m_targetParameters);
+	writer.add("moment1", m_moment1);
+	writer.add("moment2", m_moment2);
+	writer.add("shard-learner-updates", shardLearnerUpdates);
+}
+
+/// <summary>
+/// Loads the parameters, the target parameters and, if the learner is the same, the state of the learner. The target
+/// version is incremented so that every thread pulls the loaded target parameters
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+/// <returns>False if the checkpoint has no parameters or their number doesn't match</returns>
+bool DeepParameterServer::loadCheckpoint(const CheckpointReader& reader)
+{
+	std::lock_guard<std::mutex> targetLock(m_targetMutex);
+	vector<std::unique_lock<std::mutex>> shardLocks;
+	for (Shard& shard : m_shards)
+		shardLocks.emplace_back(shard.mutex);
+
+	size_t numParameters, numTargetParameters;
+	if (!reader.get("parameters", numParameters) || !reader.get("target-parameters", numTargetParameters)
+		|| numParameters != m_parameters.size() || numTargetParameters != m_targetParameters.size())
+		return false;
+	reader.read("parameters", m_parameters);
+	reader.read("target-parameters", m_targetParameters);
+
+	//the state of the learner is read into temporaries: it is only loaded if all of it is in the checkpoint
+	vector<double> moment1(m_moment1.size()), moment2(m_moment2.size()), shardLearnerUpdates(m_shards.size());
+	if (reader.read("moment1", moment1) && reader.read("moment2", moment2)
+		&& reader.read("shard-learner-updates", shardLearnerUpdates))
+	{
+		m_moment1.swap(moment1);
+		m_moment2.swap(moment2);
+		for (size_t i = 0; i < m_shards.size(); i++)
+			m_shards[i].numLearnerUpdates = (size_t)shardLearnerUpdates[i];
+	}
+	m_targetVersion++;
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "deep-native-network.h"
+#include <vector>
+#include <mutex>
+#include <atomic>
+using namespace std;
+
+class CheckpointWriter;
+class CheckpointReader;
+
+//Parameters of a native network shared by several actor-learner threads (asynchronous deep RL). Each thread computes
+//gradients with its own copy of the network and pushes them here. The parameters are split in shards, each with its own
+//lock and learner state, so two threads only wait for each other if they update the same shard at the same time. A copy
+//of the parameters is kept for the target networks, updated with updateTarget() and pulled by the threads when it changes
+class DeepParameterServer
+{
+	struct Shard
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		size_t numLearnerUpdates = 0;
+		std::mutex mutex;
+	};
+	vector<Shard> m_shards;
+	vector<double> m_parameters;
+	vector<double> m_moment1;
+	vector<double> m_moment2;
+	NativeLearnerType m_learnerType = NativeLearnerType::SGD;
+	std::atomic<size_t> m_numUpdates;
+
+	vector<double> m_targetParameters;
+	std::mutex m_targetMutex;
+	std::atomic<size_t> m_targetVersion;
+public:
+	DeepParameterServer();
+
+	//the parameters (i.e., the initial parameters of a network) are copied. The gradients pushed are applied with the learner
+	void initialize(const double* pParameters, size_t numParameters, NativeLearnerType learnerType, size_t numShards);
+
+	size_t getNumParameters() const { return m_parameters.size(); }
+	size_t getNumShards() const { return m_shards.size(); }
+	//number of gradients pushed
+	size_t getNumUpdates() const { return m_numUpdates.load(); }
+
+	//applies the gradient to every shard. Each thread should start from a different shard (i.e., its index) to avoid
+	//waiting for the same locks
+	void pushGradient(const double* pGradient, double learningRate, size_t firstShard = 0);
+	//copies the parameters, one shard at a time: the copy may mix shards updated with different gradients
+	void pullParameters(double* pOutput);
+
+	//copies the current parameters to the target parameters
+	void updateTarget();
+	//incremented with each updateTarget()
+	size_t getTargetVersion() const { return m_targetVersion.load(); }
+	//copies the target parameters and returns their version
+	size_t pullTargetParameters(double* pOutput);
+
+	//the parameters, the target parameters and the state of the learner of every shard. Loading requires the same number of
+	//parameters and shards
+	void saveCheckpoint(CheckpointWriter& writer);
+	bool loadCheckpoint(const CheckpointReader& reader);
+};
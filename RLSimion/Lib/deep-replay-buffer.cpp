@@ -0,0 +1,231 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "deep-replay-buffer.h"
+#include "deep-minibatch.h"
+#include "deep-functions.h"
+#include "config.h"
+#include "logger.h"
+#include "../Common/named-var-set.h"
+#include <algorithm>
+#include <string.h>
+
+DeepReplayBuffer::DeepReplayBuffer(ConfigNode* pConfigNode)
+{
+	m_bufferSize = INT_PARAM(pConfigNode, "Buffer-Size", "Number of tuples kept in the buffer. Minibatches are drawn from them", 100000);
+	m_replayRatio = DOUBLE_PARAM(pConfigNode, "Replay-Ratio", "Number of minibatch updates per environment step (i.e., 0.25 updates once every 4 steps)", 1.0);
+	m_minNumTuples = INT_PARAM(pConfigNode, "Min-Tuples", "Number of tuples stored before the first update", 1000);
+}
+
+DeepReplayBuffer::DeepReplayBuffer()
+{
+	//default behaviour when the replay buffer is not used: minibatches are filled with consecutive tuples
+	m_bufferSize.set(0);
+	m_replayRatio.set(0.0);
+	m_minNumTuples.set(0);
+}
+
+DeepReplayBuffer::DeepReplayBuffer(size_t bufferSize, double replayRatio, size_t minNumTuples)
+{
+	m_bufferSize.set((int)bufferSize);
+	m_replayRatio.set(replayRatio);
+	m_minNumTuples.set((int)minNumTuples);
+}
+
+DeepReplayBuffer::~DeepReplayBuffer()
+{
+	stopSamplerThread();
+
+	for (size_t i = 0; i < 2; i++)
+	{
+		for (DeepMinibatch* pMinibatch : m_minibatches[i])
+			delete pMinibatch;
+	}
+}
+
+void DeepReplayBuffer::stopSamplerThread()
+{
+	if (m_samplerThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bExit = true;
+		}
+		m_nextMinibatchesUsed.notify_one();
+		m_samplerThread.join();
+	}
+}
+
+/// <summary>
+/// Returns whether the replay buffer is enabled or not
+/// </summary>
+bool DeepReplayBuffer::bUsing() const
+{
+	return m_bufferSize.get() > 0;
+}
+
+/// <summary>
+/// Allocates the buffer and the minibatches
+/// </summary>
+/// <param name="definitions">Definitions of the networks trained with the minibatches, which give the variables stored</param>
+/// <param name="minibatchSize">Number of tuples in each minibatch</param>
+void DeepReplayBuffer::initialize(const vector<DeepNetworkDefinition*>& definitions, size_t minibatchSize)
+{
+	if (!bUsing()) return;
+
+	size_t bufferSize = (size_t)m_bufferSize.get();
+	m_stores = vector<Store>(definitions.size());
+	for (size_t i = 0; i < definitions.size(); i++)
+	{
+		Store& store = m_stores[i];
+		store.pDefinition = definitions[i];
+		store.numStateValues = definitions[i]->getInputStateVariables().size();
+		store.numActionValues = definitions[i]->getUsedActionVariables().size();
+		store.s = vector<double>(bufferSize * store.numStateValues);
+		store.a = vector<double>(bufferSize * store.numActionValues);
+		store.s_p = vector<double>(bufferSize * store.numStateValues);
+	}
+	m_r = vector<double>(bufferSize);
+	m_numTuples = 0;
+	m_nextPosition = 0;
+
+	m_minibatchSize = minibatchSize;
+	for (size_t i = 0; i < 2; i++)
+	{
+		for (DeepNetworkDefinition* pDefinition : definitions)
+			m_minibatches[i].push_back(new DeepMinibatch(minibatchSize, pDefinition));
+	}
+
+	//seeded with rand() so that the experiment's random seed also determines the tuples drawn
+	m_randomGenerator.seed((unsigned int)rand());
+
+	if (m_minNumTuples.get() > m_bufferSize.get())
+		Logger::logMessage(MessageType::Warning, "Replay buffer: Min-Tuples is greater than Buffer-Size. Updates will start once the buffer is full");
+}
+
+/// <summary>
+/// Stores a tuple, overwriting the oldest one if the buffer is full
+/// </summary>
+void DeepReplayBuffer::addTuple(const State* s, const Action* a, const State* s_p, double r)
+{
+	if (!bUsing() || m_stores.empty()) return;
+
+	std::lock_guard<std::mutex> lock(m_storeMutex);
+	for (Store& store : m_stores)
+	{
+		store.pDefinition->stateToVector(s, store.s, m_nextPosition);
+		store.pDefinition->actionToVector(a, store.a, m_nextPosition);
+		store.pDefinition->stateToVector(s_p, store.s_p, m_nextPosition);
+	}
+	m_r[m_nextPosition] = r;
+
+	m_nextPosition = (m_nextPosition + 1) % m_r.size();
+	m_numTuples = std::min(m_numTuples + 1, m_r.size());
+}
+
+/// <summary>
+/// Accumulates Replay-Ratio updates for the last environment step and returns how many of them are due, so that fractional
+/// ratios update once every few steps
+/// </summary>
+size_t DeepReplayBuffer::getNumUpdatesDue()
+{
+	size_t minNumTuples = std::max(m_minibatchSize, (size_t)std::max(0, m_minNumTuples.get()));
+	if (!bUsing() || m_numTuples < std::min(minNumTuples, m_r.size()))
+		return 0;
+
+	m_pendingUpdates += m_replayRatio.get();
+	size_t numUpdates = (size_t)m_pendingUpdates;
+	m_pendingUpdates -= (double)numUpdates;
+	return numUpdates;
+}
+
+/// <summary>
+/// Fills the minibatches with the same random tuples (drawn uniformly, with replacement)
+/// </summary>
+void DeepReplayBuffer::fillMinibatches(vector<DeepMinibatch*>& minibatches)
+{
+	std::lock_guard<std::mutex> lock(m_storeMutex);
+	std::uniform_int_distribution<size_t> distribution(0, m_numTuples - 1);
+	for (size_t i = 0; i < m_minibatchSize; i++)
+	{
+		size_t tuple = distribution(m_randomGenerator);
+		for (size_t j = 0; j < m_stores.size(); j++)
+		{
+			const Store& store = m_stores[j];
+			DeepMinibatch* pMinibatch = minibatches[j];
+			memcpy(&pMinibatch->s()[i * store.numStateValues], &store.s[tuple * store.numStateValues], store.numStateValues * sizeof(double));
+			if (store.numActionValues > 0) //V-functions have no input action
+				memcpy(&pMinibatch->a()[i * store.numActionValues], &store.a[tuple * store.numActionValues], store.numActionValues * sizeof(double));
+			memcpy(&pMinibatch->s_p()[i * store.numStateValues], &store.s_p[tuple * store.numStateValues], store.numStateValues * sizeof(double));
+			pMinibatch->r()[i] = m_r[tuple];
+		}
+	}
+	for (DeepMinibatch* pMinibatch : minibatches)
+		pMinibatch->setNumTuples(m_minibatchSize);
+}
+
+/// <summary>
+/// Fills the minibatches that aren't being trained and waits until the learner starts using them to fill the other ones
+/// </summary>
+void DeepReplayBuffer::samplerThreadLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_bExit)
+	{
+		vector<DeepMinibatch*>& minibatches = m_minibatches[1 - m_currentMinibatches];
+		lock.unlock();
+		fillMinibatches(minibatches);
+		lock.lock();
+
+		m_bNextMinibatchesReady = true;
+		m_nextMinibatchesReady.notify_one();
+		m_nextMinibatchesUsed.wait(lock, [this] { return m_bExit || !m_bNextMinibatchesReady; });
+	}
+}
+
+/// <summary>
+/// Returns the minibatches filled by the sampler thread and lets it fill the ones returned by the previous call. It only waits
+/// if the sampler hasn't finished filling them. The tuples drawn may not include those added since the sampler filled them
+/// </summary>
+const vector<DeepMinibatch*>& DeepReplayBuffer::nextMinibatches()
+{
+	if (!m_samplerThread.joinable())
+	{
+		//first call: fill the first minibatches here and start sampling the next ones
+		m_currentMinibatches = 0;
+		fillMinibatches(m_minibatches[0]);
+		m_samplerThread = std::thread(&DeepReplayBuffer::samplerThreadLoop, this);
+		return m_minibatches[0];
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_nextMinibatchesReady.wait(lock, [this] { return m_bNextMinibatchesReady; });
+		m_currentMinibatches = 1 - m_currentMinibatches;
+		m_bNextMinibatchesReady = false;
+	}
+	m_nextMinibatchesUsed.notify_one();
+	return m_minibatches[m_currentMinibatches];
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "parameters.h"
+#include <vector>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+class ConfigNode;
+class NamedVarSet;
+typedef NamedVarSet State;
+typedef NamedVarSet Action;
+class DeepMinibatch;
+class DeepNetworkDefinition;
+
+//Replay buffer of the deep learners (DQN, DDPG). Tuples are stored already normalized, with the layout of the minibatches of
+//each of the network definitions given (DDPG has two: the actor's and the critic's), so a minibatch is assembled copying rows.
+//Minibatches of tuples drawn uniformly from the buffer are assembled by a background thread, one minibatch ahead of the one
+//being trained, and the learner runs Replay-Ratio updates per environment step
+class DeepReplayBuffer
+{
+	INT_PARAM m_bufferSize;
+	DOUBLE_PARAM m_replayRatio;
+	INT_PARAM m_minNumTuples;
+
+	//one store per network definition, all of them with the same tuples in the same positions
+	struct Store
+	{
+		DeepNetworkDefinition* pDefinition = nullptr;
+		size_t numStateValues = 0;
+		size_t numActionValues = 0;
+		vector<double> s;
+		vector<double> a;
+		vector<double> s_p;
+	};
+	vector<Store> m_stores;
+	vector<double> m_r;
+	size_t m_numTuples = 0;
+	size_t m_nextPosition = 0;
+	//guards the stores: tuples are added from the main thread while the sampler copies them
+	std::mutex m_storeMutex;
+
+	double m_pendingUpdates = 0.0;
+
+	//only used from the sampler thread once it has been started
+	std::mt19937 m_randomGenerator;
+
+	//two sets of minibatches (one per network definition): the one being trained and the one being filled by the sampler
+	size_t m_minibatchSize = 0;
+	vector<DeepMinibatch*> m_minibatches[2];
+	size_t m_currentMinibatches = 0;
+	bool m_bNextMinibatchesReady = false;
+	bool m_bExit = false;
+	std::thread m_samplerThread;
+	std::mutex m_mutex;
+	std::condition_variable m_nextMinibatchesReady;
+	std::condition_variable m_nextMinibatchesUsed;
+
+	void fillMinibatches(vector<DeepMinibatch*>& minibatches);
+	void samplerThreadLoop();
+	void stopSamplerThread();
+public:
+	DeepReplayBuffer(ConfigNode* pConfigNode);
+	DeepReplayBuffer();
+	//used without a config file
+	DeepReplayBuffer(size_t bufferSize, double replayRatio, size_t minNumTuples);
+	~DeepReplayBuffer();
+
+	bool bUsing() const;
+
+	//must be called before adding tuples, with the definitions of the networks trained with the minibatches
+	void initialize(const vector<DeepNetworkDefinition*>& definitions, size_t minibatchSize);
+
+	void addTuple(const State* s, const Action* a, const State* s_p, double r);
+	size_t getNumTuples() const { return m_numTuples; }
+
+	//number of updates to be done after the last tuple added (0 until there are enough tuples in the buffer)
+	size_t getNumUpdatesDue();
+	//minibatches of random tuples to train, in the same order as the definitions given to initialize()
+	const vector<DeepMinibatch*>& nextMinibatches();
+};
@@ -38,5 +38,10 @@ DeferredLoad::DeferredLoad(unsigned int loadOrder)
 	SimGod::registerDeferredLoadStep(this,loadOrder);
 }
 
+/// <summary>
+/// Destroyed objects are removed from the list, so that another app can be created in the same process (i.e., in tests)
+/// </summary>
 DeferredLoad::~DeferredLoad()
-{}
\ No newline at end of file
+{
+	SimGod::unregisterDeferredLoadStep(this);
+}
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include "logger.h"
 #include "worlds/world.h"
 #include "stats.h"
+#include "checkpoint.h"
 #include "../../tools/System/Timer.h"
 #include "../../tools/System/CrossPlatform.h"
 #include "app.h"
@@ -45,6 +46,8 @@ bool ExperimentTime::operator==(ExperimentTime& exp)
 	return m_step == exp.m_step && m_episodeIndex == exp.m_episodeIndex;
 }
 
+thread_local bool* Experiment::m_pThreadTerminalState = nullptr;
+
 /// <summary>
 /// Returns the progress of the experiment (normalized in range [0,1])
 /// </summary>
@@ -117,6 +120,7 @@ void Experiment::setNumSteps(int numSteps)
 /// </summary>
 bool Experiment::isEvaluationEpisode()
 {
+	if (m_pThreadTerminalState) return false;
 	if (m_evalFreq.get() > 0)
 	{
 		unsigned int episodeInEvalTrainingCycle = (m_episodeIndex - 1)
@@ -181,6 +185,7 @@ void Experiment::reset()
 	m_trainingEpisodeIndex = 0; //[1..m_numTrainingEpisodes]
 	m_evalEpisodeIndex = 0; //[1..1+m_numTrainingEpisodes/ evalFreq]
 	m_episodeIndex = 0; //[1..g_numEpisodes]
+	m_firstEpisodeIndex = 1;
 	m_step = 0; //]1..g_numStepsPerEpisode]
 	m_experimentStep = 0;
 	m_bTerminalState = false;
@@ -264,11 +269,12 @@ void Experiment::nextEpisode()
 }
 
 /// <summary>
-/// Is this the first episode?
+/// Is this the first episode run? If the experiment was resumed from a checkpoint, the logger is initialized in the first
+/// episode after the checkpoint's
 /// </summary>
 bool Experiment::isFirstEpisode()
 {
-	return m_episodeIndex == 1;
+	return m_episodeIndex == m_firstEpisodeIndex;
 }
 
 /// <summary>
@@ -358,4 +364,37 @@ void Experiment::incNumUpdateSteps()
 unsigned int Experiment::getNumUpdateSteps()
 {
 	return m_numUpdates;
-}
\ No newline at end of file
+}
+
+/// <summary>
+/// Saves the position of the experiment (episode and step counters) to a checkpoint
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void Experiment::saveCheckpoint(CheckpointWriter& writer)
+{
+	writer.add("indices", { (double)m_episodeIndex, (double)m_trainingEpisodeIndex, (double)m_evalEpisodeIndex
+		, (double)m_experimentStep, (double)m_numUpdates });
+}
+
+/// <summary>
+/// Resumes the experiment from the position saved in a checkpoint. The next episode will be the one after the episode
+/// in which the checkpoint was saved, and the first one run (and logged) by this process
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+/// <returns>False if the checkpoint has no position of the experiment</returns>
+bool Experiment::loadCheckpoint(const CheckpointReader& reader)
+{
+	vector<double> indices(5);
+	if (!reader.read("indices", indices))
+	{
+		Logger::logMessage(MessageType::Warning, "The checkpoint has no position of the experiment. It will start from the first episode");
+		return false;
+	}
+	m_episodeIndex = (unsigned int)indices[0];
+	m_trainingEpisodeIndex = (unsigned int)indices[1];
+	m_evalEpisodeIndex = (unsigned int)indices[2];
+	m_experimentStep = (unsigned int)indices[3];
+	m_numUpdates = (unsigned int)indices[4];
+	m_firstEpisodeIndex = m_episodeIndex + 1;
+	return true;
+}
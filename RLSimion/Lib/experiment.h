@@ -6,6 +6,8 @@ typedef NamedVarSet Action;
 typedef NamedVarSet Reward;
 class ConfigNode;
 class Timer;
+class CheckpointWriter;
+class CheckpointReader;
 
 #define MAX_PROGRESS_MSG_LEN 1024
 
@@ -31,6 +33,8 @@ class Experiment
 	unsigned int m_step; //]1..g_numStepsPerEpisode]
 	unsigned int m_trainingEpisodeIndex; //[1..m_numTrainingEpisodes]
 	unsigned int m_evalEpisodeIndex; //[1..1+m_numTrainingEpisodes/ evalFreq]
+	//the first episode run by this process: the one after the checkpoint's if the experiment was resumed
+	unsigned int m_firstEpisodeIndex = 1;
 
 	INT_PARAM m_randomSeed;
 
@@ -46,6 +50,9 @@ class Experiment
 	unsigned int m_numSteps= 0;
 	unsigned int m_experimentStep= 0;
 	bool m_bTerminalState;
+	//actor-learner threads that simulate episodes with their own copy of the dynamic model (AsyncQLearning) redirect the
+	//terminal state set by the reward functions to a flag of their own. Their episodes are always training episodes
+	static thread_local bool* m_pThreadTerminalState;
 
 	unsigned int m_numUpdates = 0;
 
@@ -67,7 +74,9 @@ public:
 	unsigned int getStep(){ return m_step; }
 	bool isFirstStep(){ return m_step == 1; }
 	bool isLastStep(){ return (m_bTerminalState || m_step == m_numSteps); }
-	void setTerminalState(){ m_bTerminalState = true; }
+	void setTerminalState(){ if (m_pThreadTerminalState) *m_pThreadTerminalState = true; else m_bTerminalState = true; }
+	//called from an actor-learner thread with its own terminal state flag
+	static void setThreadTerminalState(bool* pTerminalState) { m_pThreadTerminalState = pTerminalState; }
 	void nextStep();
 
 	//EPISODES
@@ -82,6 +91,7 @@ public:
 	unsigned int getEpisodeInEvaluationIndex();
 	void nextEpisode();
 	//true if is the first evaluation episode or the first training episode
+	//true in the first episode run by this process, which isn't the first one if the experiment was resumed
 	bool isFirstEpisode();
 	//true if is the last evaluation episode or the last training episode
 	bool isLastEpisode();
@@ -100,6 +110,7 @@ public:
 	unsigned int getNumSteps(){ return m_numSteps; }
 	void setNumSteps(int numSteps);
 	unsigned int getExperimentStep() { return m_experimentStep; } //returns the current step since the experiment began
+	int getRandomSeed() { return m_randomSeed.get(); }
 	
 	void incNumUpdateSteps();
 	unsigned int getNumUpdateSteps();
@@ -112,4 +123,8 @@ public:
 	const char* getProgressString();
 
 	void timestep(State *s, Action *a,State *s_p, Reward* pReward);
+
+	//the position of the experiment is saved in checkpoints to resume interrupted experiments
+	void saveCheckpoint(CheckpointWriter& writer);
+	bool loadCheckpoint(const CheckpointReader& reader);
 };
\ No newline at end of file
@@ -32,6 +32,7 @@
 
 FunctionSampler::~FunctionSampler()
 {
+	delete m_pSnapshot;
 	delete m_pState;
 	delete m_pAction;
 }
@@ -65,6 +66,97 @@ FunctionSampler::FunctionSampler(string functionId, StateActionFunction* pFuncti
 
 	for (int i = 0; i < (int) m_pAction->getNumVars(); ++i)
 		m_pAction->set(i, m_pAction->getDescriptor()[i].getMin() + m_pAction->getDescriptor()[i].getRangeWidth()*0.5);
+
+	//the inputs that are not sampled keep those values in every sample
+	for (const string& varName : pFunction->getInputStateVariables())
+		m_stateInputs.push_back(vector<double>(m_numSamples, m_pState->get(varName.c_str())));
+	for (const string& varName : pFunction->getInputActionVariables())
+		m_actionInputs.push_back(vector<double>(m_numSamples, m_pAction->get(varName.c_str())));
+	for (const vector<double>& input : m_stateInputs)
+		m_pStateInputs.push_back(input.data());
+	for (const vector<double>& input : m_actionInputs)
+		m_pActionInputs.push_back(input.data());
+
+	m_outputs = vector<double>(m_numSamples * m_numOutputs);
+	m_snapshotOutputs = vector<double>(m_numSamples * m_numOutputs);
+	m_snapshotSampledValues = vector<double>(m_numSamples);
+}
+
+/// <summary>
+/// Sets the values of a sampled variable in the inputs of the function
+/// </summary>
+/// <param name="source">Whether it is a state or an action variable</param>
+/// <param name="varName">Name of the variable</param>
+/// <param name="stride">Number of consecutive samples that share the same value of this variable</param>
+void FunctionSampler::setSampledVariable(VariableSource source, const string& varName, size_t stride)
+{
+	const vector<string>& inputs = (source == StateSource) ? m_pFunction->getInputStateVariables() : m_pFunction->getInputActionVariables();
+	vector<vector<double>>& inputValues = (source == StateSource) ? m_stateInputs : m_actionInputs;
+
+	NamedVarProperties* pProperties = Source(source)->getProperties(varName.c_str());
+	double minValue = pProperties->getMin();
+	double rangeStep = pProperties->getRangeWidth() / (double)(m_samplesPerDimension - 1);
+
+	for (size_t input = 0; input < inputs.size(); ++input)
+	{
+		if (inputs[input] != varName)
+			continue;
+		for (size_t sample = 0; sample < m_numSamples; ++sample)
+			inputValues[input][sample] = minValue + rangeStep * (double)((sample / stride) % m_samplesPerDimension);
+	}
+}
+
+/// <summary>
+/// Copies the sampled output from the outputs of a batch evaluation
+/// </summary>
+void FunctionSampler::getOutput(const vector<double>& outputs, vector<double>& outSampledValues) const
+{
+	for (size_t sample = 0; sample < m_numSamples; ++sample)
+		outSampledValues[sample] = outputs[sample * m_numOutputs + m_outputIndex];
+}
+
+/// <summary>
+/// Samples the function and returns a vector with all the samples
+/// </summary>
+/// <returns>A vector with getNumSamplesX()*getNumSamplesY() samples from the function</returns>
+const vector<double>& FunctionSampler::sample()
+{
+	m_pFunction->evaluateBatch(m_pStateInputs.data(), m_pActionInputs.data(), m_numSamples, m_pState, m_pAction, m_outputs.data());
+	getOutput(m_outputs, m_sampledValues);
+	return m_sampledValues;
+}
+
+/// <summary>
+/// Copies the current parameters of the function so that sampleSnapshot() can be called from another thread. The snapshot is
+/// created the first time it is called. Must be called from the thread that updates the function
+/// </summary>
+/// <returns>False if the function doesn't support snapshots</returns>
+bool FunctionSampler::takeSnapshot()
+{
+	if (!m_bSnapshotsSupported)
+		return false;
+	if (!m_pSnapshot)
+	{
+		m_pSnapshot = m_pFunction->createSnapshot(m_pStateInputs.data(), m_pActionInputs.data(), m_numSamples, m_pState, m_pAction);
+		if (!m_pSnapshot)
+		{
+			m_bSnapshotsSupported = false;
+			return false;
+		}
+	}
+	m_pSnapshot->update();
+	return true;
+}
+
+/// <summary>
+/// Samples the function using the parameters copied by the last call to takeSnapshot()
+/// </summary>
+/// <returns>A vector with getNumSamplesX()*getNumSamplesY() samples from the function</returns>
+const vector<double>& FunctionSampler::sampleSnapshot()
+{
+	m_pSnapshot->evaluate(m_snapshotOutputs.data());
+	getOutput(m_snapshotOutputs, m_snapshotSampledValues);
+	return m_snapshotSampledValues;
 }
 
 /// <summary>
@@ -105,86 +197,22 @@ FunctionSampler3D::FunctionSampler3D(string functionId, StateActionFunction* pFu
 	:FunctionSampler(functionId, pFunction, outputIndex, samplesPerDimension, 2, stateDescriptor, actionDescriptor)
 	, m_xVarName(xVarName), m_yVarName(yVarName)
 {
-	m_xVarSource = Source(xVarSource);
-	m_yVarSource = Source(yVarSource);
+	//samples are stored by rows: x changes in every sample, y every m_samplesPerDimension samples
+	setSampledVariable(xVarSource, xVarName, 1);
+	setSampledVariable(yVarSource, yVarName, m_samplesPerDimension);
 }
 
 
-/// <summary>
-/// Samples the function and returns a vector with all the samples
-/// </summary>
-/// <param name="outputIndex">Index of the output (the sampler may have more than one output)</param>
-/// <returns>A vector with getNumSamplesX()*getNumSamplesY() samples from the function</returns>
-const vector<double>& FunctionSampler3D::sample()
-{
-	double xValue, yValue;
-	double xMinValue, xRangeStep, xRange;
-	NamedVarProperties* pXProperties = m_xVarSource->getProperties(m_xVarName.c_str());// m_sampledVariableSources[0]->getProperties(m_sampledVariableNames[0].c_str());
-	xMinValue = pXProperties->getMin();
-	xRange = pXProperties->getRangeWidth();
-	xRangeStep = xRange / (double)(m_samplesPerDimension - 1);
-	double yMinValue, yRangeStep, yRange;
-	NamedVarProperties* pYProperties = m_yVarSource->getProperties(m_yVarName.c_str());// m_sampledVariableSources[1]->getProperties(m_sampledVariableNames[1].c_str());
-	yMinValue = pYProperties->getMin();
-	yRange = pYProperties->getRangeWidth();
-	yRangeStep = yRange / (double)(m_samplesPerDimension - 1);
-	
-	unsigned int i = 0;
-	for (unsigned int y = 0; y < m_samplesPerDimension; ++y)
-	{
-		yValue = yMinValue + yRangeStep * (double)y;
-		m_yVarSource->set(m_yVarName.c_str(), yValue);// m_sampledVariableSources[1]->set(m_sampledVariableNames[1].c_str(), yValue);
-		for (unsigned int x = 0; x < m_samplesPerDimension; ++x)
-		{
-			xValue = xMinValue + xRangeStep * (double)x;
-			m_xVarSource->set(m_xVarName.c_str(), xValue);// m_sampledVariableSources[0]->set(m_sampledVariableNames[0].c_str(), xValue);
-			vector<double>& output= m_pFunction->evaluate(m_pState, m_pAction);
-
-			m_sampledValues[i] = output[m_outputIndex];
-			++i;
-		}
-	}
-	return m_sampledValues;
-}
-
 FunctionSampler2D::FunctionSampler2D(string functionId, StateActionFunction* pFunction, size_t outputIndex, size_t samplesPerDimension
 	, Descriptor& stateDescriptor, Descriptor& actionDescriptor
 	, VariableSource xVarSource, string xVarName)
 	:FunctionSampler(functionId, pFunction, outputIndex, samplesPerDimension, 1, stateDescriptor, actionDescriptor)
 	, m_xVarName(xVarName)
 {
-	m_xVarSource = Source(xVarSource);
+	setSampledVariable(xVarSource, xVarName, 1);
 }
 
 
-/// <summary>
-/// Samples the function and returns a vector with all the samples
-/// </summary>
-/// <param name="outputIndex">Output index (the sampler may have more than one output)</param>
-/// <returns>A vector with getNumSamplesX() samples from the function</returns>
-const vector<double>& FunctionSampler2D::sample()
-{
-	double xValue, xMinValue, xRangeStep, xRange;
-	NamedVarProperties* pXProperties = m_xVarSource->getProperties(m_xVarName.c_str());
-	xMinValue = pXProperties->getMin();
-	xRange = pXProperties->getRangeWidth();
-	xRangeStep = xRange / (double)(m_samplesPerDimension - 1);
-
-
-	unsigned int i = 0;
-	for (unsigned int x = 0; x < m_samplesPerDimension; ++x)
-	{
-		xValue = xMinValue + xRangeStep * (double)x;
-		m_xVarSource->set(m_xVarName.c_str(), xValue);
-
-		vector<double>& output = m_pFunction->evaluate(m_pState, m_pAction);
-
-		m_sampledValues[i] = output[m_outputIndex];
-		++i;
-	}
-	return m_sampledValues;
-}
-
 /// <summary>
 /// Returns the name of the function
 /// </summary>
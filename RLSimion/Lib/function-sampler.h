@@ -4,6 +4,7 @@
 using namespace std;
 
 class StateActionFunction;
+class StateActionFunctionSnapshot;
 class NamedVarSet;
 using State = NamedVarSet;
 using Action = NamedVarSet;
@@ -26,14 +27,39 @@ protected:
 	size_t m_numOutputs;
 	string m_functionId;
 
+	//inputs of the function in every sample, as structures of arrays (see StateActionFunction::evaluateBatch())
+	vector<vector<double>> m_stateInputs;
+	vector<vector<double>> m_actionInputs;
+	vector<const double*> m_pStateInputs;
+	vector<const double*> m_pActionInputs;
+	vector<double> m_outputs;
+
+	//snapshots are sampled from another thread, so they have their own buffers
+	StateActionFunctionSnapshot* m_pSnapshot = nullptr;
+	bool m_bSnapshotsSupported = true;
+	vector<double> m_snapshotOutputs;
+	vector<double> m_snapshotSampledValues;
+
 	NamedVarSet* Source(VariableSource source);
+
+	//sets the values of a sampled variable in the inputs: the i-th value in its range is used in the samples where
+	//(sample / stride) % m_samplesPerDimension == i
+	void setSampledVariable(VariableSource source, const string& varName, size_t stride);
+	void getOutput(const vector<double>& outputs, vector<double>& outSampledValues) const;
 public:
 	FunctionSampler(string functionId, StateActionFunction* pFunction, size_t outputIndex, size_t samplesPerDimension, size_t numDimensions
 		, Descriptor& stateDescriptor, Descriptor& actionDescriptor);
 	virtual ~FunctionSampler();
 
 	size_t getNumOutputs() const;
-	virtual const vector<double>& sample() = 0;
+	//Samples the function and returns a vector with all the samples
+	const vector<double>& sample();
+
+	//Copies the current parameters of the function, so that sampleSnapshot() can be called from another thread while the
+	//function keeps learning. Returns false if the function doesn't support snapshots: then, sample() has to be used
+	bool takeSnapshot();
+	//Samples the function with the parameters copied by the last call to takeSnapshot()
+	const vector<double>& sampleSnapshot();
 
 	virtual string getFunctionId() const = 0;
 	virtual size_t getNumSamplesX() = 0;
@@ -42,16 +68,12 @@ public:
 
 class FunctionSampler3D : public FunctionSampler
 {
-	NamedVarSet* m_xVarSource;
 	string m_xVarName;
-	NamedVarSet* m_yVarSource;
 	string m_yVarName;
 public:
 	FunctionSampler3D(string functionId, StateActionFunction* pFunction, size_t outputIndex, size_t samplesPerDimension
 		, Descriptor& stateDescriptor, Descriptor& actionDescriptor
 		, VariableSource xVarSource, string xVarName, VariableSource yVarSource, string yVarName);
-	
-	const vector<double>& sample();
 
 	string getFunctionId() const;
 	size_t getNumSamplesX();
@@ -60,14 +82,11 @@ public:
 
 class FunctionSampler2D : public FunctionSampler
 {
-	NamedVarSet* m_xVarSource;
 	string m_xVarName;
 public:
 	FunctionSampler2D(string functionId, StateActionFunction* pFunction, size_t outputIndex, size_t samplesPerDimension
 		, Descriptor& stateDescriptor, Descriptor& actionDescriptor, VariableSource xVarSource, string xVarName);
 
-	const vector<double>& sample();
-
 	string getFunctionId() const;
 	size_t getNumSamplesX();
 	size_t getNumSamplesY();
@@ -0,0 +1,405 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "log-sample-converter.h"
+#include "../Common/columnar-log.h"
+#include "../../3rd-party/tinyxml2/tinyxml2.h"
+#include "../../tools/System/FileUtils.h"
+#include "../../tools/System/CrossPlatform.h"
+#include "../../tools/System/MemoryMappedFile.h"
+#include <thread>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <string.h>
+
+using namespace tinyxml2;
+
+//headers of version 2 logs (see logger.cpp). Every header takes 16 64-bit values
+#define LOG_HEADER_SIZE (16 * sizeof(long long int))
+#define LOG_EXPERIMENT_HEADER 1
+#define LOG_EPISODE_HEADER 2
+#define LOG_STEP_HEADER 3
+#define LOG_EPISODE_END_HEADER 4
+
+/// <summary>
+/// Constructor
+/// </summary>
+/// <param name="filter">Episodes and steps from which samples are taken</param>
+/// <param name="numThreads">Number of logs converted at once. If 0, the number of cores is used</param>
+/// <param name="numSamplesPerBlock">Number of samples each thread keeps in memory before writing them to the output file</param>
+LogSampleConverter::LogSampleConverter(const LogSampleFilter& filter, size_t numThreads, size_t numSamplesPerBlock)
+	: m_filter(filter), m_numSamplesPerBlock(std::max((size_t)1, numSamplesPerBlock))
+{
+	m_numThreads = numThreads;
+	if (m_numThreads == 0)
+		m_numThreads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// <summary>
+/// Reads the descriptor of a log and adds it to the list of logs to be converted if its variables are the same as those
+/// of the first log added
+/// </summary>
+/// <param name="descriptorFilename">Log descriptor file</param>
+/// <returns>False if the descriptor can't be read or the variables don't match</returns>
+bool LogSampleConverter::addLog(const string& descriptorFilename)
+{
+	XMLDocument doc;
+	if (doc.LoadFile(descriptorFilename.c_str()) != XML_NO_ERROR)
+		return false;
+
+	XMLElement* pRoot = doc.FirstChildElement("ExperimentLogDescriptor");
+	if (pRoot == nullptr || pRoot->Attribute("BinaryDataFile") == nullptr)
+		return false;
+
+	LogInfo log;
+	log.descriptorFilename = descriptorFilename;
+	log.binaryFilename = getDirectory(descriptorFilename) + pRoot->Attribute("BinaryDataFile");
+
+	vector<string> stateVariables, actionVariables, rewardVariables;
+	for (XMLElement* pChild = pRoot->FirstChildElement(); pChild != nullptr; pChild = pChild->NextSiblingElement())
+	{
+		const char* name = pChild->GetText() != nullptr ? pChild->GetText() : "";
+		if (!strcmp(pChild->Name(), "State-variable")) stateVariables.push_back(name);
+		else if (!strcmp(pChild->Name(), "Action-variable")) actionVariables.push_back(name);
+		else if (!strcmp(pChild->Name(), "Reward-variable")) rewardVariables.push_back(name);
+		else if (strcmp(pChild->Name(), "Stat-variable")) continue;
+		log.numLoggedVariables++;
+	}
+	if (stateVariables.empty())
+		return false;
+
+	if (m_logs.empty())
+	{
+		m_stateVariables = stateVariables;
+		m_actionVariables = actionVariables;
+		m_rewardVariables = rewardVariables;
+	}
+	else if (stateVariables != m_stateVariables || actionVariables != m_actionVariables || rewardVariables != m_rewardVariables)
+		return false;
+
+	m_logs.push_back(log);
+	return true;
+}
+
+bool LogSampleConverter::isEpisodeTypeSelected(long long int episodeType) const
+{
+	//episodeType is 0 in evaluation episodes and 1 in training episodes
+	switch (m_filter.episodeTypes)
+	{
+	case LogEpisodeTypes::evaluation: return episodeType == 0;
+	case LogEpisodeTypes::training: return episodeType == 1;
+	case LogEpisodeTypes::all:
+	default: return true;
+	}
+}
+
+bool LogSampleConverter::isStepSelected(long long int stepIndex) const
+{
+	return stepIndex >= m_filter.firstStep && (m_filter.lastStep < 0 || stepIndex <= m_filter.lastStep);
+}
+
+/// <summary>
+/// Converts all the logs added and writes the sample file
+/// </summary>
+/// <param name="outputFilename">Sample file descriptor. The binary data file is named after it (adding ".bin")</param>
+/// <param name="bWriteShuffleFile">Whether a random permutation of the samples is written too (adding ".shuffle.bin")</param>
+/// <param name="seed">Seed used to shuffle the samples</param>
+/// <returns>False if no sample is written</returns>
+bool LogSampleConverter::convert(const string& outputFilename, bool bWriteShuffleFile, unsigned int seed)
+{
+	string binaryFilename = outputFilename + ".bin";
+	string shuffleFilename = bWriteShuffleFile ? outputFilename + ".shuffle.bin" : "";
+
+	m_numSamplesWritten = 0;
+	m_numDuplicatesRemoved = 0;
+	m_numLogsConverted = 0;
+	m_sampleHashes.clear();
+	if (m_logs.empty())
+		return false;
+
+	CrossPlatform::Fopen_s(&m_pOutputFile, binaryFilename.c_str(), "wb");
+	if (m_pOutputFile == nullptr)
+		return false;
+
+	m_nextLog = 0;
+	vector<thread> workers;
+	size_t numThreads = std::min(m_numThreads, m_logs.size());
+	for (size_t i = 1; i < numThreads; i++)
+		workers.push_back(thread(&LogSampleConverter::workerThread, this));
+	workerThread();
+	for (thread& worker : workers)
+		worker.join();
+
+	fclose(m_pOutputFile);
+	m_pOutputFile = nullptr;
+	m_sampleHashes.clear();
+
+	if (m_numSamplesWritten == 0)
+		return false;
+	if (bWriteShuffleFile && !writeShuffleFile(shuffleFilename, seed))
+		shuffleFilename = "";
+	return writeDescriptor(outputFilename, binaryFilename, shuffleFilename);
+}
+
+/// <summary>
+/// Converts logs until there are none left. Each thread has its own block of samples, which is written to the output file
+/// when it is full
+/// </summary>
+void LogSampleConverter::workerThread()
+{
+	vector<double> samples;
+	samples.reserve(m_numSamplesPerBlock * getNumElementsPerSample());
+
+	size_t logIndex;
+	while ((logIndex = m_nextLog++) < m_logs.size())
+	{
+		if (convertLog(m_logs[logIndex], samples))
+		{
+			lock_guard<mutex> lock(m_outputMutex);
+			m_numLogsConverted++;
+		}
+	}
+	flushSamples(samples);
+}
+
+bool LogSampleConverter::convertLog(const LogInfo& log, vector<double>& samples)
+{
+	switch (ColumnarLogReader::getFileVersion(log.binaryFilename.c_str()))
+	{
+	case 2: return convertVersion2Log(log, samples);
+	case COLUMNAR_LOG_FILE_VERSION: return convertVersion3Log(log, samples);
+	default: return false;
+	}
+}
+
+/// <summary>
+/// Reads a version 2 log sequentially. The file is mapped in memory, so only the pages being read need to be in memory
+/// </summary>
+bool LogSampleConverter::convertVersion2Log(const LogInfo& log, vector<double>& samples)
+{
+	MemoryMappedFile file;
+	if (!file.open(log.binaryFilename.c_str()))
+		return false;
+	file.setAccessPattern(MemoryMappedFile::Sequential);
+
+	const char* pData = file.getData();
+	const size_t size = file.getSize();
+	const size_t numSampleVariables = m_stateVariables.size() + m_actionVariables.size() + m_rewardVariables.size();
+
+	size_t offset = LOG_HEADER_SIZE; //experiment header
+	size_t numVariables = 0;
+	bool bEpisodeSelected = false;
+	const double* pPrevStep = nullptr;
+	long long int prevStepIndex = 0;
+	while (offset + LOG_HEADER_SIZE <= size)
+	{
+		long long int header[LOG_HEADER_SIZE / sizeof(long long int)];
+		memcpy(header, pData + offset, LOG_HEADER_SIZE);
+		offset += LOG_HEADER_SIZE;
+
+		if (header[0] == LOG_EPISODE_HEADER)
+		{
+			//episodeType, episodeIndex, numVariablesLogged, episodeSubIndex
+			numVariables = (size_t)header[3];
+			bEpisodeSelected = isEpisodeTypeSelected(header[1]) && numVariables >= numSampleVariables;
+			pPrevStep = nullptr;
+		}
+		else if (header[0] == LOG_STEP_HEADER)
+		{
+			if (offset + numVariables * sizeof(double) > size)
+				break; //the log was truncated
+			const double* pStep = (const double*)(pData + offset);
+			offset += numVariables * sizeof(double);
+			if (!bEpisodeSelected)
+				continue;
+
+			long long int stepIndex = header[1];
+			if (pPrevStep != nullptr && stepIndex == prevStepIndex + 1 && isStepSelected(stepIndex))
+				addSample(pPrevStep, pStep, samples);
+			pPrevStep = pStep;
+			prevStepIndex = stepIndex;
+		}
+		else if (header[0] == LOG_EPISODE_END_HEADER)
+			pPrevStep = nullptr;
+		else
+			break; //corrupt data
+	}
+	return true;
+}
+
+/// <summary>
+/// Reads a version 3 log one episode at a time. Only the columns of the state, action and reward variables are read
+/// </summary>
+bool LogSampleConverter::convertVersion3Log(const LogInfo& log, vector<double>& samples)
+{
+	ColumnarLogReader reader;
+	if (!reader.open(log.binaryFilename.c_str()))
+		return false;
+
+	const size_t numSampleVariables = m_stateVariables.size() + m_actionVariables.size() + m_rewardVariables.size();
+	vector<double> stepIndices, column, steps;
+	for (size_t episode = 0; episode < reader.getNumEpisodes(); episode++)
+	{
+		size_t numSteps = reader.getNumSteps(episode);
+		if (!isEpisodeTypeSelected(reader.getEpisodeInfo(episode).index.episodeType) || numSteps < 2
+			|| reader.getNumColumns(episode) < NumStepColumns + numSampleVariables)
+			continue;
+
+		//columns are transposed to rows with the same layout as the steps of version 2 logs
+		if (!reader.readColumn(episode, StepIndexColumn, stepIndices) || stepIndices.size() != numSteps)
+			continue;
+		steps.resize(numSteps * numSampleVariables);
+		bool bColumnsRead = true;
+		for (size_t var = 0; var < numSampleVariables && bColumnsRead; var++)
+		{
+			bColumnsRead = reader.readColumn(episode, NumStepColumns + var, column) && column.size() == numSteps;
+			for (size_t step = 0; step < numSteps && bColumnsRead; step++)
+				steps[step * numSampleVariables + var] = column[step];
+		}
+		if (!bColumnsRead)
+			continue;
+
+		for (size_t step = 1; step < numSteps; step++)
+		{
+			long long int stepIndex = (long long int)stepIndices[step];
+			if (stepIndex == (long long int)stepIndices[step - 1] + 1 && isStepSelected(stepIndex))
+				addSample(&steps[(step - 1) * numSampleVariables], &steps[step * numSampleVariables], samples);
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// Adds the sample <s,a,s',r> made from two consecutive steps to the thread's block of samples
+/// </summary>
+/// <param name="pPrevStep">Values logged in the previous step: s is taken from it</param>
+/// <param name="pStep">Values logged in the step: s', a and r are taken from it</param>
+void LogSampleConverter::addSample(const double* pPrevStep, const double* pStep, vector<double>& samples)
+{
+	const size_t numStateVariables = m_stateVariables.size();
+	const size_t numActionVariables = m_actionVariables.size();
+	const size_t numRewardVariables = m_rewardVariables.size();
+
+	samples.insert(samples.end(), pPrevStep, pPrevStep + numStateVariables);
+	samples.insert(samples.end(), pStep + numStateVariables, pStep + numStateVariables + numActionVariables);
+	samples.insert(samples.end(), pStep, pStep + numStateVariables);
+	samples.insert(samples.end(), pStep + numStateVariables + numActionVariables
+		, pStep + numStateVariables + numActionVariables + numRewardVariables);
+
+	if (samples.size() >= m_numSamplesPerBlock * getNumElementsPerSample())
+		flushSamples(samples);
+}
+
+/// <summary>
+/// Writes a block of samples to the output file and empties it. If duplicates are removed, samples already written
+/// (by any thread) are removed from the block first
+/// </summary>
+void LogSampleConverter::flushSamples(vector<double>& samples)
+{
+	const size_t numElementsPerSample = getNumElementsPerSample();
+	const size_t sampleSize = numElementsPerSample * sizeof(double);
+	size_t numSamples = samples.size() / numElementsPerSample;
+	if (numSamples == 0)
+		return;
+
+	//64-bit FNV-1a hashes of the samples, calculated before taking the lock
+	vector<unsigned long long int> hashes;
+	if (m_filter.bRemoveDuplicates)
+	{
+		hashes.resize(numSamples);
+		const unsigned char* pBytes = (const unsigned char*)samples.data();
+		for (size_t i = 0; i < numSamples; i++)
+		{
+			unsigned long long int hash = 14695981039346656037ull;
+			for (size_t byte = 0; byte < sampleSize; byte++)
+				hash = (hash ^ *pBytes++) * 1099511628211ull;
+			hashes[i] = hash;
+		}
+	}
+
+	lock_guard<mutex> lock(m_outputMutex);
+	if (m_filter.bRemoveDuplicates)
+	{
+		size_t numUniqueSamples = 0;
+		for (size_t i = 0; i < numSamples; i++)
+		{
+			if (!m_sampleHashes.insert(hashes[i]).second)
+				continue;
+			if (numUniqueSamples != i)
+				memcpy(&samples[numUniqueSamples * numElementsPerSample], &samples[i * numElementsPerSample], sampleSize);
+			numUniqueSamples++;
+		}
+		m_numDuplicatesRemoved += numSamples - numUniqueSamples;
+		numSamples = numUniqueSamples;
+	}
+	m_numSamplesWritten += fwrite(samples.data(), sampleSize, numSamples, m_pOutputFile);
+	samples.clear();
+}
+
+/// <summary>
+/// Writes a random permutation of the indices of the samples written
+/// </summary>
+bool LogSampleConverter::writeShuffleFile(const string& filename, unsigned int seed) const
+{
+	if (m_numSamplesWritten > 0xffffffffu)
+		return false;
+
+	vector<unsigned int> indices(m_numSamplesWritten);
+	std::iota(indices.begin(), indices.end(), 0);
+	std::shuffle(indices.begin(), indices.end(), std::mt19937(seed));
+
+	FILE* pFile;
+	CrossPlatform::Fopen_s(&pFile, filename.c_str(), "wb");
+	if (pFile == nullptr)
+		return false;
+	size_t numIndicesWritten = fwrite(indices.data(), sizeof(unsigned int), indices.size(), pFile);
+	fclose(pFile);
+	return numIndicesWritten == indices.size();
+}
+
+/// <summary>
+/// Writes the sample file descriptor. The data files are referenced relative to the descriptor
+/// </summary>
+bool LogSampleConverter::writeDescriptor(const string& filename, const string& binaryFilename, const string& shuffleFilename) const
+{
+	FILE* pFile;
+	CrossPlatform::Fopen_s(&pFile, filename.c_str(), "w");
+	if (pFile == nullptr)
+		return false;
+
+	//all the files are in the same directory
+	const size_t directoryLength = getDirectory(filename).size();
+	fprintf(pFile, "<SampleFileDescriptor BinaryDataFile=\"%s\" NumSamples=\"%zu\"", binaryFilename.substr(directoryLength).c_str(), m_numSamplesWritten);
+	if (!shuffleFilename.empty())
+		fprintf(pFile, " ShuffleFile=\"%s\"", shuffleFilename.substr(directoryLength).c_str());
+	fprintf(pFile, ">\n");
+	for (const string& variable : m_stateVariables) fprintf(pFile, "  <State-variable>%s</State-variable>\n", variable.c_str());
+	for (const string& variable : m_actionVariables) fprintf(pFile, "  <Action-variable>%s</Action-variable>\n", variable.c_str());
+	for (const string& variable : m_rewardVariables) fprintf(pFile, "  <Reward-variable>%s</Reward-variable>\n", variable.c_str());
+	fprintf(pFile, "</SampleFileDescriptor>\n");
+	fclose(pFile);
+	return true;
+}
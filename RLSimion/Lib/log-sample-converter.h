@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
+#include <stdio.h>
+using namespace std;
+
+//Types of episodes from which samples are taken
+enum class LogEpisodeTypes { all, evaluation, training };
+
+struct LogSampleFilter
+{
+	LogEpisodeTypes episodeTypes = LogEpisodeTypes::all;
+	//range of steps (within each episode) taken. Samples are taken from steps firstStep..lastStep. A negative lastStep
+	//means up to the end of the episode
+	long long int firstStep = 0;
+	long long int lastStep = -1;
+	//samples with exactly the same values as a previous one are not written
+	bool bRemoveDuplicates = false;
+};
+
+//Converts experiment logs (versions 2 and 3) to a sample file with tuples <s,a,s',r> that can be used for offline
+//training (see SampleFile). Logs are read by several threads at once, one episode at a time, and samples are written to
+//the output file in blocks, so memory use doesn't depend on the size of the logs (except for the hashes kept to remove
+//duplicates, 8 bytes per sample written).
+//Each step logged holds s', a and r, so a tuple is made from two consecutive steps: s from the first one and the rest
+//from the second one. Steps that aren't consecutive (i.e., the logger averaged several steps) don't make a tuple
+class LogSampleConverter
+{
+	//what a worker thread needs to know about a log
+	struct LogInfo
+	{
+		string descriptorFilename;
+		string binaryFilename;
+		size_t numLoggedVariables = 0; //state, action, reward and stat variables
+	};
+	vector<LogInfo> m_logs;
+	vector<string> m_stateVariables, m_actionVariables, m_rewardVariables;
+
+	LogSampleFilter m_filter;
+	size_t m_numThreads;
+	size_t m_numSamplesPerBlock;
+
+	//shared by the worker threads
+	atomic<size_t> m_nextLog;
+	mutex m_outputMutex;
+	FILE* m_pOutputFile = nullptr;
+	size_t m_numSamplesWritten = 0;
+	size_t m_numDuplicatesRemoved = 0;
+	size_t m_numLogsConverted = 0;
+	unordered_set<unsigned long long int> m_sampleHashes;
+
+	size_t getNumElementsPerSample() const { return 2 * m_stateVariables.size() + m_actionVariables.size() + m_rewardVariables.size(); }
+	bool isEpisodeTypeSelected(long long int episodeType) const;
+	bool isStepSelected(long long int stepIndex) const;
+
+	void workerThread();
+	bool convertLog(const LogInfo& log, vector<double>& samples);
+	bool convertVersion2Log(const LogInfo& log, vector<double>& samples);
+	bool convertVersion3Log(const LogInfo& log, vector<double>& samples);
+	void addSample(const double* pPrevStep, const double* pStep, vector<double>& samples);
+	void flushSamples(vector<double>& samples);
+
+	bool writeDescriptor(const string& filename, const string& binaryFilename, const string& shuffleFilename) const;
+	bool writeShuffleFile(const string& filename, unsigned int seed) const;
+public:
+	//numThreads= 0 uses as many threads as cores
+	LogSampleConverter(const LogSampleFilter& filter, size_t numThreads = 0, size_t numSamplesPerBlock = 4096);
+	virtual ~LogSampleConverter() {}
+
+	//Adds a log (given by its descriptor) to the list of logs to be converted. The first log added sets the variables of
+	//the samples: logs with different state, action or reward variables are not added. Returns false if the log isn't added
+	bool addLog(const string& descriptorFilename);
+	size_t getNumLogs() const { return m_logs.size(); }
+
+	//Converts all the logs added and writes the sample file descriptor (outputFilename) and the binary data file. If
+	//bWriteShuffleFile is true, a random permutation of the samples (an unsigned 32-bit index per sample) is also written
+	//and referenced from the descriptor so that SampleFile doesn't need to shuffle them before the first epoch.
+	//Returns false if no sample is written
+	bool convert(const string& outputFilename, bool bWriteShuffleFile = false, unsigned int seed = 0);
+
+	size_t getNumSamplesWritten() const { return m_numSamplesWritten; }
+	size_t getNumDuplicatesRemoved() const { return m_numDuplicatesRemoved; }
+	size_t getNumLogsConverted() const { return m_numLogsConverted; }
+};
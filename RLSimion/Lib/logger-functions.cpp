@@ -29,6 +29,8 @@
 #include "function-sampler.h"
 #include "../../tools/System/CrossPlatform.h"
 #include <unordered_map>
+#include <algorithm>
+#include <math.h>
 using namespace std;
 
 #define FUNCTION_SAMPLE_HEADER 6543
@@ -72,13 +74,12 @@ struct FunctionSampleHeader
 /// <param name="filename">Path to the output file</param>
 void Logger::openFunctionLogFile(const char* filename)
 {
-	CrossPlatform::Fopen_s(&m_functionLogFile, m_outputFunctionLogBinary.c_str(), "wb");
-	if (m_functionLogFile)
+	if (m_functionLogWriter.open(m_outputFunctionLogBinary.c_str()))
 	{
 		//write function log header
 		FunctionLogHeader functionLogHeader;
 		functionLogHeader.numFunctions = SimionApp::get()->getFunctionSamplers().size();
-		fwrite(&functionLogHeader, sizeof(FunctionLogHeader), 1, m_functionLogFile);
+		m_functionLogWriter.write(&functionLogHeader, sizeof(FunctionLogHeader));
 
 		//write function declarations
 		unsigned int functionId = 0;
@@ -91,9 +92,18 @@ void Logger::openFunctionLogFile(const char* filename)
 			functionDeclarationHeader.numSamplesY = (unsigned int)sampler->getNumSamplesY();
 			functionDeclarationHeader.numSamplesZ = 1; //for now, not using it
 
-			fwrite(&functionDeclarationHeader, sizeof(FunctionDeclarationHeader), 1, m_functionLogFile);
+			m_functionLogWriter.write(&functionDeclarationHeader, sizeof(FunctionDeclarationHeader));
 			functionId++;
 		}
+
+		//from now on, only the background thread writes the function log
+		m_functionSamplers = SimionApp::get()->getFunctionSamplers();
+		m_bFunctionSnapshotTaken = vector<bool>(m_functionSamplers.size(), false);
+		m_functionSamples = vector<vector<double>>(m_functionSamplers.size());
+		m_lastLoggedFunctionSamples = vector<vector<double>>(m_functionSamplers.size());
+		m_bFunctionSamplePending = false;
+		m_bExitFunctionLogThread = false;
+		m_functionLogThread = std::thread(&Logger::functionLogThreadLoop, this);
 	}
 	else Logger::logMessage(MessageType::Warning, "Function log file couldn't be opened, so no function info will be saved.");
 }
@@ -103,36 +113,112 @@ void Logger::openFunctionLogFile(const char* filename)
 /// </summary>
 void Logger::closeFunctionLogFile()
 {
-	if (m_functionLogFile)
-		fclose(m_functionLogFile);
+	if (m_functionLogThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_functionLogMutex);
+			m_bExitFunctionLogThread = true;
+		}
+		m_functionLogCondition.notify_all();
+		m_functionLogThread.join();
+	}
+	if (m_functionLogWriter.isOpen() && m_numSkippedFunctionSamples > 0)
+	{
+		char message[256];
+		CrossPlatform::Sprintf_s(message, 256, "%d function samples weren't logged because the functions didn't change enough"
+			, (int)m_numSkippedFunctionSamples);
+		Logger::logMessage(MessageType::Info, message);
+		m_numSkippedFunctionSamples = 0;
+	}
+	m_functionLogWriter.close();
 }
 
 /// <summary>
-/// Adds a sample from each function to the log file
+/// Takes a snapshot of each function and hands them to the background thread, which samples them and adds them to the log
+/// file. Functions that don't support snapshots are sampled here
 /// </summary>
 void Logger::writeFunctionLogSample()
 {
-	if (!m_functionLogFile)
+	if (!m_functionLogThread.joinable())
 		return;
 
-	unsigned int functionId = 0;
-	for (FunctionSampler* sampler : SimionApp::get()->getFunctionSamplers())
+	std::unique_lock<std::mutex> lock(m_functionLogMutex);
+	//functions are logged every few episodes, so the previous sample should have been written long ago
+	m_functionLogCondition.wait(lock, [this] { return !m_bFunctionSamplePending; });
+
+	Experiment* pExperiment = SimionApp::get()->pExperiment.ptr();
+	m_functionSampleEpisode = pExperiment->getEvaluationIndex();
+	m_functionSampleStep = pExperiment->getStep();
+	m_functionSampleExperimentStep = pExperiment->getExperimentStep();
+
+	for (size_t functionId = 0; functionId < m_functionSamplers.size(); functionId++)
 	{
-		//Write the header
-		FunctionSampleHeader header;
-		Experiment* pExperiment = SimionApp::get()->pExperiment.ptr();
-		header.episode = pExperiment->getEvaluationIndex();
-		header.step = pExperiment->getStep();
-		header.experimentStep = pExperiment->getExperimentStep();
-		header.id = functionId;
+		m_bFunctionSnapshotTaken[functionId] = m_functionSamplers[functionId]->takeSnapshot();
+		if (!m_bFunctionSnapshotTaken[functionId])
+			m_functionSamples[functionId] = m_functionSamplers[functionId]->sample();
+	}
+	m_bFunctionSamplePending = true;
+	lock.unlock();
+	m_functionLogCondition.notify_all();
+}
+
+/// <summary>
+/// Returns whether any value of a function changed more than the threshold since it was last logged
+/// </summary>
+bool Logger::hasFunctionChanged(size_t functionId, const vector<double>& values) const
+{
+	const vector<double>& lastValues = m_lastLoggedFunctionSamples[functionId];
+	if (m_functionLogChangeThreshold.get() <= 0.0 || lastValues.size() != values.size())
+		return true;
 
-		fwrite(&header, sizeof(FunctionSampleHeader), 1, m_functionLogFile);
+	auto range = std::minmax_element(lastValues.begin(), lastValues.end());
+	double tolerance = m_functionLogChangeThreshold.get() * (*range.second - *range.first);
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		//NaN values are always considered a change
+		if (!(fabs(values[i] - lastValues[i]) <= tolerance))
+			return true;
+	}
+	return false;
+}
 
-		//Write the values sampled
-		const vector<double>& valuesSampled = sampler->sample();
+/// <summary>
+/// Background thread that samples the functions and writes the samples to the function log file
+/// </summary>
+void Logger::functionLogThreadLoop()
+{
+	std::unique_lock<std::mutex> lock(m_functionLogMutex);
+	while (true)
+	{
+		m_functionLogCondition.wait(lock, [this] { return m_bFunctionSamplePending || m_bExitFunctionLogThread; });
+		if (!m_bFunctionSamplePending)
+			return;
+		//the control loop doesn't touch the snapshots or the samples until we are done
+		lock.unlock();
 
-		fwrite(&valuesSampled[0], sizeof(double), valuesSampled.size(), m_functionLogFile);
+		FunctionSampleHeader header;
+		header.episode = m_functionSampleEpisode;
+		header.step = m_functionSampleStep;
+		header.experimentStep = m_functionSampleExperimentStep;
+		for (size_t functionId = 0; functionId < m_functionSamplers.size(); functionId++)
+		{
+			const vector<double>& valuesSampled = m_bFunctionSnapshotTaken[functionId]
+				? m_functionSamplers[functionId]->sampleSnapshot() : m_functionSamples[functionId];
+
+			if (!hasFunctionChanged(functionId, valuesSampled))
+			{
+				m_numSkippedFunctionSamples++;
+				continue;
+			}
+			header.id = functionId;
+			m_functionLogWriter.write(&header, sizeof(FunctionSampleHeader));
+			m_functionLogWriter.write(&valuesSampled[0], sizeof(double) * valuesSampled.size());
+			m_lastLoggedFunctionSamples[functionId] = valuesSampled;
+		}
+		m_functionLogWriter.flush();
 
-		functionId++;
+		lock.lock();
+		m_bFunctionSamplePending = false;
+		m_functionLogCondition.notify_all();
 	}
 }
@@ -37,9 +37,9 @@
 #include <algorithm>
 #include <stdexcept>
 
-FILE *Logger::m_logFile = 0;
 MessageOutputMode Logger::m_messageOutputMode = MessageOutputMode::Console;
 NamedPipeClient Logger::m_outputPipe;
+AsyncMessageSender Logger::m_messageSender;
 bool Logger::m_bLogMessagesEnabled = true;
 
 #define HEADER_MAX_SIZE 16
@@ -112,8 +112,20 @@ Logger::Logger(ConfigNode* pConfigNode)
 
 	m_logFreq = DOUBLE_PARAM(pConfigNode, "Log-Freq", "Log frequency. Simulation time in seconds.", 0.25);
 
+	m_bLogStatQuantiles = BOOL_PARAM(pConfigNode, "Log-Stat-Quantiles", "Log the median and the 99th percentile of every stat besides its mean. They are estimated online, within the same interval as the mean", false);
+	if (m_bLogStatQuantiles.get())
+		m_stats.setQuantiles({ 0.5, 0.99 });
+
+	m_bCompressLog = BOOL_PARAM(pConfigNode, "Compress-Log", "Write the log file in the compressed columnar format (version 3). Badger can only read uncompressed logs (version 2)", false);
+
+	m_logOverflowPolicy = ENUM_PARAM<LogOverflowPolicy>(pConfigNode, "Log-Overflow-Policy", "What to do with logged steps if the log can't be written fast enough: wait until it is written (backPressure) or drop them (drop). Only uncompressed logs drop steps: compressed logs (Compress-Log) are written one whole episode at a time and always wait", LogOverflowPolicy::backPressure);
+
+	m_messageOverflowPolicy = ENUM_PARAM<LogOverflowPolicy>(pConfigNode, "Message-Overflow-Policy", "What to do with info messages if the Herd agent doesn't read them fast enough: drop them (drop) or wait until they are sent (backPressure). Progress messages are always replaced by the latest one, and warnings, errors and evaluations are never dropped", LogOverflowPolicy::drop);
+	m_messageSender.setOverflowPolicy(m_messageOverflowPolicy.get());
+
 	m_bLogFunctions = BOOL_PARAM(pConfigNode, "Log-Functions", "Log functions learned?", true);
 	m_numFunctionLogPoints = INT_PARAM(pConfigNode, "Num-Functions-Logged", "How many times per experiment save logged functions", 10);
+	m_functionLogChangeThreshold = DOUBLE_PARAM(pConfigNode, "Function-Log-Change-Threshold", "A function is only logged again if some sample changed more than this fraction of the range of values in the last sample logged. If 0, all samples are logged", 0.0);
 
 	m_pEpisodeTimer = new Timer();
 	m_pExperimentTimer = new Timer();
@@ -136,6 +148,8 @@ void Logger::setOutputFilenames()
 	SimionApp::get()->registerOutputFile(m_outputLogDescriptor.c_str());
 	m_outputLogBinary = inputConfigFile + LOG_BINARY_EXTENSION;
 	SimionApp::get()->registerOutputFile(m_outputLogBinary.c_str());
+	m_outputLogIndex = m_outputLogBinary + LOG_EPISODE_INDEX_EXTENSION;
+	SimionApp::get()->registerOutputFile(m_outputLogIndex.c_str());
 
 	//open the log file
 	openLogFile(m_outputLogBinary.c_str());
@@ -153,17 +167,25 @@ Logger::~Logger()
 	if (m_pExperimentTimer) delete m_pExperimentTimer;
 	if (m_pEpisodeTimer) delete m_pEpisodeTimer;
 
+	//close the log files before the pipe, so that any warning can still be sent through it
+	closeLogFile();
+	closeFunctionLogFile();
+
+	//send everything pending before the closing message
+	if (m_messageSender.getNumDroppedMessages() > 0)
+	{
+		char buffer[BUFFER_SIZE];
+		CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "%d info messages were dropped because the agent couldn't keep up"
+			, (int)m_messageSender.getNumDroppedMessages());
+		logMessage(MessageType::Warning, buffer);
+	}
+	m_messageSender.close();
+
 	//Send message to let the server know we have finished
 	//Not really needed under Windows, but it seems to be needed in Linux
 	const char closingMessage [] = "<End></End>";
 	m_outputPipe.writeBuffer(closingMessage, (int)strlen(closingMessage) + 1);
 	m_outputPipe.closeConnection();
-
-	for (auto it = m_stats.begin(); it != m_stats.end(); it++)
-		delete *it;
-
-	closeLogFile();
-	closeFunctionLogFile();
 }
 
 /// <summary>
@@ -188,13 +210,15 @@ void Logger::writeLogFileXMLDescriptor(const char* filename)
 	if (logXMLDescriptorFile)
 	{
 		if (m_bLogFunctions.get())
-			CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "<ExperimentLogDescriptor BinaryDataFile=\"%s\" FunctionsDataFile=\"%s\" SceneFile=\"%s\">\n"
+			CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "<ExperimentLogDescriptor BinaryDataFile=\"%s\" IndexFile=\"%s\" FunctionsDataFile=\"%s\" SceneFile=\"%s\">\n"
 				, getFilename(m_outputLogBinary).c_str()
+				, getFilename(m_outputLogIndex).c_str()
 				, getFilename(m_outputFunctionLogBinary).c_str()
 				, (SimionApp::get()->pWorld->getDynamicModel()->getName() + string(".scene")).c_str());
 		else
-			CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "<ExperimentLogDescriptor BinaryDataFile=\"%s\" SceneFile=\"%s\">\n"
+			CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "<ExperimentLogDescriptor BinaryDataFile=\"%s\" IndexFile=\"%s\" SceneFile=\"%s\">\n"
 				, getFilename(m_outputLogBinary).c_str()
+				, getFilename(m_outputLogIndex).c_str()
 				, (SimionApp::get()->pWorld->getDynamicModel()->getName() + string(".scene")).c_str());
 		//write the types of episodes
 		if (m_bLogEvaluationEpisodes.get()) CrossPlatform::Strcat_s(buffer, BUFFER_SIZE, "  <Episode-Type Id=\"0\">Evaluation</Episode-Type>\n");
@@ -216,11 +240,18 @@ void Logger::writeStatDescriptorToBuffer(char* pOutBuffer)
 {
 	char buffer[BUFFER_SIZE];
 
-	for (auto iterator = m_stats.begin(); iterator != m_stats.end(); iterator++)
+	for (size_t stat = 0; stat < m_stats.size(); stat++)
 	{
-		CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "  <Stat-variable>%s/%s</Stat-variable>\n", (*iterator)->getKey().c_str()
-			, (*iterator)->getSubkey().c_str());
+		CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "  <Stat-variable>%s/%s</Stat-variable>\n", m_stats.getKey(stat).c_str()
+			, m_stats.getSubkey(stat).c_str());
 		CrossPlatform::Strcat_s(pOutBuffer, BUFFER_SIZE, buffer);
+		//quantiles are logged right after the mean of each stat
+		for (size_t quantile = 0; quantile < m_stats.getNumQuantiles(); quantile++)
+		{
+			CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "  <Stat-variable>%s/%s (p%g)</Stat-variable>\n", m_stats.getKey(stat).c_str()
+				, m_stats.getSubkey(stat).c_str(), 100.0 * m_stats.getQuantile(quantile));
+			CrossPlatform::Strcat_s(pOutBuffer, BUFFER_SIZE, buffer);
+		}
 	}
 }
 void Logger::writeNamedVarSetDescriptorToBuffer(char* pOutBuffer, const char* id, const Descriptor* descriptor)
@@ -268,6 +299,8 @@ void Logger::firstEpisode()
 
 void Logger::lastEpisode()
 {
+	//wait until the last function sample has been written
+	closeFunctionLogFile();
 }
 
 
@@ -291,7 +324,7 @@ void Logger::firstStep()
 	bool bEvalEpisode = SimionApp::get()->pExperiment->isEvaluationEpisode();
 
 	//reset stats
-	for (auto it = m_stats.begin(); it != m_stats.end(); it++) (*it)->reset();
+	m_stats.reset();
 
 	//write the episode header in the log file
 	if (isEpisodeTypeLogged(bEvalEpisode))
@@ -326,6 +359,10 @@ void Logger::lastStep()
 
 	//log the end of the episode: this way we don't have to precalculate the number of steps logged per episode
 	writeEpisodeEndHeader();
+	writeLogIndexEntry();
+	//hand whatever has been logged so far to the writer thread so that the files are up to date after each episode
+	m_logWriter.flush();
+	m_logIndexWriter.flush();
 
 	//in case this is the last step of an evaluation episode, we log it and send the info to the host if there is one
 	char buffer[BUFFER_SIZE];
@@ -355,8 +392,8 @@ void Logger::lastStep()
 void Logger::timestep(State* s, Action* a, State* s_p, Reward* r)
 {
 	bool bEvalEpisode = SimionApp::get()->pExperiment->isEvaluationEpisode();
-	//we add the scalar reward in evaluation episodes for monitoring purposes, no matter if we are logging this type of episode or not
-	if (bEvalEpisode) m_episodeRewardSum += r->getSumValue();
+	//we add the scalar reward for monitoring purposes (evaluation messages and the log index), no matter if we are logging this type of episode or not
+	m_episodeRewardSum += r->getSumValue();
 
 	addLogDataSample(s_p, a, r); //We log s_p instead of s to log a coherent state-reward: r= f(s_p)
 	
@@ -386,7 +423,7 @@ void Logger::addLogDataSample(State* s, Action* a, Reward* r)
 	//reward
 	for (size_t i = 0; i < r->getNumVars(); i++) { m_avgLogData[variableIndex] += r->get(i); variableIndex++; }
 	//stats
-	for (auto iterator = m_stats.begin(); iterator != m_stats.end(); iterator++) (*iterator)->addSample();
+	m_stats.addSample();
 }
 
 void Logger::resetAvgLogData()
@@ -395,7 +432,7 @@ void Logger::resetAvgLogData()
 	m_numSamples = 0;
 	for (size_t i = 0; i < m_numLoggedVars; i++) m_avgLogData[i] = 0.0;
 	//reset stats
-	for (auto it = m_stats.begin(); it != m_stats.end(); it++) (*it)->reset();
+	m_stats.reset();
 }
 
 void Logger::writeLogData()
@@ -410,7 +447,21 @@ void Logger::writeLogData()
 
 	offset += writeStatsToBuffer(buffer, offset);
 
-	writeLogBuffer(buffer, offset);
+	//compressed steps are kept in memory and written with the whole episode, which is never dropped (see
+	//writeEpisodeEndHeader()), so the overflow policy doesn't apply to them
+	if (m_bCompressLog.get())
+	{
+		StepHeader header;
+		memcpy(&header, buffer, sizeof(StepHeader));
+		m_columnarLogWriter.addStep(header.stepIndex, header.experimentRealTime, header.episodeSimTime, header.episodeRealTime
+			, (double*)(buffer + sizeof(StepHeader)));
+		m_logIndexEntry.numSteps++;
+		return;
+	}
+
+	//steps can be dropped if the writer thread can't keep up. Headers can't, or the log file would be corrupt
+	if (writeLogBuffer(buffer, offset, true))
+		m_logIndexEntry.numSteps++;
 }
 
 void Logger::writeExperimentHeader()
@@ -423,8 +474,14 @@ void Logger::writeExperimentHeader()
 		pExperiment->getNumEvaluations()*pExperiment->getNumEpisodesPerEvaluation();
 	if (m_bLogTrainingEpisodes.get())
 		header.numEpisodes += pExperiment->getNumTrainingEpisodes();
+	if (m_bCompressLog.get())
+		header.fileVersion = COLUMNAR_LOG_FILE_VERSION;
 
 	writeLogBuffer((char*)&header, sizeof(ExperimentHeader));
+
+	LogEpisodeIndexHeader indexHeader;
+	indexHeader.logFileVersion = header.fileVersion;
+	m_logIndexWriter.write(&indexHeader, sizeof(LogEpisodeIndexHeader));
 }
 
 void Logger::writeEpisodeHeader()
@@ -443,19 +500,47 @@ void Logger::writeEpisodeHeader()
 		pWorld->getDynamicModel()->getActionDescriptor().size()
 		+ pWorld->getDynamicModel()->getStateDescriptor().size()
 		+ pWorld->getRewardVector()->getNumVars()
-		+ m_stats.size();
+		+ m_stats.size() * (1 + m_stats.getNumQuantiles());
+
+	m_logIndexEntry = LogEpisodeIndexEntry();
+	m_logIndexEntry.offset = (long long int) m_logWriter.getNumBytesWritten();
+	m_logIndexEntry.episodeType = header.episodeType;
+	m_logIndexEntry.episodeIndex = header.episodeIndex;
+	m_logIndexEntry.episodeSubIndex = header.episodeSubIndex;
+	m_logIndexEntry.numVariablesLogged = header.numVariablesLogged;
 
+	if (m_bCompressLog.get())
+	{
+		m_columnarLogWriter.beginEpisode(header.episodeType, header.episodeIndex, header.episodeSubIndex, (size_t)header.numVariablesLogged);
+		return;
+	}
 	writeLogBuffer((char*)&header, sizeof(EpisodeHeader));
 }
 
 void Logger::writeEpisodeEndHeader()
 {
+	if (m_bCompressLog.get())
+	{
+		//the whole episode is written now
+		m_logIndexEntry.offset = (long long int) m_logWriter.getNumBytesWritten();
+		m_columnarLogBuffer.clear();
+		m_columnarLogWriter.endEpisode(m_logWriter.getNumBytesWritten(), m_columnarLogBuffer);
+		writeLogBuffer(m_columnarLogBuffer.data(), (int)m_columnarLogBuffer.size());
+		return;
+	}
 	StepHeader episodeEndHeader;
 	memset(&episodeEndHeader, 0, sizeof(StepHeader));
 	episodeEndHeader.magicNumber = EPISODE_END_HEADER;
 	writeLogBuffer((char*)&episodeEndHeader, sizeof(StepHeader));
 }
 
+void Logger::writeLogIndexEntry()
+{
+	m_logIndexEntry.rewardSum = m_episodeRewardSum;
+	m_logIndexEntry.avgReward = m_episodeRewardSum / std::max(1.0, (double)SimionApp::get()->pExperiment->getStep());
+	m_logIndexWriter.write(&m_logIndexEntry, sizeof(LogEpisodeIndexEntry));
+}
+
 int Logger::writeStepHeaderToBuffer(char* buffer, int offset)
 {
 	StepHeader header;
@@ -484,16 +569,16 @@ int Logger::writeAvgLogData(char* buffer, int offset)
 
 int Logger::writeStatsToBuffer(char* buffer, int offset)
 {
-	int numVars = (int)m_stats.size();
 	double* pDoubleBuffer = (double*)(buffer + offset);
 	int i = 0;
-	for (auto it = m_stats.begin(); it != m_stats.end(); ++it)
+	for (size_t stat = 0; stat < m_stats.size(); stat++)
 	{
 		//Because we may not be logging all the steps, we need to save the average values instead of only the current value
-		pDoubleBuffer[i] = (*it)->getStatsInfo()->getAvg();
-		++i;
+		pDoubleBuffer[i++] = m_stats.getAvg(stat);
+		for (size_t quantile = 0; quantile < m_stats.getNumQuantiles(); quantile++)
+			pDoubleBuffer[i++] = m_stats.getQuantileEstimate(stat, quantile);
 	}
-	return (int) (numVars * sizeof(double));
+	return (int) (i * sizeof(double));
 }
 
 
@@ -501,7 +586,7 @@ void Logger::addVarSetToStats(const char* key, NamedVarSet* varset)
 {
 	for (int i = 0; i < (int) varset->getNumVars(); i++)
 	{
-		m_stats.push_back(new Stats<double>(key, varset->getProperties(i)->getName(), varset->getRef(i)));
+		m_stats.add(key, varset->getProperties(i)->getName(), varset->getRef(i));
 	}
 }
 
@@ -510,30 +595,44 @@ size_t Logger::getNumStats()
 	return m_stats.size();
 }
 
-IStats* Logger::getStats(unsigned int i)
-{
-	if (i < m_stats.size())
-		return m_stats[i];
-	return nullptr;
-}
 
 
 void Logger::openLogFile(const char* logFilename)
 {
-	CrossPlatform::Fopen_s(&m_logFile, logFilename, "wb");
-	if (!m_logFile)
+	if (!m_logWriter.open(logFilename, m_logOverflowPolicy.get()))
 		logMessage(MessageType::Warning, "Log file couldn't be opened, so no log info will be saved.");
+	else if (!m_logIndexWriter.open(m_outputLogIndex.c_str()))
+		logMessage(MessageType::Warning, "Log index file couldn't be opened. Episodes will have to be found reading the whole log");
 }
 void Logger::closeLogFile()
 {
-	if (m_logFile)
-		fclose(m_logFile);
+	if (!m_logWriter.isOpen())
+		return;
+
+	if (m_bCompressLog.get())
+	{
+		//index with the offsets of the episodes and columns, so that readers don't have to read the whole file
+		m_columnarLogBuffer.clear();
+		m_columnarLogWriter.writeIndex(m_logWriter.getNumBytesWritten(), m_columnarLogBuffer);
+		writeLogBuffer(m_columnarLogBuffer.data(), (int)m_columnarLogBuffer.size());
+	}
+	m_logWriter.close();
+	m_logIndexWriter.close();
+
+	char buffer[BUFFER_SIZE];
+	if (m_logWriter.getNumDroppedRecords() > 0)
+	{
+		CrossPlatform::Sprintf_s(buffer, BUFFER_SIZE, "%d logged steps were dropped because the log file couldn't be written fast enough"
+			, (int)m_logWriter.getNumDroppedRecords());
+		logMessage(MessageType::Warning, buffer);
+	}
+	if (m_logWriter.hasWriteErrors())
+		logMessage(MessageType::Warning, "Error writing the log file");
 }
 
-void Logger::writeLogBuffer(const char* pBuffer, int numBytes)
+bool Logger::writeLogBuffer(const char* pBuffer, int numBytes, bool bCanBeDropped)
 {
-	if (m_logFile)
-		fwrite(pBuffer, 1, numBytes, m_logFile);
+	return m_logWriter.write(pBuffer, numBytes, bCanBeDropped);
 }
 
 void Logger::enableLogMessages(bool enable)
@@ -553,7 +652,8 @@ void Logger::logMessage(MessageType type, const char* message)
 {
 	char messageLine[1024];
 
-	if (m_messageOutputMode == MessageOutputMode::NamedPipe && m_outputPipe.isConnected())
+	//once the message sender is closed (the app is being destroyed), messages are printed instead
+	if (m_messageOutputMode == MessageOutputMode::NamedPipe && m_outputPipe.isConnected() && !m_messageSender.isClosed())
 	{
 		switch (type)
 		{
@@ -568,7 +668,16 @@ void Logger::logMessage(MessageType type, const char* message)
 		case Error:
 			CrossPlatform::Sprintf_s(messageLine, 1024, "<Error>ERROR: %s</Error>", message); break;
 		}
-		m_outputPipe.writeBuffer(messageLine, (int)strlen(messageLine) + 1);
+		//the control loop never waits for the pipe (unless the overflow policy is backPressure). The sender is started
+		//with the first message
+		m_messageSender.open(&m_outputPipe);
+		if (type == Progress)
+			m_messageSender.sendProgress(messageLine);
+		else
+			m_messageSender.send(messageLine, type == Info);
+		//make sure errors are sent before the app exits
+		if (type == Error)
+			m_messageSender.flush();
 	}
 	else if (m_bLogMessagesEnabled)
 	{
@@ -6,6 +6,10 @@ using namespace std;
 #include "parameters.h"
 #include "../../tools/System/NamedPipe.h"
 #include "stats.h"
+#include "async-file-writer.h"
+#include "async-message-sender.h"
+#include "../Common/columnar-log.h"
+#include "../Common/log-episode-index.h"
 
 class NamedVarSet;
 typedef NamedVarSet State;
@@ -26,24 +30,57 @@ class Logger
 
 	//Functions log file: drawable downsampled 2d or 1d versions of the functions learned by the agents
 	string m_outputFunctionLogBinary;
-	FILE *m_functionLogFile = nullptr;
+	AsyncFileWriter m_functionLogWriter;
 
 	BOOL_PARAM m_bLogFunctions;
 	INT_PARAM m_numFunctionLogPoints;
+	DOUBLE_PARAM m_functionLogChangeThreshold;
+
+	//Functions are sampled and written from a background thread. The control loop only copies the parameters of the
+	//functions (see FunctionSampler::takeSnapshot()), or samples them itself if they don't support snapshots
+	vector<FunctionSampler*> m_functionSamplers;
+	vector<bool> m_bFunctionSnapshotTaken;
+	vector<vector<double>> m_functionSamples;
+	vector<vector<double>> m_lastLoggedFunctionSamples;
+	long long int m_functionSampleEpisode = 0, m_functionSampleStep = 0, m_functionSampleExperimentStep = 0;
+	size_t m_numSkippedFunctionSamples = 0;
+
+	std::thread m_functionLogThread;
+	std::mutex m_functionLogMutex;
+	std::condition_variable m_functionLogCondition;
+	bool m_bFunctionSamplePending = false;
+	bool m_bExitFunctionLogThread = false;
 
 	void openFunctionLogFile(const char* filename);
 	void closeFunctionLogFile();
 
 	void writeFunctionLogSample();
+	void functionLogThreadLoop();
+	bool hasFunctionChanged(size_t functionId, const vector<double>& values) const;
 
 	//Log file
 	string m_outputLogDescriptor;
 	string m_outputLogBinary;
-	static FILE *m_logFile;
+	//log files are written from a background thread. If it can't keep up, step records are either dropped or
+	//the control loop waits, depending on m_logOverflowPolicy. Headers are never dropped, and neither are the blocks of
+	//compressed logs (one per episode)
+	AsyncFileWriter m_logWriter;
 
 	BOOL_PARAM m_bLogEvaluationEpisodes;
 	BOOL_PARAM m_bLogTrainingEpisodes;
 	DOUBLE_PARAM m_logFreq; //in seconds: time between file logs
+	ENUM_PARAM<LogOverflowPolicy> m_logOverflowPolicy;
+	ENUM_PARAM<LogOverflowPolicy> m_messageOverflowPolicy;
+
+	//version 3 logs: steps are kept in memory and written compressed, one column per variable, at the end of each episode
+	BOOL_PARAM m_bCompressLog;
+	ColumnarLogWriter m_columnarLogWriter;
+	vector<char> m_columnarLogBuffer;
+
+	//sidecar index with an entry per episode logged, written when the episode ends (see ExperimentLogReader)
+	string m_outputLogIndex;
+	AsyncFileWriter m_logIndexWriter{ 4096, 4 };
+	LogEpisodeIndexEntry m_logIndexEntry;
 
 	Timer *m_pEpisodeTimer = nullptr;
 	Timer *m_pExperimentTimer = nullptr;
@@ -55,7 +92,7 @@ class Logger
 	void closeLogFile();
 
 private:
-	static void writeLogBuffer(const char* pBuffer, int numBytes);
+	bool writeLogBuffer(const char* pBuffer, int numBytes, bool bCanBeDropped = false);
 	void writeLogFileXMLDescriptor(const char* filename);
 
 	void writeNamedVarSetDescriptorToBuffer(char* buffer, const char* id, const Descriptor* pNamedVarSet);
@@ -64,6 +101,7 @@ private:
 	void writeExperimentHeader();
 	void writeEpisodeHeader();
 	void writeEpisodeEndHeader();
+	void writeLogIndexEntry();
 	int writeStepHeaderToBuffer(char* buffer, int offset);
 	int writeAvgLogData(char* buffer, int offset);
 	int writeStatsToBuffer(char* buffer, int offset);
@@ -73,7 +111,8 @@ private:
 	void resetAvgLogData();
 
 	//stats
-	vector<IStats *> m_stats;
+	Stats m_stats;
+	BOOL_PARAM m_bLogStatQuantiles;
 	//Variables used to log averaged data (state/action/reward)
 	size_t m_numSamples = 0;
 	size_t m_numLoggedVars = 0;
@@ -95,17 +134,19 @@ public:
 	template <typename T>
 	void addVarToStats(string key, string subkey, T& variable)
 	{
-		m_stats.push_back(new Stats<T>(key, subkey, variable));
+		m_stats.add(key, subkey, variable);
 	}
 	void addVarSetToStats(const char* key, NamedVarSet* varset);
 
 	size_t getNumStats();
-	IStats* getStats(unsigned int i);
+	Stats& getStats() { return m_stats; }
 
 	void setOutputFilenames();
 
 	static MessageOutputMode m_messageOutputMode;
 	static NamedPipeClient m_outputPipe;
+	//messages are written to m_outputPipe from a background thread
+	static AsyncMessageSender m_messageSender;
 	static bool m_bLogMessagesEnabled;
 
 	//Function called to report progress and error messages
@@ -116,6 +157,7 @@ public:
 
 protected:
 	friend class Experiment;
+	friend class SimionApp;
 	//METHODS CALLED FROM Experiment
 	//called to log episodes
 	void firstEpisode();
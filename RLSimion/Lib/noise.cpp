@@ -69,6 +69,25 @@ double GaussianNoise::getNormalDistributionSample(double mean, double sigma)
 	return z * sigma + mean;
 }
 
+/// <summary>
+/// Fills a buffer with samples from N(0,1). Each Box-Muller transform gives two independent samples (with the cosine and
+/// the sine), so only half the random numbers and logarithms of getNormalDistributionSample() are needed
+/// </summary>
+/// <param name="pSamples">Output buffer</param>
+/// <param name="numSamples">Number of samples</param>
+void GaussianNoise::getNormalDistributionSamples(double* pSamples, size_t numSamples)
+{
+	for (size_t i = 0; i < numSamples; i += 2)
+	{
+		double x1 = (double)(rand() + 1) / ((double)RAND_MAX + 1);
+		double x2 = (double)rand() / (double)RAND_MAX;
+		double radius = sqrt(-2 * log(x1));
+		pSamples[i] = radius * cos(2 * M_PI * x2);
+		if (i + 1 < numSamples)
+			pSamples[i + 1] = radius * sin(2 * M_PI * x2);
+	}
+}
+
 double GaussianNoise::getPDF(double mean, double sigma, double value,double scaleFactor)
 {
 	double diff = (value - mean)/scaleFactor;
@@ -102,6 +121,12 @@ Noise::Noise()
 	m_lastValue = 0.0;
 }
 
+void Noise::getSamples(double* pSamples, size_t numEnvironments)
+{
+	for (size_t i = 0; i < numEnvironments; i++)
+		pSamples[i] = getSample();
+}
+
 std::shared_ptr<Noise> Noise::getInstance(ConfigNode* pConfigNode)
 {
 	return CHOICE<Noise>(pConfigNode, "Noise", "Noise type",
@@ -151,6 +176,31 @@ double GaussianNoise::getSample()
 	return randValue;
 }
 
+/// <summary>
+/// Returns a sample for each environment, generated in a single batch. Each environment has its own filter state
+/// </summary>
+/// <param name="pSamples">Output buffer with a sample per environment</param>
+/// <param name="numEnvironments">Number of environments</param>
+void GaussianNoise::getSamples(double* pSamples, size_t numEnvironments)
+{
+	double sigma = m_sigma.get();
+	double alpha = m_alpha.get();
+	double scale = m_scale->get();
+
+	if (m_lastValues.size() != numEnvironments)
+		m_lastValues.assign(numEnvironments, 0.0);
+
+	if (sigma > 0.00000000001)
+		getNormalDistributionSamples(pSamples, numEnvironments);
+	else
+		std::fill(pSamples, pSamples + numEnvironments, 0.0);
+
+	for (size_t i = 0; i < numEnvironments; i++)
+	{
+		pSamples[i] = alpha * pSamples[i] * sigma * scale + (1.0 - alpha) * m_lastValues[i];
+		m_lastValues[i] = pSamples[i];
+	}
+}
 
 double GaussianNoise::getVariance()
 {
@@ -266,6 +316,29 @@ double OrnsteinUhlenbeckNoise::getSample()
 	return newNoise;
 }
 
+/// <summary>
+/// Returns a sample for each environment, generated in a single batch. Each environment has its own process
+/// </summary>
+/// <param name="pSamples">Output buffer with a sample per environment</param>
+/// <param name="numEnvironments">Number of environments</param>
+void OrnsteinUhlenbeckNoise::getSamples(double* pSamples, size_t numEnvironments)
+{
+	double theta = m_theta.get();
+	double sigma = m_sigma.get();
+	double mu = m_mu.get();
+	double scale = m_scale->get();
+
+	if (m_lastValues.size() != numEnvironments)
+		m_lastValues.assign(numEnvironments, 0.0);
+
+	GaussianNoise::getNormalDistributionSamples(pSamples, numEnvironments);
+	for (size_t i = 0; i < numEnvironments; i++)
+	{
+		m_lastValues[i] += theta * (mu - m_lastValues[i]) * m_dt + sigma * sqrt(m_dt) * pSamples[i];
+		pSamples[i] = m_lastValues[i] * scale;
+	}
+}
+
 double OrnsteinUhlenbeckNoise::getSampleProbability(double sample, bool bUseMarginalNoise)
 {
 	double sigma;
@@ -12,6 +12,9 @@ class Noise
 protected:
 	Noise();
 	double m_lastValue;
+	//the last value of each environment, used by noises with memory when the actions of several environments are selected
+	//at once
+	vector<double> m_lastValues;
 public:
 	static std::shared_ptr<Noise> getInstance(ConfigNode* pParameters);
 	virtual ~Noise() {}
@@ -19,6 +22,9 @@ public:
 	virtual double getVariance() = 0;
 	virtual double unscale(double noise) { return noise; }
 	virtual double getSample()= 0;
+	//one sample for each of numEnvironments environments stepped together. Noises with memory (filtered or
+	//Ornstein-Uhlenbeck) evolve independently in each environment. By default, getSample() is called for each environment
+	virtual void getSamples(double* pSamples, size_t numEnvironments);
 	//bUseMarginal= true means that the internal parameters should be neglected and, instead
 	//, a very thin noise source should be used. This is used to simulate the calculation of
 	//the probability of a sample belonging to a deterministic policy
@@ -39,10 +45,13 @@ public:
 	double getVariance();
 	double unscale(double noise);
 	double getSample();
+	void getSamples(double* pSamples, size_t numEnvironments);
 	double getSampleProbability(double sample, bool bUseMarginalNoise = false);
 
 	static double getSampleProbability(double mean, double sigma, double value, double scale = 1.0);
 	static double getNormalDistributionSample(double mean, double sigma);
+	//numSamples samples from N(0,1). Both values generated by each Box-Muller transform are used
+	static void getNormalDistributionSamples(double* pSamples, size_t numSamples);
 	static double getPDF(double mean, double sigma, double value,double scaleFactor=1.0);
 };
 
@@ -72,5 +81,6 @@ public:
 	double getVariance();
 	double unscale(double noise);
 	double getSample();
+	void getSamples(double* pSamples, size_t numEnvironments);
 	double getSampleProbability(double sample, bool bUseMarginalNoise = false);
 };
\ No newline at end of file
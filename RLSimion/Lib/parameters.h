@@ -7,7 +7,9 @@
 #include <list>
 #include <tuple>
 #include "config.h"
-#include "deep-layer.h" //Activation enum type is defined there
+#include "deep-layer.h" //Activation, DeepBackend and DeepPrecision enum types are defined there
+#include "async-file-writer.h" //LogOverflowPolicy enum type is defined there
+#include "sample-file.h" //SampleOrder enum type is defined there
 #include <stdexcept>
 
 using namespace std;
@@ -64,6 +66,23 @@ protected:
 		else if (!strcmp(strValue, "cubic")) value = Interpolation::cubic;
 		else value = m_default;
 	}
+	void initValue(ConfigNode* pConfigNode, LogOverflowPolicy& value)
+	{
+		const char* strValue = pConfigNode->getConstString(m_name);
+		if (strValue == nullptr) value = m_default;
+		else if (!strcmp(strValue, "backPressure")) value = LogOverflowPolicy::backPressure;
+		else if (!strcmp(strValue, "drop")) value = LogOverflowPolicy::drop;
+		else value = m_default;
+	}
+	void initValue(ConfigNode* pConfigNode, SampleOrder& value)
+	{
+		const char* strValue = pConfigNode->getConstString(m_name);
+		if (strValue == nullptr) value = m_default;
+		else if (!strcmp(strValue, "sequential")) value = SampleOrder::sequential;
+		else if (!strcmp(strValue, "random")) value = SampleOrder::random;
+		else if (!strcmp(strValue, "shuffled")) value = SampleOrder::shuffled;
+		else value = m_default;
+	}
 	void initValue(ConfigNode* pConfigNode, Activation& value)
 	{
 		const char* strValue = pConfigNode->getConstString(m_name);
@@ -71,6 +90,22 @@ protected:
 			value = DeepLayer::activationFromFunctionName(strValue);
 		else value = m_default;
 	}
+	void initValue(ConfigNode* pConfigNode, DeepBackend& value)
+	{
+		const char* strValue = pConfigNode->getConstString(m_name);
+		if (strValue == nullptr) value = m_default;
+		else if (!strcmp(strValue, "CNTK")) value = DeepBackend::CNTK;
+		else if (!strcmp(strValue, "Native")) value = DeepBackend::Native;
+		else value = m_default;
+	}
+	void initValue(ConfigNode* pConfigNode, DeepPrecision& value)
+	{
+		const char* strValue = pConfigNode->getConstString(m_name);
+		if (strValue == nullptr) value = m_default;
+		else if (!strcmp(strValue, "Double")) value = DeepPrecision::Double;
+		else if (!strcmp(strValue, "Single")) value = DeepPrecision::Single;
+		else value = m_default;
+	}
 
 public:
 	SimpleParam() = default;
@@ -30,10 +30,20 @@
 #include "../../tools/System/CrossPlatform.h"
 #include "logger.h"
 #include <limits>
+#include <algorithm>
+#include <numeric>
+#include <string.h>
+#include <stdlib.h>
 
 using namespace tinyxml2;
 
-SampleFile::SampleFile(string filename)
+/// <summary>
+/// Loads the descriptor of a sample file and maps its binary data file in memory
+/// </summary>
+/// <param name="filename">Descriptor of the sample file</param>
+/// <param name="order">Order in which samples are drawn</param>
+/// <param name="minibatchSize">Number of samples copied at once by the prefetch thread</param>
+SampleFile::SampleFile(string filename, SampleOrder order, size_t minibatchSize)
 {
 	XMLDocument doc;
 	string folder;
@@ -62,19 +72,42 @@ SampleFile::SampleFile(string filename)
 		m_numElementsPerSample = 2 * m_numStateVariables + m_numActionVariables + m_numRewardVariables;
 		m_sampleSizeInBytes = sizeof(double) * m_numElementsPerSample; //<s, a, s_p, r>
 
-		//We are using an arbitrary data chunk size (10^5). With 100 variables per tuple, we would need 100*8*10^5= 80Mb of memory, which seems reasonable
-		m_dataChunkSizeInSamples= 2000;
-		m_dataChunkSizeInElements= m_dataChunkSizeInSamples * m_numElementsPerSample;
-		m_numChunksInFile = (m_numSamplesInFile / m_dataChunkSizeInSamples);
-		if (m_numSamplesInFile % m_dataChunkSizeInSamples != 0) m_numChunksInFile++;
-		m_cachedData = vector<double>(m_dataChunkSizeInSamples * m_sampleSizeInBytes);
-		m_currentChunk = 0;
-
-		CrossPlatform::Fopen_s((FILE **)&m_pBinaryFile, m_binaryFilename.c_str(), "rb");
-		if (m_pBinaryFile && m_numChunksInFile > 0)
+		if (m_sampleSizeInBytes > 0 && m_binaryFile.open(m_binaryFilename.c_str()))
+		{
+			//don't read past the end of the file if the descriptor is wrong
+			size_t numSamplesInBinaryFile = m_binaryFile.getSize() / m_sampleSizeInBytes;
+			if (numSamplesInBinaryFile < (size_t)m_numSamplesInFile)
+			{
+				Logger::logMessage(MessageType::Warning, (string("The binary data file has less samples than expected: ") + m_binaryFilename).c_str());
+				m_numSamplesInFile = (int)numSamplesInBinaryFile;
+			}
+		}
+		if (m_binaryFile.isOpen() && m_numSamplesInFile > 0)
 		{
-			//Open the sample file and read the first data chunk
-			m_numValidSamplesInCache = (int)fread(m_cachedData.data(), m_sampleSizeInBytes, m_dataChunkSizeInSamples, (FILE*)m_pBinaryFile);
+			m_pSamples = (const double*)m_binaryFile.getData();
+			m_binaryFile.setAccessPattern(order == SampleOrder::sequential ? MemoryMappedFile::Sequential : MemoryMappedFile::Random);
+
+			//seeded with rand() so that the experiment's random seed also determines the samples drawn
+			m_order = order;
+			m_randomGenerator.seed((unsigned int)rand());
+			if (m_order == SampleOrder::shuffled)
+			{
+				m_shuffledIndices.resize(m_numSamplesInFile);
+				std::iota(m_shuffledIndices.begin(), m_shuffledIndices.end(), 0);
+				m_nextSampleIndex = m_shuffledIndices.size(); //shuffled before drawing the first sample
+				//the converter may have written a permutation of the samples to be used in the first epoch
+				if (pRoot->Attribute("ShuffleFile") != nullptr
+					&& loadShuffleFile(folder + string(pRoot->Attribute("ShuffleFile"))))
+					m_nextSampleIndex = 0;
+			}
+
+			//the first minibatch is filled here, the next one by the prefetch thread
+			m_minibatchSize = std::max((size_t)1, minibatchSize);
+			for (vector<double>& minibatch : m_minibatches)
+				minibatch.resize(m_minibatchSize * m_numElementsPerSample);
+			fillMinibatch(m_minibatches[0]);
+			m_prefetchThread = std::thread(&SampleFile::prefetchThreadLoop, this);
+
 			Logger::logMessage(MessageType::Info, (string("Sample file loaded: ") + filename).c_str());
 			return;
 		}
@@ -85,11 +118,42 @@ SampleFile::SampleFile(string filename)
 
 SampleFile::~SampleFile()
 {
-	if (m_pBinaryFile)
-		fclose((FILE *) m_pBinaryFile);
+	if (m_prefetchThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bExit = true;
+		}
+		m_nextMinibatchUsed.notify_one();
+		m_prefetchThread.join();
+	}
 }
 
 
+/// <summary>
+/// Loads a precomputed permutation of the samples (one unsigned 32-bit index per sample) to m_shuffledIndices
+/// </summary>
+/// <returns>False if the file can't be read or it doesn't hold a valid index for every sample</returns>
+bool SampleFile::loadShuffleFile(string filename)
+{
+	FILE* pFile;
+	CrossPlatform::Fopen_s(&pFile, filename.c_str(), "rb");
+	if (pFile == nullptr)
+		return false;
+
+	vector<unsigned int> indices(m_numSamplesInFile);
+	size_t numIndicesRead = fread(indices.data(), sizeof(unsigned int), indices.size(), pFile);
+	bool bEndOfFile = fgetc(pFile) == EOF;
+	fclose(pFile);
+	if (numIndicesRead != indices.size() || !bEndOfFile)
+		return false;
+	for (unsigned int index : indices)
+		if (index >= (unsigned int)m_numSamplesInFile) return false;
+
+	m_shuffledIndices = indices;
+	return true;
+}
+
 /// <summary>
 /// Reads the whole sample file and calculates the range of abosulte action variables (not normalized). This is useful if we want to use DQN: there is no point using the whole range
 /// of an action variable if we only have samples for a subrange. In fact, discrete actions that were not sampled may be given a higher Q(s,a) value after training
@@ -99,7 +163,6 @@ SampleFile::~SampleFile()
 vector<double> SampleFile::calculateAbsActionRanges()
 {
 	vector<double> actionRanges= vector<double> ( 2 * m_numActionVariables);
-	vector<double> dataChunk = vector<double> (m_dataChunkSizeInElements);
 
 	//initialize the output action ranges
 	for (size_t actionVarIndex = 0; actionVarIndex < m_numActionVariables; actionVarIndex++)
@@ -108,59 +171,140 @@ vector<double> SampleFile::calculateAbsActionRanges()
 		actionRanges[2 * actionVarIndex + 1] = std::numeric_limits<double>::lowest(); //max(i) = double.Min();
 	}
 
-	//position ourselves at the beginning
-	fseek((FILE*)m_pBinaryFile, 0, SEEK_SET);
+	if (!isOpen())
+		return actionRanges;
+
 	//calculate the absolute ranges
-	for (size_t i = 0; i < m_numChunksInFile; i++)
+	size_t actionSampleOffset;
+	for (size_t sampleIndex = 0; sampleIndex < (size_t)m_numSamplesInFile; sampleIndex++)
 	{
-		//read a chunk
-		size_t numValidSamplesRead = fread(dataChunk.data(), m_sampleSizeInBytes, m_dataChunkSizeInSamples, (FILE*)m_pBinaryFile);
-		//udpate the ranges
-		size_t actionSampleOffset;
-		for (size_t sampleIndex = 0; sampleIndex < numValidSamplesRead; sampleIndex++)
+		actionSampleOffset = m_numElementsPerSample * sampleIndex + m_numStateVariables; //skip previous samples and the state
+		for (size_t actionVarIndex = 0; actionVarIndex < m_numActionVariables; actionVarIndex++)
 		{
-			actionSampleOffset = m_numElementsPerSample * sampleIndex + m_numStateVariables; //skip previous samples and the state
-			for (size_t actionVarIndex = 0; actionVarIndex < m_numActionVariables; actionVarIndex++)
-			{
-				if (dataChunk[actionSampleOffset + actionVarIndex] < actionRanges[2 * actionVarIndex])
-					actionRanges[2 * actionVarIndex] = dataChunk[actionSampleOffset + actionVarIndex]; //update the minimum
+			if (m_pSamples[actionSampleOffset + actionVarIndex] < actionRanges[2 * actionVarIndex])
+				actionRanges[2 * actionVarIndex] = m_pSamples[actionSampleOffset + actionVarIndex]; //update the minimum
 
-				if (dataChunk[actionSampleOffset + actionVarIndex] > actionRanges[2 * actionVarIndex + 1])
-					actionRanges[2 * actionVarIndex + 1] = dataChunk[actionSampleOffset + actionVarIndex]; //update the maximum
-			}
+			if (m_pSamples[actionSampleOffset + actionVarIndex] > actionRanges[2 * actionVarIndex + 1])
+				actionRanges[2 * actionVarIndex + 1] = m_pSamples[actionSampleOffset + actionVarIndex]; //update the maximum
 		}
 	}
 
 	return actionRanges;
 }
 
-void SampleFile::loadNextDataChunkFromFile()
+/// <summary>
+/// Returns the index of the next sample to be drawn from the file
+/// </summary>
+size_t SampleFile::nextSampleIndex()
+{
+	size_t index;
+	switch (m_order)
+	{
+	case SampleOrder::sequential:
+		index = m_nextSampleIndex;
+		m_nextSampleIndex = (m_nextSampleIndex + 1) % m_numSamplesInFile;
+		return index;
+	case SampleOrder::random:
+		return std::uniform_int_distribution<size_t>(0, m_numSamplesInFile - 1)(m_randomGenerator);
+	case SampleOrder::shuffled:
+	default:
+		//new epoch: shuffle the samples again
+		if (m_nextSampleIndex == m_shuffledIndices.size())
+		{
+			std::shuffle(m_shuffledIndices.begin(), m_shuffledIndices.end(), m_randomGenerator);
+			m_nextSampleIndex = 0;
+		}
+		return m_shuffledIndices[m_nextSampleIndex++];
+	}
+}
+
+/// <summary>
+/// Copies the next samples from the mapped file to a minibatch. The pages of the file are read here if they are not in memory
+/// </summary>
+void SampleFile::fillMinibatch(vector<double>& minibatch)
+{
+	for (size_t i = 0; i < m_minibatchSize; i++)
+		memcpy(&minibatch[i * m_numElementsPerSample], m_pSamples + nextSampleIndex() * m_numElementsPerSample, m_sampleSizeInBytes);
+}
+
+/// <summary>
+/// Fills the minibatch that isn't being used and waits until samples start being drawn from it to fill the other one
+/// </summary>
+void SampleFile::prefetchThreadLoop()
 {
-	//Read a data chunk from the sample file
-	if (m_pBinaryFile != nullptr && m_numChunksInFile>0)
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_bExit)
 	{
-		m_currentChunk= m_currentSampleIndex / m_dataChunkSizeInSamples;
+		vector<double>& minibatch = m_minibatches[1 - m_currentMinibatch];
+		lock.unlock();
+		fillMinibatch(minibatch);
+		lock.lock();
 
-		fseek((FILE*) m_pBinaryFile, m_currentChunk * (m_dataChunkSizeInSamples * m_sampleSizeInBytes), SEEK_SET);
-		m_numValidSamplesInCache = (int) fread(m_cachedData.data(), m_sampleSizeInBytes, m_dataChunkSizeInSamples, (FILE*) m_pBinaryFile);
+		m_bNextMinibatchReady = true;
+		m_nextMinibatchReady.notify_one();
+		m_nextMinibatchUsed.wait(lock, [this] { return m_bExit || !m_bNextMinibatchReady; });
 	}
-	else Logger::logMessage(MessageType::Error, "Failed to open offline sample file");
 }
 
+/// <summary>
+/// Starts drawing samples from the minibatch filled by the prefetch thread. It only waits if the prefetch thread hasn't
+/// finished filling it
+/// </summary>
+void SampleFile::nextMinibatch()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_nextMinibatchReady.wait(lock, [this] { return m_bNextMinibatchReady; });
+		m_currentMinibatch = 1 - m_currentMinibatch;
+		m_bNextMinibatchReady = false;
+	}
+	m_numSamplesDrawnFromMinibatch = 0;
+	m_nextMinibatchUsed.notify_one();
+}
+
+/// <summary>
+/// Draws the next sample and copies it to the state, action and next state given. Only the first reward variable is used.
+/// If the file has no reward variables, the reward is 0
+/// </summary>
 void SampleFile::drawRandomSample(State* s, Action* a, State* s_p, double& reward)
 {
-	if (m_currentSampleIndex >= m_currentChunk * m_dataChunkSizeInSamples + m_numValidSamplesInCache
-		|| m_currentSampleIndex < m_currentChunk * m_dataChunkSizeInSamples)
-		loadNextDataChunkFromFile();
-
-	int sampleOffset = m_numElementsPerSample * (m_currentSampleIndex - m_currentChunk * m_dataChunkSizeInSamples);
-	for (int i = 0; i < s->getNumVars(); i++) s->set(i, m_cachedData[sampleOffset + i]);
-	sampleOffset += (int) s->getNumVars();
-	for (int i = 0; i < a->getNumVars(); i++) a->set(i, m_cachedData[sampleOffset + i]);
-	sampleOffset += (int) a->getNumVars();
-	for (int i = 0; i < s_p->getNumVars(); i++) s_p->set(i, m_cachedData[sampleOffset + i]);
-	sampleOffset += (int) s_p->getNumVars();
-	reward = m_cachedData[sampleOffset]; //We only take the first reward value. Should be enough for now
-
-	m_currentSampleIndex = ++m_currentSampleIndex % m_numSamplesInFile;
-}
\ No newline at end of file
+	if (!isOpen()) return;
+
+	if (m_numSamplesDrawnFromMinibatch == m_minibatchSize)
+		nextMinibatch();
+	const double* pSample = &m_minibatches[m_currentMinibatch][m_numSamplesDrawnFromMinibatch * m_numElementsPerSample];
+	m_numSamplesDrawnFromMinibatch++;
+
+	for (int i = 0; i < std::min(m_numStateVariables, (int)s->getNumVars()); i++) s->set(i, pSample[i]);
+	pSample += m_numStateVariables;
+	for (int i = 0; i < std::min(m_numActionVariables, (int)a->getNumVars()); i++) a->set(i, pSample[i]);
+	pSample += m_numActionVariables;
+	for (int i = 0; i < std::min(m_numStateVariables, (int)s_p->getNumVars()); i++) s_p->set(i, pSample[i]);
+	pSample += m_numStateVariables;
+	if (m_numRewardVariables > 0)
+		reward = pSample[0]; //We only take the first reward value. Should be enough for now
+	else
+		reward = 0.0;
+}
+
+/// <summary>
+/// Draws numSamples samples at once
+/// </summary>
+/// <param name="numSamples">Number of samples</param>
+/// <param name="pOutSamples">Output buffer with room for numSamples * getNumElementsPerSample() values</param>
+void SampleFile::drawRandomSamples(size_t numSamples, double* pOutSamples)
+{
+	if (!isOpen()) return;
+
+	while (numSamples > 0)
+	{
+		if (m_numSamplesDrawnFromMinibatch == m_minibatchSize)
+			nextMinibatch();
+		size_t numSamplesCopied = std::min(numSamples, m_minibatchSize - m_numSamplesDrawnFromMinibatch);
+		memcpy(pOutSamples, &m_minibatches[m_currentMinibatch][m_numSamplesDrawnFromMinibatch * m_numElementsPerSample]
+			, numSamplesCopied * m_sampleSizeInBytes);
+		pOutSamples += numSamplesCopied * m_numElementsPerSample;
+		m_numSamplesDrawnFromMinibatch += numSamplesCopied;
+		numSamples -= numSamplesCopied;
+	}
+}
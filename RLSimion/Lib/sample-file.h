@@ -2,6 +2,11 @@
 
 #include <string>
 #include <vector>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "../../tools/System/MemoryMappedFile.h"
 using namespace std;
 
 class NamedVarSet;
@@ -9,30 +14,59 @@ typedef NamedVarSet State;
 typedef NamedVarSet Action;
 typedef NamedVarSet Reward;
 
+//Order in which samples are drawn from a sample file: one after another, uniformly at random (with replacement), or
+//shuffled once per epoch (every sample is drawn once per pass through the file)
+enum class SampleOrder { sequential, random, shuffled };
+
+//Tuples <s,a,s',r> used for offline training. The binary data file is memory-mapped, so only the pages with the samples
+//drawn are read. Samples are copied from the mapped file to minibatches by a background thread, one minibatch ahead of
+//the one being used, so that the training loop doesn't wait for the disk even if the file doesn't fit in memory
 class SampleFile
 {
 	int m_numSamplesInFile = 0;
 	int m_sampleSizeInBytes = 0;
 	int m_numElementsPerSample = 0;
 	int m_numStateVariables = 0, m_numActionVariables = 0, m_numRewardVariables = 0;
-	int m_currentSampleIndex = 0;
 	string m_binaryFilename;
 
-	vector<double> m_cachedData;
-	int m_dataChunkSizeInSamples;
-	int m_dataChunkSizeInElements;
-	int m_numValidSamplesInCache;
-	int m_numChunksInFile;
-	int m_currentChunk;
+	MemoryMappedFile m_binaryFile;
+	const double* m_pSamples = nullptr;
+
+	//sample indices. Only used from the prefetch thread once it has been started
+	SampleOrder m_order = SampleOrder::shuffled;
+	std::mt19937 m_randomGenerator;
+	size_t m_nextSampleIndex = 0;
+	vector<unsigned int> m_shuffledIndices;
+	size_t nextSampleIndex();
+	bool loadShuffleFile(string filename);
 
-	void* m_pBinaryFile= nullptr;
+	//two minibatches: the one samples are being drawn from and the one being filled by the prefetch thread
+	size_t m_minibatchSize = 0;
+	vector<double> m_minibatches[2];
+	size_t m_currentMinibatch = 0;
+	size_t m_numSamplesDrawnFromMinibatch = 0;
+	bool m_bNextMinibatchReady = false;
+	bool m_bExit = false;
+	std::thread m_prefetchThread;
+	std::mutex m_mutex;
+	std::condition_variable m_nextMinibatchReady;
+	std::condition_variable m_nextMinibatchUsed;
 
-	void loadNextDataChunkFromFile();
+	void fillMinibatch(vector<double>& minibatch);
+	void prefetchThreadLoop();
+	void nextMinibatch();
 public:
-	SampleFile(string filename);
+	SampleFile(string filename, SampleOrder order = SampleOrder::shuffled, size_t minibatchSize = 4096);
 	~SampleFile();
 
+	bool isOpen() const { return m_pSamples != nullptr; }
+	int getNumSamples() const { return m_numSamplesInFile; }
+	//values in each sample: the state, the action, the next state and the reward variables
+	int getNumElementsPerSample() const { return m_numElementsPerSample; }
+
 	void drawRandomSample(State* s, Action* a, State* s_p, double& reward);
+	//copies numSamples samples to pOutSamples, one after another (getNumElementsPerSample() values each)
+	void drawRandomSamples(size_t numSamples, double* pOutSamples);
 
 	vector<double> calculateAbsActionRanges();
-};
\ No newline at end of file
+};
@@ -35,9 +35,14 @@
 #include "experience-replay.h"
 #include "parameters.h"
 #include "features.h"
+#include "checkpoint.h"
+#include "logger.h"
+#include "../../tools/System/FileUtils.h"
 #include <algorithm>
+#include <string.h>
 
 std::vector<std::pair<DeferredLoad*, unsigned int>> SimGod::m_deferredLoadSteps;
+std::vector<Checkpointable*> SimGod::m_checkpointables;
 CHILD_OBJECT<StateFeatureMap> SimGod::m_pGlobalStateFeatureMap;
 CHILD_OBJECT<ActionFeatureMap> SimGod::m_pGlobalActionFeatureMap;
 
@@ -61,6 +66,12 @@ SimGod::SimGod(ConfigNode* pConfigNode)
 	m_bFreezeTargetFunctions = BOOL_PARAM(pConfigNode, "Freeze-Target-Function", "Defers updates on the V-functions to improve stability", false);
 	m_targetFunctionUpdateFreq = INT_PARAM(pConfigNode, "Target-Function-Update-Freq", "Update frequency at which target functions will be updated. Only used if Freeze-Target-Function=true", 100);
 	m_bUseImportanceWeights = BOOL_PARAM(pConfigNode, "Use-Importance-Weights", "Use sample importance weights to allow off-policy learning -experimental-", false);
+
+	m_checkpointFreq = INT_PARAM(pConfigNode, "Checkpoint-Freq", "Number of training episodes between checkpoints of the learned functions, which are also saved after the last training episode. If 0, no checkpoint is saved", 0);
+	m_warmStartFile = FILE_PATH_PARAM(pConfigNode, "Warm-Start-File", "Checkpoint the learned functions are loaded from before the experiment starts. Leave blank to start from scratch", "");
+	m_bResumeExperiment = BOOL_PARAM(pConfigNode, "Warm-Start-Resume", "Resume the experiment from the episode in which the warm-start checkpoint was saved (i.e., to continue an interrupted experiment)", false);
+	if (strlen(m_warmStartFile.get()) > 0)
+		SimionApp::get()->registerInputFile(m_warmStartFile.get());
 }
 
 
@@ -142,6 +153,13 @@ void SimGod::registerDeferredLoadStep(DeferredLoad* deferredLoadObject, unsigned
 	m_deferredLoadSteps.push_back(std::pair<DeferredLoad*, unsigned int>(deferredLoadObject, orderLoad));
 }
 
+void SimGod::unregisterDeferredLoadStep(DeferredLoad* deferredLoadObject)
+{
+	m_deferredLoadSteps.erase(std::remove_if(m_deferredLoadSteps.begin(), m_deferredLoadSteps.end()
+		, [deferredLoadObject](const std::pair<DeferredLoad*, unsigned int>& step) { return step.first == deferredLoadObject; })
+		, m_deferredLoadSteps.end());
+}
+
 bool myComparison(const std::pair<DeferredLoad*, unsigned int> &a, const std::pair<DeferredLoad*, unsigned int> &b)
 {
 	return a.second < b.second;
@@ -158,6 +176,108 @@ void SimGod::deferredLoad()
 	{
 		(*it).first->deferredLoadStep();
 	}
+
+	//warm start: once everything has been initialized, the learned functions are overwritten with those in the checkpoint
+	if (strlen(m_warmStartFile.get()) > 0)
+	{
+		if (loadCheckpoint(m_warmStartFile.get(), m_bResumeExperiment.get()))
+			Logger::logMessage(MessageType::Info, (string("Warm start from checkpoint: ") + m_warmStartFile.get()).c_str());
+		else
+			Logger::logMessage(MessageType::Error, (string("Couldn't load the warm-start checkpoint: ") + m_warmStartFile.get()).c_str());
+	}
+}
+
+void SimGod::registerCheckpointable(Checkpointable* pCheckpointable)
+{
+	m_checkpointables.push_back(pCheckpointable);
+}
+
+void SimGod::unregisterCheckpointable(Checkpointable* pCheckpointable)
+{
+	m_checkpointables.erase(std::remove(m_checkpointables.begin(), m_checkpointables.end(), pCheckpointable), m_checkpointables.end());
+}
+
+/// <summary>
+/// The checkpoint is saved beside the log files, with the name of the experiment and the extension .ckpt
+/// </summary>
+void SimGod::setOutputFilenames()
+{
+	if (m_checkpointFreq.get() <= 0)
+		return;
+	m_checkpointFilename = removeExtension(SimionApp::get()->getConfigFile()) + ".ckpt";
+	SimionApp::get()->registerOutputFile(m_checkpointFilename.c_str());
+}
+
+/// <summary>
+/// Lets the simions know that a training episode (or the last one) ended, and saves a checkpoint every Checkpoint-Freq
+/// training episodes and after the last training episode
+/// </summary>
+void SimGod::onTrainingEpisodeEnd()
+{
+	Experiment* pExperiment = SimionApp::get()->pExperiment.ptr();
+	bool bLastTrainingEpisode = pExperiment->getTrainingEpisodeIndex() == pExperiment->getNumTrainingEpisodes();
+	for (unsigned int i = 0; i < m_simions.size(); i++)
+	{
+		m_simions[i]->onTrainingEpisodeEnd();
+		if (bLastTrainingEpisode)
+			m_simions[i]->onExperimentEnd();
+	}
+
+	if (m_checkpointFreq.get() <= 0 || m_checkpointFilename.empty())
+		return;
+	if (pExperiment->getTrainingEpisodeIndex() % m_checkpointFreq.get() == 0 || bLastTrainingEpisode)
+	{
+		if (!saveCheckpoint(m_checkpointFilename))
+			Logger::logMessage(MessageType::Warning, (string("Couldn't save the checkpoint: ") + m_checkpointFilename).c_str());
+	}
+}
+
+/// <summary>
+/// Saves the position of the experiment and the learned functions of every Checkpointable object. The entries of each
+/// object are prefixed with its index
+/// </summary>
+/// <param name="filename">Name of the checkpoint</param>
+/// <returns>False if the file couldn't be written</returns>
+bool SimGod::saveCheckpoint(const string& filename)
+{
+	CheckpointWriter writer;
+	if (!writer.open(filename))
+		return false;
+
+	writer.setPrefix("Experiment/");
+	SimionApp::get()->pExperiment->saveCheckpoint(writer);
+	for (size_t i = 0; i < m_checkpointables.size(); i++)
+	{
+		writer.setPrefix(std::to_string(i) + "/");
+		m_checkpointables[i]->saveCheckpoint(writer);
+	}
+	return writer.close();
+}
+
+/// <summary>
+/// Loads the learned functions of every Checkpointable object from a checkpoint saved by an experiment with the same
+/// configuration
+/// </summary>
+/// <param name="filename">Name of the checkpoint</param>
+/// <param name="bResumeExperiment">If true, the position of the experiment is loaded too</param>
+/// <returns>False if the file couldn't be read</returns>
+bool SimGod::loadCheckpoint(const string& filename, bool bResumeExperiment)
+{
+	CheckpointReader reader;
+	if (!reader.open(filename))
+		return false;
+
+	if (bResumeExperiment)
+	{
+		reader.setPrefix("Experiment/");
+		SimionApp::get()->pExperiment->loadCheckpoint(reader);
+	}
+	for (size_t i = 0; i < m_checkpointables.size(); i++)
+	{
+		reader.setPrefix(std::to_string(i) + "/");
+		m_checkpointables[i]->loadCheckpoint(reader);
+	}
+	return true;
 }
 
 
@@ -11,6 +11,7 @@ class ConfigNode;
 class Simion;
 class ExperienceReplay;
 class DeferredLoad;
+class Checkpointable;
 class StateFeatureMap;
 class ActionFeatureMap;
 class FeatureList;
@@ -39,6 +40,13 @@ class SimGod
 	static std::vector<std::pair<DeferredLoad*, unsigned int>> m_deferredLoadSteps;
 
 	CHILD_OBJECT<ExperienceReplay> m_pExperienceReplay;
+
+	//checkpoints of the learned functions
+	static std::vector<Checkpointable*> m_checkpointables;
+	INT_PARAM m_checkpointFreq;
+	FILE_PATH_PARAM m_warmStartFile;
+	BOOL_PARAM m_bResumeExperiment;
+	std::string m_checkpointFilename;
 public:
 	SimGod(ConfigNode* pParameters);
 	SimGod() = default;
@@ -57,8 +65,21 @@ public:
 
 	//delayed load
 	static void registerDeferredLoadStep(DeferredLoad* deferredLoadObject,unsigned int orderLoad);
+	static void unregisterDeferredLoadStep(DeferredLoad* deferredLoadObject);
 	void deferredLoad();
 
+	//checkpoints
+	static void registerCheckpointable(Checkpointable* pCheckpointable);
+	static void unregisterCheckpointable(Checkpointable* pCheckpointable);
+	//registers the checkpoint file as an output of the experiment. Called once the name of the config file is known
+	void setOutputFilenames();
+	//called after every training episode: lets the simions know, and saves a checkpoint every Checkpoint-Freq training
+	//episodes and after the last one
+	void onTrainingEpisodeEnd();
+	bool saveCheckpoint(const std::string& filename);
+	//if bResumeExperiment is true, the experiment continues from the episode in which the checkpoint was saved
+	bool loadCheckpoint(const std::string& filename, bool bResumeExperiment);
+
 	//global feature maps
 	static std::shared_ptr<StateFeatureMap> getGlobalStateFeatureMap();
 	static std::shared_ptr<ActionFeatureMap> getGlobalActionFeatureMap();
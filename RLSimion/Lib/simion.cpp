@@ -32,7 +32,7 @@
 #include "DQN.h"
 #include "DDPG.h"
 #include "deep-cacla.h"
-//#include "async-deep-simion.h"
+#include "async-deep-simion.h"
 
 std::shared_ptr<Simion> Simion::getInstance(ConfigNode* pConfigNode)
 {
@@ -50,9 +50,15 @@ std::shared_ptr<Simion> Simion::getInstance(ConfigNode* pConfigNode)
 		{"DQN", CHOICE_ELEMENT_NEW<DQN>},
 		{"Double-DQN", CHOICE_ELEMENT_NEW<DoubleDQN>},
 		{"DDPG", CHOICE_ELEMENT_NEW<DDPG>},
-		{"Deep-CACLA", CHOICE_ELEMENT_NEW<DeepCACLA>}
+		{"Deep-CACLA", CHOICE_ELEMENT_NEW<DeepCACLA>},
+		{"Async-Q-Learning", CHOICE_ELEMENT_NEW<AsyncQLearning>}
 #endif
-		/*,{ "Async-QL-earning", CHOICE_ELEMENT_NEW<AsyncQLearning > }*/
 	});
 }
 
+void Simion::selectActions(const vector<const State*>& s, const vector<Action*>& a, vector<double>& probabilities)
+{
+	probabilities.resize(s.size());
+	for (size_t i = 0; i < s.size(); i++)
+		probabilities[i] = selectAction(s[i], a[i]);
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "parameters.h"
+#include <vector>
+using namespace std;
 class NamedVarSet;
 typedef NamedVarSet State;
 typedef NamedVarSet Action;
@@ -16,5 +18,14 @@ public:
 	//selectAction sets output in a, and returns the probability under which the simion selected the action
 	virtual double selectAction(const State *s, Action *a) = 0;
 
+	//selects the actions of several environments stepped together (a[i] for s[i]) and sets the probability of each of them.
+	//By default, selectAction() is called for each environment
+	virtual void selectActions(const vector<const State*>& s, const vector<Action*>& a, vector<double>& probabilities);
+
+	//called after every training episode, before the checkpoint (if due) is saved, and after the last one, while the app
+	//still exists. Simions doing work in the background must not do it during evaluation episodes or after the experiment
+	virtual void onTrainingEpisodeEnd() {}
+	virtual void onExperimentEnd() {}
+
 	static std::shared_ptr<Simion> getInstance(ConfigNode* pParameters);
 };
\ No newline at end of file
@@ -25,90 +25,227 @@
 
 #include "stats.h"
 #include <algorithm>
+#include <limits>
 #include <math.h>
 
-#define MAX_KEY_SIZE 128
-
-StatsInfo::StatsInfo()
+/// <summary>
+/// Constructor
+/// </summary>
+/// <param name="quantile">Quantile estimated, in (0,1)</param>
+QuantileSketch::QuantileSketch(double quantile)
 {
+	m_quantile = quantile;
 	reset();
 }
 
 /// <summary>
-/// Resets the stats
+/// Forgets all the samples
 /// </summary>
-void StatsInfo::reset()
+void QuantileSketch::reset()
 {
-	m_min = std::numeric_limits<double>::max();
-	m_max = std::numeric_limits<double>::lowest();
 	m_numSamples = 0;
-	m_meanSum = 0.0;
-	m_stdDevSum = 0.0;
-	m_sum = 0.0;
+	for (int i = 0; i < 5; i++)
+	{
+		m_heights[i] = 0.0;
+		m_positions[i] = i + 1.0;
+	}
+	m_desiredPositions[0] = 1.0;
+	m_desiredPositions[1] = 1.0 + 2.0 * m_quantile;
+	m_desiredPositions[2] = 1.0 + 4.0 * m_quantile;
+	m_desiredPositions[3] = 3.0 + 2.0 * m_quantile;
+	m_desiredPositions[4] = 5.0;
+	m_increments[0] = 0.0;
+	m_increments[1] = m_quantile / 2.0;
+	m_increments[2] = m_quantile;
+	m_increments[3] = (1.0 + m_quantile) / 2.0;
+	m_increments[4] = 1.0;
+}
+
+double QuantileSketch::parabolic(int i, double d) const
+{
+	return m_heights[i] + d / (m_positions[i + 1] - m_positions[i - 1])
+		* ((m_positions[i] - m_positions[i - 1] + d) * (m_heights[i + 1] - m_heights[i]) / (m_positions[i + 1] - m_positions[i])
+			+ (m_positions[i + 1] - m_positions[i] - d) * (m_heights[i] - m_heights[i - 1]) / (m_positions[i] - m_positions[i - 1]));
 }
 
+double QuantileSketch::linear(int i, int d) const
+{
+	return m_heights[i] + d * (m_heights[i + d] - m_heights[i]) / (m_positions[i + d] - m_positions[i]);
+}
 
-//one pass-mean/std.dev. calculation
-//https://www.strchr.com/standard_deviation_in_one_pass
-//double std_dev(double a[], int n) {
-//	if (n == 0)
-//		return 0.0;
-//	int i = 0;
-//	double meanSum = a[0];
-//	double stdDevSum = 0.0;
-//	for (i = 1; i < n; ++i) {
-//		double stepSum = a[i] - meanSum;
-//		double stepMean = ((i - 1) * stepSum) / i;
-//		meanSum += stepMean;
-//		stdDevSum += stepMean * stepSum;
-//	}
-//	// for poulation variance: return sqrt(stdDevSum / elements);
-//	return sqrt(stdDevSum / (elements - 1));
-//}
+/// <summary>
+/// Adds a sample. The first five samples are kept as they are, the rest adjust the markers
+/// </summary>
+void QuantileSketch::addSample(double value)
+{
+	if (m_numSamples < 5)
+	{
+		m_heights[m_numSamples++] = value;
+		if (m_numSamples == 5)
+			std::sort(m_heights, m_heights + 5);
+		return;
+	}
+	m_numSamples++;
 
+	//cell in which the sample falls, extending the extreme markers if needed
+	int cell;
+	if (value < m_heights[0])
+	{
+		m_heights[0] = value;
+		cell = 0;
+	}
+	else if (value >= m_heights[4])
+	{
+		m_heights[4] = value;
+		cell = 3;
+	}
+	else
+	{
+		cell = 0;
+		while (value >= m_heights[cell + 1]) cell++;
+	}
+
+	for (int i = cell + 1; i < 5; i++)
+		m_positions[i] += 1.0;
+	for (int i = 0; i < 5; i++)
+		m_desiredPositions[i] += m_increments[i];
+
+	//move the middle markers towards their desired positions
+	for (int i = 1; i < 4; i++)
+	{
+		double d = m_desiredPositions[i] - m_positions[i];
+		if ((d >= 1.0 && m_positions[i + 1] - m_positions[i] > 1.0) || (d <= -1.0 && m_positions[i - 1] - m_positions[i] < -1.0))
+		{
+			int step = d > 0.0 ? 1 : -1;
+			double height = parabolic(i, step);
+			if (m_heights[i - 1] < height && height < m_heights[i + 1])
+				m_heights[i] = height;
+			else
+				m_heights[i] = linear(i, step);
+			m_positions[i] += step;
+		}
+	}
+}
 
 /// <summary>
-/// Adds a sample to the collection of values
+/// Returns the estimate of the quantile. With less than five samples, the closest sample is returned
 /// </summary>
-/// <param name="value">New sample</param>
-void StatsInfo::addSample(double value)
+double QuantileSketch::get() const
 {
-	m_min = std::min(value, m_min);
-	m_max = std::max(value, m_max);
+	if (m_numSamples >= 5)
+		return m_heights[2];
+	if (m_numSamples == 0)
+		return 0.0;
+
+	double samples[5];
+	std::copy(m_heights, m_heights + m_numSamples, samples);
+	std::sort(samples, samples + m_numSamples);
+	return samples[(size_t)(m_quantile * (m_numSamples - 1) + 0.5)];
+}
 
-	m_numSamples++;
 
-	double stepSum = value - m_meanSum;
-	double stepMean = ((double)(m_numSamples - 1) * stepSum) / (double)m_numSamples;
-	m_meanSum += stepMean;
-	m_sum += value;
-	m_stdDevSum += stepMean * stepSum;
+/// <summary>
+/// Adds an element for a new variable to every array
+/// </summary>
+/// <returns>Index of the new variable</returns>
+size_t Stats::add(string key, string subkey, const void* pVariable, ReadFunction readFunction)
+{
+	m_sources.push_back(pVariable);
+	m_sourceReadFunctions.push_back(readFunction);
+	m_keys.push_back(key);
+	m_subkeys.push_back(subkey);
+	m_values.push_back(0.0);
+	m_min.push_back(0.0);
+	m_max.push_back(0.0);
+	m_mean.push_back(0.0);
+	m_m2.push_back(0.0);
+	for (double quantile : m_quantiles)
+		m_quantileSketches.push_back(QuantileSketch(quantile));
+	return m_keys.size() - 1;
+}
+
+/// <summary>
+/// Registers a double variable
+/// </summary>
+/// <param name="key">Key of the variable (i.e., the object that owns it)</param>
+/// <param name="subkey">Name of the variable</param>
+/// <param name="variable">The variable. It must exist as long as the stats are sampled</param>
+void Stats::add(string key, string subkey, double& variable)
+{
+	m_doubleSourceIndices.push_back(add(key, subkey, &variable, &Stats::read<double>));
+	m_doubleSources.push_back(&variable);
 }
 
 /// <summary>
-/// Returns the maximum sampled value
+/// Sets the quantiles estimated for every variable
 /// </summary>
-double StatsInfo::getMin(){ return m_min; }
+/// <param name="quantiles">Quantiles in (0,1)</param>
+void Stats::setQuantiles(const vector<double>& quantiles)
+{
+	m_quantiles = quantiles;
+	m_quantileSketches.clear();
+	for (size_t stat = 0; stat < size(); stat++)
+	{
+		for (double quantile : m_quantiles)
+			m_quantileSketches.push_back(QuantileSketch(quantile));
+	}
+}
 
 /// <summary>
-/// Returns the minimum sampled value
+/// Forgets all the samples taken
 /// </summary>
-double StatsInfo::getMax(){ return m_max; }
+void Stats::reset()
+{
+	m_numSamples = 0;
+	std::fill(m_min.begin(), m_min.end(), std::numeric_limits<double>::max());
+	std::fill(m_max.begin(), m_max.end(), std::numeric_limits<double>::lowest());
+	std::fill(m_mean.begin(), m_mean.end(), 0.0);
+	std::fill(m_m2.begin(), m_m2.end(), 0.0);
+	for (QuantileSketch& sketch : m_quantileSketches)
+		sketch.reset();
+}
 
 /// <summary>
-/// Returns the mean value of all samples
+/// Takes a sample of all the variables
 /// </summary>
-double StatsInfo::getAvg()
+void Stats::addSample()
 {
-	if (m_numSamples > 0) return m_sum / m_numSamples;
-	return 0.0;
+	const size_t numStats = size();
+	double* pValues = m_values.data();
+
+	//gather the values
+	for (size_t i = 0; i < m_doubleSources.size(); i++)
+		pValues[m_doubleSourceIndices[i]] = *m_doubleSources[i];
+	for (size_t i = 0; i < m_otherSources.size(); i++)
+		pValues[m_otherSourceIndices[i]] = m_otherSourceReadFunctions[i](m_otherSources[i]);
+
+	//all the variables have the same number of samples, so this loop has no dependencies between iterations
+	m_numSamples++;
+	const double invNumSamples = 1.0 / (double)m_numSamples;
+	double* pMin = m_min.data();
+	double* pMax = m_max.data();
+	double* pMean = m_mean.data();
+	double* pM2 = m_m2.data();
+	for (size_t i = 0; i < numStats; i++)
+	{
+		const double value = pValues[i];
+		pMin[i] = value < pMin[i] ? value : pMin[i];
+		pMax[i] = value > pMax[i] ? value : pMax[i];
+		const double delta = value - pMean[i];
+		pMean[i] += delta * invNumSamples;
+		pM2[i] += delta * (value - pMean[i]);
+	}
+
+	const size_t numQuantiles = m_quantiles.size();
+	for (size_t i = 0; i < m_quantileSketches.size(); i++)
+		m_quantileSketches[i].addSample(pValues[i / numQuantiles]);
 }
 
 /// <summary>
-/// Returns the standard deviation of all the samples
+/// Returns the (sample) standard deviation of the samples of a variable
 /// </summary>
-double StatsInfo::getStdDev()
+double Stats::getStdDev(size_t stat) const
 {
-	if (m_numSamples > 1) return sqrt(fabs(m_stdDevSum / (m_numSamples - 1)));
+	if (m_numSamples > 1) return sqrt(m_m2[stat] / (double)(m_numSamples - 1));
 	return 0.0;
 }
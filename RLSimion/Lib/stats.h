@@ -4,60 +4,89 @@
 #include <string>
 using namespace std;
 
-class StatsInfo
+//Streaming estimate of a quantile with the P-square algorithm (Jain and Chlamtac, 1985). Only five markers are kept and
+//adjusted with each sample, so memory and time per sample are constant
+class QuantileSketch
 {
-	double m_min;
-	double m_max;
-	double m_numSamples;
-	double m_sum;
-	double m_meanSum;
-	double m_stdDevSum;
-
-	bool m_bLog;
+	double m_quantile = 0.5;
+	double m_heights[5];
+	double m_positions[5];
+	double m_desiredPositions[5];
+	double m_increments[5];
+	size_t m_numSamples = 0;
+
+	double parabolic(int i, double d) const;
+	double linear(int i, int d) const;
 public:
-	StatsInfo();
+	QuantileSketch(double quantile = 0.5);
 
 	void reset();
-
-	double getMin();
-	double getMax();
-	double getAvg();
-	double getStdDev();
-
 	void addSample(double value);
+	double get() const;
 };
 
-//common interface
-class IStats
+//Stats of the variables registered by other objects (i.e., the TD error), all of them sampled at once every step.
+//They are kept as arrays with an element per variable: the values of the variables are first copied to m_values and
+//then the min/max/mean/variance of all of them are updated in a single loop (mean and variance with Welford's algorithm).
+//Optionally, some quantiles (i.e., p50/p99) of every variable can be estimated too
+class Stats
 {
-protected:
-	StatsInfo m_statsInfo;
-	string m_key;
-	string m_subkey;
-public:
-	virtual ~IStats() {}
-	StatsInfo* getStatsInfo() { return &m_statsInfo; }
-	string getKey() { return m_key; }
-	string getSubkey() { return m_subkey; }
-	void reset() { m_statsInfo.reset(); }
-
-	virtual void addSample() = 0;
-	virtual double get() = 0;
-};
+	vector<string> m_keys;
+	vector<string> m_subkeys;
 
-template <typename T> class Stats: public IStats
-{
-	T& m_variable;
+	//the sources of the values: double variables are copied directly, variables of any other type are converted
+	vector<const double*> m_doubleSources;
+	vector<size_t> m_doubleSourceIndices;
+	typedef double(*ReadFunction)(const void*);
+	vector<const void*> m_otherSources;
+	vector<ReadFunction> m_otherSourceReadFunctions;
+	vector<size_t> m_otherSourceIndices;
+
+	//every variable, in the order they were added
+	vector<const void*> m_sources;
+	vector<ReadFunction> m_sourceReadFunctions;
+
+	template <typename T> static double read(const void* pVariable) { return (double) *(const T*)pVariable; }
+	size_t add(string key, string subkey, const void* pVariable, ReadFunction readFunction);
+
+	size_t m_numSamples = 0;
+	vector<double> m_values;
+	vector<double> m_min;
+	vector<double> m_max;
+	vector<double> m_mean;
+	vector<double> m_m2; //sum of squared differences from the mean
+
+	//m_quantileSketches[stat * m_quantiles.size() + quantile]
+	vector<double> m_quantiles;
+	vector<QuantileSketch> m_quantileSketches;
 public:
-	Stats(string key, string subkey, T& variable): m_variable(variable)
+	void add(string key, string subkey, double& variable);
+	template <typename T> void add(string key, string subkey, T& variable)
 	{
-		m_key = key;
-		m_subkey = subkey;
-		reset();
+		m_otherSourceIndices.push_back(add(key, subkey, &variable, &Stats::read<T>));
+		m_otherSources.push_back(&variable);
+		m_otherSourceReadFunctions.push_back(&Stats::read<T>);
 	}
-	virtual ~Stats() {}
 
-	virtual void addSample() { m_statsInfo.addSample((double) m_variable); }
-	virtual double get() { return (double) m_variable; }
-};
+	//quantiles estimated for every variable (i.e., {0.5, 0.99}). None by default
+	void setQuantiles(const vector<double>& quantiles);
+	size_t getNumQuantiles() const { return m_quantiles.size(); }
+	double getQuantile(size_t quantile) const { return m_quantiles[quantile]; }
+
+	size_t size() const { return m_keys.size(); }
+	const string& getKey(size_t stat) const { return m_keys[stat]; }
+	const string& getSubkey(size_t stat) const { return m_subkeys[stat]; }
 
+	void reset();
+	//samples all the variables
+	void addSample();
+
+	//current value of the variable
+	double getValue(size_t stat) const { return m_sourceReadFunctions[stat](m_sources[stat]); }
+	//stats of the samples taken since the last reset
+	double getMin(size_t stat) const { return m_min[stat]; }
+	double getMax(size_t stat) const { return m_max[stat]; }
+	double getAvg(size_t stat) const { return m_mean[stat]; }
+	double getStdDev(size_t stat) const;
+	double getQuantileEstimate(size_t stat, size_t quantile) const { return m_quantileSketches[stat * m_quantiles.size() + quantile].get(); }
+};
@@ -0,0 +1,121 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "thread-pool.h"
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+	if (numThreads == 0)
+	{
+		unsigned int numHardwareThreads = std::thread::hardware_concurrency();
+		numThreads = numHardwareThreads > 1 ? numHardwareThreads - 1 : 0;
+	}
+	m_nextTask = 0;
+	for (size_t i = 0; i < numThreads; i++)
+		m_threads.push_back(std::thread(&ThreadPool::workerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bExit = true;
+	}
+	m_newJob.notify_all();
+	for (auto it = m_threads.begin(); it != m_threads.end(); ++it)
+		(*it).join();
+}
+
+void ThreadPool::runTasks()
+{
+	size_t task;
+	while ((task = m_nextTask++) < m_numTasks)
+	{
+		try
+		{
+			m_task(task);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_taskException)
+				m_taskException = std::current_exception();
+		}
+	}
+}
+
+void ThreadPool::workerLoop()
+{
+	unsigned int lastJobId = 0;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_newJob.wait(lock, [&] { return m_bExit || m_jobId != lastJobId; });
+		if (m_bExit)
+			return;
+		lastJobId = m_jobId;
+
+		lock.unlock();
+		runTasks();
+		lock.lock();
+
+		m_numBusyWorkers--;
+		if (m_numBusyWorkers == 0)
+			m_jobFinished.notify_all();
+	}
+}
+
+void ThreadPool::parallelFor(size_t numTasks, const std::function<void(size_t)>& task)
+{
+	if (m_threads.empty() || numTasks <= 1)
+	{
+		for (size_t i = 0; i < numTasks; i++)
+			task(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = task;
+		m_numTasks = numTasks;
+		m_nextTask = 0;
+		m_numBusyWorkers = m_threads.size();
+		m_taskException = nullptr;
+		m_jobId++;
+	}
+	m_newJob.notify_all();
+
+	runTasks();
+
+	std::exception_ptr taskException;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_jobFinished.wait(lock, [&] { return m_numBusyWorkers == 0; });
+		m_task = nullptr;
+		taskException = m_taskException;
+	}
+	if (taskException)
+		std::rethrow_exception(taskException);
+}
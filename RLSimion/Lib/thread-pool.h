@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+//Fixed set of worker threads used to run the same task over a range of indices (i.e., one call per
+//world copy). The calling thread also takes tasks, so a pool with N threads runs N+1 tasks at a time
+class ThreadPool
+{
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_newJob;
+	std::condition_variable m_jobFinished;
+	unsigned int m_jobId = 0;
+	bool m_bExit = false;
+
+	std::function<void(size_t)> m_task;
+	size_t m_numTasks = 0;
+	std::atomic<size_t> m_nextTask;
+	size_t m_numBusyWorkers = 0;
+	std::exception_ptr m_taskException;
+
+	void workerLoop();
+	void runTasks();
+public:
+	//numThreads: number of worker threads. If 0, one less than the number of hardware threads is used
+	ThreadPool(size_t numThreads = 0);
+	virtual ~ThreadPool();
+
+	size_t getNumThreads() const { return m_threads.size(); }
+
+	//Calls task(i) for i in [0, numTasks) and returns once all of them have finished. If any task throws
+	//an exception, it is rethrown here
+	void parallelFor(size_t numTasks, const std::function<void(size_t)>& task);
+};
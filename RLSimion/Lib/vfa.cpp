@@ -48,6 +48,41 @@ LinearVFA::~LinearVFA()
 		delete m_pPendingUpdates;
 }
 
+/// <summary>
+/// Saves the weights of the function in a checkpoint
+/// </summary>
+/// <param name="writer">The checkpoint being written</param>
+void LinearVFA::saveCheckpoint(CheckpointWriter& writer)
+{
+	if (!m_pWeights)
+		return;
+	vector<double> weights(m_numWeights);
+	for (size_t i = 0; i < m_numWeights; i++)
+		weights[i] = (*m_pWeights)[i];
+	writer.add("weights", weights);
+}
+
+/// <summary>
+/// Loads the weights of the function from a checkpoint, if it has the same number of weights
+/// </summary>
+/// <param name="reader">The checkpoint</param>
+void LinearVFA::loadCheckpoint(const CheckpointReader& reader)
+{
+	if (!m_pWeights)
+		return;
+	size_t numWeights;
+	const double* pWeights = reader.get("weights", numWeights);
+	if (!pWeights || numWeights != m_numWeights)
+	{
+		Logger::logMessage(MessageType::Warning, "The weights of a linear function couldn't be loaded from the checkpoint");
+		return;
+	}
+	for (size_t i = 0; i < m_numWeights; i++)
+		(*m_pWeights)[i] = pWeights[i];
+	if (m_pFrozenWeights)
+		m_pMemManager->copy(m_pWeights, m_pFrozenWeights);
+}
+
 void LinearVFA::setCanUseDeferredUpdates(bool bCanUseDeferredUpdates)
 {
 	m_bCanBeFrozen = bCanUseDeferredUpdates;
@@ -64,12 +99,7 @@ double LinearVFA::get(const FeatureList *pFeatures,bool bUseFrozenWeights)
 	double value = 0.0;
 	size_t localIndex;
 
-	IMemBuffer *pWeights;
-
-	if (!bUseFrozenWeights || !m_bCanBeFrozen || SimionApp::get()->pSimGod->getTargetFunctionUpdateFreq() == 0)
-		pWeights = m_pWeights;
-	else
-		pWeights = m_pFrozenWeights;
+	IMemBuffer *pWeights = getEvaluationWeights(bUseFrozenWeights);
 
 	for (size_t i = 0; i<pFeatures->m_numFeatures; i++)
 	{
@@ -84,6 +114,17 @@ double LinearVFA::get(const FeatureList *pFeatures,bool bUseFrozenWeights)
 	return value;
 }
 
+/// <summary>
+/// Returns the weights used to evaluate the function: the online weights, or the frozen ones if we are deferring updates
+/// </summary>
+/// <param name="bUseFrozenWeights">Flag used to determine whether to use the online or target function</param>
+IMemBuffer* LinearVFA::getEvaluationWeights(bool bUseFrozenWeights)
+{
+	if (!bUseFrozenWeights || !m_bCanBeFrozen || SimionApp::get()->pSimGod->getTargetFunctionUpdateFreq() == 0)
+		return m_pWeights;
+	return m_pFrozenWeights;
+}
+
 /// <summary>
 /// Sets the function to saturate its output in range [min,max]
 /// </summary>
@@ -179,6 +220,74 @@ void LinearVFA::set(size_t feature, double value)
 }
 
 
+//SNAPSHOTS: used to evaluate a fixed batch of inputs from another thread//////////////////////////
+
+LinearVFASnapshot::LinearVFASnapshot(LinearVFA* pVFA)
+{
+	m_pVFA = pVFA;
+	m_sampleFeatures.push_back(0);
+}
+
+/// <summary>
+/// Adds the features of a sample to the batch. Features outside [minIndex, maxIndex) don't belong to the function and are ignored,
+/// as in LinearVFA::get()
+/// </summary>
+void LinearVFASnapshot::addSample(const FeatureList* pFeatures, size_t minIndex, size_t maxIndex)
+{
+	for (size_t i = 0; i < pFeatures->m_numFeatures; i++)
+	{
+		size_t index = pFeatures->m_pFeatures[i].m_index;
+		if (index < minIndex || index >= maxIndex)
+			continue;
+		//until the batch is complete, we store the index of the weight itself
+		m_featureWeights.push_back(index - minIndex);
+		m_featureFactors.push_back(pFeatures->m_pFeatures[i].m_factor);
+	}
+	m_sampleFeatures.push_back(m_featureWeights.size());
+}
+
+/// <summary>
+/// Must be called after the last sample has been added. Samples close to each other share most of their weights, so
+/// each weight is only copied once on update()
+/// </summary>
+void LinearVFASnapshot::endBatch()
+{
+	m_weightIndices = m_featureWeights;
+	std::sort(m_weightIndices.begin(), m_weightIndices.end());
+	m_weightIndices.erase(std::unique(m_weightIndices.begin(), m_weightIndices.end()), m_weightIndices.end());
+	m_weightValues.resize(m_weightIndices.size());
+
+	for (size_t& weight : m_featureWeights)
+		weight = (size_t)(std::lower_bound(m_weightIndices.begin(), m_weightIndices.end(), weight) - m_weightIndices.begin());
+}
+
+/// <summary>
+/// Copies the weights used by the batch. Must be called from the thread that updates the function
+/// </summary>
+void LinearVFASnapshot::update()
+{
+	IMemBuffer* pWeights = m_pVFA->getEvaluationWeights();
+	for (size_t i = 0; i < m_weightIndices.size(); i++)
+		m_weightValues[i] = (*pWeights)[m_weightIndices[i]];
+}
+
+/// <summary>
+/// Evaluates the samples of the batch with the weights copied by the last call to update(). It only uses the snapshot's own
+/// data, so it can be called from any thread
+/// </summary>
+/// <param name="pOutput">Output buffer, with one value per sample</param>
+void LinearVFASnapshot::evaluate(double* pOutput)
+{
+	for (size_t sample = 0; sample + 1 < m_sampleFeatures.size(); sample++)
+	{
+		double value = 0.0;
+		for (size_t i = m_sampleFeatures[sample]; i < m_sampleFeatures[sample + 1]; i++)
+			value += m_weightValues[m_featureWeights[i]] * m_featureFactors[i];
+		pOutput[sample] = value;
+	}
+}
+
+
 //STATE VFA: V(s), pi(s), .../////////////////////////////////////////////////////////////////////
 
 LinearStateVFA::LinearStateVFA(ConfigNode* pConfigNode)
@@ -225,6 +334,17 @@ LinearStateVFA::LinearStateVFA(MemManager<SimionMemPool>* pMemManager, std::shar
 	:LinearVFA(pMemManager)
 {
 	m_pStateFeatureMap = stateFeatureMap;
+
+	m_numWeights = m_pStateFeatureMap->getTotalNumFeatures();
+	m_pWeights = 0;
+	m_minIndex = 0;
+	m_maxIndex = m_numWeights;
+
+	m_pAux = new FeatureList("LinearStateVFA/aux");
+
+	m_bSaturateOutput = false;
+	m_minOutput = 0.0;
+	m_maxOutput = 0.0;
 }
 
 
@@ -294,6 +414,44 @@ const vector<string>& LinearStateVFA::getInputActionVariables()
 	return m_pStateFeatureMap->getInputActionVariables();
 }
 
+/// <summary>
+/// Implements StateActionFunction::evaluateBatch(). Consecutive samples with the same state are only evaluated once
+/// </summary>
+void LinearStateVFA::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	StateActionBatchInputs inputs(this, pStateValues, pActionValues, s, a);
+	for (size_t sample = 0; sample < numSamples; sample++)
+	{
+		if (inputs.sameStateAsPrevious(sample))
+		{
+			pOutput[sample] = pOutput[sample - 1];
+			continue;
+		}
+		inputs.set(sample);
+		pOutput[sample] = get(s);
+	}
+}
+
+/// <summary>
+/// Implements StateActionFunction::createSnapshot(). The features of the batch are calculated here, so the snapshot can be
+/// evaluated without using the feature map
+/// </summary>
+StateActionFunctionSnapshot* LinearStateVFA::createSnapshot(const double* const* pStateValues, const double* const* pActionValues
+	, size_t numSamples, State* s, Action* a)
+{
+	StateActionBatchInputs inputs(this, pStateValues, pActionValues, s, a);
+	LinearVFASnapshot* pSnapshot = new LinearVFASnapshot(this);
+	for (size_t sample = 0; sample < numSamples; sample++)
+	{
+		inputs.set(sample);
+		getFeatures(s, m_pAux);
+		pSnapshot->addSample(m_pAux, m_minIndex, m_maxIndex);
+	}
+	pSnapshot->endBatch();
+	return pSnapshot;
+}
+
 
 
 
@@ -316,6 +474,9 @@ LinearStateActionVFA::LinearStateActionVFA(MemManager<SimionMemPool>* pMemManage
 	m_pAux = new FeatureList("LinearStateActionVFA/aux");
 	//this is used in "lower-level" methods
 	m_pAux2 = new FeatureList("LinearStateActionVFA/aux2");
+	//these are used to evaluate batches
+	m_pBatchStateFeatures = new FeatureList("LinearStateActionVFA/batch-state");
+	m_pBatchActionFeatures = new FeatureList("LinearStateActionVFA/batch-action");
 
 	m_bSaturateOutput = false;
 	m_minOutput = 0.0;
@@ -339,6 +500,8 @@ LinearStateActionVFA::~LinearStateActionVFA()
 	//SimGod owns the feature maps -> his responsability to free memory
 	if (m_pAux) delete m_pAux;
 	if (m_pAux2) delete m_pAux2;
+	if (m_pBatchStateFeatures) delete m_pBatchStateFeatures;
+	if (m_pBatchActionFeatures) delete m_pBatchActionFeatures;
 
 	if (m_pArgMaxTies) delete [] m_pArgMaxTies;
 }
@@ -548,4 +711,66 @@ const vector<string>& LinearStateActionVFA::getInputStateVariables()
 const vector<string>& LinearStateActionVFA::getInputActionVariables()
 {
 	return m_pActionFeatureMap->getInputActionVariables();
-}
\ No newline at end of file
+}
+
+/// <summary>
+/// Implements StateActionFunction::evaluateBatch(). The state and action features are kept between samples and only
+/// recalculated when the state (or the action) changes, so evaluating many actions in the same state (or the other way
+/// around) only uses one of the feature maps per sample. The state-action features are not built: the weight of each
+/// pair of state and action features is added as we go
+/// </summary>
+void LinearStateActionVFA::evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+	, State* s, Action* a, double* pOutput)
+{
+	StateActionBatchInputs inputs(this, pStateValues, pActionValues, s, a);
+	IMemBuffer* pWeights = getEvaluationWeights();
+	for (size_t sample = 0; sample < numSamples; sample++)
+	{
+		bool bNewState = !inputs.sameStateAsPrevious(sample);
+		bool bNewAction = !inputs.sameActionAsPrevious(sample);
+		if (!bNewState && !bNewAction)
+		{
+			pOutput[sample] = pOutput[sample - 1];
+			continue;
+		}
+		inputs.set(sample);
+		if (bNewState)
+			m_pStateFeatureMap->getFeatures(s, nullptr, m_pBatchStateFeatures);
+		if (bNewAction)
+			m_pActionFeatureMap->getFeatures(nullptr, a, m_pBatchActionFeatures);
+
+		//same as getFeatures() + get(), in the same order, without spawning the features
+		double value = 0.0;
+		for (size_t i = 0; i < m_pBatchStateFeatures->m_numFeatures; i++)
+		{
+			const size_t stateIndex = m_pBatchStateFeatures->m_pFeatures[i].m_index;
+			const double stateFactor = m_pBatchStateFeatures->m_pFeatures[i].m_factor;
+			for (size_t j = 0; j < m_pBatchActionFeatures->m_numFeatures; j++)
+			{
+				const size_t localIndex = stateIndex + m_pBatchActionFeatures->m_pFeatures[j].m_index * m_numStateWeights;
+				if (localIndex < m_numWeights)
+					value += (*pWeights)[localIndex] * (stateFactor * m_pBatchActionFeatures->m_pFeatures[j].m_factor);
+			}
+		}
+		pOutput[sample] = value;
+	}
+}
+
+/// <summary>
+/// Implements StateActionFunction::createSnapshot(). The features of the batch are calculated here, so the snapshot can be
+/// evaluated without using the feature maps
+/// </summary>
+StateActionFunctionSnapshot* LinearStateActionVFA::createSnapshot(const double* const* pStateValues, const double* const* pActionValues
+	, size_t numSamples, State* s, Action* a)
+{
+	StateActionBatchInputs inputs(this, pStateValues, pActionValues, s, a);
+	LinearVFASnapshot* pSnapshot = new LinearVFASnapshot(this);
+	for (size_t sample = 0; sample < numSamples; sample++)
+	{
+		inputs.set(sample);
+		getFeatures(s, a, m_pAux);
+		pSnapshot->addSample(m_pAux, m_minIndex, m_maxIndex);
+	}
+	pSnapshot->endBatch();
+	return pSnapshot;
+}
@@ -11,6 +11,7 @@ class ConfigFile;
 
 #include "parameters.h"
 #include "deferred-load.h"
+#include "checkpoint.h"
 #include "../Common/state-action-function.h"
 #include "mem-manager.h"
 class IMemBuffer;
@@ -19,7 +20,7 @@ class IMemBuffer;
 //LinearVFA////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////
 
-class LinearVFA
+class LinearVFA : public Checkpointable
 {
 protected:
 	//this is used to simplify the implementation of the StateActionFunction interface
@@ -43,6 +44,8 @@ public:
 	LinearVFA(MemManager<SimionMemPool>* pMemManager);
 	virtual ~LinearVFA();
 	double get(const FeatureList *features,bool bUseFrozenWeights= true);
+	//the weights used by get(): the online weights or, if we are deferring updates, the frozen ones
+	IMemBuffer* getEvaluationWeights(bool bUseFrozenWeights = true);
 	IMemBuffer *getWeights(){ return m_pWeights; }
 	size_t getNumWeights(){ return m_numWeights; }
 
@@ -55,6 +58,30 @@ public:
 
 	void setIndexOffset(unsigned int offset);
 
+	//the weights are saved in checkpoints. Once loaded, they are copied to the frozen weights too
+	void saveCheckpoint(CheckpointWriter& writer);
+	void loadCheckpoint(const CheckpointReader& reader);
+};
+
+//Snapshot of a linear function for a fixed batch of inputs: the features of every sample are calculated once, when the
+//snapshot is created, and update() only copies the weights used by those features
+class LinearVFASnapshot : public StateActionFunctionSnapshot
+{
+	LinearVFA* m_pVFA;
+	vector<size_t> m_sampleFeatures; //index of the first feature of each sample, plus the end of the last one
+	vector<size_t> m_featureWeights; //index in m_weightValues of the weight of each feature
+	vector<double> m_featureFactors;
+	vector<size_t> m_weightIndices; //weights used by the batch
+	vector<double> m_weightValues; //copy of those weights
+public:
+	LinearVFASnapshot(LinearVFA* pVFA);
+
+	void addSample(const FeatureList* pFeatures, size_t minIndex, size_t maxIndex);
+	//must be called after the last sample is added
+	void endBatch();
+
+	void update();
+	void evaluate(double* pOutput);
 };
 
 class LinearStateVFA: public LinearVFA, public StateActionFunction, public DeferredLoad
@@ -85,6 +112,10 @@ public:
 	vector<double>& evaluate(const State* s, const Action* a);
 	const vector<string>& getInputStateVariables();
 	const vector<string>& getInputActionVariables();
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+	StateActionFunctionSnapshot* createSnapshot(const double* const* pStateValues, const double* const* pActionValues
+		, size_t numSamples, State* s, Action* a);
 };
 
 
@@ -98,6 +129,9 @@ protected:
 
 	FeatureList *m_pAux = nullptr;
 	FeatureList *m_pAux2 = nullptr;
+	//features of the last state and action evaluated by evaluateBatch()
+	FeatureList *m_pBatchStateFeatures = nullptr;
+	FeatureList *m_pBatchActionFeatures = nullptr;
 	DOUBLE_PARAM m_initValue;
 	int *m_pArgMaxTies= nullptr;
 
@@ -138,4 +172,8 @@ public:
 	vector<double>& evaluate(const State* s, const Action* a);
 	const vector<string>& getInputStateVariables();
 	const vector<string>& getInputActionVariables();
+	void evaluateBatch(const double* const* pStateValues, const double* const* pActionValues, size_t numSamples
+		, State* s, Action* a, double* pOutput);
+	StateActionFunctionSnapshot* createSnapshot(const double* const* pStateValues, const double* const* pActionValues
+		, size_t numSamples, State* s, Action* a);
 };
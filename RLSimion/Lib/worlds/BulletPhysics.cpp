@@ -156,6 +156,198 @@ void BulletPhysics::updateBulletState(State* s, const Action* a, double dt)
 	for (auto it = m_bulletObjects.begin(); it != m_bulletObjects.end(); ++it)
 		(*it)->updateBulletState(s,a,dt);
 }
+//btDiscreteDynamicsWorld doesn't expose the time left over from the last call to stepSimulation(), but it
+//decides how many fixed substeps are taken in the next call, so it must be part of the snapshot
+struct DynamicsWorldLocalTime : public btDiscreteDynamicsWorld
+{
+	static btScalar& get(btDiscreteDynamicsWorld* pWorld)
+	{
+		return pWorld->*(&DynamicsWorldLocalTime::m_localTime);
+	}
+};
+
+void BulletPhysics::saveSnapshot(BulletSnapshot& snapshot)
+{
+	snapshot.clear();
+
+	btCollisionObjectArray& objects = m_dynamicsWorld->getCollisionObjectArray();
+	snapshot.write<int>(objects.size());
+	snapshot.write<int>(m_dynamicsWorld->getNumConstraints());
+	snapshot.write<btScalar>(DynamicsWorldLocalTime::get(m_dynamicsWorld));
+
+	//bodies
+	for (int i = 0; i < objects.size(); i++)
+	{
+		btCollisionObject* pObject = objects[i];
+		snapshot.write<int>(pObject->getInternalType());
+		snapshot.write<btTransform>(pObject->getWorldTransform());
+		snapshot.write<btTransform>(pObject->getInterpolationWorldTransform());
+		snapshot.write<btVector3>(pObject->getInterpolationLinearVelocity());
+		snapshot.write<btVector3>(pObject->getInterpolationAngularVelocity());
+		snapshot.write<int>(pObject->getActivationState());
+		snapshot.write<btScalar>(pObject->getDeactivationTime());
+		snapshot.write<btScalar>(pObject->getHitFraction());
+
+		btRigidBody* pRigidBody = btRigidBody::upcast(pObject);
+		if (pRigidBody)
+		{
+			snapshot.write<btVector3>(pRigidBody->getLinearVelocity());
+			snapshot.write<btVector3>(pRigidBody->getAngularVelocity());
+			snapshot.write<btVector3>(pRigidBody->getTotalForce());
+			snapshot.write<btVector3>(pRigidBody->getTotalTorque());
+		}
+		btSoftBody* pSoftBody = btSoftBody::upcast(pObject);
+		if (pSoftBody)
+		{
+			snapshot.write<int>(pSoftBody->m_nodes.size());
+			for (int n = 0; n < pSoftBody->m_nodes.size(); n++)
+			{
+				const btSoftBody::Node& node = pSoftBody->m_nodes[n];
+				snapshot.write<btVector3>(node.m_x);
+				snapshot.write<btVector3>(node.m_q);
+				snapshot.write<btVector3>(node.m_v);
+				snapshot.write<btVector3>(node.m_f);
+			}
+		}
+	}
+
+	//constraint warm-starting
+	for (int i = 0; i < m_dynamicsWorld->getNumConstraints(); i++)
+		snapshot.write<btScalar>(m_dynamicsWorld->getConstraint(i)->getAppliedImpulse());
+
+	//contact points (used to warm-start the solver). Manifolds are identified by the index of their bodies in the world
+	int numManifolds = m_dispatcher->getNumManifolds();
+	snapshot.write<int>(numManifolds);
+	for (int i = 0; i < numManifolds; i++)
+	{
+		btPersistentManifold* pManifold = m_dispatcher->getManifoldByIndexInternal(i);
+		snapshot.write<int>(pManifold->getBody0()->getWorldArrayIndex());
+		snapshot.write<int>(pManifold->getBody1()->getWorldArrayIndex());
+		snapshot.write<int>(pManifold->getNumContacts());
+		for (int c = 0; c < pManifold->getNumContacts(); c++)
+			snapshot.write<btManifoldPoint>(pManifold->getContactPoint(c));
+	}
+}
+
+void BulletPhysics::restoreSnapshot(BulletSnapshot& snapshot, State* s)
+{
+	snapshot.rewind();
+
+	btCollisionObjectArray& objects = m_dynamicsWorld->getCollisionObjectArray();
+	if (snapshot.read<int>() != objects.size() || snapshot.read<int>() != m_dynamicsWorld->getNumConstraints())
+		throw std::runtime_error("BulletPhysics::restoreSnapshot() was called with a snapshot from a different world");
+	DynamicsWorldLocalTime::get(m_dynamicsWorld) = snapshot.read<btScalar>();
+
+	//bodies
+	for (int i = 0; i < objects.size(); i++)
+	{
+		btCollisionObject* pObject = objects[i];
+		if (snapshot.read<int>() != pObject->getInternalType())
+			throw std::runtime_error("BulletPhysics::restoreSnapshot() was called with a snapshot from a different world");
+
+		btTransform worldTransform = snapshot.read<btTransform>();
+		pObject->setWorldTransform(worldTransform);
+		pObject->setInterpolationWorldTransform(snapshot.read<btTransform>());
+		pObject->setInterpolationLinearVelocity(snapshot.read<btVector3>());
+		pObject->setInterpolationAngularVelocity(snapshot.read<btVector3>());
+		pObject->forceActivationState(snapshot.read<int>());
+		pObject->setDeactivationTime(snapshot.read<btScalar>());
+		pObject->setHitFraction(snapshot.read<btScalar>());
+
+		btRigidBody* pRigidBody = btRigidBody::upcast(pObject);
+		if (pRigidBody)
+		{
+			if (pRigidBody->getMotionState())
+				pRigidBody->getMotionState()->setWorldTransform(worldTransform);
+			pRigidBody->setLinearVelocity(snapshot.read<btVector3>());
+			pRigidBody->setAngularVelocity(snapshot.read<btVector3>());
+			//the saved totals already include the linear/angular factors of the body, which applyCentralForce() and
+			//applyTorque() would apply again: they are set to 1 while the totals are restored, so that they are exact
+			btVector3 linearFactor = pRigidBody->getLinearFactor(), angularFactor = pRigidBody->getAngularFactor();
+			pRigidBody->setLinearFactor(btVector3(1.0, 1.0, 1.0));
+			pRigidBody->setAngularFactor(btVector3(1.0, 1.0, 1.0));
+			pRigidBody->clearForces();
+			pRigidBody->applyCentralForce(snapshot.read<btVector3>());
+			pRigidBody->applyTorque(snapshot.read<btVector3>());
+			pRigidBody->setLinearFactor(linearFactor);
+			pRigidBody->setAngularFactor(angularFactor);
+			pRigidBody->updateInertiaTensor();
+		}
+		btSoftBody* pSoftBody = btSoftBody::upcast(pObject);
+		if (pSoftBody)
+		{
+			if (snapshot.read<int>() != pSoftBody->m_nodes.size())
+				throw std::runtime_error("BulletPhysics::restoreSnapshot() was called with a snapshot from a different world");
+			for (int n = 0; n < pSoftBody->m_nodes.size(); n++)
+			{
+				btSoftBody::Node& node = pSoftBody->m_nodes[n];
+				node.m_x = snapshot.read<btVector3>();
+				node.m_q = snapshot.read<btVector3>();
+				node.m_v = snapshot.read<btVector3>();
+				node.m_f = snapshot.read<btVector3>();
+			}
+			pSoftBody->updateBounds();
+		}
+	}
+
+	//constraint warm-starting
+	for (int i = 0; i < m_dynamicsWorld->getNumConstraints(); i++)
+		m_dynamicsWorld->getConstraint(i)->internalSetAppliedImpulse(snapshot.read<btScalar>());
+
+	restoreContactCaches(snapshot);
+
+	updateState(s);
+}
+
+void BulletPhysics::restoreContactCaches(BulletSnapshot& snapshot)
+{
+	//Manifolds are owned by the collision algorithms in the broadphase pair cache, so they can't be
+	//recreated from the snapshot. Instead, the contents of the manifolds that still exist are overwritten
+	//with the saved contact points. The rest are emptied and will be refilled in the next step
+	int numManifolds = m_dispatcher->getNumManifolds();
+	for (int m = 0; m < numManifolds; m++)
+		m_dispatcher->getManifoldByIndexInternal(m)->clearManifold();
+
+	int numSavedManifolds = snapshot.read<int>();
+	for (int i = 0; i < numSavedManifolds; i++)
+	{
+		int body0 = snapshot.read<int>();
+		int body1 = snapshot.read<int>();
+		int numContacts = snapshot.read<int>();
+
+		btPersistentManifold* pManifold = 0;
+		for (int m = 0; m < numManifolds && !pManifold; m++)
+		{
+			btPersistentManifold* pCandidate = m_dispatcher->getManifoldByIndexInternal(m);
+			if (pCandidate->getBody0()->getWorldArrayIndex() == body0
+				&& pCandidate->getBody1()->getWorldArrayIndex() == body1)
+				pManifold = pCandidate;
+		}
+
+		for (int c = 0; c < numContacts; c++)
+		{
+			btManifoldPoint point = snapshot.read<btManifoldPoint>();
+			point.m_userPersistentData = 0;
+			if (pManifold)
+				pManifold->addManifoldPoint(point);
+		}
+	}
+
+	//bring the broadphase up to date with the restored bounding boxes
+	m_dynamicsWorld->updateAabbs();
+}
+
+void BulletPhysics::resetFromInitialSnapshot(State* s)
+{
+	if (m_initialSnapshot.isEmpty())
+	{
+		reset(s);
+		saveSnapshot(m_initialSnapshot);
+	}
+	else
+		restoreSnapshot(m_initialSnapshot, s);
+}
+
 ///////////////////////////////////////////
 //CAN ONLY BE USED WITH SOFTDYNAMICSWORLD//
 //////////////////////////////////////////
@@ -2,6 +2,7 @@
 #include "../../../3rd-party/bullet3-2.86/src/btBulletDynamicsCommon.h"
 
 #include "BulletCreationInterface.h"
+#include "BulletSnapshot.h"
 
 #include <stdio.h>
 #include <vector>
@@ -16,6 +17,10 @@ class BulletPhysics : public BulletCreationInterface
 	std::vector<btSoftBody*> m_pSoftObjects;
 
 	std::vector<BulletBody*> m_bulletObjects;
+
+	BulletSnapshot m_initialSnapshot;
+
+	void restoreContactCaches(BulletSnapshot& snapshot);
 public:
 	//CONSTANTS
 	static const double MASS_ROBOT;
@@ -66,5 +71,14 @@ public:
 	void updateState(State* s);
 	void updateBulletState(State* s, const Action* a, double dt);
 
+	//Snapshots of the whole simulated world. restoreSnapshot() brings the world back to the moment
+	//saveSnapshot() was called and updates the state variables bound to the bodies
+	void saveSnapshot(BulletSnapshot& snapshot);
+	void restoreSnapshot(BulletSnapshot& snapshot, State* s);
+
+	//The first call does a regular reset and saves a snapshot of the initial state. Later calls
+	//restore that snapshot instead. Only for worlds whose initial state doesn't depend on s
+	void resetFromInitialSnapshot(State* s);
+
 	btAlignedObjectArray<btCollisionShape*> getCollisionShape();
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../../../3rd-party/bullet3-2.86/src/LinearMath/btTransform.h"
+#include <vector>
+#include <string.h>
+#include <stdexcept>
+#include <type_traits>
+
+//Flat buffer holding a snapshot of a whole BulletPhysics world: body transforms and velocities,
+//soft-body nodes, constraint impulses and contact-point warm-starting data. It is written by
+//BulletPhysics::saveSnapshot() and read back by BulletPhysics::restoreSnapshot(). The buffer is
+//never shrunk, so saving several times into the same snapshot doesn't allocate after the first time
+class BulletSnapshot
+{
+	std::vector<char> m_buffer;
+	size_t m_size = 0;
+	size_t m_readOffset = 0;
+
+public:
+	BulletSnapshot() {}
+	virtual ~BulletSnapshot() {}
+
+	void clear() { m_size = 0; m_readOffset = 0; }
+	bool isEmpty() const { return m_size == 0; }
+	size_t getSize() const { return m_size; }
+	const char* getData() const { return m_buffer.data(); }
+
+	//rewinds the read offset so that the snapshot can be restored more than once
+	void rewind() { m_readOffset = 0; }
+	bool endOfSnapshot() const { return m_readOffset >= m_size; }
+
+	//only trivially copyable types are copied byte by byte. Vectors and transforms aren't in every build of Bullet (they
+	//may have their own copy operators to use SIMD instructions), so they are written component by component (see below)
+	template <typename T>
+	void write(const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "BulletSnapshot can only copy trivially copyable types");
+		if (m_size + sizeof(T) > m_buffer.size())
+			m_buffer.resize(2 * (m_size + sizeof(T)));
+		memcpy(&m_buffer[m_size], &value, sizeof(T));
+		m_size += sizeof(T);
+	}
+
+	template <typename T>
+	T read()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "BulletSnapshot can only copy trivially copyable types");
+		T value;
+		if (m_readOffset + sizeof(T) > m_size)
+			throw std::runtime_error("BulletSnapshot: tried to read past the end of the snapshot");
+		memcpy(&value, &m_buffer[m_readOffset], sizeof(T));
+		m_readOffset += sizeof(T);
+		return value;
+	}
+};
+
+template <>
+inline void BulletSnapshot::write<btVector3>(const btVector3& value)
+{
+	write<btScalar>(value.x());
+	write<btScalar>(value.y());
+	write<btScalar>(value.z());
+}
+
+template <>
+inline btVector3 BulletSnapshot::read<btVector3>()
+{
+	btScalar x = read<btScalar>();
+	btScalar y = read<btScalar>();
+	btScalar z = read<btScalar>();
+	return btVector3(x, y, z);
+}
+
+//a transform is written as the rows of its basis followed by its origin
+template <>
+inline void BulletSnapshot::write<btTransform>(const btTransform& value)
+{
+	for (int row = 0; row < 3; row++)
+		write<btVector3>(value.getBasis()[row]);
+	write<btVector3>(value.getOrigin());
+}
+
+template <>
+inline btTransform BulletSnapshot::read<btTransform>()
+{
+	btVector3 row0 = read<btVector3>();
+	btVector3 row1 = read<btVector3>();
+	btVector3 row2 = read<btVector3>();
+	btVector3 origin = read<btVector3>();
+	return btTransform(btMatrix3x3(row0.x(), row0.y(), row0.z(), row1.x(), row1.y(), row1.z(), row2.x(), row2.y(), row2.z()), origin);
+}
@@ -0,0 +1,99 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "BulletWorldPool.h"
+#include "BulletPhysics.h"
+#include <stdexcept>
+
+BulletWorldPool::BulletWorldPool(size_t numWorlds, std::function<void(BulletPhysics*)> createScene, size_t numThreads)
+	: m_threadPool(numThreads)
+{
+	for (size_t i = 0; i < numWorlds; i++)
+	{
+		BulletPhysics* pWorld = new BulletPhysics();
+		createScene(pWorld);
+		m_worlds.push_back(pWorld);
+	}
+}
+
+BulletWorldPool::~BulletWorldPool()
+{
+	for (auto it = m_worlds.begin(); it != m_worlds.end(); ++it)
+		delete (*it);
+}
+
+void BulletWorldPool::reset(const std::vector<State*>& s)
+{
+	if (s.size() != m_worlds.size())
+		throw std::runtime_error("BulletWorldPool::reset() was given a number of states different to the number of worlds");
+
+	m_threadPool.parallelFor(m_worlds.size(), [&](size_t i)
+	{
+		m_worlds[i]->resetFromInitialSnapshot(s[i]);
+	});
+}
+
+void BulletWorldPool::updateBulletState(const std::vector<State*>& s, const std::vector<const Action*>& a, double dt)
+{
+	if (s.size() != m_worlds.size() || a.size() != m_worlds.size())
+		throw std::runtime_error("BulletWorldPool::updateBulletState() was given a number of states/actions different to the number of worlds");
+
+	m_threadPool.parallelFor(m_worlds.size(), [&](size_t i)
+	{
+		m_worlds[i]->updateBulletState(s[i], a[i], dt);
+	});
+}
+
+void BulletWorldPool::stepSimulation(double dt, int maxSubSteps)
+{
+	m_threadPool.parallelFor(m_worlds.size(), [&](size_t i)
+	{
+		m_worlds[i]->stepSimulation((float)dt, maxSubSteps);
+	});
+}
+
+void BulletWorldPool::updateState(const std::vector<State*>& s)
+{
+	if (s.size() != m_worlds.size())
+		throw std::runtime_error("BulletWorldPool::updateState() was given a number of states different to the number of worlds");
+
+	m_threadPool.parallelFor(m_worlds.size(), [&](size_t i)
+	{
+		m_worlds[i]->updateState(s[i]);
+	});
+}
+
+void BulletWorldPool::executeAction(const std::vector<State*>& s, const std::vector<const Action*>& a, double dt, int maxSubSteps)
+{
+	if (s.size() != m_worlds.size() || a.size() != m_worlds.size())
+		throw std::runtime_error("BulletWorldPool::executeAction() was given a number of states/actions different to the number of worlds");
+
+	m_threadPool.parallelFor(m_worlds.size(), [&](size_t i)
+	{
+		m_worlds[i]->updateBulletState(s[i], a[i], dt);
+		m_worlds[i]->stepSimulation((float)dt, maxSubSteps);
+		m_worlds[i]->updateState(s[i]);
+	});
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../thread-pool.h"
+
+#include <vector>
+#include <functional>
+class BulletPhysics;
+class NamedVarSet;
+typedef NamedVarSet State;
+typedef NamedVarSet Action;
+
+//Set of independent Bullet worlds built from the same scene and stepped concurrently. Each world is
+//paired with the i-th state/action of the batched calls, so that N copies of the same environment
+//can be run with a single call per control step
+class BulletWorldPool
+{
+	std::vector<BulletPhysics*> m_worlds;
+	ThreadPool m_threadPool;
+
+public:
+	//createScene is called once per world with an empty BulletPhysics object and must initialize
+	//its physics and add the bodies. The worlds that provide one are PushBox1, PushBox2, PullBox1,
+	//PullBox2 and RobotControl (i.e., PushBox1::createScene)
+	BulletWorldPool(size_t numWorlds, std::function<void(BulletPhysics*)> createScene, size_t numThreads = 0);
+	virtual ~BulletWorldPool();
+
+	size_t getNumWorlds() const { return m_worlds.size(); }
+	BulletPhysics* getWorld(size_t i) { return m_worlds[i]; }
+
+	void reset(const std::vector<State*>& s);
+	void updateBulletState(const std::vector<State*>& s, const std::vector<const Action*>& a, double dt);
+	void stepSimulation(double dt, int maxSubSteps);
+	void updateState(const std::vector<State*>& s);
+
+	//updateBulletState(), stepSimulation() and updateState() within a single parallel pass over the worlds
+	void executeAction(const std::vector<State*>& s, const std::vector<const Action*>& a, double dt, int maxSubSteps = 20);
+};
@@ -24,6 +24,7 @@
 */
 
 #include "FAST.h"
+#include "windFieldCache.h"
 #include "../../Common/named-var-set.h"
 #include "../config.h"
 #include "world.h"
@@ -48,10 +49,12 @@ using namespace std;
 #define SERVO_MODULE_CONFIG_FILE "../config/world/FAST/NRELOffshrBsline5MW_Onshore_ServoDyn.dat"
 #define PORTAL_CONFIG_FILE "FASTDimensionalPortal.xml"
 #define DIMENSIONAL_PORTAL_PIPE_NAME "FASTDimensionalPortal"
+#define DIMENSIONAL_PORTAL_SHARED_MEMORY_NAME "FASTDimensionalPortal"
 #define DIMENSIONAL_PORTAL_DLL "../bin/FASTDimensionalPortal.dll"
 
 #define TRAINING_WIND_BASE_FILE_NAME "training-wind-file-"
 #define EVALUATION_WIND_BASE_FILE_NAME "eval-wind-file-"
+#define WIND_FIELD_CACHE_DIR "../cache/TurbSim"
 
 FASTWindTurbine::FASTWindTurbine(ConfigNode* pConfigNode)
 {
@@ -64,6 +67,9 @@ FASTWindTurbine::FASTWindTurbine(ConfigNode* pConfigNode)
 	{
 		m_trainingMeanWindSpeeds = MULTI_VALUE_SIMPLE_PARAM<DOUBLE_PARAM, double>(pConfigNode, "Training-Mean-Wind-Speeds", "Mean wind speeds used in training episodes", 12.5);
 		m_evaluationMeanWindSpeeds = MULTI_VALUE_SIMPLE_PARAM<DOUBLE_PARAM, double>(pConfigNode, "Evaluation-Mean-Wind-Speeds", "Mean wind speeds in evaluation episodes", 12.5);
+		m_bUseWindFieldCache = BOOL_PARAM(pConfigNode, "Use-Wind-Field-Cache", "Reuse the wind files generated by TurbSim in previous experiments with the same wind conditions", true);
+		m_windFieldCacheSize = INT_PARAM(pConfigNode, "Wind-Field-Cache-Size", "Maximum size (in MB) of the wind file cache. The least recently used files are removed", 4096);
+		m_bUseSharedMemory = BOOL_PARAM(pConfigNode, "Use-Shared-Memory", "Exchange states/actions with FAST through shared memory instead of a named pipe (lower latency per step)", false);
 	}
 
 	//model constants
@@ -185,9 +191,37 @@ FASTWindTurbine::FASTWindTurbine(ConfigNode* pConfigNode)
 }
 
 
+void FASTWindTurbine::generateWindFile(const string& baseFilename, double meanWindSpeed)
+{
+	string outBaseFilename = string(SimionApp::get()->getOutputDirectory()) + string("/") + baseFilename;
+	string outConfigFileName = outBaseFilename + string(".inp");
+	m_TurbSimConfigTemplate.instantiateConfigFile(outConfigFileName.c_str()
+		, SimionApp::get()->pExperiment->getEpisodeLength() + 30.0	//AnalysisTime
+		, SimionApp::get()->pExperiment->getEpisodeLength() + 30.0	//UsableTime
+		, meanWindSpeed);												//URef
+
+	//the random seeds are set in the template, so the instantiated file fully determines the wind field
+	string key;
+	if (m_pWindFieldCache)
+	{
+		key = WindFieldCache::getKey(m_TurbSimConfigTemplate.getInstantiatedConfigFile());
+		if (m_pWindFieldCache->fetch(key, outBaseFilename))
+		{
+			Logger::logMessage(MessageType::Info, (string("Reusing cached wind file: ") + baseFilename).c_str());
+			return;
+		}
+	}
+
+	string commandLine = string("../bin/TurbSim.exe") + string(" ") + outConfigFileName;
+	TurbSimProcess.spawn((char*)(commandLine).c_str());
+	TurbSimProcess.wait();
+
+	if (m_pWindFieldCache && !m_pWindFieldCache->store(key, outBaseFilename))
+		Logger::logMessage(MessageType::Warning, (string("Couldn't store wind file in cache: ") + baseFilename).c_str());
+}
+
 void FASTWindTurbine::deferredLoadStep()
 {
-	string outConfigFileName, exeFileName;
 	string commandLine;
 
 	//Generate templated TurbSim wind profiles
@@ -196,39 +230,22 @@ void FASTWindTurbine::deferredLoadStep()
 	{
 		Logger::logMessage(MessageType::Info, "Generating TurbSim wind files");
 
-		exeFileName = string("../bin/TurbSim.exe");
+		if (m_bUseWindFieldCache.get())
+		{
+			//TurbSim writes the .bts file read by FAST and the .twr file with the tower's wind
+			m_pWindFieldCache = new WindFieldCache(WIND_FIELD_CACHE_DIR
+				, (unsigned long long) m_windFieldCacheSize.get() * 1024 * 1024, { ".bts", ".twr" });
+		}
 
 		//evaluation wind files
 		for (unsigned int i = 0; i < m_evaluationMeanWindSpeeds.size(); i++)
-		{
-			outConfigFileName = string(SimionApp::get()->getOutputDirectory()) + string("/")
-				+ string(EVALUATION_WIND_BASE_FILE_NAME) + to_string(i) + string(".inp");
-			m_TurbSimConfigTemplate.instantiateConfigFile(outConfigFileName.c_str()
-				, SimionApp::get()->pExperiment->getEpisodeLength() + 30.0	//AnalysisTime
-				, SimionApp::get()->pExperiment->getEpisodeLength() + 30.0	//UsableTime
-				, m_evaluationMeanWindSpeeds[i]->get());						//URef
-
-			commandLine = exeFileName + string(" ") + outConfigFileName;
-			TurbSimProcess.spawn((char*)(commandLine).c_str());
-			TurbSimProcess.wait();
-		}
+			generateWindFile(string(EVALUATION_WIND_BASE_FILE_NAME) + to_string(i), m_evaluationMeanWindSpeeds[i]->get());
 		//set the number of episodes per evaluation
 		SimionApp::get()->pExperiment->setNumEpisodesPerEvaluation((int)m_evaluationMeanWindSpeeds.size());
 
 		//training wind files
 		for (unsigned int i = 0; i < m_trainingMeanWindSpeeds.size(); i++)
-		{
-			outConfigFileName = string(SimionApp::get()->getOutputDirectory()) + string("/") 
-				+ string(TRAINING_WIND_BASE_FILE_NAME) + to_string(i) + string(".inp");
-			m_TurbSimConfigTemplate.instantiateConfigFile(outConfigFileName.c_str()
-				, SimionApp::get()->pExperiment->getEpisodeLength()+30.0	//AnalysisTime
-				, SimionApp::get()->pExperiment->getEpisodeLength()+30.0	//UsableTime
-				, m_trainingMeanWindSpeeds[i]->get());						//URef
-
-			commandLine = exeFileName + string(" ") + outConfigFileName;
-			TurbSimProcess.spawn((char*)(commandLine).c_str());
-			TurbSimProcess.wait();
-		}
+			generateWindFile(string(TRAINING_WIND_BASE_FILE_NAME) + to_string(i), m_trainingMeanWindSpeeds[i]->get());
 	}
 	//Load the template used to tell FAST which wind file to use
 	m_FASTWindConfigTemplate.load(FAST_WIND_CONFIG_TEMPLATE_FILE);
@@ -254,6 +271,9 @@ void FASTWindTurbine::deferredLoadStep()
 FASTWindTurbine::~FASTWindTurbine()
 {
 	m_namedPipeServer.closeServer();
+	m_sharedMemoryServer.closeServer();
+	if (m_pWindFieldCache)
+		delete m_pWindFieldCache;
 	Logger::logMessage(MessageType::Info, "Closed connection to FASTDimensionalPortal");
 }
 
@@ -268,12 +288,21 @@ void FASTWindTurbine::reset(State *s)
 	//This may happen for slight inaccuracies of DT
 	if (FASTprocess.isRunning())
 		FASTprocess.stop();
-	//If the named pipe is already open, close it
+	//If the named pipe/shared memory are already open, close them
 	m_namedPipeServer.closeServer();
+	m_sharedMemoryServer.closeServer();
 
-	//Open the named pipe server
-	//FASTDimensionalPortal.xml -> used to pass the pipe's name to the dll
+	//Open the named pipe server and, if requested, the shared memory server
+	//FASTDimensionalPortal.xml -> used to pass the pipe's name to the dll. If the shared memory channel is used,
+	//its name is also passed and the dll will use it instead of the pipe
 	bool pipeServerOpened = m_namedPipeServer.openUniqueNamedPipeServer(DIMENSIONAL_PORTAL_PIPE_NAME);
+	bool sharedMemoryServerOpened = false;
+	if (m_bUseSharedMemory.get())
+	{
+		sharedMemoryServerOpened = m_sharedMemoryServer.openUniqueServer(DIMENSIONAL_PORTAL_SHARED_MEMORY_NAME);
+		if (!sharedMemoryServerOpened)
+			Logger::logMessage(MessageType::Warning, "Couldn't open shared memory server. Using the named pipe instead");
+	}
 	if (pipeServerOpened)
 	{
 		outConfigFileName = string(SimionApp::get()->getOutputDirectory()) + string("/")
@@ -281,8 +310,12 @@ void FASTWindTurbine::reset(State *s)
 		CrossPlatform::Fopen_s(&pOutConfigFile, outConfigFileName.c_str(), "w");
 		if (pOutConfigFile)
 		{
-			CrossPlatform::Fprintf_s(pOutConfigFile, "<?xml version=\"1.0\"?>\n<FAST-DIMENSIONAL-PORTAL>\n  <PIPE-NAME>%s</PIPE-NAME>\n</FAST-DIMENSIONAL-PORTAL>"
+			CrossPlatform::Fprintf_s(pOutConfigFile, "<?xml version=\"1.0\"?>\n<FAST-DIMENSIONAL-PORTAL>\n  <PIPE-NAME>%s</PIPE-NAME>\n"
 				, m_namedPipeServer.getPipeFullName());
+			if (sharedMemoryServerOpened)
+				CrossPlatform::Fprintf_s(pOutConfigFile, "  <SHARED-MEMORY-NAME>%s</SHARED-MEMORY-NAME>\n"
+					, m_sharedMemoryServer.getFullName());
+			CrossPlatform::Fprintf_s(pOutConfigFile, "</FAST-DIMENSIONAL-PORTAL>");
 			fclose(pOutConfigFile);
 			Logger::logMessage(MessageType::Info, "FASTDimensionalPortal.dll: pipe server created");
 		}
@@ -340,10 +373,17 @@ void FASTWindTurbine::reset(State *s)
 	if (bSpawned && FASTprocess.isRunning())
 	{
 		Logger::logMessage(MessageType::Info, "Waiting for the client to connect");
-		m_namedPipeServer.waitForClientConnection();
+		if (m_sharedMemoryServer.isConnected())
+		{
+			//if FAST crashes, we don't want to keep waiting for it
+			m_sharedMemoryServer.setPeerAliveCheck([this]() { return FASTprocess.isRunning(); });
+			m_sharedMemoryServer.waitForClientConnection();
+		}
+		else
+			m_namedPipeServer.waitForClientConnection();
 		Logger::logMessage(MessageType::Info, "Client connected");
 		//receive(s)
-		m_namedPipeServer.readToBuffer(s->getValueVector(), (int) s->getNumVars() * sizeof(double));
+		receiveFromPortal(s->getValueVector(), (int) s->getNumVars() * sizeof(double));
 	}
 	else
 	{
@@ -353,6 +393,20 @@ void FASTWindTurbine::reset(State *s)
 	}
 }
 
+int FASTWindTurbine::sendToPortal(const void* pBuffer, int numBytes)
+{
+	if (m_sharedMemoryServer.isConnected())
+		return m_sharedMemoryServer.writeBuffer(pBuffer, numBytes);
+	return m_namedPipeServer.writeBuffer(pBuffer, numBytes);
+}
+
+int FASTWindTurbine::receiveFromPortal(void* pBuffer, int numBytes)
+{
+	if (m_sharedMemoryServer.isConnected())
+		return m_sharedMemoryServer.readToBuffer(pBuffer, numBytes);
+	return m_namedPipeServer.readToBuffer(pBuffer, numBytes);
+}
+
 void FASTWindTurbine::executeAction(State *s,const Action *a,double dt)
 {
 	//Check FAST is still running
@@ -368,7 +422,7 @@ void FASTWindTurbine::executeAction(State *s,const Action *a,double dt)
 	//here we have to cheat the compiler (const). We don't want to, but we have to
 	double* pActionValues = ((Action*)a)->getValueVector();
 	int numBytesToWrite = sizeof(double) * 2; //hard-coded because there might be auxiliary actions added by the controller
-	int numBytesWritten= m_namedPipeServer.writeBuffer(pActionValues, numBytesToWrite);
+	int numBytesWritten= sendToPortal(pActionValues, numBytesToWrite);
 	if (numBytesToWrite != numBytesWritten)
 	{
 		Logger::logMessage(MessageType::Info, "FAST process ended prematurely");
@@ -379,7 +433,7 @@ void FASTWindTurbine::executeAction(State *s,const Action *a,double dt)
 
 	//receive(s')
 	size_t numBytesToRead = s->getNumVars() * sizeof(double);
-	size_t numBytesRead= m_namedPipeServer.readToBuffer(s->getValueVector(), (int) numBytesToRead);
+	size_t numBytesRead= receiveFromPortal(s->getValueVector(), (int) numBytesToRead);
 	if (numBytesToRead!=numBytesRead)
 	{
 		Logger::logMessage(MessageType::Info, "FAST process ended prematurely");
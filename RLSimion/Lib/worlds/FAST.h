@@ -3,23 +3,37 @@
 #include "world.h"
 #include "../deferred-load.h"
 #include "../../../tools/System/NamedPipe.h"
+#include "../../../tools/System/SharedMemoryChannel.h"
 #include "../../../tools/System/Process.h"
 #include "../parameters.h"
 #include "templatedConfigFile.h"
 
 class SetPoint;
+class WindFieldCache;
 class RewardFunction;
 
 class FASTWindTurbine : public DynamicModel, public DeferredLoad
 {
 	Process FASTprocess,TurbSimProcess;
 	NamedPipeServer m_namedPipeServer;
+	SharedMemoryServer m_sharedMemoryServer;
+	BOOL_PARAM m_bUseSharedMemory;
 
 	TemplatedConfigFile m_FASTConfigTemplate, m_FASTWindConfigTemplate, m_TurbSimConfigTemplate;
 
 	MULTI_VALUE_SIMPLE_PARAM<DOUBLE_PARAM,double> m_trainingMeanWindSpeeds;
 	MULTI_VALUE_SIMPLE_PARAM<DOUBLE_PARAM, double> m_evaluationMeanWindSpeeds;
 
+	BOOL_PARAM m_bUseWindFieldCache;
+	INT_PARAM m_windFieldCacheSize;
+	WindFieldCache* m_pWindFieldCache = nullptr;
+
+	void generateWindFile(const string& baseFilename, double meanWindSpeed);
+
+	//messages to/from FASTDimensionalPortal go through the shared memory channel or the named pipe
+	int sendToPortal(const void* pBuffer, int numBytes);
+	int receiveFromPortal(void* pBuffer, int numBytes);
+
 public:
 
 	FASTWindTurbine(ConfigNode* pParameters);
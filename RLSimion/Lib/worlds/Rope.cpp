@@ -26,10 +26,13 @@
 #include "Rope.h"
 #include <string>
 
-Rope::Rope(DynamicModel* pWorld, std::vector<btSoftBody*>* arr): BulletBody()
+Rope::Rope(std::vector<btSoftBody*>* arr): BulletBody()
 {
 	m_pSoftBodies = arr;
+}
 
+void Rope::addStateVariables(DynamicModel* pWorld, std::vector<btSoftBody*>* arr)
+{
 	unsigned int j;
 	int i;
 	for (j = 0; j < arr->size(); j++)
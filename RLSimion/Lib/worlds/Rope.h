@@ -12,7 +12,9 @@ class Rope: public BulletBody
 	std::vector<btSoftBody*>* m_pSoftBodies;
 public:
 
-	Rope(DynamicModel* pWorld, std::vector<btSoftBody*>* arr);
+	Rope(std::vector<btSoftBody*>* arr);
+	//adds the state variables of the rope links to the world. Copies of the scene (see BulletWorldPool) don't need them
+	static void addStateVariables(DynamicModel* pWorld, std::vector<btSoftBody*>* arr);
 	~Rope() = default;
 
 	//override these two methods from BulletBody
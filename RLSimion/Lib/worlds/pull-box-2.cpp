@@ -36,41 +36,10 @@
 
 
 
-PullBox2::PullBox2(ConfigNode* pConfigNode)
+void PullBox2::createScene(BulletPhysics* pBulletPhysics)
 {
-	METADATA("World", "Pull-Box-2");
-	m_target_X = addStateVariable("target-x", "m", -20.0, 20.0);
-	m_target_Y = addStateVariable("target-y", "m", -20.0, 20.0);
-
-	m_rob1_X = addStateVariable("robot1-x", "m", -20.0, 20.0);
-	m_rob1_Y = addStateVariable("robot1-y", "m", -20.0, 20.0);
-	m_rob2_X = addStateVariable("robot2-x", "m", -20.0, 20.0);
-	m_rob2_Y = addStateVariable("robot2-y", "m", -20.0, 20.0);
-
-	m_box_X = addStateVariable("box-x", "m", -20.0, 20.0);
-	m_box_Y = addStateVariable("box-y", "m", -20.0, 20.0);
-
-	m_theta_r1 = addStateVariable("robot1-theta", "rad", -3.15, 3.15, true);
-	m_theta_r2 = addStateVariable("robot2-theta", "rad", -3.15, 3.15, true);
-	m_boxTheta = addStateVariable("box-theta", "rad", -3.15, 3.15, true);
-	m_D_BtX = addStateVariable("box-to-target-x", "m", -20.0, 20.0);
-	m_D_BtY = addStateVariable("box-to-target-y", "m", -20.0, 20.0);
-
-	m_D_Br1X = addStateVariable("robot1-to-box-x", "m", -6.0, 6.0);
-	m_D_Br1Y = addStateVariable("robot1-to-box-y", "m", -6.0, 6.0);
-	m_D_Br2X = addStateVariable("robot2-to-box-x", "m", -6.0, 6.0);
-	m_D_Br2Y = addStateVariable("robot2-to-box-y", "m", -6.0, 6.0);
-
-	addActionVariable("robot1-v", "m/s", -2.0, 2.0);
-	addActionVariable("robot1-omega", "rad/s", -8.0, 8.0);
-	addActionVariable("robot2-v", "m/s", -2.0, 2.0);
-	addActionVariable("robot2-omega", "rad/s", -8.0, 8.0);
-
-	//init Bullet
-	m_pBulletPhysics = new BulletPhysics();
-
-	m_pBulletPhysics->initSoftPhysics();
-	m_pBulletPhysics->initPlayground();
+	pBulletPhysics->initSoftPhysics();
+	pBulletPhysics->initPlayground();
 
 	/// Creating target point, kinematic
 	{
@@ -78,7 +47,7 @@ PullBox2::PullBox2(ConfigNode* pConfigNode)
 			, btVector3(BulletPhysics::TargetX, BulletPhysics::TargetZ, BulletPhysics::TargetY)
 			, new btConeShape(btScalar(0.5), btScalar(0.001)));
 		pTarget->setAbsoluteStateVarIds("target-x", "target-y");
-		m_pBulletPhysics->add(pTarget);
+		pBulletPhysics->add(pTarget);
 	}
 
 	///Creating dynamic box
@@ -87,7 +56,7 @@ PullBox2::PullBox2(ConfigNode* pConfigNode)
 		, new btBoxShape(btVector3(btScalar(0.6), btScalar(0.6), btScalar(0.6))));
 	pBox->setAbsoluteStateVarIds("box-x", "box-y", "box-theta");
 	pBox->setRelativeStateVarIds("box-to-target-x", "box-to-target-y", "target-x", "target-y");
-	m_pBulletPhysics->add(pBox);
+	pBulletPhysics->add(pBox);
 
 	///creating  dynamic robot one
 	Robot* pRobot1 = new Robot(BulletPhysics::MASS_ROBOT
@@ -96,7 +65,7 @@ PullBox2::PullBox2(ConfigNode* pConfigNode)
 	pRobot1->setAbsoluteStateVarIds("robot1-x", "robot1-y", "robot1-theta");
 	pRobot1->setActionIds("robot1-v", "robot1-omega");
 	pRobot1->setRelativeStateVarIds("robot1-to-box-x", "robot1-to-box-y", "box-x", "box-y");
-	m_pBulletPhysics->add(pRobot1);
+	pBulletPhysics->add(pRobot1);
 
 	///creating  dynamic robot two
 	
@@ -106,16 +75,52 @@ PullBox2::PullBox2(ConfigNode* pConfigNode)
 	pRobot2->setAbsoluteStateVarIds("robot2-x", "robot2-y", "robot2-theta");
 	pRobot2->setActionIds("robot2-v", "robot2-omega");
 	pRobot2->setRelativeStateVarIds("robot2-to-box-x", "robot2-to-box-y", "box-x", "box-y");
-	m_pBulletPhysics->add(pRobot2);
+	pBulletPhysics->add(pRobot2);
 	
 
 	/// creating an union with rope between robot and box
 	{
-		m_pBulletPhysics->connectWithRope(pRobot1->getBody(), pBox->getBody());
-		m_pBulletPhysics->connectWithRope(pRobot2->getBody(), pBox->getBody());
-		Rope* pRope = new Rope(this, m_pBulletPhysics->getSoftBodiesArray());
-		m_pBulletPhysics->add(pRope);
+		pBulletPhysics->connectWithRope(pRobot1->getBody(), pBox->getBody());
+		pBulletPhysics->connectWithRope(pRobot2->getBody(), pBox->getBody());
+		Rope* pRope = new Rope(pBulletPhysics->getSoftBodiesArray());
+		pBulletPhysics->add(pRope);
 	}
+}
+
+PullBox2::PullBox2(ConfigNode* pConfigNode)
+{
+	METADATA("World", "Pull-Box-2");
+	m_target_X = addStateVariable("target-x", "m", -20.0, 20.0);
+	m_target_Y = addStateVariable("target-y", "m", -20.0, 20.0);
+
+	m_rob1_X = addStateVariable("robot1-x", "m", -20.0, 20.0);
+	m_rob1_Y = addStateVariable("robot1-y", "m", -20.0, 20.0);
+	m_rob2_X = addStateVariable("robot2-x", "m", -20.0, 20.0);
+	m_rob2_Y = addStateVariable("robot2-y", "m", -20.0, 20.0);
+
+	m_box_X = addStateVariable("box-x", "m", -20.0, 20.0);
+	m_box_Y = addStateVariable("box-y", "m", -20.0, 20.0);
+
+	m_theta_r1 = addStateVariable("robot1-theta", "rad", -3.15, 3.15, true);
+	m_theta_r2 = addStateVariable("robot2-theta", "rad", -3.15, 3.15, true);
+	m_boxTheta = addStateVariable("box-theta", "rad", -3.15, 3.15, true);
+	m_D_BtX = addStateVariable("box-to-target-x", "m", -20.0, 20.0);
+	m_D_BtY = addStateVariable("box-to-target-y", "m", -20.0, 20.0);
+
+	m_D_Br1X = addStateVariable("robot1-to-box-x", "m", -6.0, 6.0);
+	m_D_Br1Y = addStateVariable("robot1-to-box-y", "m", -6.0, 6.0);
+	m_D_Br2X = addStateVariable("robot2-to-box-x", "m", -6.0, 6.0);
+	m_D_Br2Y = addStateVariable("robot2-to-box-y", "m", -6.0, 6.0);
+
+	addActionVariable("robot1-v", "m/s", -2.0, 2.0);
+	addActionVariable("robot1-omega", "rad/s", -8.0, 8.0);
+	addActionVariable("robot2-v", "m/s", -2.0, 2.0);
+	addActionVariable("robot2-omega", "rad/s", -8.0, 8.0);
+
+	//init Bullet
+	m_pBulletPhysics = new BulletPhysics();
+	createScene(m_pBulletPhysics);
+	Rope::addStateVariables(this, m_pBulletPhysics->getSoftBodiesArray());
 
 	//the reward function
 	m_pRewardFunction->addRewardComponent(new DistanceReward2D(getStateDescriptor(),"box-x", "box-y", "target-x", "target-y"));
@@ -124,7 +129,7 @@ PullBox2::PullBox2(ConfigNode* pConfigNode)
 
 void PullBox2::reset(State *s)
 {
-	m_pBulletPhysics->reset(s);
+	m_pBulletPhysics->resetFromInitialSnapshot(s);
 }
 
 void PullBox2::executeAction(State *s, const Action *a, double dt)
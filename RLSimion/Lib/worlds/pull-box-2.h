@@ -30,4 +30,7 @@ public:
 
 	void reset(State *s);
 	void executeAction(State *s, const Action *a, double dt);
+
+	//initializes the physics and adds the bodies. Can be used to build copies of this world (see BulletWorldPool)
+	static void createScene(BulletPhysics* pBulletPhysics);
 };
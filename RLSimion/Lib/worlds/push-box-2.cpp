@@ -39,41 +39,10 @@ double static getDistanceBetweenPoints(double x1, double y1, double x2, double y
 	return distance;
 }
 
-PushBox2::PushBox2(ConfigNode* pConfigNode)
+void PushBox2::createScene(BulletPhysics* pBulletPhysics)
 {
-	METADATA("World", "Push-Box-2");
-	
-	m_target_X = addStateVariable("target-x", "m", -20.0, 20.0);
-	m_target_Y = addStateVariable("target-y", "m", -20.0, 20.0);
-	m_rob1_X = addStateVariable("robot1-x", "m", -20.0, 20.0);
-	m_rob1_Y = addStateVariable("robot1-y", "m", -20.0, 20.0);
-	m_rob2_X = addStateVariable("robot2-x", "m", -20.0, 20.0);
-	m_rob2_Y = addStateVariable("robot2-y", "m", -20.0, 20.0);
-
-	m_box_X  = addStateVariable("box-x", "m", -20.0, 20.0);
-	m_box_Y  = addStateVariable("box-y", "m", -20.0, 20.0);
-
-	m_D_Br1X = addStateVariable("robot1-to-box-x", "m", -20.0, 20.0);
-	m_D_Br1Y = addStateVariable("robot1-to-box-y", "m", -20.0, 20.0);
-	m_D_Br2X = addStateVariable("robot2-to-box-x", "m", -20.0, 20.0);
-	m_D_Br2Y = addStateVariable("robot2-to-box-y", "m", -20.0, 20.0);
-
-	m_D_BtX = addStateVariable("box-to-target-x", "m", -20.0, 20.0);
-	m_D_BtY = addStateVariable("box-to-target-y", "m", -20.0, 20.0);
-	m_theta_r1 = addStateVariable("robot1-theta", "rad", -3.15, 3.15, true);
-	m_theta_r2 = addStateVariable("robot2-theta", "rad", -3.15, 3.15, true);
-
-	m_boxTheta = addStateVariable("box-theta", "rad", -3.15, 3.15, true);
-
-	addActionVariable("robot1-v", "m/s", -2.0, 2.0);
-	addActionVariable("robot1-omega", "rad/s", -8.0, 8.0);
-	addActionVariable("robot2-v", "m/s", -2.0, 2.0);
-	addActionVariable("robot2-omega", "rad/s", -8.0, 8.0);
-
-	m_pBulletPhysics = new BulletPhysics();
-
-	m_pBulletPhysics->initPhysics();
-	m_pBulletPhysics->initPlayground();
+	pBulletPhysics->initPhysics();
+	pBulletPhysics->initPlayground();
 
 	/// Creating target point, kinematic
 	{
@@ -81,7 +50,7 @@ PushBox2::PushBox2(ConfigNode* pConfigNode)
 			, btVector3(BulletPhysics::TargetX, BulletPhysics::TargetZ, BulletPhysics::TargetY)
 			, new btConeShape(btScalar(0.5), btScalar(0.001)));
 		pTarget->setAbsoluteStateVarIds("target-x", "target-y");
-		m_pBulletPhysics->add(pTarget);
+		pBulletPhysics->add(pTarget);
 	}
 
 	///Creating dynamic box
@@ -91,7 +60,7 @@ PushBox2::PushBox2(ConfigNode* pConfigNode)
 			, new btBoxShape(btVector3(btScalar(0.6), btScalar(0.6), btScalar(0.6))));
 		pBox->setAbsoluteStateVarIds("box-x", "box-y", "box-theta");
 		pBox->setRelativeStateVarIds("box-to-target-x", "box-to-target-y", "target-x", "target-y");
-		m_pBulletPhysics->add(pBox);
+		pBulletPhysics->add(pBox);
 	}
 
 	///creating  dynamic robot one
@@ -102,7 +71,7 @@ PushBox2::PushBox2(ConfigNode* pConfigNode)
 		pRobot1->setAbsoluteStateVarIds("robot1-x", "robot1-y", "robot1-theta");
 		pRobot1->setActionIds("robot1-v", "robot1-omega");
 		pRobot1->setRelativeStateVarIds("robot1-to-box-x", "robot1-to-box-y", "box-x", "box-y");
-		m_pBulletPhysics->add(pRobot1);
+		pBulletPhysics->add(pRobot1);
 	}
 
 	///creating  dynamic robot two
@@ -113,9 +82,44 @@ PushBox2::PushBox2(ConfigNode* pConfigNode)
 		pRobot2->setAbsoluteStateVarIds("robot2-x", "robot2-y", "robot2-theta");
 		pRobot2->setActionIds("robot2-v", "robot2-omega");
 		pRobot2->setRelativeStateVarIds("robot2-to-box-x", "robot2-to-box-y", "box-x", "box-y");
-		m_pBulletPhysics->add(pRobot2);
+		pBulletPhysics->add(pRobot2);
 	}
+}
 
+PushBox2::PushBox2(ConfigNode* pConfigNode)
+{
+	METADATA("World", "Push-Box-2");
+	
+	m_target_X = addStateVariable("target-x", "m", -20.0, 20.0);
+	m_target_Y = addStateVariable("target-y", "m", -20.0, 20.0);
+	m_rob1_X = addStateVariable("robot1-x", "m", -20.0, 20.0);
+	m_rob1_Y = addStateVariable("robot1-y", "m", -20.0, 20.0);
+	m_rob2_X = addStateVariable("robot2-x", "m", -20.0, 20.0);
+	m_rob2_Y = addStateVariable("robot2-y", "m", -20.0, 20.0);
+
+	m_box_X  = addStateVariable("box-x", "m", -20.0, 20.0);
+	m_box_Y  = addStateVariable("box-y", "m", -20.0, 20.0);
+
+	m_D_Br1X = addStateVariable("robot1-to-box-x", "m", -20.0, 20.0);
+	m_D_Br1Y = addStateVariable("robot1-to-box-y", "m", -20.0, 20.0);
+	m_D_Br2X = addStateVariable("robot2-to-box-x", "m", -20.0, 20.0);
+	m_D_Br2Y = addStateVariable("robot2-to-box-y", "m", -20.0, 20.0);
+
+	m_D_BtX = addStateVariable("box-to-target-x", "m", -20.0, 20.0);
+	m_D_BtY = addStateVariable("box-to-target-y", "m", -20.0, 20.0);
+	m_theta_r1 = addStateVariable("robot1-theta", "rad", -3.15, 3.15, true);
+	m_theta_r2 = addStateVariable("robot2-theta", "rad", -3.15, 3.15, true);
+
+	m_boxTheta = addStateVariable("box-theta", "rad", -3.15, 3.15, true);
+
+	addActionVariable("robot1-v", "m/s", -2.0, 2.0);
+	addActionVariable("robot1-omega", "rad/s", -8.0, 8.0);
+	addActionVariable("robot2-v", "m/s", -2.0, 2.0);
+	addActionVariable("robot2-omega", "rad/s", -8.0, 8.0);
+
+	//Init Bullet
+	m_pBulletPhysics = new BulletPhysics();
+	createScene(m_pBulletPhysics);
 
 	//the reward function
 	m_pRewardFunction->addRewardComponent(new DistanceReward2D(getStateDescriptor(), "box-x", "box-y", "target-x", "target-y"));
@@ -124,7 +128,7 @@ PushBox2::PushBox2(ConfigNode* pConfigNode)
 
 void PushBox2::reset(State *s)
 {
-	m_pBulletPhysics->reset(s);
+	m_pBulletPhysics->resetFromInitialSnapshot(s);
 }
 
 void PushBox2::executeAction(State *s, const Action *a, double dt)
@@ -34,47 +34,50 @@
 #include "Box.h"
 
 
-RobotControl::RobotControl(ConfigNode* pConfigNode)
+void RobotControl::createScene(BulletPhysics* pBulletPhysics)
 {
-	METADATA("World", "Robot-control");
-
-	m_target_X = addStateVariable("target-x", "m", -20.0, 20.0);
-	m_target_Y = addStateVariable("target-y", "m", -20.0, 20.0);
+	const double massRobot = 0.5;
+	const double massTarget = 0.1;
 
-	m_rob1_X = addStateVariable("robot1-x", "m", -20.0, 20.0);
-	m_rob1_Y = addStateVariable("robot1-y", "m", -20.0, 20.0);
-	m_theta = addStateVariable("robot1-theta", "rad", -3.1415, 3.1415, true);
-
-	m_linear_vel = addActionVariable("robot1-v", "m/s", -2.0, 2.0);
-	m_omega = addActionVariable("robot1-omega", "rad", -8.0, 8.0);
-
-	MASS_ROBOT = 0.5f;
-	MASS_GROUND = 0.f;
-	MASS_TARGET = 0.1f;
-
-	m_pBulletPhysics = new BulletPhysics();
-	m_pBulletPhysics->initPhysics();
-	m_pBulletPhysics->initPlayground();
+	pBulletPhysics->initPhysics();
+	pBulletPhysics->initPlayground();
 	
 	/// Creating target point, kinematic
 	{
-		KinematicObject* pTarget = new KinematicObject(MASS_TARGET
+		KinematicObject* pTarget = new KinematicObject(massTarget
 			, btVector3(BulletPhysics::TargetX, 0, BulletPhysics::TargetY)
 			, new btConeShape(btScalar(0.5), btScalar(0.001)));
 		pTarget->setAbsoluteStateVarIds("target-x", "target-y");
-		m_pBulletPhysics->add(pTarget);
+		pBulletPhysics->add(pTarget);
 	}
 
 	///creating a dynamic robot  
 	{
-		Robot* pRobot1 = new Robot(MASS_ROBOT
+		Robot* pRobot1 = new Robot(massRobot
 			, btVector3(BulletPhysics::r1origin_x, 0, BulletPhysics::r1origin_y)
 			, new btSphereShape(0.5));
 		pRobot1->setAbsoluteStateVarIds("robot1-x", "robot1-y", "robot1-theta");
 		pRobot1->setActionIds("robot1-v", "robot1-omega");
-		m_pBulletPhysics->add(pRobot1);
+		pBulletPhysics->add(pRobot1);
 	}
+}
 
+RobotControl::RobotControl(ConfigNode* pConfigNode)
+{
+	METADATA("World", "Robot-control");
+
+	m_target_X = addStateVariable("target-x", "m", -20.0, 20.0);
+	m_target_Y = addStateVariable("target-y", "m", -20.0, 20.0);
+
+	m_rob1_X = addStateVariable("robot1-x", "m", -20.0, 20.0);
+	m_rob1_Y = addStateVariable("robot1-y", "m", -20.0, 20.0);
+	m_theta = addStateVariable("robot1-theta", "rad", -3.1415, 3.1415, true);
+
+	m_linear_vel = addActionVariable("robot1-v", "m/s", -2.0, 2.0);
+	m_omega = addActionVariable("robot1-omega", "rad", -8.0, 8.0);
+
+	m_pBulletPhysics = new BulletPhysics();
+	createScene(m_pBulletPhysics);
 
 	//the reward function
 	m_pRewardFunction->addRewardComponent(new DistanceReward2D(getStateDescriptor(),"robot1-x","robot1-y","target-x","target-y"));
@@ -83,7 +86,7 @@ RobotControl::RobotControl(ConfigNode* pConfigNode)
 
 void RobotControl::reset(State *s)
 {
-	m_pBulletPhysics->reset(s);
+	m_pBulletPhysics->resetFromInitialSnapshot(s);
 }
 
 void RobotControl::executeAction(State *s, const Action *a, double dt)
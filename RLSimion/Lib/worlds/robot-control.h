@@ -10,11 +10,6 @@ class BulletPhysics;
 //Move box with 2 robots
 class RobotControl : public DynamicModel
 {
-	/// All-Simulation variables
-	double MASS_TARGET;
-	double MASS_ROBOT;
-	double MASS_GROUND;
-
 	/// State variables
 	size_t m_target_X, m_target_Y;
 	size_t m_rob1_X, m_rob1_Y;
@@ -34,5 +29,8 @@ public:
 	void reset(State *s);
 	void executeAction(State *s, const Action *a, double dt);
 
+	//initializes the physics and adds the bodies. Can be used to build copies of this world (see BulletWorldPool)
+	static void createScene(BulletPhysics* pBulletPhysics);
+
 };
 
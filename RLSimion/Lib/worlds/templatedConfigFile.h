@@ -39,4 +39,6 @@ public:
 		return false;
 	}
 
+	//content of the last file instantiated
+	const char* getInstantiatedConfigFile() const { return m_pInstantiatedConfigFile; }
 };
@@ -0,0 +1,273 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "windFieldCache.h"
+#include "../../../tools/System/FileUtils.h"
+#include "../../../tools/System/CrossPlatform.h"
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <time.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <process.h>
+#include <sys/utime.h>
+#define makeDirectory(name) _mkdir(name)
+#define openFile _open
+#define closeFile _close
+#define getProcessId _getpid
+#define touchFile(name) _utime(name, nullptr)
+#define CREATE_EXCLUSIVE_FLAGS (_O_CREAT | _O_EXCL | _O_WRONLY)
+#else
+#include <unistd.h>
+#include <utime.h>
+#define makeDirectory(name) mkdir(name, 0777)
+#define openFile open
+#define closeFile close
+#define getProcessId getpid
+#define touchFile(name) utime(name, nullptr)
+#define CREATE_EXCLUSIVE_FLAGS (O_CREAT | O_EXCL | O_WRONLY)
+#endif
+
+#define LOCK_FILE_NAME ".lock"
+#define LOCK_TIMEOUT_SECONDS 30
+//a lock/temporary file older than this was left by a process that died while holding it
+#define STALE_FILE_SECONDS 600
+#define KEY_LENGTH 16
+#define COPY_BUFFER_SIZE (1024 * 1024)
+
+namespace
+{
+	bool getFileInfo(const std::string& filename, unsigned long long& size, time_t& lastModification)
+	{
+		struct stat info;
+		if (stat(filename.c_str(), &info) != 0)
+			return false;
+		size = (unsigned long long) info.st_size;
+		lastModification = info.st_mtime;
+		return true;
+	}
+
+	bool copyFile(const std::string& src, const std::string& dst)
+	{
+		FILE *pSrc, *pDst;
+		CrossPlatform::Fopen_s(&pSrc, src.c_str(), "rb");
+		if (!pSrc) return false;
+		CrossPlatform::Fopen_s(&pDst, dst.c_str(), "wb");
+		if (!pDst)
+		{
+			fclose(pSrc);
+			return false;
+		}
+		std::vector<char> buffer(COPY_BUFFER_SIZE);
+		size_t numBytesRead;
+		bool bOk = true;
+		while (bOk && (numBytesRead = fread(buffer.data(), 1, COPY_BUFFER_SIZE, pSrc)) > 0)
+			bOk = fwrite(buffer.data(), 1, numBytesRead, pDst) == numBytesRead;
+		bOk = bOk && !ferror(pSrc);
+		fclose(pSrc);
+		bOk = (fclose(pDst) == 0) && bOk;
+		return bOk;
+	}
+
+	//creates the directory and its parents if they don't exist
+	void makeDirectories(const std::string& directory)
+	{
+		for (size_t i = 1; i <= directory.size(); i++)
+		{
+			if (i == directory.size() || directory[i] == '/' || directory[i] == '\\')
+				makeDirectory(directory.substr(0, i).c_str());
+		}
+	}
+}
+
+WindFieldCache::WindFieldCache(const char* directory, unsigned long long maxSizeInBytes, const std::vector<std::string>& extensions)
+	: m_directory(directory), m_maxSizeInBytes(maxSizeInBytes), m_extensions(extensions)
+{
+	makeDirectories(m_directory);
+}
+
+std::string WindFieldCache::getKey(const char* instantiatedConfigFile)
+{
+	//64-bit FNV-1a: we only need a stable hash (the same across platforms and runs), not a cryptographic one
+	unsigned long long hash = 14695981039346656037ULL;
+	for (const char* p = instantiatedConfigFile; *p; p++)
+	{
+		//ignore carriage returns so that the same template gives the same key in Windows and Linux
+		if (*p == '\r') continue;
+		hash ^= (unsigned char)*p;
+		hash *= 1099511628211ULL;
+	}
+	char key[KEY_LENGTH + 1];
+	CrossPlatform::Sprintf_s(key, KEY_LENGTH + 1, "%016llx", hash);
+	return std::string(key);
+}
+
+std::string WindFieldCache::getEntryFilename(const std::string& key, const std::string& extension) const
+{
+	return m_directory + "/" + key + extension;
+}
+
+bool WindFieldCache::fetch(const std::string& key, const std::string& outputBaseName)
+{
+	//mark it as recently used first, so that no other process evicts it while we copy it
+	if (touchFile(getEntryFilename(key, m_extensions[0]).c_str()) != 0)
+		return false;
+
+	for (const std::string& extension : m_extensions)
+	{
+		if (!copyFile(getEntryFilename(key, extension), outputBaseName + extension))
+			return false;
+	}
+	return true;
+}
+
+bool WindFieldCache::store(const std::string& key, const std::string& inputBaseName)
+{
+	//the first extension is renamed last: an entry isn't considered to be in the cache until it exists
+	for (int i = (int)m_extensions.size() - 1; i >= 0; i--)
+	{
+		std::string entryFilename = getEntryFilename(key, m_extensions[i]);
+		std::string tempFilename = entryFilename + ".tmp-" + std::to_string(getProcessId());
+		if (!copyFile(inputBaseName + m_extensions[i], tempFilename))
+		{
+			remove(tempFilename.c_str());
+			return false;
+		}
+		if (rename(tempFilename.c_str(), entryFilename.c_str()) != 0)
+		{
+			//Windows doesn't overwrite existing files: another process stored the same entry
+			remove(tempFilename.c_str());
+		}
+	}
+
+	if (lock())
+	{
+		evict(key);
+		unlock();
+	}
+	return true;
+}
+
+bool WindFieldCache::lock()
+{
+	std::string lockFilename = m_directory + "/" + LOCK_FILE_NAME;
+	auto start = std::chrono::steady_clock::now();
+	while (true)
+	{
+		int fd = openFile(lockFilename.c_str(), CREATE_EXCLUSIVE_FLAGS, 0666);
+		if (fd >= 0)
+		{
+			closeFile(fd);
+			return true;
+		}
+
+		unsigned long long size;
+		time_t lastModification;
+		if (getFileInfo(lockFilename, size, lastModification) && difftime(time(nullptr), lastModification) > STALE_FILE_SECONDS)
+			remove(lockFilename.c_str());
+
+		if (std::chrono::steady_clock::now() - start > std::chrono::seconds(LOCK_TIMEOUT_SECONDS))
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+void WindFieldCache::unlock()
+{
+	remove((m_directory + "/" + LOCK_FILE_NAME).c_str());
+}
+
+void WindFieldCache::evict(const std::string& keyToKeep)
+{
+	struct Entry
+	{
+		unsigned long long size = 0;
+		time_t lastUse = 0;
+	};
+	std::map<std::string, Entry> entries;
+	unsigned long long totalSize = 0;
+
+	vector<string> files;
+	getFilesInDirectory(m_directory, files);
+	for (const string& file : files)
+	{
+		unsigned long long size;
+		time_t lastModification;
+		if (!getFileInfo(file, size, lastModification))
+			continue;
+
+		string filename = getFilename(file);
+		if (filename.find(".tmp-") != string::npos)
+		{
+			//temporary file left by a process that died while storing an entry
+			if (difftime(time(nullptr), lastModification) > STALE_FILE_SECONDS)
+				remove(file.c_str());
+			continue;
+		}
+		size_t extensionPos = filename.find('.');
+		if (extensionPos != KEY_LENGTH)
+			continue;
+		string key = filename.substr(0, KEY_LENGTH);
+		string extension = filename.substr(KEY_LENGTH);
+		if (std::find(m_extensions.begin(), m_extensions.end(), extension) == m_extensions.end())
+			continue;
+
+		Entry& entry = entries[key];
+		entry.size += size;
+		if (extension == m_extensions[0])
+			entry.lastUse = lastModification;
+		totalSize += size;
+	}
+
+	if (totalSize <= m_maxSizeInBytes)
+		return;
+
+	//least recently used first. Incomplete entries have lastUse=0, so they go first
+	std::vector<std::pair<time_t, std::string>> entriesByUse;
+	for (auto& entry : entries)
+		entriesByUse.push_back(std::make_pair(entry.second.lastUse, entry.first));
+	std::sort(entriesByUse.begin(), entriesByUse.end());
+
+	for (size_t i = 0; i < entriesByUse.size() && totalSize > m_maxSizeInBytes; i++)
+	{
+		const std::string& key = entriesByUse[i].second;
+		if (key == keyToKeep)
+			continue;
+		//the marker file is removed first so that the entry stops being fetched
+		bool bRemoved = true;
+		for (const std::string& extension : m_extensions)
+			bRemoved = (remove(getEntryFilename(key, extension).c_str()) == 0 || !fileExists(getEntryFilename(key, extension))) && bRemoved;
+		if (bRemoved)
+			totalSize -= entries[key].size;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//Content-addressed cache of the wind-field files generated by TurbSim. The key of an entry is a hash of
+//the instantiated TurbSim input file (which includes the random seeds), so the same wind conditions
+//always map to the same entry and TurbSim only needs to be run once. Entries are stored in a directory
+//shared by all the processes on the machine:
+//  - files are written with a temporary name and then renamed, so a reader never sees a partial file
+//  - stores and evictions are serialized with a lock file
+//  - when the total size exceeds the limit, the least recently used entries are removed
+class WindFieldCache
+{
+	std::string m_directory;
+	unsigned long long m_maxSizeInBytes;
+	std::vector<std::string> m_extensions;
+
+	std::string getEntryFilename(const std::string& key, const std::string& extension) const;
+	bool lock();
+	void unlock();
+	void evict(const std::string& keyToKeep);
+public:
+	//extensions: files generated by TurbSim that make up an entry (i.e. ".bts"). The first one is used
+	//to keep track of the last time the entry was used
+	WindFieldCache(const char* directory, unsigned long long maxSizeInBytes, const std::vector<std::string>& extensions);
+	virtual ~WindFieldCache() {}
+
+	static std::string getKey(const char* instantiatedConfigFile);
+
+	//If the entry is in the cache, its files are copied to outputBaseName + extension and true is returned
+	bool fetch(const std::string& key, const std::string& outputBaseName);
+	//Copies the files generated in inputBaseName + extension to the cache
+	bool store(const std::string& key, const std::string& inputBaseName);
+};
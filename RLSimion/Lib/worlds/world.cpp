@@ -57,6 +57,7 @@ CHILD_OBJECT_FACTORY<DynamicModel> World::m_pDynamicModel;
 World::World(ConfigNode* pConfigNode)
 {
 	if (!pConfigNode) return;
+	m_pConfigNode = pConfigNode;
 	m_episodeSimTime = 0.0;
 	m_totalSimTime = 0.0;
 
@@ -96,6 +97,18 @@ double World::getStepStartSimTime()
 	return m_stepStartSimTime;
 }
 
+/// <summary>
+/// Creates an independent instance of the dynamic model with the same configuration. Only the dynamic model is copied:
+/// models that read the simulation time of the world (i.e., to follow a setpoint) read the time of the main world
+/// </summary>
+/// <returns>The new instance</returns>
+std::shared_ptr<DynamicModel> World::createDynamicModelCopy()
+{
+	if (!m_pConfigNode)
+		return nullptr;
+	return DynamicModel::getInstance(m_pConfigNode->getChild("Dynamic-Model"));
+}
+
 Reward* World::getRewardVector()
 {
 	return m_pDynamicModel->getRewardVector();
@@ -68,6 +68,7 @@ public:
 class World
 {
 	static CHILD_OBJECT_FACTORY<DynamicModel> m_pDynamicModel;
+	ConfigNode* m_pConfigNode = nullptr;
 	INT_PARAM m_numIntegrationSteps;
 	DOUBLE_PARAM m_dt;
 
@@ -83,6 +84,9 @@ public:
 	double getTotalSimTime();
 	double getStepStartSimTime();
 	static DynamicModel* getDynamicModel(){ return m_pDynamicModel.ptr(); }
+	//creates another instance of the dynamic model from the same configuration, i.e., to simulate episodes in other threads
+	std::shared_ptr<DynamicModel> createDynamicModelCopy();
+	int getNumIntegrationSteps() { return m_numIntegrationSteps.get(); }
 	bool bIsFirstIntegrationStep() { return m_bFirstIntegrationStep; }
 	void setIsFirstIntegrationStep(bool bFirstIntegrationStep) { m_bFirstIntegrationStep = bFirstIntegrationStep; }
 
@@ -84,9 +84,12 @@ mkdir tmp/System-linux
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/CrossPlatform.cpp -o tmp/System-linux/CrossPlatform.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/DynamicLib-linux.cpp -o tmp/System-linux/DynamicLib-linux.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/FileUtils.cpp -o tmp/System-linux/FileUtils.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/MemoryMappedFile-linux.cpp -o tmp/System-linux/MemoryMappedFile-linux.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/NamedPipe-Common.cpp -o tmp/System-linux/NamedPipe-Common.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/NamedPipe-linux.cpp -o tmp/System-linux/NamedPipe-linux.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/Process-linux.cpp -o tmp/System-linux/Process-linux.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/SharedMemoryChannel-Common.cpp -o tmp/System-linux/SharedMemoryChannel-Common.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/SharedMemoryChannel-linux.cpp -o tmp/System-linux/SharedMemoryChannel-linux.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC tools/System/Timer.cpp -o tmp/System-linux/Timer.o
 ar rcs tmp/System-linux/System-linux.a tmp/System-linux/*.o 
 
@@ -290,7 +293,10 @@ ar rcs tmp/Bullet3-linux/Bullet3-linux.a tmp/Bullet3-linux/*.o
 
 echo [RLSimion-Common-linux]
 mkdir tmp/RLSimion-Common-linux
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Common/columnar-log.cpp -o tmp/RLSimion-Common-linux/columnar-log.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Common/log-episode-index.cpp -o tmp/RLSimion-Common-linux/log-episode-index.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Common/named-var-set.cpp -o tmp/RLSimion-Common-linux/named-var-set.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Common/state-action-function.cpp -o tmp/RLSimion-Common-linux/state-action-function.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Common/wire.cpp -o tmp/RLSimion-Common-linux/wire.o
 ar rcs tmp/RLSimion-Common-linux/RLSimion-Common-linux.a tmp/RLSimion-Common-linux/*.o 
 
@@ -319,6 +325,8 @@ g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/actor-regular.cpp -o tmp/RLSimion-Lib-linux/actor-regular.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/actor.cpp -o tmp/RLSimion-Lib-linux/actor.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/app.cpp -o tmp/RLSimion-Lib-linux/app.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/async-file-writer.cpp -o tmp/RLSimion-Lib-linux/async-file-writer.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/async-message-sender.cpp -o tmp/RLSimion-Lib-linux/async-message-sender.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/cntk-wrapper-loader.cpp -o tmp/RLSimion-Lib-linux/cntk-wrapper-loader.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/config.cpp -o tmp/RLSimion-Lib-linux/config.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/controller.cpp -o tmp/RLSimion-Lib-linux/controller.o
@@ -331,10 +339,17 @@ g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-discrete-q-policy.cpp -o tmp/RLSimion-Lib-linux/deep-discrete-q-policy.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-functions.cpp -o tmp/RLSimion-Lib-linux/deep-functions.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-layer.cpp -o tmp/RLSimion-Lib-linux/deep-layer.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-kernels.cpp -o tmp/RLSimion-Lib-linux/deep-kernels.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-learner.cpp -o tmp/RLSimion-Lib-linux/deep-learner.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-minibatch.cpp -o tmp/RLSimion-Lib-linux/deep-minibatch.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-native-network.cpp -o tmp/RLSimion-Lib-linux/deep-native-network.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-replay-buffer.cpp -o tmp/RLSimion-Lib-linux/deep-replay-buffer.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-parameter-server.cpp -o tmp/RLSimion-Lib-linux/deep-parameter-server.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deep-network-cache.cpp -o tmp/RLSimion-Lib-linux/deep-network-cache.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/checkpoint.cpp -o tmp/RLSimion-Lib-linux/checkpoint.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/deferred-load.cpp -o tmp/RLSimion-Lib-linux/deferred-load.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/DQN.cpp -o tmp/RLSimion-Lib-linux/DQN.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/async-deep-simion.cpp -o tmp/RLSimion-Lib-linux/async-deep-simion.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/etraces.cpp -o tmp/RLSimion-Lib-linux/etraces.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/experience-replay.cpp -o tmp/RLSimion-Lib-linux/experience-replay.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/experiment.cpp -o tmp/RLSimion-Lib-linux/experiment.o
@@ -357,17 +372,20 @@ g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/reward.cpp -o tmp/RLSimion-Lib-linux/reward.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/run-time-requirements.cpp -o tmp/RLSimion-Lib-linux/run-time-requirements.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/sample-file.cpp -o tmp/RLSimion-Lib-linux/sample-file.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/log-sample-converter.cpp -o tmp/RLSimion-Lib-linux/log-sample-converter.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/simgod.cpp -o tmp/RLSimion-Lib-linux/simgod.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/simion.cpp -o tmp/RLSimion-Lib-linux/simion.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/single-dimension-grid.cpp -o tmp/RLSimion-Lib-linux/single-dimension-grid.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/stats.cpp -o tmp/RLSimion-Lib-linux/stats.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/utils.cpp -o tmp/RLSimion-Lib-linux/utils.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/thread-pool.cpp -o tmp/RLSimion-Lib-linux/thread-pool.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/vfa-policy.cpp -o tmp/RLSimion-Lib-linux/vfa-policy.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/vfa.cpp -o tmp/RLSimion-Lib-linux/vfa.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/aux-rewards.cpp -o tmp/RLSimion-Lib-linux/aux-rewards.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/balancingpole.cpp -o tmp/RLSimion-Lib-linux/balancingpole.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/BulletBody.cpp -o tmp/RLSimion-Lib-linux/BulletBody.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/BulletPhysics.cpp -o tmp/RLSimion-Lib-linux/BulletPhysics.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/BulletWorldPool.cpp -o tmp/RLSimion-Lib-linux/BulletWorldPool.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/double-pendulum.cpp -o tmp/RLSimion-Lib-linux/double-pendulum.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/drone-6-dof-control.cpp -o tmp/RLSimion-Lib-linux/drone-6-dof-control.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/drone-6-dof.cpp -o tmp/RLSimion-Lib-linux/drone-6-dof.o
@@ -385,6 +403,7 @@ g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/setpoint.cpp -o tmp/RLSimion-Lib-linux/setpoint.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/swinguppendulum.cpp -o tmp/RLSimion-Lib-linux/swinguppendulum.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/templatedConfigFile.cpp -o tmp/RLSimion-Lib-linux/templatedConfigFile.o
+g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/windFieldCache.cpp -o tmp/RLSimion-Lib-linux/windFieldCache.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/underwatervehicle.cpp -o tmp/RLSimion-Lib-linux/underwatervehicle.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/windturbine.cpp -o tmp/RLSimion-Lib-linux/windturbine.o
 g++ -c -g2 -gdwarf-2 -w -Wswitch -W"no-deprecated-declarations" -W"empty-body" -W"return-type" -Wparentheses -W"no-format" -Wuninitialized -W"unreachable-code" -W"unused-function" -W"unused-value" -W"unused-variable" -Wswitch -W"no-deprecated-declarations" -Wconversion -O0 -fno-strict-aliasing -fno-omit-frame-pointer -fthreadsafe-statics -fexceptions -frtti -x c++ -std=c++11 -fPIC RLSimion/Lib/worlds/world.cpp -o tmp/RLSimion-Lib-linux/world.o
@@ -405,7 +424,18 @@ mkdir tmp/SystemTests
 g++ -c -x c++ -std=c++11 tests/System/main-linux.cpp -Itests/linux -o tests/System/main-linux.cpp.o
 g++ -o tmp/SystemTests/SystemTests.exe tests/System/main-linux.cpp.o -Wl,--no-undefined  "tmp/System-linux/System-linux.a" -lpthread
 
+echo [PortalStandIn]
+mkdir tmp/PortalStandIn
+g++ -c -x c++ -std=c++11 -O2 tests/FAST/PortalStandIn/PortalStandIn.cpp -o tmp/PortalStandIn/PortalStandIn.o
+g++ -o tmp/PortalStandIn/PortalStandIn.exe tmp/PortalStandIn/PortalStandIn.o -Wl,--no-undefined  "tmp/System-linux/System-linux.a" "tmp/tinyxml2-linux/tinyxml2-linux.a" -lpthread
+
+echo [SimionLogToSamples]
+mkdir tmp/SimionLogToSamples
+g++ -c -x c++ -std=c++11 -O2 tools/SimionLogToSamples/main.cpp -o tmp/SimionLogToSamples/main.o
+g++ -o tmp/SimionLogToSamples/SimionLogToSamples.exe tmp/SimionLogToSamples/main.o -Wl,--no-undefined  "tmp/RLSimion-Lib-linux/RLSimion-Lib-linux.a" "tmp/RLSimion-Common-linux/RLSimion-Common-linux.a" "tmp/System-linux/System-linux.a" "tmp/tinyxml2-linux/tinyxml2-linux.a" -lpthread
+
 echo "#### 2. Run unit tests"
 tmp/GeometryLibTests/GeometryLibTests.exe
 tmp/RLSimionTests/RLSimionTests.exe
 tmp/SystemTests/SystemTests.exe
+tmp/PortalStandIn/PortalStandIn.exe --benchmark 1000
@@ -0,0 +1,227 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+//Stand-in for FAST + FASTDimensionalPortal.dll, used to test the coupling with RLSimion without FAST.
+//It exchanges the same messages as the real portal: the state (FAST_NUM_STATE_VARS doubles) is sent
+//first, and then, for each control step, an action (FAST_NUM_ACTION_VARS doubles) is received and the
+//next state is sent back.
+//
+//Usage:
+//  PortalStandIn <FASTDimensionalPortal.xml> [numSteps]
+//      Connects to the server named in the config file (shared memory if SHARED-MEMORY-NAME is given,
+//      the named pipe otherwise), just like the DLL does
+//  PortalStandIn --benchmark [numSteps]
+//      Plays the role of FASTWindTurbine: opens a shared memory server, spawns another instance of this
+//      program as the client and measures the round-trip time of each control step
+
+#include "../../../tools/System/NamedPipe.h"
+#include "../../../tools/System/SharedMemoryChannel.h"
+#include "../../../tools/System/Process.h"
+#include "../../../tools/System/Timer.h"
+#include "../../../tools/System/CrossPlatform.h"
+#include "../../../3rd-party/tinyxml2/tinyxml2.h"
+
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define FAST_NUM_STATE_VARS 19 //must match the state variables declared in FASTWindTurbine
+#define FAST_NUM_ACTION_VARS 2
+#define DEFAULT_NUM_STEPS 10000
+#define BENCHMARK_CONFIG_FILE "PortalStandIn-benchmark.xml"
+
+using namespace std;
+
+class PortalStandIn
+{
+	NamedPipeClient m_namedPipeClient;
+	SharedMemoryClient m_sharedMemoryClient;
+
+	double m_state[FAST_NUM_STATE_VARS];
+	double m_action[FAST_NUM_ACTION_VARS];
+public:
+	bool connect(const char* configFile)
+	{
+		tinyxml2::XMLDocument config;
+		if (config.LoadFile(configFile) != tinyxml2::XML_NO_ERROR)
+		{
+			cout << "PortalStandIn: Could not open configuration file " << configFile << "\n";
+			return false;
+		}
+		tinyxml2::XMLElement* pNode = config.FirstChildElement("FAST-DIMENSIONAL-PORTAL");
+		if (!pNode) return false;
+
+		tinyxml2::XMLElement* pSharedMemoryNode = pNode->FirstChildElement("SHARED-MEMORY-NAME");
+		if (pSharedMemoryNode)
+			return m_sharedMemoryClient.connectToServer(pSharedMemoryNode->GetText(), false);
+
+		tinyxml2::XMLElement* pPipeNode = pNode->FirstChildElement("PIPE-NAME");
+		if (pPipeNode)
+			return m_namedPipeClient.connectToServer(pPipeNode->GetText(), false);
+		return false;
+	}
+
+	int send(const void* pBuffer, int numBytes)
+	{
+		if (m_sharedMemoryClient.isConnected())
+			return m_sharedMemoryClient.writeBuffer(pBuffer, numBytes);
+		return m_namedPipeClient.writeBuffer(pBuffer, numBytes);
+	}
+
+	int receive(void* pBuffer, int numBytes)
+	{
+		if (m_sharedMemoryClient.isConnected())
+			return m_sharedMemoryClient.readToBuffer(pBuffer, numBytes);
+		return m_namedPipeClient.readToBuffer(pBuffer, numBytes);
+	}
+
+	//Toy dynamics: the values only need to change and depend on the action so that the server can check them
+	void run(int numSteps)
+	{
+		for (int i = 0; i < FAST_NUM_STATE_VARS; i++)
+			m_state[i] = 0.0;
+
+		const int stateSize = (int) sizeof(m_state);
+		const int actionSize = (int) sizeof(m_action);
+
+		send(m_state, stateSize);
+		for (int step = 0; step < numSteps; step++)
+		{
+			if (receive(m_action, actionSize) != actionSize)
+				break;
+			for (int i = 0; i < FAST_NUM_STATE_VARS; i++)
+				m_state[i] = m_action[i % FAST_NUM_ACTION_VARS] + (double)(step + 1);
+			if (send(m_state, stateSize) != stateSize)
+				break;
+		}
+		m_sharedMemoryClient.closeConnection();
+		m_namedPipeClient.closeConnection();
+	}
+};
+
+int runBenchmark(const char* exeName, int numSteps)
+{
+	SharedMemoryServer server;
+	if (!server.openUniqueServer("PortalStandIn"))
+	{
+		cout << "Couldn't open the shared memory server\n";
+		return 1;
+	}
+	FILE* pConfigFile;
+	CrossPlatform::Fopen_s(&pConfigFile, BENCHMARK_CONFIG_FILE, "w");
+	if (!pConfigFile)
+	{
+		cout << "Couldn't create " << BENCHMARK_CONFIG_FILE << "\n";
+		return 1;
+	}
+	CrossPlatform::Fprintf_s(pConfigFile, "<?xml version=\"1.0\"?>\n<FAST-DIMENSIONAL-PORTAL>\n  <SHARED-MEMORY-NAME>%s</SHARED-MEMORY-NAME>\n</FAST-DIMENSIONAL-PORTAL>"
+		, server.getFullName());
+	fclose(pConfigFile);
+
+	Process client;
+	string commandLine = string(exeName) + " " + BENCHMARK_CONFIG_FILE + " " + to_string(numSteps);
+	if (!client.spawn(commandLine.c_str()))
+	{
+		cout << "Couldn't spawn the client process\n";
+		return 1;
+	}
+	server.setPeerAliveCheck([&client]() { return client.isRunning(); });
+	if (!server.waitForClientConnection())
+	{
+		cout << "The client didn't connect\n";
+		return 1;
+	}
+
+	double state[FAST_NUM_STATE_VARS];
+	double action[FAST_NUM_ACTION_VARS];
+	const int stateSize = (int) sizeof(state);
+	const int actionSize = (int) sizeof(action);
+	if (server.readToBuffer(state, stateSize) != stateSize)
+	{
+		cout << "Failed to receive the initial state\n";
+		return 1;
+	}
+
+	Timer timer;
+	double minTime = 1e10, totalTime = 0.0;
+	int step;
+	for (step = 0; step < numSteps; step++)
+	{
+		action[0] = (double)step;
+		action[1] = -(double)step;
+
+		timer.start();
+		if (server.writeBuffer(action, actionSize) != actionSize
+			|| server.readToBuffer(state, stateSize) != stateSize)
+			break;
+		double elapsedTime = timer.getElapsedTime();
+
+		if (state[0] != action[0] + (double)(step + 1))
+		{
+			cout << "Wrong state received in step " << step << "\n";
+			return 1;
+		}
+		totalTime += elapsedTime;
+		if (elapsedTime < minTime) minTime = elapsedTime;
+	}
+	server.closeServer();
+	client.wait();
+	remove(BENCHMARK_CONFIG_FILE);
+
+	if (step < numSteps)
+	{
+		cout << "The client disconnected after " << step << " steps\n";
+		return 1;
+	}
+	cout << "Shared memory round trip (" << numSteps << " steps): mean= " << 1e6 * totalTime / numSteps
+		<< "us, min= " << 1e6 * minTime << "us\n";
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		cout << "Usage: PortalStandIn <FASTDimensionalPortal.xml> [numSteps]\n       PortalStandIn --benchmark [numSteps]\n";
+		return 1;
+	}
+	int numSteps = DEFAULT_NUM_STEPS;
+	if (argc > 2)
+		numSteps = atoi(argv[2]);
+
+	if (!strcmp(argv[1], "--benchmark"))
+		return runBenchmark(argv[0], numSteps);
+
+	PortalStandIn portal;
+	if (!portal.connect(argv[1]))
+	{
+		cout << "PortalStandIn: couldn't connect to the server\n";
+		return 1;
+	}
+	portal.run(numSteps);
+	return 0;
+}
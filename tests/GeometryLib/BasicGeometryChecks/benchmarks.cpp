@@ -0,0 +1,206 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../../tools/GeometryLib/matrix44.h"
+#include "../../../tools/GeometryLib/quaternion.h"
+#include "../../../tools/GeometryLib/vector3d.h"
+#include "../../../tools/GeometryLib/transform3d.h"
+#include "../../../tools/GeometryLib/bounding-box.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//These tests check that the vectorized versions of the GeometryLib operations give exactly the same
+//results as the scalar code they replaced (reimplemented here as reference) and print how long
+//each version takes
+
+namespace BasicGeometryBenchmarks
+{
+	const size_t numPoints = 100000;
+	const int numRepetitions = 20;
+
+	double randomValue() { return -10.0 + 20.0 * ((double)rand() / (double)RAND_MAX); }
+
+	Point3D referenceTransform(const Matrix44& m, const Point3D& v)
+	{
+		return Point3D(m.get(0, 0)*v.x() + m.get(1, 0)*v.y() + m.get(2, 0)*v.z() + m.get(3, 0)
+			, m.get(0, 1)*v.x() + m.get(1, 1)*v.y() + m.get(2, 1)*v.z() + m.get(3, 1)
+			, m.get(0, 2)*v.x() + m.get(1, 2)*v.y() + m.get(2, 2)*v.z() + m.get(3, 2));
+	}
+
+	Matrix44 referenceProduct(const Matrix44& a, const Matrix44& b)
+	{
+		Matrix44 result;
+		for (int col = 0; col < 4; col++)
+			for (int row = 0; row < 4; row++)
+				result.set(col, row, a.get(0, row)*b.get(col, 0) + a.get(1, row)*b.get(col, 1)
+					+ a.get(2, row)*b.get(col, 2) + a.get(3, row)*b.get(col, 3));
+		return result;
+	}
+
+	Quaternion referenceProduct(const Quaternion& a, const Quaternion& b)
+	{
+		Quaternion result(a.w() * b.x() + a.x() * b.w() + a.y() * b.z() - a.z() * b.y()
+			, a.w() * b.y() + a.y() * b.w() + a.z() * b.x() - a.x() * b.z()
+			, a.w() * b.z() + a.z() * b.w() + a.x() * b.y() - a.y() * b.x()
+			, a.w() * b.w() - a.x() * b.x() - a.y() * b.y() - a.z() * b.z());
+		result.normalize();
+		return result;
+	}
+
+	bool equal(const Vector3D& a, const Vector3D& b)
+	{
+		return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+	}
+
+	double elapsedMilliseconds(std::chrono::high_resolution_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	TEST_CLASS(GeometryLibBenchmark)
+	{
+	public:
+		TEST_METHOD(Geometry_BenchmarkTransformPoints)
+		{
+			Transform3D transform;
+			transform.setTranslation(Vector3D(1.0, -2.0, 3.5));
+			transform.setRotation(Quaternion(0.3, -1.2, 0.7));
+			transform.setScale(Vector3D(2.0, 0.5, 1.5));
+			Matrix44 matrix = transform.transformMatrix();
+
+			std::vector<Point3D> points(numPoints), transformed(numPoints), reference(numPoints);
+			for (size_t i = 0; i < numPoints; i++)
+				points[i] = Point3D(randomValue(), randomValue(), randomValue());
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int rep = 0; rep < numRepetitions; rep++)
+				for (size_t i = 0; i < numPoints; i++)
+					reference[i] = referenceTransform(matrix, points[i]);
+			double scalarTime = elapsedMilliseconds(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int rep = 0; rep < numRepetitions; rep++)
+				transform.transformPoints(points.data(), transformed.data(), numPoints);
+			double batchTime = elapsedMilliseconds(start);
+
+			std::cout << "Transform " << numPoints << " points x" << numRepetitions << ": scalar " << scalarTime
+				<< " ms, batch " << batchTime << " ms\n";
+
+			for (size_t i = 0; i < numPoints; i++)
+			{
+				Assert::IsTrue(equal(reference[i], transformed[i]));
+				Assert::IsTrue(equal(reference[i], matrix * points[i]));
+			}
+		}
+
+		TEST_METHOD(Geometry_BenchmarkSetTransform)
+		{
+			Vector3D translation(1.0, -2.0, 3.5), scale(2.0, 0.5, 1.5);
+			Quaternion rotation(0.3, -1.2, 0.7);
+			Matrix44 translationMatrix, rotationMatrix, scaleMatrix;
+			translationMatrix.setTranslation(translation);
+			rotationMatrix.setRotation(rotation);
+			scaleMatrix.setScale(scale);
+
+			Matrix44 reference = referenceProduct(referenceProduct(translationMatrix, rotationMatrix), scaleMatrix);
+			Matrix44 product = translationMatrix * rotationMatrix * scaleMatrix;
+			Matrix44 composed;
+			composed.setTransform(translation, rotation, scale);
+			for (int col = 0; col < 4; col++)
+				for (int row = 0; row < 4; row++)
+				{
+					Assert::IsTrue(reference.get(col, row) == product.get(col, row));
+					Assert::IsTrue(reference.get(col, row) == composed.get(col, row));
+				}
+
+			const int numMatrices = 1000000;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < numMatrices; i++)
+				reference = referenceProduct(referenceProduct(translationMatrix, rotationMatrix), scaleMatrix);
+			double scalarTime = elapsedMilliseconds(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < numMatrices; i++)
+				product = translationMatrix * rotationMatrix * scaleMatrix;
+			double productTime = elapsedMilliseconds(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int i = 0; i < numMatrices; i++)
+				composed.setTransform(translation, rotation, scale);
+			double composedTime = elapsedMilliseconds(start);
+
+			std::cout << "Compose " << numMatrices << " transforms: scalar products " << scalarTime << " ms, products "
+				<< productTime << " ms, setTransform " << composedTime << " ms\n";
+		}
+
+		TEST_METHOD(Geometry_BenchmarkQuaternionProduct)
+		{
+			const int numQuaternions = 1000;
+			std::vector<Quaternion> quaternions(numQuaternions);
+			for (int i = 0; i < numQuaternions; i++)
+				quaternions[i] = Quaternion(randomValue(), randomValue(), randomValue());
+
+			Quaternion reference, result;
+			for (int i = 0; i < numQuaternions; i++)
+			{
+				reference = referenceProduct(reference, quaternions[i]);
+				result = result * quaternions[i];
+				Assert::IsTrue(reference.x() == result.x() && reference.y() == result.y()
+					&& reference.z() == result.z() && reference.w() == result.w());
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int rep = 0; rep < 1000; rep++)
+				for (int i = 0; i < numQuaternions; i++)
+					reference = referenceProduct(reference, quaternions[i]);
+			double scalarTime = elapsedMilliseconds(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int rep = 0; rep < 1000; rep++)
+				for (int i = 0; i < numQuaternions; i++)
+					result = result * quaternions[i];
+			double simdTime = elapsedMilliseconds(start);
+
+			std::cout << "Multiply " << 1000 * numQuaternions << " quaternions: scalar " << scalarTime << " ms, vectorized "
+				<< simdTime << " ms\n";
+
+			//rotating a vector with the quaternion must give the same result as the rotation matrix
+			Matrix44 rotationMatrix;
+			Vector3D v(1.0, 2.0, 3.0), rotated;
+			for (int i = 0; i < numQuaternions; i++)
+			{
+				rotationMatrix.setRotation(quaternions[i]);
+				quaternions[i].rotate(&v, &rotated, 1);
+				Assert::AreEqual(0.0, (rotationMatrix * v - rotated).length(), 0.0000001, L"Quaternion rotation doesn't match the rotation matrix");
+			}
+		}
+
+		TEST_METHOD(Geometry_BenchmarkBoundingBox)
+		{
+			std::vector<Point3D> points(numPoints);
+			for (size_t i = 0; i < numPoints; i++)
+				points[i] = Point3D(randomValue(), randomValue(), randomValue());
+
+			BoundingBox3D reference, box;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int rep = 0; rep < numRepetitions; rep++)
+				for (size_t i = 0; i < numPoints; i++)
+					reference.addPoint(points[i]);
+			double scalarTime = elapsedMilliseconds(start);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int rep = 0; rep < numRepetitions; rep++)
+				box.addPoints(points.data(), numPoints);
+			double batchTime = elapsedMilliseconds(start);
+
+			std::cout << "Bounding box of " << numPoints << " points x" << numRepetitions << ": addPoint " << scalarTime
+				<< " ms, addPoints " << batchTime << " ms\n";
+
+			Assert::IsTrue(equal(reference.min(), box.min()));
+			Assert::IsTrue(equal(reference.max(), box.max()));
+		}
+	};
+}
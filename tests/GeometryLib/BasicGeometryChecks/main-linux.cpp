@@ -1,10 +1,51 @@
 #include <iostream>
 #include <stdexcept>
+#include "benchmarks.cpp"
 #include "unittest1.cpp"
 int main()
 {
   int retCode= 0;
 
+  try
+  {
+    BasicGeometryBenchmarks::GeometryLibBenchmark::Geometry_BenchmarkTransformPoints();
+    std::cout << "Passed Geometry_BenchmarkTransformPoints()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Geometry_BenchmarkTransformPoints()\n";
+  }
+  try
+  {
+    BasicGeometryBenchmarks::GeometryLibBenchmark::Geometry_BenchmarkSetTransform();
+    std::cout << "Passed Geometry_BenchmarkSetTransform()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Geometry_BenchmarkSetTransform()\n";
+  }
+  try
+  {
+    BasicGeometryBenchmarks::GeometryLibBenchmark::Geometry_BenchmarkQuaternionProduct();
+    std::cout << "Passed Geometry_BenchmarkQuaternionProduct()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Geometry_BenchmarkQuaternionProduct()\n";
+  }
+  try
+  {
+    BasicGeometryBenchmarks::GeometryLibBenchmark::Geometry_BenchmarkBoundingBox();
+    std::cout << "Passed Geometry_BenchmarkBoundingBox()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Geometry_BenchmarkBoundingBox()\n";
+  }
   try
   {
     BasicGeometryChecks::GeometryLibTest::Geometry_BoundingBoxInsideFrustum();
@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/async-file-writer.h"
+#include <stdio.h>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#define ASYNC_WRITER_TEST_FILE "async-file-writer-test.bin"
+
+namespace AsyncFileWriters
+{
+	TEST_CLASS(AsyncFileWriterTest)
+	{
+	public:
+		static const int recordSize = 100;
+
+		//each record is filled with its index, so that we can check that they were written whole and in order
+		static void fillRecord(char* pRecord, int index)
+		{
+			for (int i = 0; i < recordSize; i++)
+				pRecord[i] = (char)(index % 127);
+		}
+
+		static vector<char> readFile(const char* filename)
+		{
+			vector<char> content;
+			FILE* pFile = fopen(filename, "rb");
+			if (!pFile) return content;
+			char buffer[4096];
+			size_t numBytesRead;
+			while ((numBytesRead = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+				content.insert(content.end(), buffer, buffer + numBytesRead);
+			fclose(pFile);
+			return content;
+		}
+
+		TEST_METHOD(AsyncFileWriter_BackPressure)
+		{
+			//small blocks and ring, so that the writer thread falls behind and the producer has to wait
+			AsyncFileWriter writer(256, 4);
+			Assert::IsTrue(writer.open(ASYNC_WRITER_TEST_FILE, LogOverflowPolicy::backPressure));
+
+			const int numRecords = 20000;
+			char record[recordSize];
+			for (int i = 0; i < numRecords; i++)
+			{
+				fillRecord(record, i);
+				Assert::IsTrue(writer.write(record, recordSize, true));
+				if (i % 1000 == 0) writer.flush();
+			}
+			Assert::AreEqual((size_t)(numRecords * recordSize), writer.getNumBytesWritten());
+			writer.close();
+			Assert::IsFalse(writer.hasWriteErrors());
+			Assert::AreEqual((size_t)0, writer.getNumDroppedRecords());
+
+			vector<char> content = readFile(ASYNC_WRITER_TEST_FILE);
+			Assert::AreEqual((size_t)(numRecords * recordSize), content.size());
+			for (int i = 0; i < numRecords; i++)
+			{
+				fillRecord(record, i);
+				Assert::IsTrue(memcmp(record, &content[i * recordSize], recordSize) == 0);
+			}
+			remove(ASYNC_WRITER_TEST_FILE);
+		}
+
+		TEST_METHOD(AsyncFileWriter_Drop)
+		{
+			AsyncFileWriter writer(256, 4);
+			Assert::IsTrue(writer.open(ASYNC_WRITER_TEST_FILE, LogOverflowPolicy::drop));
+
+			//the header can't be dropped, the records can
+			const char header[] = "header";
+			Assert::IsTrue(writer.write(header, sizeof(header)));
+
+			const int numRecords = 20000;
+			char record[recordSize];
+			vector<int> writtenRecords;
+			for (int i = 0; i < numRecords; i++)
+			{
+				fillRecord(record, i);
+				if (writer.write(record, recordSize, true))
+					writtenRecords.push_back(i);
+			}
+			writer.close();
+			Assert::AreEqual((size_t)numRecords, writtenRecords.size() + writer.getNumDroppedRecords());
+
+			//only whole records can be missing
+			vector<char> content = readFile(ASYNC_WRITER_TEST_FILE);
+			Assert::AreEqual(sizeof(header) + writtenRecords.size() * recordSize, content.size());
+			Assert::IsTrue(memcmp(header, &content[0], sizeof(header)) == 0);
+			for (size_t i = 0; i < writtenRecords.size(); i++)
+			{
+				fillRecord(record, writtenRecords[i]);
+				Assert::IsTrue(memcmp(record, &content[sizeof(header) + i * recordSize], recordSize) == 0);
+			}
+			remove(ASYNC_WRITER_TEST_FILE);
+		}
+	};
+}
@@ -0,0 +1,158 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/async-message-sender.h"
+#include "../../tools/System/NamedPipe.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace AsyncMessageSenders
+{
+	//Records the messages instead of writing them to the pipe. Writing can be stalled to simulate an agent that doesn't
+	//read the pipe
+	class TestMessageSender : public AsyncMessageSender
+	{
+		mutex m_mutex;
+		condition_variable m_condition;
+		bool m_bStalled = false;
+		bool m_bWriting = false;
+		vector<string> m_messages;
+	protected:
+		virtual void writeMessage(const string& message)
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_bWriting = true;
+			m_condition.notify_all();
+			m_condition.wait(lock, [this] { return !m_bStalled; });
+			m_messages.push_back(message);
+		}
+	public:
+		TestMessageSender(size_t maxNumQueuedMessages) : AsyncMessageSender(maxNumQueuedMessages) {}
+		~TestMessageSender() { close(); }
+
+		void stall()
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_bStalled = true;
+			m_bWriting = false;
+		}
+		void waitUntilWriting()
+		{
+			unique_lock<mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_bWriting; });
+		}
+		void resume()
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_bStalled = false;
+			m_condition.notify_all();
+		}
+		vector<string> getMessages()
+		{
+			lock_guard<mutex> lock(m_mutex);
+			return m_messages;
+		}
+	};
+
+	TEST_CLASS(AsyncMessageSenderTest)
+	{
+	public:
+		TEST_METHOD(AsyncMessageSender_Drop)
+		{
+			NamedPipeClient pipe;
+			TestMessageSender sender(4);
+			sender.setOverflowPolicy(LogOverflowPolicy::drop);
+			sender.open(&pipe);
+
+			//the sender thread gets stuck writing the first message
+			sender.stall();
+			Assert::IsTrue(sender.send("first", true));
+			sender.waitUntilWriting();
+
+			//none of these calls can wait for the sender thread
+			for (int i = 0; i < 1000; i++)
+				sender.sendProgress(("progress " + std::to_string(i)).c_str());
+			int numInfoSent = 0;
+			for (int i = 0; i < 10; i++)
+				if (sender.send(("info " + std::to_string(i)).c_str(), true)) numInfoSent++;
+			Assert::IsTrue(sender.send("evaluation 0", false));
+			Assert::IsTrue(sender.send("evaluation 1", false));
+			Assert::AreEqual(4, numInfoSent);
+			Assert::AreEqual((size_t)6, sender.getNumDroppedMessages());
+
+			sender.resume();
+			sender.close();
+
+			//messages are sent in order, and only the last progress message is sent
+			vector<string> messages = sender.getMessages();
+			const char* expected[] = { "first", "progress 999", "info 0", "info 1", "info 2", "info 3", "evaluation 0", "evaluation 1" };
+			Assert::AreEqual(sizeof(expected) / sizeof(expected[0]), messages.size());
+			for (size_t i = 0; i < messages.size(); i++)
+				Assert::AreEqual(string(expected[i]), messages[i]);
+		}
+
+		TEST_METHOD(AsyncMessageSender_BackPressure)
+		{
+			NamedPipeClient pipe;
+			TestMessageSender sender(2);
+			sender.setOverflowPolicy(LogOverflowPolicy::backPressure);
+			sender.open(&pipe);
+
+			//the caller waits for room in the queue, so no message is lost
+			sender.stall();
+			std::thread resumer([&sender]()
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				sender.resume();
+			});
+			const int numMessages = 100;
+			for (int i = 0; i < numMessages; i++)
+				Assert::IsTrue(sender.send(std::to_string(i).c_str(), true));
+			sender.flush();
+			resumer.join();
+
+			vector<string> messages = sender.getMessages();
+			Assert::AreEqual((size_t)numMessages, messages.size());
+			for (int i = 0; i < numMessages; i++)
+				Assert::AreEqual(std::to_string(i), messages[i]);
+			Assert::AreEqual((size_t)0, sender.getNumDroppedMessages());
+		}
+
+		TEST_METHOD(AsyncMessageSender_OrderAndClose)
+		{
+			NamedPipeClient pipe;
+			TestMessageSender sender(16);
+			sender.open(&pipe);
+
+			//a progress message replaced by a newer one is sent after the messages queued before the newer one
+			sender.stall();
+			sender.send("first", false);
+			sender.waitUntilWriting();
+			sender.sendProgress("progress 0");
+			sender.send("info 0", true);
+			sender.sendProgress("progress 1");
+			sender.send("info 1", true);
+			sender.resume();
+			sender.flush();
+			sender.sendProgress("progress 2");
+			sender.send("info 2", true);
+			sender.close();
+
+			vector<string> messages = sender.getMessages();
+			const char* expected[] = { "first", "info 0", "progress 1", "info 1", "progress 2", "info 2" };
+			Assert::AreEqual(sizeof(expected) / sizeof(expected[0]), messages.size());
+			for (size_t i = 0; i < messages.size(); i++)
+				Assert::AreEqual(string(expected[i]), messages[i]);
+
+			//once closed, the sender stays closed
+			Assert::IsTrue(sender.isClosed());
+			sender.open(&pipe);
+			sender.sendProgress("progress 3");
+			Assert::IsFalse(sender.send("info 3", false));
+			sender.flush();
+			Assert::AreEqual(messages.size(), sender.getMessages().size());
+		}
+	};
+}
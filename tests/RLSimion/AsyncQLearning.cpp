@@ -0,0 +1,125 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestApp.h"
+#include "../../RLSimion/Lib/async-deep-simion.h"
+#include "../../RLSimion/Lib/checkpoint.h"
+#include "../../RLSimion/Lib/simgod.h"
+#include "../../RLSimion/Lib/experiment.h"
+#include "../../RLSimion/Lib/worlds/world.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace AsyncQLearningTests
+{
+	TEST_CLASS(AsyncQLearningTest)
+	{
+	public:
+		//three training episodes, each one followed by an evaluation episode
+		static string getExperimentConfig()
+		{
+			return "<Random-Seed>1</Random-Seed><Num-Episodes>3</Num-Episodes><Eval-Freq>1</Eval-Freq><Episode-Length>5.0</Episode-Length>";
+		}
+
+		static string getAsyncQLearningConfig()
+		{
+			return string("<Async-Q-Learning><Num-Actor-Learners>2</Num-Actor-Learners><Async-Update-Steps>2</Async-Update-Steps>")
+				+ "<Target-Update-Steps>10</Target-Update-Steps><Num-Parameter-Shards>2</Num-Parameter-Shards>"
+				+ "<Q-Network><Input-State><Input-State>position</Input-State></Input-State><Input-State><Input-State>velocity</Input-State></Input-State>"
+				+ "<Output-Action><Output-Action>acceleration</Output-Action></Output-Action><Num-Action-Steps>5</Num-Action-Steps>"
+				+ "<Backend>Native</Backend><Minibatch-Size>2</Minibatch-Size>"
+				+ "<Learner><Learner-Type><SGD><Learning-Rate><Schedule><Constant><Value>0.01</Value></Constant></Schedule></Learning-Rate></SGD></Learner-Type></Learner>"
+				+ "<Layers><Num-Units>8</Num-Units><Activation>Tanh</Activation></Layers></Q-Network>"
+				+ "<Policy><Policy><Discrete-Epsilon-Greedy-Deep-Policy><epsilon><Schedule><Constant><Value>0.5</Value></Constant></Schedule></epsilon>"
+				+ "</Discrete-Epsilon-Greedy-Deep-Policy></Policy></Policy></Async-Q-Learning>";
+		}
+
+		//the shared parameters, read from a checkpoint
+		static vector<double> getSharedParameters(AsyncQLearning& asyncQLearning, const string& filename)
+		{
+			CheckpointWriter writer;
+			Assert::IsTrue(writer.open(filename));
+			asyncQLearning.saveCheckpoint(writer);
+			Assert::IsTrue(writer.close());
+
+			CheckpointReader reader;
+			Assert::IsTrue(reader.open(filename));
+			size_t numParameters = 0;
+			Assert::IsTrue(reader.get("parameters", numParameters) != nullptr);
+			vector<double> parameters(numParameters);
+			Assert::IsTrue(reader.read("parameters", parameters));
+			return parameters;
+		}
+
+		TEST_METHOD(AsyncQLearning_RunAndDestroy)
+		{
+			//the background actor-learners are stopped by the app after the last training episode, before it is destroyed
+			TestApp app("AsyncQLearning_RunAndDestroy", getExperimentConfig()
+				, "<Simion><Type>" + getAsyncQLearningConfig() + "</Type></Simion>");
+			app.get()->run();
+		}
+
+		TEST_METHOD(AsyncQLearning_PausedInEvaluation)
+		{
+			TestApp app("AsyncQLearning_PausedInEvaluation", getExperimentConfig(), "");
+			const string checkpointFilename = "AsyncQLearning_PausedInEvaluation.parameters";
+			{
+				AsyncQLearning asyncQLearning(app.parse(getAsyncQLearningConfig()));
+				SimionApp* pApp = app.get();
+				pApp->pSimGod->deferredLoad();
+
+				DynamicModel* pDynamicModel = pApp->pWorld->getDynamicModel();
+				State* s = pDynamicModel->getStateDescriptor().getInstance();
+				State* s_p = pDynamicModel->getStateDescriptor().getInstance();
+				Action* a = pDynamicModel->getActionDescriptor().getInstance();
+
+				//the episodes of SimionApp::run(), letting the simion know when training episodes end
+				size_t numEvaluationEpisodes = 0;
+				for (pApp->pExperiment->nextEpisode(); pApp->pExperiment->isValidEpisode(); pApp->pExperiment->nextEpisode())
+				{
+					bool bEvaluation = pApp->pExperiment->isEvaluationEpisode();
+					vector<double> initialParameters;
+					if (bEvaluation)
+						initialParameters = getSharedParameters(asyncQLearning, checkpointFilename);
+
+					pApp->pWorld->reset(s);
+					for (pApp->pExperiment->nextStep(); pApp->pExperiment->isValidStep(); pApp->pExperiment->nextStep())
+					{
+						asyncQLearning.selectAction(s, a);
+						double r = pApp->pWorld->executeAction(s, a, s_p);
+						if (!bEvaluation)
+							asyncQLearning.update(s, a, s_p, r, 1.0);
+						s->copy(s_p);
+					}
+
+					if (bEvaluation)
+					{
+						//give the background actor-learners time to push gradients, if they weren't paused
+						std::this_thread::sleep_for(std::chrono::milliseconds(50));
+						vector<double> finalParameters = getSharedParameters(asyncQLearning, checkpointFilename);
+						Assert::AreEqual(initialParameters.size(), finalParameters.size());
+						for (size_t i = 0; i < initialParameters.size(); i++)
+							Assert::AreEqual(initialParameters[i], finalParameters[i], L"The shared parameters changed in an evaluation episode");
+						numEvaluationEpisodes++;
+					}
+					else
+					{
+						asyncQLearning.onTrainingEpisodeEnd();
+						if (pApp->pExperiment->getTrainingEpisodeIndex() == pApp->pExperiment->getNumTrainingEpisodes())
+							asyncQLearning.onExperimentEnd();
+					}
+				}
+				Assert::AreEqual((size_t)4, numEvaluationEpisodes);
+
+				delete s;
+				delete s_p;
+				delete a;
+			}
+			remove(checkpointFilename.c_str());
+		}
+	};
+}
@@ -0,0 +1,122 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "TestApp.h"
+#include "../../RLSimion/Lib/DQN.h"
+#include "../../RLSimion/Lib/DDPG.h"
+#include "../../RLSimion/Lib/simgod.h"
+#include "../../RLSimion/Lib/experiment.h"
+#include "../../RLSimion/Lib/worlds/world.h"
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace BatchActionSelection
+{
+	TEST_CLASS(BatchActionSelectionTest)
+	{
+	public:
+		//starts with an evaluation episode followed by a training episode. With a single training episode, there would be
+		//just one evaluation episode
+		static string getExperimentConfig()
+		{
+			return "<Random-Seed>1</Random-Seed><Num-Episodes>2</Num-Episodes><Eval-Freq>1</Eval-Freq><Episode-Length>1.0</Episode-Length>";
+		}
+
+		static string getNetworkConfig(const string& inputs)
+		{
+			return inputs + "<Backend>Native</Backend><Minibatch-Size>10</Minibatch-Size>"
+				+ "<Learner><Learner-Type><SGD><Learning-Rate><Schedule><Constant><Value>0.001</Value></Constant></Schedule></Learning-Rate></SGD></Learner-Type></Learner>"
+				+ "<Layers><Num-Units>8</Num-Units><Activation>Tanh</Activation></Layers>";
+		}
+
+		//the actions selected for several environments at once must be those selected for each of them separately. The
+		//initial actions are the same in both cases, because the exploration of some policies modifies them
+		static void checkSelectActions(SimionApp* pApp, Simion* pSimion)
+		{
+			const size_t numEnvironments = 5;
+			DynamicModel* pDynamicModel = pApp->pWorld->getDynamicModel();
+			vector<State*> s;
+			vector<const State*> constS;
+			vector<Action*> batchA, a;
+			for (size_t env = 0; env < numEnvironments; env++)
+			{
+				s.push_back(pDynamicModel->getStateDescriptor().getInstance());
+				s[env]->set("position", 2.0 + 10.0 * env);
+				s[env]->set("velocity", -4.0 + 2.0 * env);
+				constS.push_back(s[env]);
+				batchA.push_back(pDynamicModel->getActionDescriptor().getInstance());
+				batchA[env]->set("acceleration", -0.5 + 0.25 * env);
+				a.push_back(pDynamicModel->getActionDescriptor().getInstance());
+				a[env]->set("acceleration", -0.5 + 0.25 * env);
+			}
+
+			vector<double> probabilities;
+			pSimion->selectActions(constS, batchA, probabilities);
+			Assert::AreEqual(numEnvironments, probabilities.size());
+			for (size_t env = 0; env < numEnvironments; env++)
+			{
+				pSimion->selectAction(s[env], a[env]);
+				Assert::AreEqual(a[env]->get("acceleration"), batchA[env]->get("acceleration"), 0.000001, L"The actions selected in a batch differ from those selected separately");
+			}
+
+			for (size_t env = 0; env < numEnvironments; env++)
+			{
+				delete s[env];
+				delete batchA[env];
+				delete a[env];
+			}
+		}
+
+		//checks the selection in an evaluation episode (greedy) and a training episode (with exploration)
+		static void checkEpisodes(SimionApp* pApp, Simion* pSimion)
+		{
+			pApp->pSimGod->deferredLoad();
+
+			pApp->pExperiment->nextEpisode();
+			Assert::IsTrue(pApp->pExperiment->isEvaluationEpisode());
+			checkSelectActions(pApp, pSimion);
+
+			pApp->pExperiment->nextEpisode();
+			Assert::IsTrue(pApp->pExperiment->isValidEpisode());
+			Assert::IsFalse(pApp->pExperiment->isEvaluationEpisode());
+			checkSelectActions(pApp, pSimion);
+		}
+
+		TEST_METHOD(BatchActionSelection_DQN)
+		{
+			const string qNetwork = "<Q-Network>" + getNetworkConfig("<Input-State><Input-State>position</Input-State></Input-State>"
+				"<Input-State><Input-State>velocity</Input-State></Input-State><Output-Action><Output-Action>acceleration</Output-Action></Output-Action>"
+				"<Num-Action-Steps>7</Num-Action-Steps>") + "</Q-Network>";
+
+			//epsilon-greedy with epsilon 0: the network is evaluated in training episodes too
+			{
+				TestApp app("BatchActionSelection_DQN", getExperimentConfig(), "");
+				DQN dqn(app.parse("<DQN>" + qNetwork + "<Policy><Policy><Discrete-Epsilon-Greedy-Deep-Policy><epsilon><Schedule><Constant><Value>0.0</Value></Constant></Schedule></epsilon>"
+					"</Discrete-Epsilon-Greedy-Deep-Policy></Policy></Policy></DQN>"));
+				checkEpisodes(app.get(), &dqn);
+			}
+			//noise plus greedy without noise: the current actions are kept in training episodes
+			{
+				TestApp app("BatchActionSelection_DQN", getExperimentConfig(), "");
+				DQN dqn(app.parse("<DQN>" + qNetwork + "<Policy><Policy><Noise-Plus-Greedy-Policy><Exploration-Noise><Noise><GaussianNoise><Sigma>0.0</Sigma>"
+					"<Scale><Schedule><Constant><Value>1.0</Value></Constant></Schedule></Scale></GaussianNoise></Noise></Exploration-Noise>"
+					"</Noise-Plus-Greedy-Policy></Policy></Policy></DQN>"));
+				checkEpisodes(app.get(), &dqn);
+			}
+		}
+
+		TEST_METHOD(BatchActionSelection_DDPG)
+		{
+			//without noise, so that the training actions are the output of the policy in both cases
+			TestApp app("BatchActionSelection_DDPG", getExperimentConfig(), "");
+			DDPG ddpg(app.parse("<DDPG><Policy>" + getNetworkConfig("<Input-State><Input-State>position</Input-State></Input-State>"
+				"<Input-State><Input-State>velocity</Input-State></Input-State><Output-Action><Output-Action>acceleration</Output-Action></Output-Action>")
+				+ "</Policy><Exploration-Noise><Noise><GaussianNoise><Sigma>0.0</Sigma><Scale><Schedule><Constant><Value>1.0</Value></Constant></Schedule></Scale>"
+				+ "</GaussianNoise></Noise></Exploration-Noise><Q-Value-Function>" + getNetworkConfig("<Input-State><Input-State>position</Input-State></Input-State>"
+				"<Input-State><Input-State>velocity</Input-State></Input-State><Input-Action><Input-Action>acceleration</Input-Action></Input-Action>")
+				+ "</Q-Value-Function></DDPG>"));
+			checkEpisodes(app.get(), &ddpg);
+		}
+	};
+}
@@ -0,0 +1,111 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/worlds/BulletPhysics.h"
+#include "../../RLSimion/Lib/worlds/Box.h"
+#include "../../RLSimion/Common/named-var-set.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace BulletSnapshots
+{
+	TEST_CLASS(BulletSnapshotTest)
+	{
+		//These tests check that restoring a snapshot of a Bullet world reproduces the same simulation
+	public:
+
+		static void simulate(BulletPhysics& physics, BulletBox* pPushedBox, int numSteps)
+		{
+			for (int i = 0; i < numSteps; i++)
+			{
+				pPushedBox->getBody()->applyCentralForce(btVector3(3.0, 0.0, 1.0));
+				physics.stepSimulation(0.05f, 20);
+			}
+		}
+
+		TEST_METHOD(BulletSnapshot_RestoreAndReplay)
+		{
+			Descriptor desc;
+			desc.addVariable("box-x", "m", -20.0, 20.0);
+			desc.addVariable("box-y", "m", -20.0, 20.0);
+			desc.addVariable("box-theta", "rad", -3.15, 3.15, true);
+			State* s = desc.getInstance();
+
+			BulletPhysics physics;
+			physics.initPhysics();
+			physics.initPlayground();
+			BulletBox* pBox = new BulletBox(4.0, btVector3(0.0, 0.6, 0.0), new btBoxShape(btVector3(0.6, 0.6, 0.6)));
+			pBox->setAbsoluteStateVarIds("box-x", "box-y", "box-theta");
+			physics.add(pBox);
+			//a second box falling on top of the first one, so that there are contacts to warm-start
+			BulletBox* pFallingBox = new BulletBox(1.0, btVector3(0.3, 5.0, 0.2), new btBoxShape(btVector3(0.6, 0.6, 0.6)));
+			physics.add(pFallingBox);
+
+			physics.resetFromInitialSnapshot(s);
+			simulate(physics, pBox, 12);
+
+			BulletSnapshot snapshot;
+			physics.saveSnapshot(snapshot);
+			simulate(physics, pBox, 40);
+			btVector3 firstRun = pFallingBox->getBody()->getWorldTransform().getOrigin();
+			physics.updateState(s);
+			double firstRunX = s->get("box-x");
+
+			physics.restoreSnapshot(snapshot, s);
+			simulate(physics, pBox, 40);
+			btVector3 secondRun = pFallingBox->getBody()->getWorldTransform().getOrigin();
+
+			Assert::AreEqual(firstRun.x(), secondRun.x());
+			Assert::AreEqual(firstRun.y(), secondRun.y());
+			Assert::AreEqual(firstRun.z(), secondRun.z());
+			physics.updateState(s);
+			Assert::AreEqual(firstRunX, s->get("box-x"));
+
+			//back to the initial state
+			physics.resetFromInitialSnapshot(s);
+			Assert::AreEqual(0.0, s->get("box-x"));
+			Assert::AreEqual(0.0, s->get("box-y"));
+		}
+
+		TEST_METHOD(BulletSnapshot_RestorePendingForces)
+		{
+			Descriptor desc;
+			desc.addVariable("box-x", "m", -20.0, 20.0);
+			desc.addVariable("box-y", "m", -20.0, 20.0);
+			desc.addVariable("box-theta", "rad", -3.15, 3.15, true);
+			State* s = desc.getInstance();
+
+			BulletPhysics physics;
+			physics.initPhysics();
+			physics.initPlayground();
+			BulletBox* pBox = new BulletBox(4.0, btVector3(0.0, 0.6, 0.0), new btBoxShape(btVector3(0.6, 0.6, 0.6)));
+			pBox->setAbsoluteStateVarIds("box-x", "box-y", "box-theta");
+			physics.add(pBox);
+			physics.resetFromInitialSnapshot(s);
+
+			//the snapshot is saved with forces applied but not yet integrated, on a body whose linear and angular factors
+			//scale them
+			btRigidBody* pBody = pBox->getBody();
+			pBody->setLinearFactor(btVector3(0.3, 1.0, 0.7));
+			pBody->setAngularFactor(btVector3(0.0, 0.3, 1.0));
+			pBody->applyCentralForce(btVector3(3.0, 0.0, 1.0));
+			pBody->applyTorque(btVector3(0.5, 2.0, 1.0));
+			btVector3 force = pBody->getTotalForce(), torque = pBody->getTotalTorque();
+
+			BulletSnapshot snapshot;
+			physics.saveSnapshot(snapshot);
+			physics.stepSimulation(0.05f, 20);
+			btVector3 firstRun = pBody->getWorldTransform().getOrigin();
+
+			physics.restoreSnapshot(snapshot, s);
+			for (int i = 0; i < 3; i++)
+			{
+				Assert::AreEqual(force[i], pBody->getTotalForce()[i]);
+				Assert::AreEqual(torque[i], pBody->getTotalTorque()[i]);
+			}
+			physics.stepSimulation(0.05f, 20);
+			btVector3 secondRun = pBody->getWorldTransform().getOrigin();
+			Assert::AreEqual(firstRun.x(), secondRun.x());
+			Assert::AreEqual(firstRun.z(), secondRun.z());
+		}
+	};
+}
@@ -0,0 +1,130 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/worlds/BulletWorldPool.h"
+#include "../../RLSimion/Lib/worlds/BulletPhysics.h"
+#include "../../RLSimion/Lib/worlds/robot-control.h"
+#include "../../RLSimion/Lib/worlds/pull-box-1.h"
+#include "../../RLSimion/Common/named-var-set.h"
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace BulletWorldPools
+{
+	TEST_CLASS(BulletWorldPoolTest)
+	{
+		//These tests check that stepping the worlds of a pool in parallel gives the same states as stepping
+		//copies of the same worlds one after another
+	public:
+
+		static void compare(const std::function<void(BulletPhysics*)>& createScene, Descriptor& stateDesc, Descriptor& actionDesc)
+		{
+			const size_t numWorlds = 4;
+			const int numSteps = 30;
+			const double dt = 0.05;
+
+			BulletWorldPool pool(numWorlds, createScene, 3);
+			std::vector<BulletPhysics*> sequentialWorlds;
+			std::vector<State*> poolStates, sequentialStates;
+			std::vector<Action*> actions;
+			for (size_t i = 0; i < numWorlds; i++)
+			{
+				BulletPhysics* pWorld = new BulletPhysics();
+				createScene(pWorld);
+				sequentialWorlds.push_back(pWorld);
+				poolStates.push_back(stateDesc.getInstance());
+				sequentialStates.push_back(stateDesc.getInstance());
+				actions.push_back(actionDesc.getInstance());
+			}
+			std::vector<const Action*> constActions(actions.begin(), actions.end());
+
+			pool.reset(poolStates);
+			for (size_t i = 0; i < numWorlds; i++)
+				sequentialWorlds[i]->resetFromInitialSnapshot(sequentialStates[i]);
+
+			for (int step = 0; step < numSteps; step++)
+			{
+				//each world is given a different action
+				for (size_t i = 0; i < numWorlds; i++)
+				{
+					actions[i]->set("robot1-v", 0.5 + 0.25 * i);
+					actions[i]->set("robot1-omega", (step % 10 < 5 ? 1.0 : -1.0) * (0.5 + i));
+				}
+
+				pool.executeAction(poolStates, constActions, dt);
+				for (size_t i = 0; i < numWorlds; i++)
+				{
+					sequentialWorlds[i]->updateBulletState(sequentialStates[i], constActions[i], dt);
+					sequentialWorlds[i]->stepSimulation((float)dt, 20);
+					sequentialWorlds[i]->updateState(sequentialStates[i]);
+				}
+
+				for (size_t i = 0; i < numWorlds; i++)
+				{
+					for (size_t var = 0; var < stateDesc.size(); var++)
+						Assert::AreEqual(sequentialStates[i]->get(var), poolStates[i]->get(var)
+							, L"A world stepped in the pool diverged from the same world stepped on its own");
+				}
+			}
+			//the worlds were given different actions, so they must have ended in different states
+			Assert::IsTrue(poolStates[0]->get("robot1-x") != poolStates[1]->get("robot1-x"));
+
+			for (size_t i = 0; i < numWorlds; i++)
+			{
+				delete sequentialWorlds[i];
+				delete poolStates[i];
+				delete sequentialStates[i];
+				delete actions[i];
+			}
+		}
+
+		static void addRobotVariables(Descriptor& stateDesc, Descriptor& actionDesc)
+		{
+			stateDesc.addVariable("target-x", "m", -20.0, 20.0);
+			stateDesc.addVariable("target-y", "m", -20.0, 20.0);
+			stateDesc.addVariable("robot1-x", "m", -20.0, 20.0);
+			stateDesc.addVariable("robot1-y", "m", -20.0, 20.0);
+			stateDesc.addVariable("robot1-theta", "rad", -3.1415, 3.1415, true);
+			actionDesc.addVariable("robot1-v", "m/s", -2.0, 2.0);
+			actionDesc.addVariable("robot1-omega", "rad", -8.0, 8.0);
+		}
+
+		TEST_METHOD(BulletWorldPool_RobotControl)
+		{
+			Descriptor stateDesc, actionDesc;
+			addRobotVariables(stateDesc, actionDesc);
+
+			compare(RobotControl::createScene, stateDesc, actionDesc);
+		}
+
+		TEST_METHOD(BulletWorldPool_PullBox1)
+		{
+			Descriptor stateDesc, actionDesc;
+			addRobotVariables(stateDesc, actionDesc);
+			stateDesc.addVariable("box-x", "m", -20.0, 20.0);
+			stateDesc.addVariable("box-y", "m", -20.0, 20.0);
+			stateDesc.addVariable("box-theta", "rad", -3.1415, 3.1415, true);
+			stateDesc.addVariable("box-to-target-x", "m", -20.0, 20.0);
+			stateDesc.addVariable("box-to-target-y", "m", -20.0, 20.0);
+			stateDesc.addVariable("robot1-to-box-x", "m", -6.0, 6.0);
+			stateDesc.addVariable("robot1-to-box-y", "m", -6.0, 6.0);
+			//the points of the rope, as added by Rope::addStateVariables()
+			BulletPhysics scene;
+			PullBox1::createScene(&scene);
+			std::vector<btSoftBody*>* pRopes = scene.getSoftBodiesArray();
+			for (size_t j = 0; j < pRopes->size(); j++)
+			{
+				for (int i = 0; i < pRopes->at(j)->m_links.size(); i++)
+				{
+					std::string prefix = std::string("rope") + std::to_string(j) + "-p" + std::to_string(i);
+					stateDesc.addVariable((prefix + "-x").c_str(), "m", -20.0, 20.0);
+					stateDesc.addVariable((prefix + "-y").c_str(), "m", -20.0, 20.0);
+					stateDesc.addVariable((prefix + "-z").c_str(), "m", -20.0, 20.0);
+				}
+			}
+
+			compare(PullBox1::createScene, stateDesc, actionDesc);
+		}
+	};
+}
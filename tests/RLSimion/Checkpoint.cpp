@@ -0,0 +1,180 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/checkpoint.h"
+#include "../../RLSimion/Lib/deep-native-network.h"
+#include "../../RLSimion/Lib/deep-minibatch.h"
+#include "../../RLSimion/Lib/deep-functions.h"
+#include "../../RLSimion/Lib/experiment.h"
+#include "../../RLSimion/Common/log-episode-index.h"
+#include "TestApp.h"
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#define CHECKPOINT_TEST_FILE "checkpoint-test.ckpt"
+
+namespace Checkpoints
+{
+	//Definition of the networks without a config file, only used to create minibatches
+	class TestNetworkDefinition : public DeepNetworkDefinition
+	{
+	public:
+		TestNetworkDefinition(vector<string> stateVariables, vector<string> actionVariables, size_t numOutputs)
+		{
+			m_inputStateVariables = stateVariables;
+			m_inputActionVariables = actionVariables;
+			m_numOutputs = numOutputs;
+		}
+	};
+
+	TEST_CLASS(CheckpointTest)
+	{
+	public:
+		TEST_METHOD(Checkpoint_WriteRead)
+		{
+			//a temporary file with the name used by older versions (i.e., another process writing the same checkpoint)
+			FILE* pOtherFile = fopen(CHECKPOINT_TEST_FILE ".tmp", "wb");
+			fputs("other", pOtherFile);
+			fclose(pOtherFile);
+
+			vector<double> values = { 1.5, -2.25, 1e-300, 3.0 };
+			CheckpointWriter writer;
+			Assert::IsTrue(writer.open(CHECKPOINT_TEST_FILE));
+			writer.add("a", values);
+			writer.setPrefix("0/");
+			//names whose length isn't a multiple of 8 are padded
+			writer.add("longer-name", values.data(), 3);
+			writer.add("empty", nullptr, 0);
+			Assert::IsTrue(writer.close());
+
+			//the temporary file of this process had a different name, so the other one wasn't touched
+			char otherContents[8] = {};
+			pOtherFile = fopen(CHECKPOINT_TEST_FILE ".tmp", "rb");
+			Assert::IsTrue(pOtherFile != nullptr);
+			fread(otherContents, 1, sizeof(otherContents) - 1, pOtherFile);
+			fclose(pOtherFile);
+			Assert::AreEqual(0, strcmp(otherContents, "other"));
+			remove(CHECKPOINT_TEST_FILE ".tmp");
+
+			{
+				CheckpointReader reader;
+				Assert::IsTrue(reader.open(CHECKPOINT_TEST_FILE));
+				Assert::AreEqual((size_t)3, reader.getNumEntries());
+
+				vector<double> output(4);
+				Assert::IsTrue(reader.read("a", output));
+				for (size_t i = 0; i < values.size(); i++)
+					Assert::AreEqual(values[i], output[i]);
+
+				size_t numValues;
+				Assert::IsTrue(reader.get("longer-name", numValues) == nullptr);
+				reader.setPrefix("0/");
+				const double* pValues = reader.get("longer-name", numValues);
+				Assert::AreEqual((size_t)3, numValues);
+				Assert::AreEqual(values[2], pValues[2]);
+				//entries are only read with the right number of values
+				Assert::IsTrue(!reader.read("longer-name", output));
+				Assert::IsTrue(reader.get("empty", numValues) != nullptr);
+				Assert::AreEqual((size_t)0, numValues);
+			}
+
+			//a truncated file isn't a valid checkpoint
+			FILE* pFile = fopen(CHECKPOINT_TEST_FILE, "rb");
+			vector<char> data(1024);
+			size_t size = fread(data.data(), 1, data.size(), pFile);
+			fclose(pFile);
+			pFile = fopen(CHECKPOINT_TEST_FILE, "wb");
+			fwrite(data.data(), 1, size - 8, pFile);
+			fclose(pFile);
+			CheckpointReader truncatedReader;
+			Assert::IsTrue(!truncatedReader.open(CHECKPOINT_TEST_FILE));
+
+			remove(CHECKPOINT_TEST_FILE);
+		}
+
+		TEST_METHOD(Checkpoint_NativeNetwork)
+		{
+			//a network loaded from a checkpoint continues learning exactly as the network saved, so the state of the learner
+			//(Adam's moments) must be restored too
+			const size_t numSamples = 16;
+			TestNetworkDefinition definition({ "s0", "s1" }, {}, 2);
+			DeepMinibatch minibatch(numSamples, &definition);
+			vector<double> target(numSamples * 2);
+			for (size_t i = 0; i < numSamples; i++)
+			{
+				minibatch.s()[2 * i] = -1.0 + 2.0 * i / (numSamples - 1);
+				minibatch.s()[2 * i + 1] = cos(0.5 * i);
+				target[2 * i] = sin(3.0 * minibatch.s()[2 * i]);
+				target[2 * i + 1] = minibatch.s()[2 * i + 1];
+			}
+			NativeDeterministicPolicyNetwork network({ "s0", "s1" }, { "a0", "a1" }, "Tanh,8;Tanh,8", "Adam", false);
+			for (int i = 0; i < 20; i++)
+				network.train(&minibatch, target, 0.01);
+
+			CheckpointWriter writer;
+			Assert::IsTrue(writer.open(CHECKPOINT_TEST_FILE));
+			Assert::IsTrue(network.saveCheckpoint(writer, "Network"));
+			Assert::IsTrue(writer.close());
+
+			NativeDeterministicPolicyNetwork loadedNetwork({ "s0", "s1" }, { "a0", "a1" }, "Tanh,8;Tanh,8", "Adam", false);
+			{
+				CheckpointReader reader;
+				Assert::IsTrue(reader.open(CHECKPOINT_TEST_FILE));
+				Assert::IsTrue(!loadedNetwork.loadCheckpoint(reader, "Other-Network"));
+				Assert::IsTrue(loadedNetwork.loadCheckpoint(reader, "Network"));
+
+				//networks with a different architecture can't be loaded
+				NativeDeterministicPolicyNetwork otherNetwork({ "s0", "s1" }, { "a0", "a1" }, "Tanh,4", "Adam", false);
+				Assert::IsTrue(!otherNetwork.loadCheckpoint(reader, "Network"));
+			}
+
+			vector<double> output(numSamples * 2), loadedOutput(numSamples * 2);
+			for (int i = 0; i < 20; i++)
+			{
+				network.train(&minibatch, target, 0.01);
+				loadedNetwork.train(&minibatch, target, 0.01);
+			}
+			network.evaluate(minibatch.s(), output);
+			loadedNetwork.evaluate(minibatch.s(), loadedOutput);
+			for (size_t i = 0; i < output.size(); i++)
+				Assert::AreEqual(output[i], loadedOutput[i], L"The loaded network doesn't learn as the saved one");
+
+			remove(CHECKPOINT_TEST_FILE);
+		}
+
+		TEST_METHOD(Checkpoint_ResumeLogs)
+		{
+			//the first run saves a checkpoint after its last training episode (the 3rd episode: evaluation, training,
+			//training), and the second one resumes from it, so the first episode it runs and logs is the 4th
+			const string experiment = "<Random-Seed>1</Random-Seed><Eval-Freq>2</Eval-Freq><Episode-Length>1.0</Episode-Length>";
+			TestApp firstRun("Checkpoint_ResumeLogs1", experiment + "<Num-Episodes>2</Num-Episodes>"
+				, "<Checkpoint-Freq>1</Checkpoint-Freq>");
+			firstRun.get()->run();
+			firstRun.destroy();
+
+			TestApp resumedRun("Checkpoint_ResumeLogs2", experiment + "<Num-Episodes>4</Num-Episodes>"
+				, "<Warm-Start-File>Checkpoint_ResumeLogs1.ckpt</Warm-Start-File><Warm-Start-Resume>true</Warm-Start-Resume>", true);
+			Assert::AreEqual(7u, resumedRun.get()->pExperiment->getTotalNumEpisodes());
+			resumedRun.get()->run();
+			resumedRun.destroy();
+
+			//episodes 4 to 7: evaluation, training, training, evaluation
+			ExperimentLogReader reader;
+			Assert::IsTrue(reader.open("Checkpoint_ResumeLogs2.log.bin"));
+			Assert::AreEqual((size_t)4, reader.getNumEpisodes());
+			Assert::AreEqual((size_t)2, reader.findEpisodes(0).size());
+			Assert::AreEqual((size_t)2, reader.findEpisodes(1).size());
+			vector<double> values;
+			for (size_t episode = 0; episode < reader.getNumEpisodes(); episode++)
+			{
+				Assert::IsTrue(reader.readEpisode(episode, values));
+				Assert::IsTrue(values.size() > 0);
+			}
+			reader.close();
+		}
+	};
+}
@@ -0,0 +1,153 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Common/columnar-log.h"
+#include <stdio.h>
+#include <math.h>
+#include <limits>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#define COLUMNAR_LOG_TEST_FILE "columnar-log-test.log.bin"
+
+namespace ColumnarLogs
+{
+	TEST_CLASS(ColumnarLogTest)
+	{
+	public:
+		static bool sameBits(double a, double b)
+		{
+			return memcmp(&a, &b, sizeof(double)) == 0;
+		}
+
+		//values similar to those logged by a simulation: smooth variables, constants and some noise
+		static double simulatedValue(size_t step, size_t variable)
+		{
+			switch (variable % 4)
+			{
+			case 0: return sin(0.01 * step + variable);
+			case 1: return 0.0;
+			case 2: return (double)(step / 50);
+			default: return 0.001 * (double)((step * 7919 + variable * 104729) % 1000);
+			}
+		}
+
+		static void writeLog(const char* filename, size_t numEpisodes, size_t numSteps, size_t numVariables, bool bWriteIndex)
+		{
+			FILE* pFile = fopen(filename, "wb");
+			//experiment header
+			long long int header[COLUMNAR_LOG_HEADER_MAX_SIZE] = { 1, COLUMNAR_LOG_FILE_VERSION, (long long int)numEpisodes };
+			fwrite(header, sizeof(header), 1, pFile);
+
+			ColumnarLogWriter writer;
+			vector<char> buffer;
+			vector<double> values(numVariables);
+			for (size_t episode = 0; episode < numEpisodes; episode++)
+			{
+				writer.beginEpisode(episode % 2, episode + 1, 1, numVariables);
+				for (size_t step = 0; step < numSteps; step++)
+				{
+					for (size_t var = 0; var < numVariables; var++)
+						values[var] = simulatedValue(step, var);
+					writer.addStep(step, 0.001 * step, 0.04 * step, 0.0005 * step, values.data());
+				}
+				buffer.clear();
+				writer.endEpisode(ftell(pFile), buffer);
+				fwrite(buffer.data(), 1, buffer.size(), pFile);
+			}
+			if (bWriteIndex)
+			{
+				buffer.clear();
+				writer.writeIndex(ftell(pFile), buffer);
+				fwrite(buffer.data(), 1, buffer.size(), pFile);
+			}
+			fclose(pFile);
+		}
+
+		static void checkLog(const char* filename, size_t numEpisodes, size_t numSteps, size_t numVariables)
+		{
+			ColumnarLogReader reader;
+			Assert::IsTrue(reader.open(filename));
+			Assert::AreEqual(numEpisodes, reader.getNumEpisodes());
+			vector<double> values;
+			for (size_t episode = 0; episode < numEpisodes; episode++)
+			{
+				Assert::AreEqual(numSteps, reader.getNumSteps(episode));
+				Assert::AreEqual((long long int)(episode + 1), reader.getEpisodeInfo(episode).index.episodeIndex);
+				Assert::IsTrue(reader.readColumn(episode, StepIndexColumn, values));
+				Assert::AreEqual((double)(numSteps - 1), values[numSteps - 1]);
+				Assert::IsTrue(reader.readColumn(episode, EpisodeSimTimeColumn, values));
+				Assert::IsTrue(sameBits(0.04 * (numSteps - 1), values[numSteps - 1]));
+				for (size_t var = 0; var < numVariables; var++)
+				{
+					Assert::IsTrue(reader.readColumn(episode, NumStepColumns + var, values));
+					double sum = 0.0;
+					for (size_t step = 0; step < numSteps; step++)
+					{
+						Assert::IsTrue(sameBits(simulatedValue(step, var), values[step]));
+						sum += values[step];
+					}
+					ColumnSummary summary = reader.getSummary(episode, NumStepColumns + var);
+					Assert::AreEqual(sum / numSteps, summary.mean, 1e-9, L"Wrong mean in the index");
+				}
+			}
+		}
+
+		TEST_METHOD(ColumnarLog_EncodeDecode)
+		{
+			const double specialValues[] = { 0.0, -0.0, 1.0, 1.0, 1.0, std::numeric_limits<double>::infinity(), -1e300, 1e-300
+				, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::denorm_min(), 3.141592653589793, 3.141592653589794 };
+			vector<double> values(specialValues, specialValues + sizeof(specialValues) / sizeof(double));
+			for (size_t i = 0; i < 1000; i++)
+				values.push_back(simulatedValue(i, i % 7));
+
+			vector<char> encoded;
+			ColumnEncoding::encode(values.data(), values.size(), encoded);
+			vector<double> decoded(values.size());
+			Assert::IsTrue(ColumnEncoding::decode(encoded.data(), encoded.size(), decoded.size(), decoded.data()));
+			for (size_t i = 0; i < values.size(); i++)
+				Assert::IsTrue(sameBits(values[i], decoded[i]));
+
+			//truncated data must be detected
+			Assert::IsFalse(ColumnEncoding::decode(encoded.data(), encoded.size() / 2, decoded.size(), decoded.data()));
+
+			vector<char> compressed;
+			ColumnEncoding::compress(encoded.data(), encoded.size(), compressed);
+			vector<char> decompressed(encoded.size());
+			Assert::IsTrue(ColumnEncoding::decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()));
+			Assert::IsTrue(decompressed == encoded);
+
+			//repetitive data, with matches overlapping the bytes being copied
+			string text;
+			for (int i = 0; i < 100; i++) text += "aaaaaaaab" + std::to_string(i % 3);
+			compressed.clear();
+			ColumnEncoding::compress(text.c_str(), text.size(), compressed);
+			Assert::IsTrue(compressed.size() < text.size() / 4);
+			decompressed.resize(text.size());
+			Assert::IsTrue(ColumnEncoding::decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()));
+			Assert::IsTrue(string(decompressed.begin(), decompressed.end()) == text);
+		}
+
+		TEST_METHOD(ColumnarLog_WriteRead)
+		{
+			const size_t numEpisodes = 5, numSteps = 2000, numVariables = 12;
+			writeLog(COLUMNAR_LOG_TEST_FILE, numEpisodes, numSteps, numVariables, true);
+			Assert::AreEqual(COLUMNAR_LOG_FILE_VERSION, ColumnarLogReader::getFileVersion(COLUMNAR_LOG_TEST_FILE));
+			checkLog(COLUMNAR_LOG_TEST_FILE, numEpisodes, numSteps, numVariables);
+
+			//a version 2 log takes a 128-byte header plus 8 bytes per variable per step
+			FILE* pFile = fopen(COLUMNAR_LOG_TEST_FILE, "rb");
+			fseek(pFile, 0, SEEK_END);
+			long size = ftell(pFile);
+			fclose(pFile);
+			long version2Size = (long)(128 + numEpisodes * (128 + 128 + numSteps * (128 + 8 * numVariables)));
+			Assert::IsTrue(size * 5 < version2Size);
+
+			//without the index (i.e., the experiment crashed before closing the log) the episodes are read sequentially
+			writeLog(COLUMNAR_LOG_TEST_FILE, numEpisodes, numSteps, numVariables, false);
+			checkLog(COLUMNAR_LOG_TEST_FILE, numEpisodes, numSteps, numVariables);
+
+			remove(COLUMNAR_LOG_TEST_FILE);
+		}
+	};
+}
@@ -0,0 +1,66 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/deep-network-cache.h"
+#include "../../RLSimion/Lib/deep-native-network.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace DeepNetworkCaches
+{
+	TEST_CLASS(DeepNetworkCacheTest)
+	{
+	public:
+		static vector<double> getOutput(IDeepNetwork* pNetwork)
+		{
+			vector<double> s = { -0.5, 0.25, 0.5, 1.0 };
+			vector<double> output(2);
+			((NativeVFunctionNetwork*)pNetwork)->evaluate(s, output);
+			return output;
+		}
+
+		TEST_METHOD(DeepNetworkCache_Instances)
+		{
+			const string key = "V-Function|s0,s1|Tanh,8";
+			int numCreated = 0;
+			auto create = [&numCreated]() { numCreated++; return new NativeVFunctionNetwork({ "s0", "s1" }, "Tanh,8", "Adam", false); };
+
+			//every instance of a definition starts from the weights of the prototype, which is only built once
+			DeepNetworkCache::clear();
+			IDeepNetwork* pNetwork1 = DeepNetworkCache::getInstance(key, create);
+			IDeepNetwork* pNetwork2 = DeepNetworkCache::getInstance(key, create);
+			Assert::AreEqual(1, numCreated);
+			Assert::AreEqual((size_t)1, DeepNetworkCache::getNumPrototypes());
+			vector<double> output1 = getOutput(pNetwork1), output2 = getOutput(pNetwork2);
+			for (size_t i = 0; i < output1.size(); i++)
+				Assert::AreEqual(output1[i], output2[i]);
+			pNetwork1->destroy();
+			pNetwork2->destroy();
+
+			//the initial weights persisted by a run are used by the next run with the same definition, even if the new
+			//prototype was initialized differently
+			DeepNetworkCache::clear();
+			pNetwork1 = DeepNetworkCache::getInstance(key, create, ".");
+			output1 = getOutput(pNetwork1);
+			DeepNetworkCache::clear();
+			pNetwork2 = DeepNetworkCache::getInstance(key, create, ".");
+			output2 = getOutput(pNetwork2);
+			Assert::AreEqual(3, numCreated);
+			for (size_t i = 0; i < output1.size(); i++)
+				Assert::AreEqual(output1[i], output2[i], L"The persisted initial weights weren't loaded");
+			pNetwork1->destroy();
+			pNetwork2->destroy();
+
+			//without the file, the new prototype keeps its own weights
+			remove(DeepNetworkCache::getInitialWeightsFilename(".", key).c_str());
+			DeepNetworkCache::clear();
+			pNetwork2 = DeepNetworkCache::getInstance(key, create);
+			output2 = getOutput(pNetwork2);
+			Assert::IsTrue(output1[0] != output2[0]);
+			pNetwork2->destroy();
+			DeepNetworkCache::clear();
+		}
+	};
+}
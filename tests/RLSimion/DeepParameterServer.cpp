@@ -0,0 +1,168 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/deep-parameter-server.h"
+#include "../../RLSimion/Lib/deep-native-network.h"
+#include "../../RLSimion/Lib/deep-minibatch.h"
+#include "../../RLSimion/Lib/deep-functions.h"
+#include "../../RLSimion/Lib/checkpoint.h"
+#include <stdio.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace DeepParameterServers
+{
+	//Definition of the networks without a config file, only used to create minibatches
+	class TestNetworkDefinition : public DeepNetworkDefinition
+	{
+	public:
+		TestNetworkDefinition(vector<string> stateVariables, vector<string> actionVariables, size_t numOutputs)
+		{
+			m_inputStateVariables = stateVariables;
+			m_inputActionVariables = actionVariables;
+			m_numOutputs = numOutputs;
+		}
+	};
+
+	TEST_CLASS(DeepParameterServerTest)
+	{
+	public:
+		TEST_METHOD(DeepParameterServer_ConcurrentPush)
+		{
+			//with SGD the result doesn't depend on the order in which the gradients are applied
+			const size_t numParameters = 1000, numThreads = 4, numPushes = 200;
+			const double learningRate = 0.01;
+			vector<double> initialParameters(numParameters);
+			for (size_t i = 0; i < numParameters; i++) initialParameters[i] = sin(0.1 * i);
+			DeepParameterServer parameterServer;
+			parameterServer.initialize(initialParameters.data(), numParameters, NativeLearnerType::SGD, 7);
+			Assert::AreEqual((size_t)7, parameterServer.getNumShards());
+
+			vector<std::thread> threads;
+			for (size_t t = 0; t < numThreads; t++)
+			{
+				threads.push_back(std::thread([&, t]()
+				{
+					vector<double> gradient(numParameters), parameters(numParameters);
+					for (size_t i = 0; i < numParameters; i++) gradient[i] = (double)(t + 1) * cos(0.2 * i);
+					for (size_t i = 0; i < numPushes; i++)
+					{
+						parameterServer.pushGradient(gradient.data(), learningRate, t);
+						parameterServer.pullParameters(parameters.data());
+					}
+				}));
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+
+			Assert::AreEqual(numThreads * numPushes, parameterServer.getNumUpdates());
+			vector<double> parameters(numParameters), targetParameters(numParameters);
+			parameterServer.pullParameters(parameters.data());
+			for (size_t i = 0; i < numParameters; i++)
+			{
+				//sum of (t+1) for t in [0, numThreads) = 10
+				double expected = initialParameters[i] - learningRate * numPushes * 10.0 * cos(0.2 * i);
+				Assert::AreEqual(expected, parameters[i], 1e-9, L"Wrong parameters after concurrent updates");
+			}
+
+			//the target parameters only change with updateTarget()
+			Assert::AreEqual((size_t)0, parameterServer.pullTargetParameters(targetParameters.data()));
+			Assert::AreEqual(initialParameters[1], targetParameters[1]);
+			parameterServer.updateTarget();
+			Assert::AreEqual((size_t)1, parameterServer.pullTargetParameters(targetParameters.data()));
+			for (size_t i = 0; i < numParameters; i++)
+				Assert::AreEqual(parameters[i], targetParameters[i]);
+		}
+
+		TEST_METHOD(DeepParameterServer_TrainWithGradients)
+		{
+			//pushing the gradients of a network to a parameter server with the same learner is equivalent to training it
+			const size_t numSamples = 16;
+			TestNetworkDefinition definition({ "s0", "s1" }, {}, 3);
+			DeepMinibatch minibatch(numSamples, &definition);
+			vector<double> target(numSamples * 3);
+			for (size_t i = 0; i < numSamples * 2; i++)
+				minibatch.s()[i] = cos(0.7 * i);
+			for (size_t i = 0; i < numSamples * 3; i++)
+				target[i] = sin(0.4 * i);
+
+			NativeDiscreteQFunctionNetwork network({ "s0", "s1" }, 3, "Tanh,8;Tanh,8", "Adam", false);
+			NativeDiscreteQFunctionNetwork asyncNetwork = network;
+			Assert::IsTrue(network.getLearnerType() == NativeLearnerType::Adam);
+			const size_t numParameters = network.getNumParameters();
+			vector<double> parameters(numParameters), gradient(numParameters), asyncParameters(numParameters);
+			network.getParameters(parameters.data());
+			DeepParameterServer parameterServer;
+			parameterServer.initialize(parameters.data(), numParameters, asyncNetwork.getLearnerType(), 3);
+
+			for (int i = 0; i < 20; i++)
+			{
+				network.train(&minibatch, target, 0.01);
+				asyncNetwork.computeGradient(&minibatch, target, gradient.data());
+				parameterServer.pushGradient(gradient.data(), 0.01, i);
+				parameterServer.pullParameters(asyncParameters.data());
+				asyncNetwork.setParameters(asyncParameters.data());
+			}
+			network.getParameters(parameters.data());
+			for (size_t i = 0; i < numParameters; i++)
+				Assert::AreEqual(parameters[i], asyncParameters[i], 1e-12, L"Training with the parameter server gave different parameters");
+		}
+
+		TEST_METHOD(DeepParameterServer_LoadIncompleteLearnerState)
+		{
+			//a checkpoint with only part of the state of the learner loads the parameters and keeps the whole state of the
+			//learner of the server, as a checkpoint without any learner state does
+			const size_t numParameters = 100;
+			vector<double> parameters(numParameters), gradient(numParameters), loadedParameters(numParameters);
+			for (size_t i = 0; i < numParameters; i++)
+			{
+				parameters[i] = sin(0.1 * i);
+				gradient[i] = cos(0.3 * i);
+				loadedParameters[i] = cos(0.2 * i);
+			}
+			DeepParameterServer parameterServer, referenceParameterServer;
+			parameterServer.initialize(parameters.data(), numParameters, NativeLearnerType::Adam, 3);
+			referenceParameterServer.initialize(parameters.data(), numParameters, NativeLearnerType::Adam, 3);
+			for (size_t i = 0; i < 5; i++)
+			{
+				parameterServer.pushGradient(gradient.data(), 0.01, i);
+				referenceParameterServer.pushGradient(gradient.data(), 0.01, i);
+			}
+
+			const string incompleteFilename = "DeepParameterServer_Incomplete.ckpt", parametersFilename = "DeepParameterServer_Parameters.ckpt";
+			CheckpointWriter writer;
+			Assert::IsTrue(writer.open(incompleteFilename));
+			writer.add("parameters", loadedParameters);
+			writer.add("target-parameters", loadedParameters);
+			writer.add("moment1", gradient);
+			Assert::IsTrue(writer.close());
+			Assert::IsTrue(writer.open(parametersFilename));
+			writer.add("parameters", loadedParameters);
+			writer.add("target-parameters", loadedParameters);
+			Assert::IsTrue(writer.close());
+
+			//the files are unmapped before they are removed
+			{
+				CheckpointReader reader, referenceReader;
+				Assert::IsTrue(reader.open(incompleteFilename));
+				Assert::IsTrue(parameterServer.loadCheckpoint(reader));
+				Assert::IsTrue(referenceReader.open(parametersFilename));
+				Assert::IsTrue(referenceParameterServer.loadCheckpoint(referenceReader));
+			}
+
+			parameterServer.pushGradient(gradient.data(), 0.01);
+			referenceParameterServer.pushGradient(gradient.data(), 0.01);
+			vector<double> referenceParameters(numParameters);
+			parameterServer.pullParameters(parameters.data());
+			referenceParameterServer.pullParameters(referenceParameters.data());
+			for (size_t i = 0; i < numParameters; i++)
+				Assert::AreEqual(referenceParameters[i], parameters[i], L"Part of the state of the learner was loaded");
+
+			remove(incompleteFilename.c_str());
+			remove(parametersFilename.c_str());
+		}
+	};
+}
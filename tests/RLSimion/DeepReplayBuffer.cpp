@@ -0,0 +1,91 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/deep-replay-buffer.h"
+#include "../../RLSimion/Lib/deep-minibatch.h"
+#include "../../RLSimion/Lib/deep-functions.h"
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace DeepReplayBuffers
+{
+	//Definition of the networks without a config file, only used to create minibatches
+	class TestNetworkDefinition : public DeepNetworkDefinition
+	{
+	public:
+		TestNetworkDefinition(vector<string> stateVariables, vector<string> actionVariables, size_t numOutputs)
+		{
+			m_inputStateVariables = stateVariables;
+			m_inputActionVariables = actionVariables;
+			m_numOutputs = numOutputs;
+		}
+	};
+
+	TEST_CLASS(DeepReplayBufferTest)
+	{
+	public:
+		TEST_METHOD(DeepReplayBuffer_Sample)
+		{
+			//tuple t: s0= t, s1= 2t, a0= t, s0'= t+1, s1'= 2t+2, r= t. Normalized values are t/100
+			Descriptor stateDescriptor, actionDescriptor;
+			stateDescriptor.addVariable("s0", "m", 0.0, 100.0);
+			stateDescriptor.addVariable("s1", "m", 0.0, 200.0);
+			actionDescriptor.addVariable("a0", "m", 0.0, 100.0);
+			State* s = stateDescriptor.getInstance();
+			State* s_p = stateDescriptor.getInstance();
+			Action* a = actionDescriptor.getInstance();
+			TestNetworkDefinition qFunction({ "s0" }, { "a0" }, 1);
+			TestNetworkDefinition vFunction({ "s1", "s0" }, {}, 1);
+
+			const size_t bufferSize = 50, minNumTuples = 10, minibatchSize = 8, numTuples = 60;
+			DeepReplayBuffer replayBuffer(bufferSize, 0.5, minNumTuples);
+			Assert::IsTrue(replayBuffer.bUsing());
+			replayBuffer.initialize({ &qFunction, &vFunction }, minibatchSize);
+
+			size_t numUpdates = 0;
+			for (size_t t = 0; t < numTuples; t++)
+			{
+				s->set("s0", (double)t);
+				s->set("s1", 2.0 * t);
+				a->set("a0", (double)t);
+				s_p->set("s0", t + 1.0);
+				s_p->set("s1", 2.0 * t + 2.0);
+				replayBuffer.addTuple(s, a, s_p, (double)t);
+
+				size_t numUpdatesDue = replayBuffer.getNumUpdatesDue();
+				if (t + 1 < minNumTuples)
+					Assert::AreEqual((size_t)0, numUpdatesDue, L"Updates before the buffer had enough tuples");
+				numUpdates += numUpdatesDue;
+			}
+			//one update every two steps since the buffer had enough tuples
+			Assert::AreEqual((numTuples - minNumTuples + 1) / 2, numUpdates);
+			Assert::AreEqual(bufferSize, replayBuffer.getNumTuples());
+
+			//both minibatches have the same tuples, only the last bufferSize tuples are drawn
+			for (int i = 0; i < 5; i++)
+			{
+				const vector<DeepMinibatch*>& minibatches = replayBuffer.nextMinibatches();
+				Assert::AreEqual((size_t)2, minibatches.size());
+				DeepMinibatch* pQMinibatch = minibatches[0];
+				DeepMinibatch* pVMinibatch = minibatches[1];
+				Assert::IsTrue(pQMinibatch->isFull() && pVMinibatch->isFull());
+				for (size_t j = 0; j < minibatchSize; j++)
+				{
+					double t = pQMinibatch->r()[j];
+					Assert::IsTrue(t >= numTuples - bufferSize && t < numTuples);
+					Assert::AreEqual(t / 100.0, pQMinibatch->s()[j], 1e-12, L"Wrong state");
+					Assert::AreEqual(t / 100.0, pQMinibatch->a()[j], 1e-12, L"Wrong action");
+					Assert::AreEqual((t + 1.0) / 100.0, pQMinibatch->s_p()[j], 1e-12, L"Wrong next state");
+					Assert::AreEqual(t, pVMinibatch->r()[j], L"The minibatches have different tuples");
+					Assert::AreEqual(2.0 * t / 200.0, pVMinibatch->s()[j * 2], 1e-12, L"Wrong state");
+					Assert::AreEqual(t / 100.0, pVMinibatch->s()[j * 2 + 1], 1e-12, L"Wrong state");
+					Assert::AreEqual((2.0 * t + 2.0) / 200.0, pVMinibatch->s_p()[j * 2], 1e-12, L"Wrong next state");
+				}
+			}
+			delete s;
+			delete s_p;
+			delete a;
+		}
+	};
+}
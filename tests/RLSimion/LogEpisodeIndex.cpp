@@ -0,0 +1,266 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Common/log-episode-index.h"
+#include "../../RLSimion/Common/columnar-log.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#define LOG_EPISODE_INDEX_TEST_FILE "log-episode-index-test.log.bin"
+
+namespace LogEpisodeIndices
+{
+	TEST_CLASS(LogEpisodeIndexTest)
+	{
+	public:
+		//Three episodes: evaluation, training and evaluation, with a different number of steps each
+		static const int numEpisodes = 3;
+		static const int numVariables = 3;
+
+		static long long int getEpisodeType(int episode) { return episode % 2; }
+		static int getNumSteps(int episode) { return 10 + 5 * episode; }
+		static double getValue(int episode, int step, int column)
+		{
+			if (column == StepIndexColumn) return (double)step;
+			return episode * 1000.0 + step + 0.25 * column;
+		}
+
+		//writes the log and the index the same way the logger does
+		static void writeLog(int fileVersion)
+		{
+			FILE* pFile = fopen(LOG_EPISODE_INDEX_TEST_FILE, "wb");
+			FILE* pIndexFile = fopen(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION, "wb");
+			long long int header[16] = { 1, fileVersion, numEpisodes };
+			fwrite(header, sizeof(header), 1, pFile);
+			LogEpisodeIndexHeader indexHeader;
+			indexHeader.logFileVersion = fileVersion;
+			fwrite(&indexHeader, sizeof(indexHeader), 1, pIndexFile);
+
+			ColumnarLogWriter columnarWriter;
+			vector<char> buffer;
+			double values[NumStepColumns + numVariables];
+			for (int episode = 0; episode < numEpisodes; episode++)
+			{
+				LogEpisodeIndexEntry entry;
+				entry.offset = ftell(pFile);
+				entry.episodeType = getEpisodeType(episode);
+				entry.episodeIndex = episode + 1;
+				entry.episodeSubIndex = 1;
+				entry.numSteps = getNumSteps(episode);
+				entry.numVariablesLogged = numVariables;
+				entry.rewardSum = -episode;
+				entry.avgReward = -episode / (double)getNumSteps(episode);
+
+				if (fileVersion == COLUMNAR_LOG_FILE_VERSION)
+					columnarWriter.beginEpisode(entry.episodeType, entry.episodeIndex, 1, numVariables);
+				else
+				{
+					long long int episodeHeader[16] = { 2, entry.episodeType, entry.episodeIndex, numVariables, 1 };
+					fwrite(episodeHeader, sizeof(episodeHeader), 1, pFile);
+				}
+				for (int step = 0; step < getNumSteps(episode); step++)
+				{
+					for (int column = 0; column < NumStepColumns + numVariables; column++)
+						values[column] = getValue(episode, step, column);
+					if (fileVersion == COLUMNAR_LOG_FILE_VERSION)
+						columnarWriter.addStep(step, values[ExperimentRealTimeColumn], values[EpisodeSimTimeColumn]
+							, values[EpisodeRealTimeColumn], values + NumStepColumns);
+					else
+					{
+						long long int stepHeader[16] = { 3, step };
+						memcpy(&stepHeader[2], &values[ExperimentRealTimeColumn], 3 * sizeof(double));
+						fwrite(stepHeader, sizeof(stepHeader), 1, pFile);
+						fwrite(values + NumStepColumns, sizeof(double), numVariables, pFile);
+					}
+				}
+				if (fileVersion == COLUMNAR_LOG_FILE_VERSION)
+				{
+					buffer.clear();
+					columnarWriter.endEpisode(entry.offset, buffer);
+					fwrite(buffer.data(), 1, buffer.size(), pFile);
+				}
+				else
+				{
+					long long int episodeEndHeader[16] = { 4 };
+					fwrite(episodeEndHeader, sizeof(episodeEndHeader), 1, pFile);
+				}
+				fwrite(&entry, sizeof(entry), 1, pIndexFile);
+			}
+			if (fileVersion == COLUMNAR_LOG_FILE_VERSION)
+			{
+				buffer.clear();
+				columnarWriter.writeIndex(ftell(pFile), buffer);
+				fwrite(buffer.data(), 1, buffer.size(), pFile);
+			}
+			fclose(pFile);
+			fclose(pIndexFile);
+		}
+
+		static void checkLog(bool bIndexFile)
+		{
+			ExperimentLogReader reader;
+			Assert::IsTrue(reader.open(LOG_EPISODE_INDEX_TEST_FILE));
+			Assert::AreEqual((size_t)numEpisodes, reader.getNumEpisodes());
+
+			vector<size_t> evaluationEpisodes = reader.findEpisodes(0);
+			Assert::AreEqual((size_t)2, evaluationEpisodes.size());
+			Assert::AreEqual((size_t)0, evaluationEpisodes[0]);
+			Assert::AreEqual((size_t)2, evaluationEpisodes[1]);
+			Assert::AreEqual((size_t)1, reader.findEpisodes(1).size());
+
+			//read the episodes backwards, so that every read seeks
+			vector<double> values;
+			for (int episode = numEpisodes - 1; episode >= 0; episode--)
+			{
+				const LogEpisodeIndexEntry& entry = reader.getEpisode(episode);
+				Assert::AreEqual(getEpisodeType(episode), entry.episodeType);
+				Assert::AreEqual((long long int)episode + 1, entry.episodeIndex);
+				Assert::AreEqual((long long int)getNumSteps(episode), entry.numSteps);
+				Assert::AreEqual((long long int)numVariables, entry.numVariablesLogged);
+				//rewards are only known if the index file was written
+				if (bIndexFile)
+					Assert::AreEqual((double)-episode, entry.rewardSum);
+				else
+					Assert::IsTrue(entry.rewardSum != entry.rewardSum);
+
+				Assert::IsTrue(reader.readEpisode(episode, values));
+				const size_t numColumns = NumStepColumns + numVariables;
+				Assert::AreEqual(getNumSteps(episode) * numColumns, values.size());
+				for (int step = 0; step < getNumSteps(episode); step++)
+				{
+					for (size_t column = 0; column < numColumns; column++)
+						Assert::AreEqual(getValue(episode, step, (int)column), values[step * numColumns + column]);
+				}
+			}
+			Assert::IsFalse(reader.readEpisode(numEpisodes, values));
+		}
+
+		//overwrites the episodes before the given one, so that reading any of them fails
+		static void eraseEpisodesBefore(int episode)
+		{
+			ExperimentLogReader reader;
+			Assert::IsTrue(reader.open(LOG_EPISODE_INDEX_TEST_FILE));
+			const long long int begin = reader.getEpisode(0).offset;
+			const long long int end = reader.getEpisode(episode).offset;
+			reader.close();
+
+			FILE* pFile = fopen(LOG_EPISODE_INDEX_TEST_FILE, "r+b");
+			vector<char> garbage((size_t)(end - begin), (char)0x7f);
+			fseek(pFile, (long)begin, SEEK_SET);
+			fwrite(garbage.data(), 1, garbage.size(), pFile);
+			fclose(pFile);
+		}
+
+		static void checkSeek(int fileVersion)
+		{
+			const int episode = numEpisodes - 1;
+			writeLog(fileVersion);
+			eraseEpisodesBefore(episode);
+
+			//with the index file, the last episode is read straight from its offset
+			ExperimentLogReader reader;
+			Assert::IsTrue(reader.open(LOG_EPISODE_INDEX_TEST_FILE));
+			Assert::AreEqual((size_t)numEpisodes, reader.getNumEpisodes());
+			vector<double> values;
+			Assert::IsFalse(reader.readEpisode(0, values));
+			Assert::IsTrue(reader.readEpisode(episode, values));
+			const size_t numColumns = NumStepColumns + numVariables;
+			Assert::AreEqual(getNumSteps(episode) * numColumns, values.size());
+			for (int step = 0; step < getNumSteps(episode); step++)
+			{
+				for (size_t column = 0; column < numColumns; column++)
+					Assert::AreEqual(getValue(episode, step, (int)column), values[step * numColumns + column]);
+			}
+			reader.close();
+			remove(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION);
+			remove(LOG_EPISODE_INDEX_TEST_FILE);
+		}
+
+		TEST_METHOD(LogEpisodeIndex_RoundTrip)
+		{
+			//every field of the entries is read back as written, and an incomplete last entry is ignored
+			FILE* pFile = fopen(LOG_EPISODE_INDEX_TEST_FILE, "wb");
+			long long int header[16] = { 1, 2, 0 };
+			fwrite(header, sizeof(header), 1, pFile);
+			fclose(pFile);
+
+			vector<LogEpisodeIndexEntry> entries(4);
+			FILE* pIndexFile = fopen(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION, "wb");
+			LogEpisodeIndexHeader indexHeader;
+			indexHeader.logFileVersion = 2;
+			fwrite(&indexHeader, sizeof(indexHeader), 1, pIndexFile);
+			for (size_t i = 0; i < entries.size(); i++)
+			{
+				entries[i].offset = 128 + 1000 * (long long int)i;
+				entries[i].episodeType = (long long int)i % 2;
+				entries[i].episodeIndex = 1 + (long long int)i / 2;
+				entries[i].episodeSubIndex = 1 + (long long int)i % 3;
+				entries[i].numSteps = 7 * (long long int)i;
+				entries[i].numVariablesLogged = 5;
+				entries[i].rewardSum = -1.5 * i;
+				entries[i].avgReward = 0.125 * i;
+				fwrite(&entries[i], sizeof(LogEpisodeIndexEntry), 1, pIndexFile);
+			}
+			fwrite(&entries[0], sizeof(LogEpisodeIndexEntry) / 2, 1, pIndexFile);
+			fclose(pIndexFile);
+
+			ExperimentLogReader reader;
+			Assert::IsTrue(reader.open(LOG_EPISODE_INDEX_TEST_FILE));
+			Assert::AreEqual(entries.size(), reader.getNumEpisodes());
+			for (size_t i = 0; i < entries.size(); i++)
+			{
+				const LogEpisodeIndexEntry& entry = reader.getEpisode(i);
+				Assert::AreEqual(entries[i].offset, entry.offset);
+				Assert::AreEqual(entries[i].episodeType, entry.episodeType);
+				Assert::AreEqual(entries[i].episodeIndex, entry.episodeIndex);
+				Assert::AreEqual(entries[i].episodeSubIndex, entry.episodeSubIndex);
+				Assert::AreEqual(entries[i].numSteps, entry.numSteps);
+				Assert::AreEqual(entries[i].numVariablesLogged, entry.numVariablesLogged);
+				Assert::AreEqual(entries[i].rewardSum, entry.rewardSum);
+				Assert::AreEqual(entries[i].avgReward, entry.avgReward);
+			}
+			reader.close();
+
+			//an index written for another version of the log is not used
+			pIndexFile = fopen(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION, "wb");
+			indexHeader.logFileVersion = COLUMNAR_LOG_FILE_VERSION;
+			fwrite(&indexHeader, sizeof(indexHeader), 1, pIndexFile);
+			fwrite(&entries[0], sizeof(LogEpisodeIndexEntry), 1, pIndexFile);
+			fclose(pIndexFile);
+			Assert::IsTrue(reader.open(LOG_EPISODE_INDEX_TEST_FILE));
+			Assert::AreEqual((size_t)0, reader.getNumEpisodes());
+			reader.close();
+
+			remove(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION);
+			remove(LOG_EPISODE_INDEX_TEST_FILE);
+		}
+
+		TEST_METHOD(LogEpisodeIndex_Seek)
+		{
+			//the episodes before the one read are never parsed: they can be anything
+			checkSeek(2);
+			checkSeek(COLUMNAR_LOG_FILE_VERSION);
+		}
+
+		TEST_METHOD(LogEpisodeIndex_Version2)
+		{
+			writeLog(2);
+			checkLog(true);
+			//without the index file, the index is rebuilt reading the headers of the log
+			remove(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION);
+			checkLog(false);
+			remove(LOG_EPISODE_INDEX_TEST_FILE);
+		}
+
+		TEST_METHOD(LogEpisodeIndex_Version3)
+		{
+			writeLog(COLUMNAR_LOG_FILE_VERSION);
+			checkLog(true);
+			remove(LOG_EPISODE_INDEX_TEST_FILE LOG_EPISODE_INDEX_EXTENSION);
+			checkLog(false);
+			remove(LOG_EPISODE_INDEX_TEST_FILE);
+		}
+	};
+}
@@ -0,0 +1,221 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/log-sample-converter.h"
+#include "../../RLSimion/Lib/sample-file.h"
+#include "../../RLSimion/Common/columnar-log.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace LogSampleConverters
+{
+	TEST_CLASS(LogSampleConverterTest)
+	{
+	public:
+		//Each log has an evaluation episode (type 0) and a training episode (type 1) with 20 steps, but step 5 is missing, as if the logger
+		//had skipped it. Logged variables: s0, s1, a, r and a stat. The first state variable identifies the log, the episode and the step
+		static const int numSteps = 20;
+		static const int missingStep = 5;
+		static const int numLoggedVariables = 5;
+		static const int numElementsPerSample = 6; //s0, s1, a, s0', s1', r
+
+		static void getLoggedValues(int log, int episode, int step, double* pValues)
+		{
+			pValues[0] = log * 10000.0 + episode * 1000.0 + step;
+			pValues[1] = 2.0 * step;
+			pValues[2] = step + 0.5;
+			pValues[3] = -step;
+			pValues[4] = 99.0;
+		}
+
+		static void writeDescriptor(string filename, string binaryFilename)
+		{
+			FILE* pFile = fopen(filename.c_str(), "w");
+			fprintf(pFile, "<ExperimentLogDescriptor BinaryDataFile=\"%s\" SceneFile=\"\">\n", binaryFilename.c_str());
+			fprintf(pFile, "  <State-variable>s0</State-variable>\n  <State-variable>s1</State-variable>\n");
+			fprintf(pFile, "  <Action-variable>a</Action-variable>\n  <Reward-variable>r</Reward-variable>\n");
+			fprintf(pFile, "  <Stat-variable>stats/x</Stat-variable>\n</ExperimentLogDescriptor>\n");
+			fclose(pFile);
+		}
+
+		static void writeVersion2Log(string name, int log)
+		{
+			writeDescriptor(name, name + ".bin");
+			FILE* pFile = fopen((name + ".bin").c_str(), "wb");
+			long long int header[16] = { 1, 2, 2 };
+			fwrite(header, sizeof(header), 1, pFile);
+			double values[numLoggedVariables];
+			for (int episode = 0; episode < 2; episode++)
+			{
+				long long int episodeHeader[16] = { 2, episode, episode + 1, numLoggedVariables, 1 };
+				fwrite(episodeHeader, sizeof(episodeHeader), 1, pFile);
+				for (int step = 0; step < numSteps; step++)
+				{
+					if (step == missingStep) continue;
+					long long int stepHeader[16] = { 3, step };
+					fwrite(stepHeader, sizeof(stepHeader), 1, pFile);
+					getLoggedValues(log, episode, step, values);
+					fwrite(values, sizeof(double), numLoggedVariables, pFile);
+				}
+				long long int episodeEndHeader[16] = { 4 };
+				fwrite(episodeEndHeader, sizeof(episodeEndHeader), 1, pFile);
+			}
+			fclose(pFile);
+		}
+
+		static void writeVersion3Log(string name, int log)
+		{
+			writeDescriptor(name, name + ".bin");
+			FILE* pFile = fopen((name + ".bin").c_str(), "wb");
+			long long int header[COLUMNAR_LOG_HEADER_MAX_SIZE] = { 1, COLUMNAR_LOG_FILE_VERSION, 2 };
+			fwrite(header, sizeof(header), 1, pFile);
+			ColumnarLogWriter writer;
+			vector<char> buffer;
+			double values[numLoggedVariables];
+			for (int episode = 0; episode < 2; episode++)
+			{
+				writer.beginEpisode(episode, episode + 1, 1, numLoggedVariables);
+				for (int step = 0; step < numSteps; step++)
+				{
+					if (step == missingStep) continue;
+					getLoggedValues(log, episode, step, values);
+					writer.addStep(step, 0.0, 0.0, 0.0, values);
+				}
+				buffer.clear();
+				writer.endEpisode(ftell(pFile), buffer);
+				fwrite(buffer.data(), 1, buffer.size(), pFile);
+			}
+			buffer.clear();
+			writer.writeIndex(ftell(pFile), buffer);
+			fwrite(buffer.data(), 1, buffer.size(), pFile);
+			fclose(pFile);
+		}
+
+		static vector<double> readSamples(string filename)
+		{
+			vector<double> samples;
+			FILE* pFile = fopen(filename.c_str(), "rb");
+			if (!pFile) return samples;
+			double value;
+			while (fread(&value, sizeof(double), 1, pFile) == 1)
+				samples.push_back(value);
+			fclose(pFile);
+			return samples;
+		}
+
+		//checks that a sample was made from two consecutive steps and returns the index of the second one
+		static int checkSample(const double* pSample)
+		{
+			int step = (int)pSample[4] / 2;
+			Assert::AreEqual(pSample[0] + 1.0, pSample[3], L"s and s' don't belong to consecutive steps");
+			Assert::AreEqual(pSample[1] + 2.0, pSample[4]);
+			Assert::AreEqual(step + 0.5, pSample[2], L"The action doesn't belong to the step of s'");
+			Assert::AreEqual((double)-step, pSample[5], L"The reward doesn't belong to the step of s'");
+			Assert::IsTrue(step != missingStep && step - 1 != missingStep);
+			return step;
+		}
+
+		static void removeFiles(string name)
+		{
+			remove(name.c_str());
+			remove((name + ".bin").c_str());
+		}
+
+		TEST_METHOD(LogSampleConverter_Convert)
+		{
+			writeVersion2Log("log-converter-test-1.simion.log", 1);
+			writeVersion3Log("log-converter-test-2.simion.log", 2);
+
+			LogSampleFilter filter;
+			LogSampleConverter converter(filter, 2, 7);
+			Assert::IsTrue(converter.addLog("log-converter-test-1.simion.log"));
+			Assert::IsTrue(converter.addLog("log-converter-test-2.simion.log"));
+			Assert::IsTrue(converter.convert("log-converter-test.simion.samples", true, 1234));
+
+			//2 logs x 2 episodes x 17 pairs of consecutive steps (19 steps logged, but step 5 is missing)
+			const size_t numSamples = 2 * 2 * 17;
+			Assert::AreEqual(numSamples, converter.getNumSamplesWritten());
+			Assert::AreEqual((size_t)2, converter.getNumLogsConverted());
+			vector<double> samples = readSamples("log-converter-test.simion.samples.bin");
+			Assert::AreEqual(numSamples * numElementsPerSample, samples.size());
+			vector<int> numSamplesPerEpisode(4, 0);
+			for (size_t i = 0; i < numSamples; i++)
+			{
+				checkSample(&samples[i * numElementsPerSample]);
+				int log = (int)(samples[i * numElementsPerSample] / 10000.0);
+				int episode = ((int)samples[i * numElementsPerSample] % 10000) / 1000;
+				numSamplesPerEpisode[(log - 1) * 2 + episode]++;
+			}
+			for (int count : numSamplesPerEpisode)
+				Assert::AreEqual(17, count);
+
+			//the sample file is drawn in the order given by the shuffle file in the first epoch
+			vector<unsigned int> permutation(numSamples);
+			FILE* pFile = fopen("log-converter-test.simion.samples.shuffle.bin", "rb");
+			Assert::IsTrue(pFile != nullptr);
+			Assert::AreEqual(numSamples, fread(permutation.data(), sizeof(unsigned int), numSamples, pFile));
+			fclose(pFile);
+			{
+				SampleFile sampleFile("log-converter-test.simion.samples", SampleOrder::shuffled, 16);
+				Assert::IsTrue(sampleFile.isOpen());
+				Assert::AreEqual((int)numElementsPerSample, sampleFile.getNumElementsPerSample());
+				vector<double> drawnSamples(numSamples * numElementsPerSample);
+				sampleFile.drawRandomSamples(numSamples, drawnSamples.data());
+				for (size_t i = 0; i < numSamples; i++)
+					Assert::IsTrue(memcmp(&drawnSamples[i * numElementsPerSample], &samples[permutation[i] * numElementsPerSample]
+						, numElementsPerSample * sizeof(double)) == 0);
+			}
+
+			removeFiles("log-converter-test-1.simion.log");
+			removeFiles("log-converter-test-2.simion.log");
+			removeFiles("log-converter-test.simion.samples");
+			remove("log-converter-test.simion.samples.shuffle.bin");
+		}
+
+		TEST_METHOD(LogSampleConverter_Filter)
+		{
+			writeVersion2Log("log-converter-test-1.simion.log", 1);
+			writeVersion3Log("log-converter-test-2.simion.log", 2);
+
+			//only training episodes, steps 2..10. The same logs are added twice
+			LogSampleFilter filter;
+			filter.episodeTypes = LogEpisodeTypes::training;
+			filter.firstStep = 2;
+			filter.lastStep = 10;
+			filter.bRemoveDuplicates = true;
+			LogSampleConverter converter(filter, 4, 3);
+			for (int i = 0; i < 2; i++)
+			{
+				Assert::IsTrue(converter.addLog("log-converter-test-1.simion.log"));
+				Assert::IsTrue(converter.addLog("log-converter-test-2.simion.log"));
+			}
+			Assert::IsTrue(converter.convert("log-converter-test.simion.samples"));
+
+			//steps 2, 3, 4, 7, 8, 9 and 10 of one episode per log
+			const size_t numSamples = 2 * 7;
+			Assert::AreEqual(numSamples, converter.getNumSamplesWritten());
+			Assert::AreEqual(numSamples, converter.getNumDuplicatesRemoved());
+			vector<double> samples = readSamples("log-converter-test.simion.samples.bin");
+			Assert::AreEqual(numSamples * numElementsPerSample, samples.size());
+			for (size_t i = 0; i < numSamples; i++)
+			{
+				int step = checkSample(&samples[i * numElementsPerSample]);
+				Assert::IsTrue(step >= 2 && step <= 10);
+				Assert::AreEqual(1, ((int)samples[i * numElementsPerSample] % 10000) / 1000, L"Sample taken from an evaluation episode");
+			}
+
+			//logs with different variables are not added
+			FILE* pFile = fopen("log-converter-test-3.simion.log", "w");
+			fprintf(pFile, "<ExperimentLogDescriptor BinaryDataFile=\"x.bin\"><State-variable>x</State-variable></ExperimentLogDescriptor>");
+			fclose(pFile);
+			Assert::IsFalse(converter.addLog("log-converter-test-3.simion.log"));
+
+			removeFiles("log-converter-test-1.simion.log");
+			removeFiles("log-converter-test-2.simion.log");
+			remove("log-converter-test-3.simion.log");
+			removeFiles("log-converter-test.simion.samples");
+		}
+	};
+}
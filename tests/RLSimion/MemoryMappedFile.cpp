@@ -0,0 +1,176 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../tools/System/MemoryMappedFile.h"
+#include "../../RLSimion/Common/columnar-log.h"
+#include "../../RLSimion/Common/log-episode-index.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#define MEMORY_MAPPED_FILE_TEST_FILE "memory-mapped-file-test.log.bin"
+
+namespace MemoryMappedFiles
+{
+	TEST_CLASS(MemoryMappedFileTest)
+	{
+		//These tests map logs the way SimionLogViewer does, and only read the episodes that are viewed
+	public:
+		static const int numEpisodes = 6;
+		static const int numSteps = 40;
+		static const int numVariables = 4;
+
+		static double getValue(int episode, int step, int variable)
+		{
+			return episode * 100.0 + step + 0.125 * variable;
+		}
+
+		//writes a version 3 log. The blocks of the episodes are returned, to check the mapped data
+		static void writeLog(bool bWriteIndex, vector<vector<char>>& outEpisodeBlocks)
+		{
+			FILE* pFile = fopen(MEMORY_MAPPED_FILE_TEST_FILE, "wb");
+			long long int header[COLUMNAR_LOG_HEADER_MAX_SIZE] = { 1, COLUMNAR_LOG_FILE_VERSION, numEpisodes };
+			fwrite(header, sizeof(header), 1, pFile);
+
+			ColumnarLogWriter writer;
+			vector<char> buffer;
+			double values[numVariables];
+			outEpisodeBlocks.clear();
+			for (int episode = 0; episode < numEpisodes; episode++)
+			{
+				writer.beginEpisode(episode % 2, episode + 1, 1, numVariables);
+				for (int step = 0; step < numSteps; step++)
+				{
+					for (int var = 0; var < numVariables; var++)
+						values[var] = getValue(episode, step, var);
+					writer.addStep(step, 0.01 * step, 0.04 * step, 0.01 * step, values);
+				}
+				buffer.clear();
+				writer.endEpisode(ftell(pFile), buffer);
+				fwrite(buffer.data(), 1, buffer.size(), pFile);
+				outEpisodeBlocks.push_back(buffer);
+			}
+			if (bWriteIndex)
+			{
+				buffer.clear();
+				writer.writeIndex(ftell(pFile), buffer);
+				fwrite(buffer.data(), 1, buffer.size(), pFile);
+			}
+			fclose(pFile);
+		}
+
+		static void checkEpisode(ColumnarLogReader& reader, int episode)
+		{
+			vector<double> values;
+			Assert::AreEqual((size_t)numSteps, reader.getNumSteps(episode));
+			for (int var = 0; var < numVariables; var++)
+			{
+				Assert::IsTrue(reader.readColumn(episode, NumStepColumns + var, values));
+				Assert::AreEqual((size_t)numSteps, values.size());
+				for (int step = 0; step < numSteps; step++)
+					Assert::AreEqual(getValue(episode, step, var), values[step]);
+			}
+		}
+
+		TEST_METHOD(MemoryMappedFile_Version3Log)
+		{
+			vector<vector<char>> episodeBlocks;
+			writeLog(true, episodeBlocks);
+
+			MemoryMappedFile log;
+			Assert::IsTrue(log.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			log.setAccessPattern(MemoryMappedFile::Random);
+			FILE* pFile = fopen(MEMORY_MAPPED_FILE_TEST_FILE, "rb");
+			fseek(pFile, 0, SEEK_END);
+			Assert::AreEqual((size_t)ftell(pFile), log.getSize());
+			fclose(pFile);
+			long long int fileVersion;
+			memcpy(&fileVersion, log.getData() + sizeof(long long int), sizeof(long long int));
+			Assert::AreEqual((long long int)COLUMNAR_LOG_FILE_VERSION, fileVersion);
+
+			//the episodes are found through the index of the log, and the mapped blocks are the ones written
+			ColumnarLogReader reader;
+			Assert::IsTrue(reader.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::AreEqual((size_t)numEpisodes, reader.getNumEpisodes());
+			for (int episode = 0; episode < numEpisodes; episode++)
+			{
+				const size_t offset = (size_t)reader.getEpisodeInfo(episode).index.offset;
+				Assert::IsTrue(offset + episodeBlocks[episode].size() <= log.getSize());
+				Assert::AreEqual(0, memcmp(log.getData() + offset, episodeBlocks[episode].data(), episodeBlocks[episode].size()));
+			}
+
+			//only the episodes viewed are decoded, in any order
+			checkEpisode(reader, numEpisodes - 1);
+			checkEpisode(reader, 2);
+			checkEpisode(reader, 0);
+			reader.close();
+
+			log.close();
+			Assert::IsFalse(log.isOpen());
+			Assert::AreEqual((size_t)0, log.getSize());
+			remove(MEMORY_MAPPED_FILE_TEST_FILE);
+		}
+
+		TEST_METHOD(MemoryMappedFile_EmptyAndTruncated)
+		{
+			MemoryMappedFile log;
+			ColumnarLogReader reader;
+			ExperimentLogReader logIndex;
+
+			//missing file
+			remove(MEMORY_MAPPED_FILE_TEST_FILE);
+			Assert::IsFalse(log.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::IsFalse(log.isOpen());
+
+			//empty file
+			FILE* pFile = fopen(MEMORY_MAPPED_FILE_TEST_FILE, "wb");
+			fclose(pFile);
+			Assert::IsFalse(log.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::IsFalse(log.isOpen());
+			Assert::AreEqual(-1, ColumnarLogReader::getFileVersion(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::IsFalse(reader.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::IsFalse(logIndex.open(MEMORY_MAPPED_FILE_TEST_FILE));
+
+			//truncated experiment header
+			long long int header[COLUMNAR_LOG_HEADER_MAX_SIZE] = { 1, COLUMNAR_LOG_FILE_VERSION, numEpisodes };
+			pFile = fopen(MEMORY_MAPPED_FILE_TEST_FILE, "wb");
+			fwrite(header, sizeof(header) / 2, 1, pFile);
+			fclose(pFile);
+			Assert::IsTrue(log.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::AreEqual(sizeof(header) / 2, log.getSize());
+			log.close();
+			Assert::IsFalse(reader.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::IsFalse(logIndex.open(MEMORY_MAPPED_FILE_TEST_FILE));
+
+			//log cut in the middle of the fourth episode (the experiment crashed): the complete episodes can still be read
+			vector<vector<char>> episodeBlocks;
+			writeLog(false, episodeBlocks);
+			size_t truncatedSize = sizeof(header);
+			for (int episode = 0; episode < 3; episode++)
+				truncatedSize += episodeBlocks[episode].size();
+			truncatedSize += episodeBlocks[3].size() / 2;
+			vector<char> data(truncatedSize);
+			pFile = fopen(MEMORY_MAPPED_FILE_TEST_FILE, "rb");
+			Assert::AreEqual(truncatedSize, fread(data.data(), 1, truncatedSize, pFile));
+			fclose(pFile);
+			pFile = fopen(MEMORY_MAPPED_FILE_TEST_FILE, "wb");
+			fwrite(data.data(), 1, data.size(), pFile);
+			fclose(pFile);
+
+			Assert::IsTrue(log.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::AreEqual(truncatedSize, log.getSize());
+			log.close();
+			Assert::IsTrue(reader.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::AreEqual((size_t)3, reader.getNumEpisodes());
+			for (int episode = 0; episode < 3; episode++)
+				checkEpisode(reader, episode);
+			reader.close();
+			Assert::IsTrue(logIndex.open(MEMORY_MAPPED_FILE_TEST_FILE));
+			Assert::AreEqual((size_t)3, logIndex.getNumEpisodes());
+			logIndex.close();
+
+			remove(MEMORY_MAPPED_FILE_TEST_FILE);
+		}
+	};
+}
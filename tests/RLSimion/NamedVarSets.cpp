@@ -32,5 +32,43 @@ namespace CNamedVarSets
 			Assert::AreEqual(upperLimit, s->get("var2"));
 		}
 
+		TEST_METHOD(NamedVarSet_Normalizer)
+		{
+			Descriptor desc;
+			desc.addVariable("var1", "m", -1.0, 1.0);
+			desc.addVariable("var2", "m", 0.0, 10.0);
+			desc.addVariable("var3", "m", 5.0, 5.0); //the range is clamped to 0.01, as in getNormalized()
+			State* s = desc.getInstance();
+			s->set("var1", 0.5);
+			s->set("var2", 2.0);
+			s->set("var3", 5.005);
+
+			NamedVarSetNormalizer normalizer({ "var3", "var1", "var2" });
+			double values[3];
+			normalizer.normalize(s, values);
+			Assert::AreEqual(s->getNormalized("var3"), values[0]);
+			Assert::AreEqual(s->getNormalized("var1"), values[1]);
+			Assert::AreEqual(s->getNormalized("var2"), values[2]);
+
+			//new values and ranges are read every time
+			s->set("var2", 7.0);
+			desc[1].setMax(20.0);
+			normalizer.normalize(s, values);
+			Assert::AreEqual(s->getNormalized("var2"), values[2]);
+			Assert::AreEqual(0.35, values[2], 1e-12, L"Wrong normalized value");
+
+			//a set with a different descriptor
+			Descriptor desc2;
+			desc2.addVariable("var2", "m", 0.0, 1.0);
+			desc2.addVariable("var1", "m", 0.0, 1.0);
+			desc2.addVariable("var3", "m", 0.0, 1.0);
+			State* s2 = desc2.getInstance();
+			s2->set("var1", 0.25);
+			normalizer.normalize(s2, values);
+			Assert::AreEqual(0.25, values[1]);
+			delete s;
+			delete s2;
+		}
+
 	};
 }
\ No newline at end of file
@@ -0,0 +1,294 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/deep-native-network.h"
+#include "../../RLSimion/Lib/deep-kernels.h"
+#include "../../RLSimion/Lib/deep-minibatch.h"
+#include "../../RLSimion/Lib/deep-functions.h"
+#include <cmath>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace NativeNetworks
+{
+	//Definition of the networks without a config file, only used to create minibatches
+	class TestNetworkDefinition : public DeepNetworkDefinition
+	{
+	public:
+		TestNetworkDefinition(vector<string> stateVariables, vector<string> actionVariables, size_t numOutputs)
+		{
+			m_inputStateVariables = stateVariables;
+			m_inputActionVariables = actionVariables;
+			m_numOutputs = numOutputs;
+		}
+	};
+
+	TEST_CLASS(NativeNetworkTest)
+	{
+	public:
+		static double meanSquaredError(const vector<double>& output, const vector<double>& target)
+		{
+			double error = 0.0;
+			for (size_t i = 0; i < target.size(); i++)
+				error += (output[i] - target[i]) * (output[i] - target[i]);
+			return error / target.size();
+		}
+
+		TEST_METHOD(NativeNetwork_Gemm)
+		{
+			//sizes that aren't multiples of the blocks (K > 64) or the 4-row register blocking
+			const size_t M = 7, N = 5, K = 70;
+			vector<double> A(M * K), At(K * M), B(K * N), C(M * N), Ct(M * N), expected(M * N, 0.0);
+			for (size_t i = 0; i < A.size(); i++) A[i] = sin(0.1 * i);
+			for (size_t i = 0; i < B.size(); i++) B[i] = cos(0.3 * i);
+			for (size_t i = 0; i < M; i++)
+				for (size_t j = 0; j < N; j++)
+					for (size_t k = 0; k < K; k++)
+						expected[i * N + j] += A[i * K + k] * B[k * N + j];
+
+			DeepKernels::gemm(M, N, K, A.data(), B.data(), C.data());
+			DeepKernels::transpose(M, K, A.data(), At.data());
+			DeepKernels::gemmTransposedA(M, N, K, At.data(), B.data(), Ct.data());
+			for (size_t i = 0; i < M * N; i++)
+			{
+				Assert::AreEqual(expected[i], C[i], 1e-9, L"Wrong product");
+				Assert::AreEqual(expected[i], Ct[i], 1e-9, L"Wrong product with transposed A");
+			}
+			//accumulated
+			DeepKernels::gemm(M, N, K, A.data(), B.data(), C.data(), true);
+			for (size_t i = 0; i < M * N; i++)
+				Assert::AreEqual(2.0 * expected[i], C[i], 1e-9, L"Wrong accumulated product");
+		}
+
+		TEST_METHOD(NativeNetwork_QLearningTargets)
+		{
+			//3 tuples with 4 actions. The last row has a tie: the first action with the highest value is selected
+			const size_t M = 3, N = 4;
+			const double gamma = 0.9;
+			vector<double> Q_s_p = { 1.0, 3.0, 2.0, 0.0,   -1.0, -2.0, -0.5, -3.0,   2.0, 5.0, 5.0, 1.0 };
+			vector<double> otherQ_s_p = { 10.0, 20.0, 30.0, 40.0,   50.0, 60.0, 70.0, 80.0,   90.0, 100.0, 110.0, 120.0 };
+			vector<double> r = { 1.0, 0.0, -1.0 };
+			vector<size_t> actions = { 0, 3, 2 };
+			vector<double> Q_s(M * N), target(M * N), doubleTarget(M * N);
+			for (size_t i = 0; i < Q_s.size(); i++) Q_s[i] = 0.1 * i;
+
+			//DQN: the action is selected and evaluated with the same values
+			target = Q_s;
+			DeepKernels::qLearningTargets(M, N, Q_s_p.data(), Q_s_p.data(), r.data(), gamma, actions.data(), target.data());
+			vector<double> expected = Q_s;
+			expected[0 * N + 0] = 1.0 + gamma * 3.0;
+			expected[1 * N + 3] = 0.0 + gamma * -0.5;
+			expected[2 * N + 2] = -1.0 + gamma * 5.0;
+			for (size_t i = 0; i < target.size(); i++)
+				Assert::AreEqual(expected[i], target[i], 1e-12, L"Wrong DQN target");
+
+			//Double DQN: the action selected with Q_s_p is evaluated with otherQ_s_p
+			doubleTarget = Q_s;
+			DeepKernels::qLearningTargets(M, N, Q_s_p.data(), otherQ_s_p.data(), r.data(), gamma, actions.data(), doubleTarget.data());
+			expected[0 * N + 0] = 1.0 + gamma * 20.0;
+			expected[1 * N + 3] = 0.0 + gamma * 70.0;
+			expected[2 * N + 2] = -1.0 + gamma * 100.0;
+			for (size_t i = 0; i < doubleTarget.size(); i++)
+				Assert::AreEqual(expected[i], doubleTarget[i], 1e-12, L"Wrong Double DQN target");
+		}
+
+		TEST_METHOD(NativeNetwork_TrainVFunction)
+		{
+			//V(s)= sin(pi*s) on 32 points in [-1,1]
+			const size_t numSamples = 32;
+			TestNetworkDefinition definition({ "s" }, {}, 1);
+			DeepMinibatch minibatch(numSamples, &definition);
+			vector<double> target(numSamples), output(numSamples);
+			for (size_t i = 0; i < numSamples; i++)
+			{
+				minibatch.s()[i] = -1.0 + 2.0 * i / (numSamples - 1);
+				target[i] = sin(3.14159265 * minibatch.s()[i]);
+			}
+
+			NativeVFunctionNetwork network({ "s" }, "Tanh,16;Tanh,16", "Adam", false);
+			IDeepNetwork* pTarget = network.clone(true);
+			network.evaluate(minibatch.s(), output);
+			double initialError = meanSquaredError(output, target);
+			vector<double> targetOutput(numSamples);
+			((IVFunctionNetwork*)pTarget)->evaluate(minibatch.s(), targetOutput);
+			for (size_t i = 0; i < numSamples; i++)
+				Assert::AreEqual(output[i], targetOutput[i], L"The clone doesn't have the same weights");
+
+			for (int i = 0; i < 2000; i++)
+				network.train(&minibatch, target, 0.002);
+			network.evaluate(minibatch.s(), output);
+			double finalError = meanSquaredError(output, target);
+			Assert::IsTrue(finalError < 0.05 * initialError);
+
+			//frozen networks aren't trained
+			vector<double> frozenOutput(numSamples);
+			pTarget->train(&minibatch, target, 0.002);
+			((IVFunctionNetwork*)pTarget)->evaluate(minibatch.s(), frozenOutput);
+			for (size_t i = 0; i < numSamples; i++)
+				Assert::AreEqual(targetOutput[i], frozenOutput[i], L"A frozen network was trained");
+
+			//soft updates: alpha= 0 doesn't change the target network, alpha= 1 copies the weights
+			pTarget->softUpdate(&network, 0.0);
+			((IVFunctionNetwork*)pTarget)->evaluate(minibatch.s(), frozenOutput);
+			Assert::AreEqual(targetOutput[0], frozenOutput[0]);
+			pTarget->softUpdate(&network, 1.0);
+			((IVFunctionNetwork*)pTarget)->evaluate(minibatch.s(), frozenOutput);
+			for (size_t i = 0; i < numSamples; i++)
+				Assert::AreEqual(output[i], frozenOutput[i], 1e-12, L"Soft update with alpha=1 didn't copy the weights");
+			pTarget->destroy();
+		}
+
+		TEST_METHOD(NativeNetwork_SoftUpdate)
+		{
+			//without hidden layers the output is linear in the parameters, so blending the parameters blends the outputs
+			const size_t numSamples = 8;
+			TestNetworkDefinition definition({ "s0", "s1" }, {}, 2);
+			DeepMinibatch minibatch(numSamples, &definition);
+			vector<double> target(numSamples * 2);
+			for (size_t i = 0; i < numSamples * 2; i++)
+			{
+				minibatch.s()[i] = 0.1 * i;
+				target[i] = 1.0 - 0.2 * i;
+			}
+			NativeDeterministicPolicyNetwork network({ "s0", "s1" }, { "a0", "a1" }, "", "SGD", false);
+			IDeterministicPolicyNetwork* pTarget = (IDeterministicPolicyNetwork*)network.clone(true);
+			for (int i = 0; i < 10; i++)
+				network.train(&minibatch, target, 0.01);
+
+			vector<double> onlineOutput(numSamples * 2), targetOutput(numSamples * 2), blendedOutput(numSamples * 2);
+			network.evaluate(minibatch.s(), onlineOutput);
+			pTarget->evaluate(minibatch.s(), targetOutput);
+			pTarget->softUpdate(&network, 0.25);
+			pTarget->evaluate(minibatch.s(), blendedOutput);
+			for (size_t i = 0; i < numSamples * 2; i++)
+				Assert::AreEqual(0.25 * onlineOutput[i] + 0.75 * targetOutput[i], blendedOutput[i], 1e-12, L"Wrong soft update");
+
+			//hard update
+			pTarget->softUpdate(&network, 1.0);
+			pTarget->evaluate(minibatch.s(), blendedOutput);
+			for (size_t i = 0; i < numSamples * 2; i++)
+				Assert::AreEqual(onlineOutput[i], blendedOutput[i]);
+			pTarget->destroy();
+		}
+
+		TEST_METHOD(NativeNetwork_GradientWrtAction)
+		{
+			NativeContinuousQFunctionNetwork network({ "s0", "s1" }, { "a0", "a1" }, "Tanh,8;Sigmoid,8", "SGD", false);
+			vector<double> s = { 0.2, -0.4, 0.7, 0.1 };
+			vector<double> a = { 0.5, -0.3, -0.8, 0.9 };
+			vector<double> gradient(4), qPlus(2), qMinus(2);
+			network.gradientWrtAction(s, a, gradient);
+
+			//central finite differences
+			const double epsilon = 1e-5;
+			for (size_t i = 0; i < a.size(); i++)
+			{
+				vector<double> aPlus = a, aMinus = a;
+				aPlus[i] += epsilon;
+				aMinus[i] -= epsilon;
+				network.evaluate(s, aPlus, qPlus);
+				network.evaluate(s, aMinus, qMinus);
+				size_t sample = i / 2;
+				double expected = (qPlus[sample] - qMinus[sample]) / (2.0 * epsilon);
+				Assert::AreEqual(expected, gradient[i], 1e-6, L"Wrong gradient wrt the action");
+			}
+		}
+
+		TEST_METHOD(NativeNetwork_SinglePrecision)
+		{
+			//a single precision network with the weights of a double precision one gives the same outputs and gradients up
+			//to float rounding, and it can be trained as well
+			const size_t numSamples = 32;
+			TestNetworkDefinition definition({ "s0", "s1" }, { "a0" }, 1);
+			DeepMinibatch minibatch(numSamples, &definition);
+			vector<double> target(numSamples);
+			for (size_t i = 0; i < numSamples; i++)
+			{
+				minibatch.s()[2 * i] = -1.0 + 2.0 * i / (numSamples - 1);
+				minibatch.s()[2 * i + 1] = cos(0.5 * i);
+				minibatch.a()[i] = sin(0.3 * i);
+				target[i] = sin(3.14159265 * minibatch.s()[2 * i]) * minibatch.a()[i];
+			}
+			NativeContinuousQFunctionNetwork network({ "s0", "s1" }, { "a0" }, "Tanh,16;Tanh,16", "Adam", false);
+			NativeContinuousQFunctionNetwork singleNetwork({ "s0", "s1" }, { "a0" }, "Tanh,16;Tanh,16", "Adam", false
+				, DeepPrecision::Single);
+			Assert::IsTrue(singleNetwork.getPrecision() == DeepPrecision::Single);
+			Assert::AreEqual(network.getNumParameters(), singleNetwork.getNumParameters());
+			vector<double> parameters(network.getNumParameters());
+			network.getParameters(parameters.data());
+			singleNetwork.setParameters(parameters.data());
+
+			vector<double> output(numSamples), singleOutput(numSamples), gradient(numSamples), singleGradient(numSamples);
+			network.evaluate(minibatch.s(), minibatch.a(), output);
+			singleNetwork.evaluate(minibatch.s(), minibatch.a(), singleOutput);
+			network.gradientWrtAction(minibatch.s(), minibatch.a(), gradient);
+			singleNetwork.gradientWrtAction(minibatch.s(), minibatch.a(), singleGradient);
+			for (size_t i = 0; i < numSamples; i++)
+			{
+				Assert::AreEqual(output[i], singleOutput[i], 1e-5, L"Wrong output in single precision");
+				Assert::AreEqual(gradient[i], singleGradient[i], 1e-5, L"Wrong gradient in single precision");
+			}
+
+			double initialError = meanSquaredError(singleOutput, target);
+			for (int i = 0; i < 2000; i++)
+				singleNetwork.train(&minibatch, target, 0.002);
+			singleNetwork.evaluate(minibatch.s(), minibatch.a(), singleOutput);
+			Assert::IsTrue(meanSquaredError(singleOutput, target) < 0.05 * initialError);
+
+			//soft updates between networks with different precision are ignored
+			network.softUpdate(&singleNetwork, 1.0);
+			vector<double> outputAfterUpdate(numSamples);
+			network.evaluate(minibatch.s(), minibatch.a(), outputAfterUpdate);
+			Assert::AreEqual(output[0], outputAfterUpdate[0]);
+		}
+
+		static vector<double> getInitialParameters(unsigned int seed)
+		{
+			srand(seed);
+			NativeVFunctionNetwork network({ "s0", "s1" }, "Tanh,8", "Adam", false);
+			vector<double> parameters(network.getNumParameters());
+			network.getParameters(parameters.data());
+			return parameters;
+		}
+
+		TEST_METHOD(NativeNetwork_InitialWeightsSeed)
+		{
+			//the initial weights are determined by the experiment's random seed
+			vector<double> parameters1 = getInitialParameters(3);
+			vector<double> parameters2 = getInitialParameters(3);
+			vector<double> parameters3 = getInitialParameters(4);
+			Assert::AreEqual(parameters1.size(), parameters2.size());
+			for (size_t i = 0; i < parameters1.size(); i++)
+				Assert::AreEqual(parameters1[i], parameters2[i]);
+			Assert::IsTrue(parameters1[0] != parameters3[0]);
+		}
+
+		TEST_METHOD(NativeNetwork_EvaluateState)
+		{
+			//single-tuple evaluations normalize the variables directly into the input of the network
+			Descriptor stateDescriptor, actionDescriptor;
+			stateDescriptor.addVariable("x", "m", -10.0, 10.0);
+			stateDescriptor.addVariable("s0", "m", 0.0, 2.0);
+			stateDescriptor.addVariable("s1", "m", -1.0, 1.0);
+			actionDescriptor.addVariable("a0", "m", 0.0, 4.0);
+			State* s = stateDescriptor.getInstance();
+			Action* a = actionDescriptor.getInstance();
+			NativeContinuousQFunctionNetwork network({ "s1", "s0" }, { "a0" }, "ReLU,8", "SGD", false);
+
+			vector<double> output(1);
+			for (int i = 0; i < 3; i++)
+			{
+				s->set("s0", 0.5 * i);
+				s->set("s1", -0.2 * i);
+				a->set("a0", 1.0 + i);
+				vector<double>& q = network.evaluate(s, a);
+				network.evaluate({ s->getNormalized("s1"), s->getNormalized("s0") }, { a->getNormalized("a0") }, output);
+				Assert::AreEqual(output[0], q[0], 1e-12, L"Wrong evaluation of a state");
+			}
+			delete s;
+			delete a;
+		}
+	};
+}
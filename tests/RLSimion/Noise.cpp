@@ -0,0 +1,55 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/noise.h"
+#include "../../RLSimion/Lib/parameters-numeric.h"
+#include <math.h>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace NoiseTests
+{
+	TEST_CLASS(NoiseTest)
+	{
+	public:
+		static void meanAndStdDev(const vector<double>& samples, double& mean, double& stdDev)
+		{
+			mean = 0.0;
+			for (double sample : samples) mean += sample;
+			mean /= samples.size();
+			stdDev = 0.0;
+			for (double sample : samples) stdDev += (sample - mean) * (sample - mean);
+			stdDev = sqrt(stdDev / samples.size());
+		}
+
+		TEST_METHOD(Noise_BatchSamples)
+		{
+			const size_t numEnvironments = 5000;
+			vector<double> samples(numEnvironments);
+			double mean, stdDev;
+
+			//Gaussian noise: N(0, sigma*scale) in every environment
+			GaussianNoise gaussianNoise(0.5, 1.0, new ConstantValue(2.0));
+			gaussianNoise.getSamples(samples.data(), numEnvironments);
+			meanAndStdDev(samples, mean, stdDev);
+			Assert::AreEqual(0.0, mean, 0.05, L"Wrong mean of the gaussian noise");
+			Assert::AreEqual(1.0, stdDev, 0.05, L"Wrong standard deviation of the gaussian noise");
+
+			//filtered gaussian noise: each environment is filtered with its own last value
+			GaussianNoise filteredNoise(0.0, 0.5, new ConstantValue(1.0));
+			filteredNoise.getSamples(samples.data(), numEnvironments);
+			for (size_t i = 0; i < numEnvironments; i++)
+				Assert::AreEqual(0.0, samples[i]);
+
+			//Ornstein-Uhlenbeck: every environment has its own process, so after some time the samples of all the
+			//environments follow the stationary distribution N(mu, sigma / sqrt(2 * theta))
+			const double theta = 1.0, sigma = 0.5, mu = 0.2, dt = 0.05;
+			OrnsteinUhlenbeckNoise ouNoise(theta, sigma, mu, dt);
+			for (int step = 0; step < 200; step++)
+				ouNoise.getSamples(samples.data(), numEnvironments);
+			meanAndStdDev(samples, mean, stdDev);
+			Assert::AreEqual(mu, mean, 0.05, L"Wrong mean of the Ornstein-Uhlenbeck noise");
+			Assert::AreEqual(sigma / sqrt(2.0 * theta), stdDev, 0.05, L"Wrong standard deviation of the Ornstein-Uhlenbeck noise");
+		}
+	};
+}
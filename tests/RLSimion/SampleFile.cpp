@@ -4,6 +4,8 @@
 #include "../../tools/System/CrossPlatform.h"
 #include "../../RLSimion/Common/named-var-set.h"
 #include <string>
+#include <vector>
+#include <math.h>
 using namespace std;
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -48,7 +50,7 @@ namespace SampleFilesTests
 
 		static void checkSampleFile(string name, int numSamples)
 		{
-			SampleFile sampleFile(name);
+			SampleFile sampleFile(name, SampleOrder::sequential);
 			Descriptor sDesc, aDesc, rDesc;
 			sDesc.addVariable("x", "m", 0.0, 1000000);
 			aDesc.addVariable("u", "N", 0.0, 1000000);
@@ -103,5 +105,139 @@ namespace SampleFilesTests
 			createSampleFileBin(binaryFilename, numSamples, numVariables);
 			checkSampleFile(sampleFilename, numSamples);
 		}
+
+		//returns the index of a sample created with createSampleFileBin() and checks that its values weren't mixed with those of other samples
+		static int getSampleIndex(const double* pSample)
+		{
+			int index = (int)round(pSample[0] / (0.1 * numVariables));
+			for (int var = 1; var < numVariables; var++)
+				Assert::AreEqual(pSample[0] + 0.1 * var, pSample[var], 0.000001, L"The values of a sample were mixed with another sample's");
+			return index;
+		}
+
+		TEST_METHOD(SampleFile_Shuffled)
+		{
+			int numSamples = 5003;
+			string sampleFilename = "test4.simion.samples";
+			string binaryFilename = createSampleFileDescriptor(sampleFilename, numSamples);
+			createSampleFileBin(binaryFilename, numSamples, numVariables);
+
+			//minibatches smaller than the file, so that the prefetch thread has to fill several of them per epoch
+			SampleFile sampleFile(sampleFilename, SampleOrder::shuffled, 1000);
+			Assert::IsTrue(sampleFile.isOpen());
+			Assert::AreEqual(numVariables, sampleFile.getNumElementsPerSample());
+
+			vector<double> samples(numSamples * numVariables);
+			for (int epoch = 0; epoch < 3; epoch++)
+			{
+				//every sample must be drawn once per epoch, but not in the order they were saved
+				sampleFile.drawRandomSamples(numSamples, samples.data());
+				vector<int> timesDrawn(numSamples, 0);
+				int numInOrder = 0;
+				for (int i = 0; i < numSamples; i++)
+				{
+					int index = getSampleIndex(&samples[i * numVariables]);
+					Assert::IsTrue(index >= 0 && index < numSamples);
+					timesDrawn[index]++;
+					if (index == i) numInOrder++;
+				}
+				for (int i = 0; i < numSamples; i++)
+					Assert::AreEqual(1, timesDrawn[i]);
+				Assert::IsTrue(numInOrder < numSamples / 10);
+			}
+			remove(sampleFilename.c_str());
+			remove(binaryFilename.c_str());
+		}
+
+		TEST_METHOD(SampleFile_Random)
+		{
+			int numSamples = 3001;
+			string sampleFilename = "test5.simion.samples";
+			string binaryFilename = createSampleFileDescriptor(sampleFilename, numSamples);
+			createSampleFileBin(binaryFilename, numSamples, numVariables);
+
+			SampleFile sampleFile(sampleFilename, SampleOrder::random, 512);
+			Descriptor sDesc, aDesc;
+			sDesc.addVariable("x", "m", 0.0, 1000000);
+			aDesc.addVariable("u", "N", 0.0, 1000000);
+			State* s = new State(sDesc);
+			State* s_p = new State(sDesc);
+			Action* a = new Action(aDesc);
+
+			//samples drawn one by one and in minibatches come from the same sequence
+			const int numDraws = 20000;
+			vector<int> timesDrawn(numSamples, 0);
+			double sample[4];
+			vector<double> minibatch(100 * numVariables);
+			for (int i = 0; i < numDraws; i++)
+			{
+				if (i % 2 == 0)
+				{
+					double reward;
+					sampleFile.drawRandomSample(s, a, s_p, reward);
+					sample[0] = s->get((size_t)0); sample[1] = a->get((size_t)0); sample[2] = s_p->get((size_t)0); sample[3] = reward;
+					timesDrawn[getSampleIndex(sample)]++;
+				}
+				else
+				{
+					sampleFile.drawRandomSamples(100, minibatch.data());
+					for (int j = 0; j < 100; j++)
+						timesDrawn[getSampleIndex(&minibatch[j * numVariables])]++;
+				}
+			}
+			//with ~1.1M draws from 3001 samples, every sample must have been drawn and none of them too often
+			int totalDraws = numDraws / 2 + 100 * numDraws / 2;
+			for (int i = 0; i < numSamples; i++)
+			{
+				Assert::IsTrue(timesDrawn[i] > 0);
+				Assert::IsTrue(timesDrawn[i] < 2 * totalDraws / numSamples);
+			}
+
+			delete s;
+			delete s_p;
+			delete a;
+			remove(sampleFilename.c_str());
+			remove(binaryFilename.c_str());
+		}
+
+		TEST_METHOD(SampleFile_NoReward)
+		{
+			//files without reward variables: the reward must not be read from the next sample (or past the end of the file)
+			int numSamples = 100;
+			string sampleFilename = "test6.simion.samples";
+			string binaryFilename = sampleFilename + ".bin";
+			FILE* file;
+			CrossPlatform::Fopen_s(&file, sampleFilename.c_str(), "w");
+			CrossPlatform::Fprintf_s(file, "%s%s%s%d%s", descriptor1.c_str(), binaryFilename.c_str(), descriptor2.c_str(), numSamples
+				, "\"><State-variable>x</State-variable><Action-variable>u</Action-variable></SampleFileDescriptor>");
+			fclose(file);
+			createSampleFileBin(binaryFilename, numSamples, 3);
+
+			SampleFile sampleFile(sampleFilename, SampleOrder::sequential);
+			Assert::AreEqual(3, sampleFile.getNumElementsPerSample());
+			Descriptor sDesc, aDesc;
+			sDesc.addVariable("x", "m", 0.0, 1000000);
+			aDesc.addVariable("u", "N", 0.0, 1000000);
+			State* s = new State(sDesc);
+			State* s_p = new State(sDesc);
+			Action* a = new Action(aDesc);
+
+			double reward;
+			double expected = 0.0;
+			for (int sample = 0; sample < numSamples; sample++)
+			{
+				sampleFile.drawRandomSample(s, a, s_p, reward);
+				Assert::AreEqual(expected, s->get((size_t)0), 0.000001, L"Wrong value"); expected += 0.1;
+				Assert::AreEqual(expected, a->get((size_t)0), 0.000001, L"Wrong value"); expected += 0.1;
+				Assert::AreEqual(expected, s_p->get((size_t)0), 0.000001, L"Wrong value"); expected += 0.1;
+				Assert::AreEqual(0.0, reward);
+			}
+
+			delete s;
+			delete s_p;
+			delete a;
+			remove(sampleFilename.c_str());
+			remove(binaryFilename.c_str());
+		}
 	};
 }
\ No newline at end of file
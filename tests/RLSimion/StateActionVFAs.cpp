@@ -6,6 +6,7 @@
 #include "../../RLSimion/Lib/simgod.h"
 #include "../../RLSimion/Lib/worlds/world.h"
 #include "../../RLSimion/Lib/featuremap.h"
+#include "../../RLSimion/Lib/function-sampler.h"
 #include "../../RLSimion/Common/named-var-set.h"
 #include <iostream>
 
@@ -136,5 +137,179 @@ namespace StateActionVFA
 			delete pVFA;
 			delete pMemManager;
 		}
+		TEST_METHOD(LinearStateActionVFA_FunctionSampler)
+		{
+			Descriptor stateDescriptor;
+			size_t hX = stateDescriptor.addVariable("x", "m", 0.0, 10.0);
+			size_t hY = stateDescriptor.addVariable("y", "m", 10.0, 20.0);
+			Descriptor actionDescriptor;
+			size_t hAction = actionDescriptor.addVariable("force", "N", -1.0, 1.0);
+			const int numFeatures = 10;
+
+			StateFeatureMap* stateFeatureMap = new StateFeatureMap(new GaussianRBFGridFeatureMap(), stateDescriptor, { hX, hY }, numFeatures);
+			ActionFeatureMap* actionFeatureMap = new ActionFeatureMap(new GaussianRBFGridFeatureMap(), actionDescriptor, { hAction }, numFeatures);
+
+			MemManager<SimionMemPool> *pMemManager = new MemManager<SimionMemPool>();
+			LinearStateActionVFA *pVFA
+				= new LinearStateActionVFA(pMemManager, std::shared_ptr<StateFeatureMap>((StateFeatureMap*)stateFeatureMap)
+					, std::shared_ptr<ActionFeatureMap>((ActionFeatureMap*)actionFeatureMap));
+			pVFA->setInitValue(0.0);
+			pVFA->deferredLoadStep();
+			pMemManager->deferredLoadStep();
+			for (size_t i = 0; i < pVFA->getNumWeights(); i++)
+				pVFA->set(i, (double)(i % 17) - 8.0);
+
+			const size_t samplesPerDimension = 20;
+			FunctionSampler3D sampler("Q", pVFA, 0, samplesPerDimension, stateDescriptor, actionDescriptor
+				, StateSource, "x", ActionSource, "force");
+			vector<double> sampled = sampler.sample();
+
+			//the batched evaluation must give the same values as evaluating the samples one by one
+			State* s = stateDescriptor.getInstance();
+			Action* a = actionDescriptor.getInstance();
+			s->set(hY, 15.0);
+			for (size_t y = 0; y < samplesPerDimension; y++)
+			{
+				for (size_t x = 0; x < samplesPerDimension; x++)
+				{
+					s->set(hX, 10.0 * (double)x / (double)(samplesPerDimension - 1));
+					a->set(hAction, -1.0 + 2.0 * (double)y / (double)(samplesPerDimension - 1));
+					Assert::AreEqual(pVFA->evaluate(s, a)[0], sampled[y * samplesPerDimension + x], 0.000001
+						, L"FunctionSampler3D::sample() doesn't match LinearStateActionVFA::evaluate()");
+				}
+			}
+
+			//the snapshot keeps the weights it copied until the next snapshot is taken
+			Assert::IsTrue(sampler.takeSnapshot());
+			for (size_t i = 0; i < pVFA->getNumWeights(); i++)
+				pVFA->set(i, 1.0);
+			vector<double> snapshotSampled = sampler.sampleSnapshot();
+			for (size_t i = 0; i < sampled.size(); i++)
+				Assert::AreEqual(sampled[i], snapshotSampled[i], 0.000001, L"The snapshot changed when the function was updated");
+
+			Assert::IsTrue(sampler.takeSnapshot());
+			snapshotSampled = sampler.sampleSnapshot();
+			sampled = sampler.sample();
+			for (size_t i = 0; i < sampled.size(); i++)
+				Assert::AreEqual(sampled[i], snapshotSampled[i], 0.000001, L"The snapshot wasn't updated");
+
+			delete s;
+			delete a;
+			delete pVFA;
+			delete pMemManager;
+		}
+
+		TEST_METHOD(LinearStateActionVFA_EvaluateBatch)
+		{
+			Descriptor stateDescriptor;
+			size_t hX = stateDescriptor.addVariable("x", "m", 0.0, 10.0);
+			size_t hY = stateDescriptor.addVariable("y", "m", 10.0, 20.0);
+			Descriptor actionDescriptor;
+			size_t hAction = actionDescriptor.addVariable("force", "N", -1.0, 1.0);
+			const int numFeatures = 10;
+
+			StateFeatureMap* stateFeatureMap = new StateFeatureMap(new GaussianRBFGridFeatureMap(), stateDescriptor, { hX, hY }, numFeatures);
+			ActionFeatureMap* actionFeatureMap = new ActionFeatureMap(new GaussianRBFGridFeatureMap(), actionDescriptor, { hAction }, numFeatures);
+
+			MemManager<SimionMemPool> *pMemManager = new MemManager<SimionMemPool>();
+			LinearStateActionVFA *pVFA
+				= new LinearStateActionVFA(pMemManager, std::shared_ptr<StateFeatureMap>((StateFeatureMap*)stateFeatureMap)
+					, std::shared_ptr<ActionFeatureMap>((ActionFeatureMap*)actionFeatureMap));
+			pVFA->setInitValue(0.0);
+			pVFA->deferredLoadStep();
+			pMemManager->deferredLoadStep();
+			for (size_t i = 0; i < pVFA->getNumWeights(); i++)
+				pVFA->set(i, (double)(i % 13) - 6.0);
+
+			//several actions in each state (the state features are shared), then the same action in several states, and
+			//a repeated sample
+			vector<double> x, y, force;
+			for (size_t state = 0; state < 5; state++)
+			{
+				for (size_t action = 0; action < 7; action++)
+				{
+					x.push_back(1.3 * state);
+					y.push_back(20.0 - 2.1 * state);
+					force.push_back(-1.0 + 0.3 * action);
+				}
+			}
+			for (size_t state = 0; state < 5; state++)
+			{
+				x.push_back(9.0 - 1.7 * state);
+				y.push_back(12.0);
+				force.push_back(0.25);
+			}
+			x.push_back(x.back()); y.push_back(y.back()); force.push_back(force.back());
+
+			const double* pStateValues[] = { x.data(), y.data() };
+			const double* pActionValues[] = { force.data() };
+			State* s = stateDescriptor.getInstance();
+			Action* a = actionDescriptor.getInstance();
+			vector<double> output(x.size());
+			pVFA->evaluateBatch(pStateValues, pActionValues, x.size(), s, a, output.data());
+
+			for (size_t sample = 0; sample < x.size(); sample++)
+			{
+				s->set(hX, x[sample]);
+				s->set(hY, y[sample]);
+				a->set(hAction, force[sample]);
+				Assert::AreEqual(pVFA->evaluate(s, a)[0], output[sample], 0.000001
+					, L"LinearStateActionVFA::evaluateBatch() doesn't match LinearStateActionVFA::evaluate()");
+			}
+
+			delete s;
+			delete a;
+			delete pVFA;
+			delete pMemManager;
+		}
+
+		TEST_METHOD(LinearStateVFA_EvaluateBatch)
+		{
+			Descriptor stateDescriptor;
+			size_t hX = stateDescriptor.addVariable("x", "m", 0.0, 10.0);
+			size_t hY = stateDescriptor.addVariable("y", "m", 10.0, 20.0);
+			const int numFeatures = 10;
+
+			StateFeatureMap* stateFeatureMap = new StateFeatureMap(new GaussianRBFGridFeatureMap(), stateDescriptor, { hX, hY }, numFeatures);
+
+			MemManager<SimionMemPool> *pMemManager = new MemManager<SimionMemPool>();
+			LinearStateVFA *pVFA = new LinearStateVFA(pMemManager, std::shared_ptr<StateFeatureMap>(stateFeatureMap));
+			pVFA->setInitValue(0.0);
+			//LinearStateVFA::deferredLoadStep() isn't public
+			static_cast<DeferredLoad*>(pVFA)->deferredLoadStep();
+			pMemManager->deferredLoadStep();
+			for (size_t i = 0; i < pVFA->getNumWeights(); i++)
+				pVFA->set(i, (double)(i % 11) - 5.0);
+
+			//different states, with some of them repeated consecutively (only evaluated once)
+			vector<double> x, y;
+			for (size_t state = 0; state < 8; state++)
+			{
+				x.push_back(1.2 * state);
+				y.push_back(19.0 - 1.1 * state);
+				if (state % 3 == 0)
+				{
+					x.push_back(x.back());
+					y.push_back(y.back());
+				}
+			}
+
+			const double* pStateValues[] = { x.data(), y.data() };
+			State* s = stateDescriptor.getInstance();
+			vector<double> output(x.size());
+			pVFA->evaluateBatch(pStateValues, nullptr, x.size(), s, nullptr, output.data());
+
+			for (size_t sample = 0; sample < x.size(); sample++)
+			{
+				s->set(hX, x[sample]);
+				s->set(hY, y[sample]);
+				Assert::AreEqual(pVFA->evaluate(s, nullptr)[0], output[sample], 0.000001
+					, L"LinearStateVFA::evaluateBatch() doesn't match LinearStateVFA::evaluate()");
+			}
+
+			delete s;
+			delete pVFA;
+			delete pMemManager;
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/stats.h"
+#include <math.h>
+#include <random>
+#include <algorithm>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace StatsTests
+{
+	TEST_CLASS(StatsTest)
+	{
+	public:
+		TEST_METHOD(Stats_MeanVariance)
+		{
+			//values with a large offset, which would ruin the variance calculated as E[x^2] - E[x]^2
+			double x = 0.0, y = 0.0;
+			size_t n = 0;
+			Stats stats;
+			stats.add("Test", "x", x);
+			stats.add("Test", "y", y);
+			stats.add("Test", "n", n);
+			Assert::AreEqual((size_t)3, stats.size());
+			Assert::IsTrue(stats.getSubkey(2) == "n");
+
+			for (int episode = 0; episode < 2; episode++)
+			{
+				stats.reset();
+				const int numSamples = 1000;
+				for (int i = 0; i < numSamples; i++)
+				{
+					x = 1e9 + (i % 10);
+					y = -0.5 * i;
+					n = i;
+					stats.addSample();
+				}
+				Assert::AreEqual(1e9 + 4.5, stats.getAvg(0), 1e-6, L"Wrong mean");
+				Assert::AreEqual(sqrt(8.25 * numSamples / (numSamples - 1)), stats.getStdDev(0), 1e-6, L"Wrong standard deviation");
+				Assert::AreEqual(1e9, stats.getMin(0));
+				Assert::AreEqual(1e9 + 9, stats.getMax(0));
+				Assert::AreEqual(-0.25 * (numSamples - 1), stats.getAvg(1), 1e-9, L"Wrong mean");
+				Assert::AreEqual(-0.5 * (numSamples - 1), stats.getMin(1));
+				Assert::AreEqual(0.5 * (numSamples - 1), stats.getAvg(2), 1e-9, L"Wrong mean of a size_t variable");
+				Assert::AreEqual((double)(numSamples - 1), stats.getMax(2));
+			}
+			//the current value of the variable, not the last one sampled
+			n = 12345;
+			Assert::AreEqual(12345.0, stats.getValue(2));
+		}
+
+		TEST_METHOD(Stats_Quantiles)
+		{
+			double x = 0.0;
+			Stats stats;
+			stats.setQuantiles({ 0.5, 0.99 });
+			stats.add("Test", "x", x);
+			stats.reset();
+
+			//with less than five samples, the closest sample is returned
+			x = 3.0; stats.addSample();
+			x = 1.0; stats.addSample();
+			x = 2.0; stats.addSample();
+			Assert::AreEqual(2.0, stats.getQuantileEstimate(0, 0));
+			Assert::AreEqual(3.0, stats.getQuantileEstimate(0, 1));
+
+			//exponentially distributed values (like step latencies): the estimates must be close to the actual quantiles
+			std::mt19937 generator(1);
+			std::exponential_distribution<double> distribution(1.0);
+			vector<double> values;
+			stats.reset();
+			for (int i = 0; i < 100000; i++)
+			{
+				x = distribution(generator);
+				values.push_back(x);
+				stats.addSample();
+			}
+			std::sort(values.begin(), values.end());
+			double median = values[values.size() / 2];
+			double p99 = values[values.size() * 99 / 100];
+			Assert::AreEqual(median, stats.getQuantileEstimate(0, 0), 0.02 * median, L"Wrong median");
+			Assert::AreEqual(p99, stats.getQuantileEstimate(0, 1), 0.05 * p99, L"Wrong 99th percentile");
+		}
+	};
+}
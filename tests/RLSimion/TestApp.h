@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../../RLSimion/Lib/app.h"
+#include "../../RLSimion/Lib/config.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+//Creates a SimionApp for the tests of the objects that need the world, the experiment or the logger of the app. The
+//configuration is written to a file named after the test, so that the logs and checkpoints have a name to derive theirs
+//from, and all these files are removed when the app is destroyed. The world is always the Rain-car
+class TestApp
+{
+	string m_filename;
+	ConfigFile m_configFile;
+	vector<ConfigFile*> m_objectConfigFiles;
+	SimionApp* m_pApp = nullptr;
+
+	static void writeFile(const string& filename, const string& content)
+	{
+		FILE* pFile = fopen(filename.c_str(), "w");
+		if (!pFile) throw std::runtime_error("Couldn't write the configuration of the test app");
+		fputs(content.c_str(), pFile);
+		fclose(pFile);
+	}
+public:
+	//simGod is the content of the SimGod node. The logs are only written if bLog is true
+	TestApp(const string& name, const string& experiment, const string& simGod, bool bLog = false)
+	{
+		m_filename = name + ".exp";
+		writeFile(m_filename,
+			string("<RLSimion><RLSimion>")
+			+ "<Log><Log-Eval-Episodes>" + (bLog ? "true" : "false") + "</Log-Eval-Episodes>"
+			+ "<Log-Training-Episodes>" + (bLog ? "true" : "false") + "</Log-Training-Episodes>"
+			+ "<Log-Functions>false</Log-Functions></Log>"
+			+ "<World><Num-Integration-Steps>4</Num-Integration-Steps><Delta-T>0.25</Delta-T>"
+			+ "<Dynamic-Model><Model><Rain-car></Rain-car></Model></Dynamic-Model></World>"
+			+ "<Experiment>" + experiment + "</Experiment>"
+			+ "<SimGod>" + simGod + "</SimGod>"
+			+ "</RLSimion></RLSimion>");
+
+		m_pApp = new SimionApp(m_configFile.loadFile(m_filename.c_str()));
+		m_pApp->setExecutedRemotely(true);
+		m_pApp->setConfigFile(m_filename);
+	}
+
+	~TestApp()
+	{
+		//the objects created by the test must have been destroyed before
+		destroy();
+		for (ConfigFile* pConfigFile : m_objectConfigFiles)
+			delete pConfigFile;
+
+		string baseName = m_filename.substr(0, m_filename.size() - 4);
+		for (const char* extension : { ".exp", ".log", ".log.bin", ".log.bin.index", ".log.functions", ".ckpt" })
+			remove((baseName + extension).c_str());
+	}
+
+	SimionApp* get() { return m_pApp; }
+
+	//destroys the app before the test ends, i.e. to read the logs once they are closed. Its files are removed later
+	void destroy()
+	{
+		delete m_pApp;
+		m_pApp = nullptr;
+	}
+
+	//parses the definition of an object created by the test instead of the app, once the app exists: the state and
+	//action variables of the definition are those of the world of the app
+	ConfigNode* parse(const string& objectConfig)
+	{
+		ConfigFile* pConfigFile = new ConfigFile();
+		m_objectConfigFiles.push_back(pConfigFile);
+		pConfigFile->Parse(objectConfig.c_str());
+		if (pConfigFile->Error()) throw std::runtime_error("Wrong definition of an object of the test app");
+		return (ConfigNode*)pConfigFile->FirstChildElement();
+	}
+};
@@ -0,0 +1,63 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/thread-pool.h"
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace ThreadPools
+{
+	TEST_CLASS(ThreadPoolTest)
+	{
+	public:
+
+		TEST_METHOD(ThreadPool_AllTasks)
+		{
+			ThreadPool pool(3);
+			const size_t numTasks = 100;
+
+			//the same pool is reused by consecutive jobs, and each index is run exactly once per job
+			for (int job = 0; job < 5; job++)
+			{
+				std::vector<std::atomic<int>> numCalls(numTasks);
+				for (size_t i = 0; i < numTasks; i++) numCalls[i] = 0;
+
+				pool.parallelFor(numTasks, [&](size_t i) { numCalls[i]++; });
+
+				for (size_t i = 0; i < numTasks; i++)
+					Assert::AreEqual(1, numCalls[i].load());
+			}
+			//an empty job returns immediately
+			pool.parallelFor(0, [](size_t) { throw std::runtime_error("No task should be run"); });
+		}
+
+		TEST_METHOD(ThreadPool_Exception)
+		{
+			ThreadPool pool(3);
+			std::atomic<size_t> numFinished(0);
+
+			bool bThrown = false;
+			try
+			{
+				pool.parallelFor(20, [&](size_t i)
+				{
+					if (i == 7) throw std::runtime_error("Task 7 failed");
+					numFinished++;
+				});
+			}
+			catch (std::runtime_error& e)
+			{
+				bThrown = (std::string(e.what()) == "Task 7 failed");
+			}
+			//the exception of the task is rethrown by parallelFor()
+			Assert::IsTrue(bThrown);
+			//the rest of the tasks still run, and the pool can be used again after a failed job
+			Assert::AreEqual((size_t)19, numFinished.load());
+			numFinished = 0;
+			pool.parallelFor(20, [&](size_t i) { numFinished++; });
+			Assert::AreEqual((size_t)20, numFinished.load());
+		}
+	};
+}
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../../RLSimion/Lib/worlds/windFieldCache.h"
+#include "../../tools/System/FileUtils.h"
+#include <stdio.h>
+#ifdef _WIN32
+#include <direct.h>
+#define removeDirectory _rmdir
+#else
+#include <unistd.h>
+#define removeDirectory rmdir
+#endif
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+#define WIND_FIELD_CACHE_TEST_DIR "wind-field-cache-test"
+
+namespace WindFieldCaches
+{
+	TEST_CLASS(WindFieldCacheTest)
+	{
+	public:
+		//writes the files TurbSim would have generated for a wind field: baseName.bts and baseName.twr
+		static void writeWindFiles(const string& baseName, char content, size_t size)
+		{
+			const char* extensions[] = { ".bts", ".twr" };
+			for (const char* extension : extensions)
+			{
+				FILE* pFile = fopen((baseName + extension).c_str(), "wb");
+				string data(size, content);
+				fwrite(data.c_str(), 1, size, pFile);
+				fclose(pFile);
+			}
+		}
+
+		static string readFile(const string& filename)
+		{
+			string content;
+			FILE* pFile = fopen(filename.c_str(), "rb");
+			if (!pFile) return content;
+			char c;
+			while (fread(&c, 1, 1, pFile) == 1)
+				content += c;
+			fclose(pFile);
+			return content;
+		}
+
+		static void removeCacheFiles()
+		{
+			vector<string> files;
+			getFilesInDirectory(WIND_FIELD_CACHE_TEST_DIR, files);
+			for (const string& file : files)
+				remove(file.c_str());
+		}
+
+		TEST_METHOD(WindFieldCache_StoreFetchEvict)
+		{
+			WindFieldCache cache(WIND_FIELD_CACHE_TEST_DIR, 3000, { ".bts", ".twr" });
+			removeCacheFiles();
+
+			string key1 = WindFieldCache::getKey("URef= 12.5\nRandSeed1= 2318573\n");
+			string key2 = WindFieldCache::getKey("URef= 8.0\nRandSeed1= 2318573\n");
+			Assert::IsTrue(key1 != key2);
+			//line endings don't change the key
+			Assert::AreEqual(key1, WindFieldCache::getKey("URef= 12.5\r\nRandSeed1= 2318573\r\n"));
+
+			Assert::IsFalse(cache.fetch(key1, "wind-field-cache-out"));
+
+			writeWindFiles("wind-field-cache-in", 'a', 1000);
+			Assert::IsTrue(cache.store(key1, "wind-field-cache-in"));
+			Assert::IsTrue(cache.fetch(key1, "wind-field-cache-out"));
+			Assert::AreEqual(string(1000, 'a'), readFile("wind-field-cache-out.bts"));
+			Assert::AreEqual(string(1000, 'a'), readFile("wind-field-cache-out.twr"));
+
+			//the second entry doesn't fit with the first one, so the first one is evicted
+			writeWindFiles("wind-field-cache-in", 'b', 1000);
+			Assert::IsTrue(cache.store(key2, "wind-field-cache-in"));
+			Assert::IsFalse(cache.fetch(key1, "wind-field-cache-out"));
+			Assert::IsTrue(cache.fetch(key2, "wind-field-cache-out"));
+			Assert::AreEqual(string(1000, 'b'), readFile("wind-field-cache-out.bts"));
+
+			removeCacheFiles();
+			remove("wind-field-cache-in.bts");
+			remove("wind-field-cache-in.twr");
+			remove("wind-field-cache-out.bts");
+			remove("wind-field-cache-out.twr");
+			Assert::AreEqual(0, removeDirectory(WIND_FIELD_CACHE_TEST_DIR), L"The cache directory couldn't be removed");
+		}
+	};
+}
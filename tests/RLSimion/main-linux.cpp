@@ -1,16 +1,265 @@
 #include <iostream>
 #include <stdexcept>
+#include "AsyncFileWriter.cpp"
+#include "AsyncMessageSender.cpp"
+#include "AsyncQLearning.cpp"
+#include "BatchActionSelection.cpp"
+#include "BulletSnapshot.cpp"
+#include "BulletWorldPool.cpp"
+#include "Checkpoint.cpp"
+#include "ColumnarLog.cpp"
+#include "DeepNetworkCache.cpp"
+#include "DeepParameterServer.cpp"
+#include "DeepReplayBuffer.cpp"
 #include "Experiment.cpp"
 #include "FeatureMaps.cpp"
+#include "LogEpisodeIndex.cpp"
+#include "LogSampleConverter.cpp"
 #include "MemManager.cpp"
+#include "MemoryMappedFile.cpp"
 #include "NamedVarSets.cpp"
+#include "NativeNetwork.cpp"
+#include "Noise.cpp"
 #include "SampleFile.cpp"
+#include "Stats.cpp"
 #include "StateActionVFAs.cpp"
+#include "ThreadPool.cpp"
 #include "Utilities.cpp"
+#include "WindFieldCache.cpp"
 int main()
 {
   int retCode= 0;
 
+  try
+  {
+    AsyncFileWriters::AsyncFileWriterTest::AsyncFileWriter_BackPressure();
+    std::cout << "Passed AsyncFileWriter_BackPressure()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncFileWriter_BackPressure()\n";
+  }
+  try
+  {
+    AsyncFileWriters::AsyncFileWriterTest::AsyncFileWriter_Drop();
+    std::cout << "Passed AsyncFileWriter_Drop()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncFileWriter_Drop()\n";
+  }
+  try
+  {
+    AsyncMessageSenders::AsyncMessageSenderTest::AsyncMessageSender_Drop();
+    std::cout << "Passed AsyncMessageSender_Drop()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncMessageSender_Drop()\n";
+  }
+  try
+  {
+    AsyncMessageSenders::AsyncMessageSenderTest::AsyncMessageSender_BackPressure();
+    std::cout << "Passed AsyncMessageSender_BackPressure()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncMessageSender_BackPressure()\n";
+  }
+  try
+  {
+    AsyncMessageSenders::AsyncMessageSenderTest::AsyncMessageSender_OrderAndClose();
+    std::cout << "Passed AsyncMessageSender_OrderAndClose()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncMessageSender_OrderAndClose()\n";
+  }
+  try
+  {
+    AsyncQLearningTests::AsyncQLearningTest::AsyncQLearning_RunAndDestroy();
+    std::cout << "Passed AsyncQLearning_RunAndDestroy()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncQLearning_RunAndDestroy()\n";
+  }
+  try
+  {
+    AsyncQLearningTests::AsyncQLearningTest::AsyncQLearning_PausedInEvaluation();
+    std::cout << "Passed AsyncQLearning_PausedInEvaluation()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed AsyncQLearning_PausedInEvaluation()\n";
+  }
+  try
+  {
+    BatchActionSelection::BatchActionSelectionTest::BatchActionSelection_DQN();
+    std::cout << "Passed BatchActionSelection_DQN()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed BatchActionSelection_DQN()\n";
+  }
+  try
+  {
+    BatchActionSelection::BatchActionSelectionTest::BatchActionSelection_DDPG();
+    std::cout << "Passed BatchActionSelection_DDPG()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed BatchActionSelection_DDPG()\n";
+  }
+  try
+  {
+    BulletSnapshots::BulletSnapshotTest::BulletSnapshot_RestoreAndReplay();
+    std::cout << "Passed BulletSnapshot_RestoreAndReplay()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed BulletSnapshot_RestoreAndReplay()\n";
+  }
+  try
+  {
+    BulletSnapshots::BulletSnapshotTest::BulletSnapshot_RestorePendingForces();
+    std::cout << "Passed BulletSnapshot_RestorePendingForces()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed BulletSnapshot_RestorePendingForces()\n";
+  }
+  try
+  {
+    BulletWorldPools::BulletWorldPoolTest::BulletWorldPool_RobotControl();
+    std::cout << "Passed BulletWorldPool_RobotControl()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed BulletWorldPool_RobotControl()\n";
+  }
+  try
+  {
+    BulletWorldPools::BulletWorldPoolTest::BulletWorldPool_PullBox1();
+    std::cout << "Passed BulletWorldPool_PullBox1()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed BulletWorldPool_PullBox1()\n";
+  }
+  try
+  {
+    Checkpoints::CheckpointTest::Checkpoint_WriteRead();
+    std::cout << "Passed Checkpoint_WriteRead()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Checkpoint_WriteRead()\n";
+  }
+  try
+  {
+    Checkpoints::CheckpointTest::Checkpoint_NativeNetwork();
+    std::cout << "Passed Checkpoint_NativeNetwork()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Checkpoint_NativeNetwork()\n";
+  }
+  try
+  {
+    Checkpoints::CheckpointTest::Checkpoint_ResumeLogs();
+    std::cout << "Passed Checkpoint_ResumeLogs()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Checkpoint_ResumeLogs()\n";
+  }
+  try
+  {
+    ColumnarLogs::ColumnarLogTest::ColumnarLog_EncodeDecode();
+    std::cout << "Passed ColumnarLog_EncodeDecode()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed ColumnarLog_EncodeDecode()\n";
+  }
+  try
+  {
+    ColumnarLogs::ColumnarLogTest::ColumnarLog_WriteRead();
+    std::cout << "Passed ColumnarLog_WriteRead()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed ColumnarLog_WriteRead()\n";
+  }
+  try
+  {
+    DeepNetworkCaches::DeepNetworkCacheTest::DeepNetworkCache_Instances();
+    std::cout << "Passed DeepNetworkCache_Instances()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed DeepNetworkCache_Instances()\n";
+  }
+  try
+  {
+    DeepParameterServers::DeepParameterServerTest::DeepParameterServer_ConcurrentPush();
+    std::cout << "Passed DeepParameterServer_ConcurrentPush()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed DeepParameterServer_ConcurrentPush()\n";
+  }
+  try
+  {
+    DeepParameterServers::DeepParameterServerTest::DeepParameterServer_TrainWithGradients();
+    std::cout << "Passed DeepParameterServer_TrainWithGradients()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed DeepParameterServer_TrainWithGradients()\n";
+  }
+  try
+  {
+    DeepParameterServers::DeepParameterServerTest::DeepParameterServer_LoadIncompleteLearnerState();
+    std::cout << "Passed DeepParameterServer_LoadIncompleteLearnerState()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed DeepParameterServer_LoadIncompleteLearnerState()\n";
+  }
+  try
+  {
+    DeepReplayBuffers::DeepReplayBufferTest::DeepReplayBuffer_Sample();
+    std::cout << "Passed DeepReplayBuffer_Sample()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed DeepReplayBuffer_Sample()\n";
+  }
   try
   {
     ExperimentEpisodesSteps::ExperimentTest::Experiment_Episodes();
@@ -102,6 +351,66 @@ int main()
     std::cout << "Failed FeatureMap_TileCoding_MapUnmapSweep()\n";
   }
   try
+  {
+    LogEpisodeIndices::LogEpisodeIndexTest::LogEpisodeIndex_RoundTrip();
+    std::cout << "Passed LogEpisodeIndex_RoundTrip()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LogEpisodeIndex_RoundTrip()\n";
+  }
+  try
+  {
+    LogEpisodeIndices::LogEpisodeIndexTest::LogEpisodeIndex_Seek();
+    std::cout << "Passed LogEpisodeIndex_Seek()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LogEpisodeIndex_Seek()\n";
+  }
+  try
+  {
+    LogEpisodeIndices::LogEpisodeIndexTest::LogEpisodeIndex_Version2();
+    std::cout << "Passed LogEpisodeIndex_Version2()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LogEpisodeIndex_Version2()\n";
+  }
+  try
+  {
+    LogEpisodeIndices::LogEpisodeIndexTest::LogEpisodeIndex_Version3();
+    std::cout << "Passed LogEpisodeIndex_Version3()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LogEpisodeIndex_Version3()\n";
+  }
+  try
+  {
+    LogSampleConverters::LogSampleConverterTest::LogSampleConverter_Convert();
+    std::cout << "Passed LogSampleConverter_Convert()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LogSampleConverter_Convert()\n";
+  }
+  try
+  {
+    LogSampleConverters::LogSampleConverterTest::LogSampleConverter_Filter();
+    std::cout << "Passed LogSampleConverter_Filter()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LogSampleConverter_Filter()\n";
+  }
+  try
   {
     MemManagerTest::UnitTest1::MemManager_TotalAllocated();
     std::cout << "Passed MemManager_TotalAllocated()\n";
@@ -172,6 +481,106 @@ int main()
     std::cout << "Failed NamedVarSet_Circularity()\n";
   }
   try
+  {
+    CNamedVarSets::UnitTest1::NamedVarSet_Normalizer();
+    std::cout << "Passed NamedVarSet_Normalizer()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NamedVarSet_Normalizer()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_Gemm();
+    std::cout << "Passed NativeNetwork_Gemm()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_Gemm()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_QLearningTargets();
+    std::cout << "Passed NativeNetwork_QLearningTargets()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_QLearningTargets()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_TrainVFunction();
+    std::cout << "Passed NativeNetwork_TrainVFunction()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_TrainVFunction()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_SoftUpdate();
+    std::cout << "Passed NativeNetwork_SoftUpdate()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_SoftUpdate()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_GradientWrtAction();
+    std::cout << "Passed NativeNetwork_GradientWrtAction()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_GradientWrtAction()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_SinglePrecision();
+    std::cout << "Passed NativeNetwork_SinglePrecision()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_SinglePrecision()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_InitialWeightsSeed();
+    std::cout << "Passed NativeNetwork_InitialWeightsSeed()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_InitialWeightsSeed()\n";
+  }
+  try
+  {
+    NativeNetworks::NativeNetworkTest::NativeNetwork_EvaluateState();
+    std::cout << "Passed NativeNetwork_EvaluateState()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed NativeNetwork_EvaluateState()\n";
+  }
+  try
+  {
+    NoiseTests::NoiseTest::Noise_BatchSamples();
+    std::cout << "Passed Noise_BatchSamples()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Noise_BatchSamples()\n";
+  }
+  try
   {
     SampleFilesTests::SampleFileTest::SampleFile_Small();
     std::cout << "Passed SampleFile_Small()\n";
@@ -202,6 +611,56 @@ int main()
     std::cout << "Failed SampleFile_Larger()\n";
   }
   try
+  {
+    SampleFilesTests::SampleFileTest::SampleFile_Shuffled();
+    std::cout << "Passed SampleFile_Shuffled()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed SampleFile_Shuffled()\n";
+  }
+  try
+  {
+    SampleFilesTests::SampleFileTest::SampleFile_Random();
+    std::cout << "Passed SampleFile_Random()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed SampleFile_Random()\n";
+  }
+  try
+  {
+    SampleFilesTests::SampleFileTest::SampleFile_NoReward();
+    std::cout << "Passed SampleFile_NoReward()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed SampleFile_NoReward()\n";
+  }
+  try
+  {
+    StatsTests::StatsTest::Stats_MeanVariance();
+    std::cout << "Passed Stats_MeanVariance()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Stats_MeanVariance()\n";
+  }
+  try
+  {
+    StatsTests::StatsTest::Stats_Quantiles();
+    std::cout << "Passed Stats_Quantiles()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed Stats_Quantiles()\n";
+  }
+  try
   {
     StateActionVFA::UnitTest1::LinearStateActionVFA_ArgMax();
     std::cout << "Passed LinearStateActionVFA_ArgMax()\n";
@@ -222,6 +681,36 @@ int main()
     std::cout << "Failed LinearStateActionVFA_FeatureMap()\n";
   }
   try
+  {
+    StateActionVFA::UnitTest1::LinearStateActionVFA_FunctionSampler();
+    std::cout << "Passed LinearStateActionVFA_FunctionSampler()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LinearStateActionVFA_FunctionSampler()\n";
+  }
+  try
+  {
+    StateActionVFA::UnitTest1::LinearStateActionVFA_EvaluateBatch();
+    std::cout << "Passed LinearStateActionVFA_EvaluateBatch()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LinearStateActionVFA_EvaluateBatch()\n";
+  }
+  try
+  {
+    StateActionVFA::UnitTest1::LinearStateVFA_EvaluateBatch();
+    std::cout << "Passed LinearStateVFA_EvaluateBatch()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed LinearStateVFA_EvaluateBatch()\n";
+  }
+  try
   {
     System::System_Windows::RLSimion_Utilities_getDirectory();
     std::cout << "Passed RLSimion_Utilities_getDirectory()\n";
@@ -261,5 +750,55 @@ int main()
     retCode= 1;
     std::cout << "Failed RLSimion_Utilities_getLastBarPos()\n";
   }
+  try
+  {
+    WindFieldCaches::WindFieldCacheTest::WindFieldCache_StoreFetchEvict();
+    std::cout << "Passed WindFieldCache_StoreFetchEvict()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed WindFieldCache_StoreFetchEvict()\n";
+  }
+  try
+  {
+    ThreadPools::ThreadPoolTest::ThreadPool_AllTasks();
+    std::cout << "Passed ThreadPool_AllTasks()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed ThreadPool_AllTasks()\n";
+  }
+  try
+  {
+    ThreadPools::ThreadPoolTest::ThreadPool_Exception();
+    std::cout << "Passed ThreadPool_Exception()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed ThreadPool_Exception()\n";
+  }
+  try
+  {
+    MemoryMappedFiles::MemoryMappedFileTest::MemoryMappedFile_Version3Log();
+    std::cout << "Passed MemoryMappedFile_Version3Log()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed MemoryMappedFile_Version3Log()\n";
+  }
+  try
+  {
+    MemoryMappedFiles::MemoryMappedFileTest::MemoryMappedFile_EmptyAndTruncated();
+    std::cout << "Passed MemoryMappedFile_EmptyAndTruncated()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed MemoryMappedFile_EmptyAndTruncated()\n";
+  }
   return retCode;
 }
@@ -2,9 +2,18 @@
 
 #include "../../tools/System/Process.h"
 #include "../../tools/System/NamedPipe.h"
+#include "../../tools/System/SharedMemoryChannel.h"
 #include "../../tools/System/CrossPlatform.h"
 #include <thread>
 #include <chrono>
+#include <vector>
+#include <string>
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
 using namespace std;
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -15,6 +24,11 @@ char serverBuffer[BUFFER_SIZE];
 NamedPipeClient clientPipe;
 NamedPipeServer serverPipe;
 
+#define NUM_ROUND_TRIPS 1000
+#define LARGE_MESSAGE_SIZE (3 * SHARED_MEMORY_RING_SIZE / 2) //doesn't fit in the ring buffer
+SharedMemoryServer sharedMemoryServer;
+SharedMemoryClient sharedMemoryClient;
+
 namespace SystemTests
 {		
 	TEST_CLASS(System_Tests)
@@ -89,6 +103,110 @@ namespace SystemTests
 			Assert::IsTrue(!clientPipe.isConnected());
 		}
 
+		static void sharedMemoryClientThread()
+		{
+			bool bConnected = sharedMemoryClient.connectToServer(sharedMemoryServer.getFullName(), false);
+			if (!bConnected) return;
+
+			//echo back each message with every value incremented, like a FAST step would return the next state
+			double values[2];
+			while (sharedMemoryClient.readToBuffer(values, sizeof(values)) == sizeof(values))
+			{
+				values[0] += 1.0;
+				values[1] += 1.0;
+				sharedMemoryClient.writeBuffer(values, sizeof(values));
+			}
+			sharedMemoryClient.closeConnection();
+		}
+
+		static void sharedMemoryLargeMessageClientThread()
+		{
+			bool bConnected = sharedMemoryClient.connectToServer(sharedMemoryServer.getFullName(), false);
+			if (!bConnected) return;
+
+			vector<char> message(LARGE_MESSAGE_SIZE);
+			for (size_t i = 0; i < message.size(); i++)
+				message[i] = (char)(i % 127);
+			sharedMemoryClient.writeBuffer(message.data(), (int)message.size());
+			sharedMemoryClient.closeConnection();
+		}
+
+		TEST_METHOD(SharedMemory)
+		{
+			//round trips. Asserts are checked after joining the client thread
+			Assert::IsTrue(sharedMemoryServer.openUniqueServer("test"));
+			std::thread client(sharedMemoryClientThread);
+			bool bConnected = sharedMemoryServer.waitForClientConnection();
+
+			double values[2] = { 0.0, 10.0 };
+			bool bAllBytesSent = true;
+			for (int i = 0; i < NUM_ROUND_TRIPS && bConnected && bAllBytesSent; i++)
+			{
+				bAllBytesSent = sharedMemoryServer.writeBuffer(values, sizeof(values)) == sizeof(values)
+					&& sharedMemoryServer.readToBuffer(values, sizeof(values)) == sizeof(values);
+			}
+			//the client leaves its loop when the server closes the channel
+			sharedMemoryServer.closeServer();
+			client.join();
+
+			Assert::IsTrue(bConnected);
+			Assert::IsTrue(bAllBytesSent);
+			Assert::AreEqual((double)NUM_ROUND_TRIPS, values[0]);
+			Assert::AreEqual(10.0 + NUM_ROUND_TRIPS, values[1]);
+			Assert::IsTrue(!sharedMemoryServer.isConnected());
+			Assert::IsTrue(!sharedMemoryClient.isConnected());
+
+			//a message larger than the ring buffer is received whole, and the client closing after writing it
+			//doesn't prevent reading it
+			Assert::IsTrue(sharedMemoryServer.openUniqueServer("test"));
+			std::thread largeMessageClient(sharedMemoryLargeMessageClientThread);
+			bConnected = sharedMemoryServer.waitForClientConnection();
+			vector<char> message(LARGE_MESSAGE_SIZE);
+			int numBytesRead = bConnected ? sharedMemoryServer.readToBuffer(message.data(), LARGE_MESSAGE_SIZE) : 0;
+			largeMessageClient.join();
+
+			Assert::AreEqual((int)LARGE_MESSAGE_SIZE, numBytesRead);
+			bool bCorrect = true;
+			for (size_t i = 0; i < message.size(); i++)
+				bCorrect = bCorrect && (message[i] == (char)(i % 127));
+			Assert::IsTrue(bCorrect);
+
+			//nothing else will be written, so the read must return instead of blocking
+			Assert::AreEqual(0, sharedMemoryServer.readToBuffer(values, sizeof(values)));
+			sharedMemoryServer.closeServer();
+		}
+
+		TEST_METHOD(SharedMemory_StaleServer)
+		{
+			//in Windows, the objects are destroyed with the last handle to them, so only Linux can leave them behind
+#ifndef _WIN32
+			//a server killed without closing the channel leaves its object in /dev/shm
+			pid_t pid = fork();
+			if (pid == 0)
+			{
+				SharedMemoryServer crashedServer;
+				_exit(crashedServer.openUniqueServer("stale-test") ? 0 : 1);
+			}
+			int status = -1;
+			waitpid(pid, &status, 0);
+			Assert::AreEqual(0, status);
+			int fd = shm_open("/stale-test-0", O_RDWR, 0);
+			Assert::IsTrue(fd >= 0);
+			close(fd);
+
+			//the next server reclaims the name, but not the name of a server still running
+			SharedMemoryServer server, secondServer;
+			Assert::IsTrue(server.openUniqueServer("stale-test"));
+			Assert::IsTrue(string(server.getFullName()) == "/stale-test-0");
+			Assert::IsTrue(secondServer.openUniqueServer("stale-test"));
+			Assert::IsTrue(string(secondServer.getFullName()) == "/stale-test-1");
+			server.closeServer();
+			secondServer.closeServer();
+			fd = shm_open("/stale-test-0", O_RDWR, 0);
+			Assert::IsTrue(fd < 0);
+#endif
+		}
+
 		TEST_METHOD(CrossPlatform_CStrings)
 		{
 			char buffer[BUFFER_SIZE];
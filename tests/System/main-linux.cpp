@@ -36,6 +36,26 @@ int main()
     std::cout << "Failed NamedPipes()\n";
   }
   try
+  {
+    SystemTests::System_Tests::SharedMemory();
+    std::cout << "Passed SharedMemory()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed SharedMemory()\n";
+  }
+  try
+  {
+    SystemTests::System_Tests::SharedMemory_StaleServer();
+    std::cout << "Passed SharedMemory_StaleServer()\n";
+  }
+  catch(std::runtime_error error)
+  {
+    retCode= 1;
+    std::cout << "Failed SharedMemory_StaleServer()\n";
+  }
+  try
   {
     SystemTests::System_Tests::CrossPlatform_CStrings();
     std::cout << "Passed CrossPlatform_CStrings()\n";
@@ -24,7 +24,9 @@
 */
 
 #include "bounding-box.h"
+#include "simd.h"
 #include <algorithm>
+#include <limits>
 
 BoundingBox3D::BoundingBox3D()
 {
@@ -64,6 +66,46 @@ void BoundingBox3D::addPoint(Point3D p)
 	if (p.z() < m_min.z()) m_min.setZ(p.z());
 }
 
+void BoundingBox3D::addPoints(const Point3D* pPoints, size_t numPoints)
+{
+	if (numPoints == 0) return;
+	m_bSet = true;
+
+	double minZ = m_min.z(), maxZ = m_max.z();
+#ifdef GEOMETRYLIB_SSE2
+	//max(p,m) and min(p,m) return m unless p is greater/lower, same as the comparisons in addPoint()
+	__m128d minXY = _mm_set_pd(m_min.y(), m_min.x());
+	__m128d maxXY = _mm_set_pd(m_max.y(), m_max.x());
+	for (size_t i = 0; i < numPoints; i++)
+	{
+		__m128d xy = _mm_set_pd(pPoints[i].y(), pPoints[i].x());
+		maxXY = _mm_max_pd(xy, maxXY);
+		minXY = _mm_min_pd(xy, minXY);
+		if (pPoints[i].z() > maxZ) maxZ = pPoints[i].z();
+		if (pPoints[i].z() < minZ) minZ = pPoints[i].z();
+	}
+	double values[2];
+	_mm_storeu_pd(values, minXY);
+	m_min = Point3D(values[0], values[1], minZ);
+	_mm_storeu_pd(values, maxXY);
+	m_max = Point3D(values[0], values[1], maxZ);
+#else
+	double minX = m_min.x(), minY = m_min.y(), maxX = m_max.x(), maxY = m_max.y();
+	for (size_t i = 0; i < numPoints; i++)
+	{
+		const Point3D& p = pPoints[i];
+		if (p.x() > maxX) maxX = p.x();
+		if (p.y() > maxY) maxY = p.y();
+		if (p.z() > maxZ) maxZ = p.z();
+		if (p.x() < minX) minX = p.x();
+		if (p.y() < minY) minY = p.y();
+		if (p.z() < minZ) minZ = p.z();
+	}
+	m_min = Point3D(minX, minY, minZ);
+	m_max = Point3D(maxX, maxY, maxZ);
+#endif
+}
+
 
 const Point3D& BoundingBox3D::min() const { return m_min; }
 const Point3D& BoundingBox3D::max() const { return m_max; }
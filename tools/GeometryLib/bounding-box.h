@@ -2,6 +2,7 @@
 
 #include "vector3d.h"
 #include "vector2d.h"
+#include <stddef.h>
 
 
 class BoundingBox3D
@@ -14,6 +15,8 @@ public:
 	BoundingBox3D(Point3D min, Point3D max);
 	virtual ~BoundingBox3D();
 	void addPoint(Point3D p);
+	//same as calling addPoint() for each of the points, but with the min/max kept in registers
+	void addPoints(const Point3D* pPoints, size_t numPoints);
 	void reset();
 
 	const Point3D& min() const;
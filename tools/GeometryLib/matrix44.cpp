@@ -24,6 +24,7 @@
 */
 
 #include "matrix44.h"
+#include "simd.h"
 
 
 Matrix44::Matrix44()
@@ -122,6 +123,31 @@ void Matrix44::setScale(const Vector3D& scale)
 	set(3, 3, 1.0);
 }
 
+void Matrix44::setTransform(const Vector3D& translation, const Quaternion& rotation, const Vector3D& scale)
+{
+	//the columns of the rotation matrix are scaled and the translation is the last column
+	setRotation(rotation);
+	const double scales[3] = { scale.x(), scale.y(), scale.z() };
+#ifdef GEOMETRYLIB_SSE2
+	for (int c = 0; c < 3; c++)
+	{
+		__m128d s = _mm_set1_pd(scales[c]);
+		_mm_storeu_pd(&_values[c * 4], _mm_mul_pd(_mm_loadu_pd(&_values[c * 4]), s));
+		_mm_storeu_pd(&_values[c * 4 + 2], _mm_mul_pd(_mm_loadu_pd(&_values[c * 4 + 2]), s));
+	}
+#else
+	for (int c = 0; c < 3; c++)
+	{
+		for (int r = 0; r < 4; r++)
+			_values[c * 4 + r] *= scales[c];
+	}
+#endif
+	set(3, 0, translation.x());
+	set(3, 1, translation.y());
+	set(3, 2, translation.z());
+	set(3, 3, 1.0);
+}
+
 void Matrix44::setPerspective(double halfWidth, double halfHeight, double nearPlaneDist, double farPlaneDist)
 {
 	//http://www.songho.ca/opengl/gl_projectionmatrix.html
@@ -153,50 +179,125 @@ BoundingBox3D Matrix44::operator*(const BoundingBox3D& box) const
 
 Matrix44 Matrix44::operator*(const Matrix44& mat) const
 {
+	//Each column of the result is a linear combination of the columns of this matrix:
+	//result.col(c) = col(0)*mat(c,0) + col(1)*mat(c,1) + col(2)*mat(c,2) + col(3)*mat(c,3)
 	Matrix44 result;
-	result.set(0, 0, get(0, 0)*mat.get(0, 0) + get(1, 0)*mat.get(0, 1) + get(2, 0)*mat.get(0, 2) + get(3, 0)*mat.get(0, 3));
-	result.set(1, 0, get(0, 0)*mat.get(1, 0) + get(1, 0)*mat.get(1, 1) + get(2, 0)*mat.get(1, 2) + get(3, 0)*mat.get(1, 3));
-	result.set(2, 0, get(0, 0)*mat.get(2, 0) + get(1, 0)*mat.get(2, 1) + get(2, 0)*mat.get(2, 2) + get(3, 0)*mat.get(2, 3));
-	result.set(3, 0, get(0, 0)*mat.get(3, 0) + get(1, 0)*mat.get(3, 1) + get(2, 0)*mat.get(3, 2) + get(3, 0)*mat.get(3, 3));
-
-	result.set(0, 1, get(0, 1)*mat.get(0, 0) + get(1, 1)*mat.get(0, 1) + get(2, 1)*mat.get(0, 2) + get(3, 1)*mat.get(0, 3));
-	result.set(1, 1, get(0, 1)*mat.get(1, 0) + get(1, 1)*mat.get(1, 1) + get(2, 1)*mat.get(1, 2) + get(3, 1)*mat.get(1, 3));
-	result.set(2, 1, get(0, 1)*mat.get(2, 0) + get(1, 1)*mat.get(2, 1) + get(2, 1)*mat.get(2, 2) + get(3, 1)*mat.get(2, 3));
-	result.set(3, 1, get(0, 1)*mat.get(3, 0) + get(1, 1)*mat.get(3, 1) + get(2, 1)*mat.get(3, 2) + get(3, 1)*mat.get(3, 3));
-
-	result.set(0, 2, get(0, 2)*mat.get(0, 0) + get(1, 2)*mat.get(0, 1) + get(2, 2)*mat.get(0, 2) + get(3, 2)*mat.get(0, 3));
-	result.set(1, 2, get(0, 2)*mat.get(1, 0) + get(1, 2)*mat.get(1, 1) + get(2, 2)*mat.get(1, 2) + get(3, 2)*mat.get(1, 3));
-	result.set(2, 2, get(0, 2)*mat.get(2, 0) + get(1, 2)*mat.get(2, 1) + get(2, 2)*mat.get(2, 2) + get(3, 2)*mat.get(2, 3));
-	result.set(3, 2, get(0, 2)*mat.get(3, 0) + get(1, 2)*mat.get(3, 1) + get(2, 2)*mat.get(3, 2) + get(3, 2)*mat.get(3, 3));
-
-	result.set(0, 3, get(0, 3)*mat.get(0, 0) + get(1, 3)*mat.get(0, 1) + get(2, 3)*mat.get(0, 2) + get(3, 3)*mat.get(0, 3));
-	result.set(1, 3, get(0, 3)*mat.get(1, 0) + get(1, 3)*mat.get(1, 1) + get(2, 3)*mat.get(1, 2) + get(3, 3)*mat.get(1, 3));
-	result.set(2, 3, get(0, 3)*mat.get(2, 0) + get(1, 3)*mat.get(2, 1) + get(2, 3)*mat.get(2, 2) + get(3, 3)*mat.get(2, 3));
-	result.set(3, 3, get(0, 3)*mat.get(3, 0) + get(1, 3)*mat.get(3, 1) + get(2, 3)*mat.get(3, 2) + get(3, 3)*mat.get(3, 3));
-
+#if defined(GEOMETRYLIB_AVX)
+	__m256d col0 = _mm256_loadu_pd(&_values[0]);
+	__m256d col1 = _mm256_loadu_pd(&_values[4]);
+	__m256d col2 = _mm256_loadu_pd(&_values[8]);
+	__m256d col3 = _mm256_loadu_pd(&_values[12]);
+	for (int c = 0; c < 4; c++)
+	{
+		const double* matCol = &mat._values[c * 4];
+		__m256d sum = _mm256_mul_pd(col0, _mm256_set1_pd(matCol[0]));
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(col1, _mm256_set1_pd(matCol[1])));
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(col2, _mm256_set1_pd(matCol[2])));
+		sum = _mm256_add_pd(sum, _mm256_mul_pd(col3, _mm256_set1_pd(matCol[3])));
+		_mm256_storeu_pd(&result._values[c * 4], sum);
+	}
+#elif defined(GEOMETRYLIB_SSE2)
+	for (int half = 0; half < 4; half += 2)
+	{
+		__m128d col0 = _mm_loadu_pd(&_values[0 + half]);
+		__m128d col1 = _mm_loadu_pd(&_values[4 + half]);
+		__m128d col2 = _mm_loadu_pd(&_values[8 + half]);
+		__m128d col3 = _mm_loadu_pd(&_values[12 + half]);
+		for (int c = 0; c < 4; c++)
+		{
+			const double* matCol = &mat._values[c * 4];
+			__m128d sum = _mm_mul_pd(col0, _mm_set1_pd(matCol[0]));
+			sum = _mm_add_pd(sum, _mm_mul_pd(col1, _mm_set1_pd(matCol[1])));
+			sum = _mm_add_pd(sum, _mm_mul_pd(col2, _mm_set1_pd(matCol[2])));
+			sum = _mm_add_pd(sum, _mm_mul_pd(col3, _mm_set1_pd(matCol[3])));
+			_mm_storeu_pd(&result._values[c * 4 + half], sum);
+		}
+	}
+#else
+	for (int c = 0; c < 4; c++)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			result._values[c * 4 + r] = _values[0 + r] * mat._values[c * 4 + 0] + _values[4 + r] * mat._values[c * 4 + 1]
+				+ _values[8 + r] * mat._values[c * 4 + 2] + _values[12 + r] * mat._values[c * 4 + 3];
+		}
+	}
+#endif
 	return result;
 }
 
-
-
 Point3D Matrix44::operator*(const Point3D& v) const
 {
 	Point3D result;
-	result.setX(get(0, 0)*v.x() + get(1, 0)*v.y() + get(2, 0)*v.z() + get(3, 0));
-	result.setY(get(0, 1)*v.x() + get(1, 1)*v.y() + get(2, 1)*v.z() + get(3, 1));
-	result.setZ(get(0, 2)*v.x() + get(1, 2)*v.y() + get(2, 2)*v.z() + get(3, 2));
+	transformPoints(&v, &result, 1);
 	return result;
 }
 
 Vector3D Matrix44::operator*(const Vector3D& v) const
 {
 	Vector3D result;
-	result.setX(get(0, 0)*v.x() + get(1, 0)*v.y() + get(2, 0)*v.z());
-	result.setY(get(0, 1)*v.x() + get(1, 1)*v.y() + get(2, 1)*v.z());
-	result.setZ(get(0, 2)*v.x() + get(1, 2)*v.y() + get(2, 2)*v.z());
+	transformVectors(&v, &result, 1);
 	return result;
 }
 
+void Matrix44::transformPoints(const Point3D* pPoints, Point3D* pOutPoints, size_t numPoints) const
+{
+	//p'= col(0)*x + col(1)*y + col(2)*z + col(3)
+#ifdef GEOMETRYLIB_SSE2
+	__m128d col0XY = _mm_loadu_pd(&_values[0]);
+	__m128d col1XY = _mm_loadu_pd(&_values[4]);
+	__m128d col2XY = _mm_loadu_pd(&_values[8]);
+	__m128d col3XY = _mm_loadu_pd(&_values[12]);
+	double result[2];
+	for (size_t i = 0; i < numPoints; i++)
+	{
+		const double x = pPoints[i].x(), y = pPoints[i].y(), z = pPoints[i].z();
+		__m128d sum = _mm_mul_pd(col0XY, _mm_set1_pd(x));
+		sum = _mm_add_pd(sum, _mm_mul_pd(col1XY, _mm_set1_pd(y)));
+		sum = _mm_add_pd(sum, _mm_mul_pd(col2XY, _mm_set1_pd(z)));
+		sum = _mm_add_pd(sum, col3XY);
+		_mm_storeu_pd(result, sum);
+		pOutPoints[i] = Point3D(result[0], result[1], _values[2] * x + _values[6] * y + _values[10] * z + _values[14]);
+	}
+#else
+	for (size_t i = 0; i < numPoints; i++)
+	{
+		const double x = pPoints[i].x(), y = pPoints[i].y(), z = pPoints[i].z();
+		pOutPoints[i] = Point3D(_values[0] * x + _values[4] * y + _values[8] * z + _values[12]
+			, _values[1] * x + _values[5] * y + _values[9] * z + _values[13]
+			, _values[2] * x + _values[6] * y + _values[10] * z + _values[14]);
+	}
+#endif
+}
+
+void Matrix44::transformVectors(const Vector3D* pVectors, Vector3D* pOutVectors, size_t numVectors) const
+{
+	//vectors are not affected by translations: v'= col(0)*x + col(1)*y + col(2)*z
+#ifdef GEOMETRYLIB_SSE2
+	__m128d col0XY = _mm_loadu_pd(&_values[0]);
+	__m128d col1XY = _mm_loadu_pd(&_values[4]);
+	__m128d col2XY = _mm_loadu_pd(&_values[8]);
+	double result[2];
+	for (size_t i = 0; i < numVectors; i++)
+	{
+		const double x = pVectors[i].x(), y = pVectors[i].y(), z = pVectors[i].z();
+		__m128d sum = _mm_mul_pd(col0XY, _mm_set1_pd(x));
+		sum = _mm_add_pd(sum, _mm_mul_pd(col1XY, _mm_set1_pd(y)));
+		sum = _mm_add_pd(sum, _mm_mul_pd(col2XY, _mm_set1_pd(z)));
+		_mm_storeu_pd(result, sum);
+		pOutVectors[i] = Vector3D(result[0], result[1], _values[2] * x + _values[6] * y + _values[10] * z);
+	}
+#else
+	for (size_t i = 0; i < numVectors; i++)
+	{
+		const double x = pVectors[i].x(), y = pVectors[i].y(), z = pVectors[i].z();
+		pOutVectors[i] = Vector3D(_values[0] * x + _values[4] * y + _values[8] * z
+			, _values[1] * x + _values[5] * y + _values[9] * z
+			, _values[2] * x + _values[6] * y + _values[10] * z);
+	}
+#endif
+}
+
 Point2D Matrix44::operator*(const Point2D& v) const
 {
 	Point2D result;
@@ -2,6 +2,7 @@
 #include "quaternion.h"
 #include "vector3d.h"
 #include "bounding-box.h"
+#include <stddef.h>
 
 class Matrix44
 {
@@ -16,6 +17,8 @@ public:
 	void setTranslation(const Vector3D& translation);
 	void setScale(const Vector3D& scale);
 	void setPerspective(double halfWidth, double halfHeight, double nearPlaneDist, double farPlaneDist);
+	//same as translation*rotation*scale, but without multiplying the three matrices
+	void setTransform(const Vector3D& translation, const Quaternion& rotation, const Vector3D& scale);
 
 	Matrix44 operator*(const Matrix44& mat) const;
 	BoundingBox3D operator*(const BoundingBox3D& box) const;
@@ -26,6 +29,10 @@ public:
 	Point2D operator* (const Point2D& p) const;
 	Vector2D operator* (const Vector2D& v) const;
 
+	//Batch versions of operator*. pOut can be the same array as the input
+	void transformPoints(const Point3D* pPoints, Point3D* pOutPoints, size_t numPoints) const;
+	void transformVectors(const Vector3D* pVectors, Vector3D* pOutVectors, size_t numVectors) const;
+
 	double* asArray();
 
 	double get(int col, int row) const;
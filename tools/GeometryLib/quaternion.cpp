@@ -24,6 +24,7 @@
 */
 
 #include "quaternion.h"
+#include "simd.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
 
@@ -237,13 +238,59 @@ Quaternion Quaternion::operator*(Quaternion quat)
 		fromOrientations();
 
 	Quaternion result;
+#ifdef GEOMETRYLIB_SSE2
+	//(x,y) and (z,w) are calculated in parallel, with the terms added in the same order as the scalar version
+	__m128d xy = _mm_loadu_pd(&m_x), zw = _mm_loadu_pd(&m_z);
+	__m128d qxy = _mm_loadu_pd(&quat.m_x), qzw = _mm_loadu_pd(&quat.m_z);
+	__m128d ww = _mm_set1_pd(m_w);
+	__m128d yz = _mm_shuffle_pd(xy, zw, 1);
+	__m128d zx = _mm_shuffle_pd(zw, xy, 0);
+	const __m128d negateSecond = _mm_set_pd(-0.0, 0.0);
+
+	//x= w*qx + x*qw + y*qz - z*qy
+	//y= w*qy + y*qw + z*qx - x*qz
+	__m128d resultXY = _mm_mul_pd(ww, qxy);
+	resultXY = _mm_add_pd(resultXY, _mm_mul_pd(xy, _mm_unpackhi_pd(qzw, qzw)));
+	resultXY = _mm_add_pd(resultXY, _mm_mul_pd(yz, _mm_shuffle_pd(qzw, qxy, 0)));
+	resultXY = _mm_sub_pd(resultXY, _mm_mul_pd(zx, _mm_shuffle_pd(qxy, qzw, 1)));
+	//z= w*qz + z*qw + x*qy - y*qx
+	//w= w*qw - x*qx - y*qy - z*qz
+	__m128d resultZW = _mm_mul_pd(ww, qzw);
+	resultZW = _mm_add_pd(resultZW, _mm_xor_pd(_mm_mul_pd(zx, _mm_shuffle_pd(qzw, qxy, 1)), negateSecond));
+	resultZW = _mm_add_pd(resultZW, _mm_xor_pd(_mm_mul_pd(xy, _mm_unpackhi_pd(qxy, qxy)), negateSecond));
+	resultZW = _mm_sub_pd(resultZW, _mm_mul_pd(yz, _mm_shuffle_pd(qxy, qzw, 0)));
+
+	_mm_storeu_pd(&result.m_x, resultXY);
+	_mm_storeu_pd(&result.m_z, resultZW);
+#else
 	result.m_x = m_w * quat.m_x + m_x * quat.m_w + m_y * quat.m_z - m_z * quat.m_y;
 	result.m_y = m_w * quat.m_y + m_y * quat.m_w + m_z * quat.m_x - m_x * quat.m_z;
 	result.m_z = m_w * quat.m_z + m_z * quat.m_w + m_x * quat.m_y - m_y * quat.m_x;
 	result.m_w = m_w * quat.m_w - m_x * quat.m_x - m_y * quat.m_y - m_z * quat.m_z;
+#endif
 	result.normalize();
 	return result;
 }
+
+Vector3D Quaternion::rotate(const Vector3D& v) const
+{
+	//v'= v + 2w(q x v) + 2q x (q x v), with q= (x,y,z). Cheaper than building the rotation matrix
+	//when only a few vectors are rotated
+	Vector3D q(x(), y(), z());
+	Vector3D t = q.cross(v) * 2.0;
+	return v + t * w() + q.cross(t);
+}
+
+void Quaternion::rotate(const Vector3D* pVectors, Vector3D* pOutVectors, size_t numVectors) const
+{
+	Vector3D q(x(), y(), z());
+	double qw = w();
+	for (size_t i = 0; i < numVectors; i++)
+	{
+		Vector3D t = q.cross(pVectors[i]) * 2.0;
+		pOutVectors[i] = pVectors[i] + t * qw + q.cross(t);
+	}
+}
 void Quaternion::operator+=(const Quaternion quat)
 {
 	if (bUseOrientations())
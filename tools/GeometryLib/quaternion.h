@@ -1,4 +1,6 @@
 #pragma once
+#include "vector3d.h"
+#include <stddef.h>
 
 class Quaternion
 {
@@ -58,6 +60,10 @@ public:
 	void operator-=(const Quaternion quat);
 	void operator*=(const Quaternion quat);
 	void operator*=(const double x);
+
+	//rotates v by this quaternion. The batch version rotates numVectors vectors (pOut can be the same as the input)
+	Vector3D rotate(const Vector3D& v) const;
+	void rotate(const Vector3D* pVectors, Vector3D* pOutVectors, size_t numVectors) const;
 };
 
 
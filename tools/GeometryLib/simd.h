@@ -0,0 +1,16 @@
+#pragma once
+
+//SIMD support for GeometryLib. SSE2 is always available in x64 (and in x86 builds with /arch:SSE2, the
+//default in Visual Studio), so it is used unless the target doesn't support it. AVX is only used if
+//the compiler is allowed to (/arch:AVX, -mavx), because binaries built with it don't run on older CPUs.
+//All the SIMD code paths do the same operations in the same order as the scalar ones, so results are
+//bit-identical whichever path is compiled in
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEOMETRYLIB_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(GEOMETRYLIB_SSE2) && defined(__AVX__)
+#define GEOMETRYLIB_AVX
+#include <immintrin.h>
+#endif
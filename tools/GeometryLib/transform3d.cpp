@@ -50,12 +50,19 @@ void Transform3D::updateMatrix()
 	if (m_rotation.bUseOrientations())
 		m_rotation.fromOrientations();
 
-	Matrix44 rot,trans,scale;
+	m_matrix.setTransform(m_translation, m_rotation, m_scale);
+}
 
-	rot.setRotation(m_rotation);
-	trans.setTranslation(m_translation);
-	scale.setScale(m_scale);
-	m_matrix = trans*rot*scale;
+void Transform3D::transformPoints(const Point3D* pPoints, Point3D* pOutPoints, size_t numPoints)
+{
+	updateMatrix();
+	m_matrix.transformPoints(pPoints, pOutPoints, numPoints);
+}
+
+void Transform3D::transformVectors(const Vector3D* pVectors, Vector3D* pOutVectors, size_t numVectors)
+{
+	updateMatrix();
+	m_matrix.transformVectors(pVectors, pOutVectors, numVectors);
 }
 
 Vector3D Transform3D::operator*(Vector3D& v)
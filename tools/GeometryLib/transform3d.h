@@ -21,6 +21,10 @@ public:
 	Vector3D operator*(Vector3D& v);
 	Point3D operator*(Point3D& v);
 
+	//Batch versions of operator*: the matrix is only updated once
+	void transformPoints(const Point3D* pPoints, Point3D* pOutPoints, size_t numPoints);
+	void transformVectors(const Vector3D* pVectors, Vector3D* pOutVectors, size_t numVectors);
+
 	Vector3D translation() const { return m_translation; }
 	Quaternion rotation() const { return m_rotation; }
 	Vector3D scale() const { return m_scale; }
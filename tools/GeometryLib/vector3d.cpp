@@ -24,6 +24,7 @@
 */
 
 #include "vector3d.h"
+#include "simd.h"
 #include <math.h>
 
 Vector3D Vector3D::operator+(const Vector3D& vec) const
@@ -99,10 +100,26 @@ Vector3D& Vector3D::operator-=(const Vector3D& vec)
 
 Vector3D Vector3D::cross(const Vector3D& vec) const
 {
+#ifdef GEOMETRYLIB_SSE2
+	//x and y are calculated in parallel: (y*vz - z*vy, z*vx - x*vz)
+	__m128d xy = _mm_loadu_pd(&m_x);
+	__m128d vecXY = _mm_loadu_pd(&vec.m_x);
+	__m128d zz = _mm_set1_pd(m_z);
+	__m128d vecZZ = _mm_set1_pd(vec.m_z);
+	__m128d yz = _mm_shuffle_pd(xy, zz, 1);
+	__m128d vecYZ = _mm_shuffle_pd(vecXY, vecZZ, 1);
+	__m128d zx = _mm_shuffle_pd(zz, xy, 0);
+	__m128d vecZX = _mm_shuffle_pd(vecZZ, vecXY, 0);
+	__m128d resultXY = _mm_sub_pd(_mm_mul_pd(yz, vecZX), _mm_mul_pd(zx, vecYZ));
+	double result[2];
+	_mm_storeu_pd(result, resultXY);
+	return Vector3D(result[0], result[1], m_x * vec.m_y - m_y * vec.m_x);
+#else
 	return Vector3D(
 		m_y * vec.m_z - m_z * vec.m_y,
 		m_z * vec.m_x - m_x * vec.m_z,
 		m_x * vec.m_y - m_y * vec.m_x);
+#endif
 }
 
 Vector3D Vector3D::inverse() const
@@ -112,7 +129,13 @@ Vector3D Vector3D::inverse() const
 
 double Vector3D::dot(const Vector3D& vec) const
 {
+#ifdef GEOMETRYLIB_SSE2
+	__m128d products = _mm_mul_pd(_mm_loadu_pd(&m_x), _mm_loadu_pd(&vec.m_x));
+	__m128d sum = _mm_add_sd(products, _mm_unpackhi_pd(products, products));
+	return _mm_cvtsd_f64(sum) + m_z*vec.m_z;
+#else
 	return m_x*vec.m_x + m_y* vec.m_y + m_z*vec.m_z;
+#endif
 }
 
 void Vector3D::normalize()
@@ -128,7 +151,7 @@ void Vector3D::normalize()
 
 double Vector3D::length() const
 {
-	return sqrt(m_x*m_x + m_y*m_y + m_z*m_z);
+	return sqrt(dot(*this));
 }
 
 Vector3D Vector3D::lerp(const Vector3D &vec1, const Vector3D &vec2, double u)
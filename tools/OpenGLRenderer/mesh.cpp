@@ -81,8 +81,7 @@ void Mesh::draw()
 
 void Mesh::updateBoundingBox(BoundingBox3D& bb)
 {
-	for (unsigned int i = 0; i < m_numPositions; ++i)
-		bb.addPoint(m_pPositions[i]);
+	bb.addPoints(m_pPositions, m_numPositions);
 }
 
 void Mesh::transformVertices(Vector3D& translation, Vector3D& scale)
@@ -0,0 +1,125 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+// SimionLogToSamples: converts experiment logs to a sample file that can be used for offline training
+//
+
+#include "../../RLSimion/Lib/log-sample-converter.h"
+#include "../System/FileUtils.h"
+#include <iostream>
+#include <stdlib.h>
+using namespace std;
+
+#define LOG_DESCRIPTOR_EXTENSION ".simion.log"
+#define SAMPLE_FILE_DESCRIPTOR_EXTENSION ".simion.samples"
+
+bool endsWith(const string& s, const string& suffix)
+{
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void printUsage()
+{
+	cout << "Usage: SimionLogToSamples <input-dir-or-log>... -output=<file> [-episodes=all|evaluation|training]"
+		<< " [-first-step=<n>] [-last-step=<n>] [-remove-duplicates] [-shuffle-file] [-threads=<n>] [-seed=<n>]\n";
+}
+
+int main(int argc, char** argv)
+{
+	LogSampleFilter filter;
+	string outputFilename;
+	bool bWriteShuffleFile = false;
+	size_t numThreads = 0;
+	unsigned int seed = 0;
+	vector<string> inputs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg.find("-output=") == 0) outputFilename = arg.substr(8);
+		else if (arg == "-episodes=evaluation") filter.episodeTypes = LogEpisodeTypes::evaluation;
+		else if (arg == "-episodes=training") filter.episodeTypes = LogEpisodeTypes::training;
+		else if (arg == "-episodes=all") filter.episodeTypes = LogEpisodeTypes::all;
+		else if (arg.find("-first-step=") == 0) filter.firstStep = atoll(arg.substr(12).c_str());
+		else if (arg.find("-last-step=") == 0) filter.lastStep = atoll(arg.substr(11).c_str());
+		else if (arg == "-remove-duplicates") filter.bRemoveDuplicates = true;
+		else if (arg == "-shuffle-file") bWriteShuffleFile = true;
+		else if (arg.find("-threads=") == 0) numThreads = (size_t)atoi(arg.substr(9).c_str());
+		else if (arg.find("-seed=") == 0) seed = (unsigned int)strtoul(arg.substr(6).c_str(), nullptr, 10);
+		else if (arg[0] != '-') inputs.push_back(arg);
+		else
+		{
+			cout << "ERROR. Unknown argument: " << arg << "\n";
+			printUsage();
+			return -1;
+		}
+	}
+	if (inputs.empty() || outputFilename.empty())
+	{
+		printUsage();
+		return -1;
+	}
+	if (!endsWith(outputFilename, SAMPLE_FILE_DESCRIPTOR_EXTENSION))
+		outputFilename += SAMPLE_FILE_DESCRIPTOR_EXTENSION;
+
+	//inputs can be log descriptors or directories with logs (in any subdirectory)
+	vector<string> logDescriptors;
+	for (const string& input : inputs)
+	{
+		if (endsWith(input, LOG_DESCRIPTOR_EXTENSION))
+		{
+			logDescriptors.push_back(input);
+			continue;
+		}
+		vector<string> files;
+		getFilesInDirectory(input, files, true);
+		for (const string& file : files)
+			if (endsWith(file, LOG_DESCRIPTOR_EXTENSION)) logDescriptors.push_back(file);
+	}
+
+	LogSampleConverter converter(filter, numThreads);
+	for (const string& logDescriptor : logDescriptors)
+	{
+		if (!converter.addLog(logDescriptor))
+			cout << "Log skipped (can't be read or mismatched variables): " << logDescriptor << "\n";
+	}
+	if (converter.getNumLogs() == 0)
+	{
+		cout << "ERROR. No log files found\n";
+		return -1;
+	}
+
+	cout << "Converting " << converter.getNumLogs() << " log files\n";
+	if (!converter.convert(outputFilename, bWriteShuffleFile, seed))
+	{
+		cout << "ERROR. No samples were written\n";
+		return -1;
+	}
+	cout << "FINISHED: " << converter.getNumSamplesWritten() << " samples from " << converter.getNumLogsConverted() << " log files";
+	if (filter.bRemoveDuplicates)
+		cout << " (" << converter.getNumDuplicatesRemoved() << " duplicates removed)";
+	cout << "\nDescriptor: " << outputFilename << "\n";
+	return 0;
+}
@@ -39,13 +39,10 @@ Step::~Step()
 	if (m_pValues) delete [] m_pValues;
 }
 
-void Step::load(FILE* pFile)
+void Step::load(const char* pData)
 {
-	size_t elementsRead = fread_s((void*)&m_header, sizeof(StepHeader), sizeof(StepHeader), 1, pFile);
-	if (elementsRead == 1 && !bEnd())
-	{
-		elementsRead = fread_s(m_pValues, sizeof(double)*m_numValues, sizeof(double), m_numValues, pFile);
-	}
+	memcpy(&m_header, pData, sizeof(StepHeader));
+	memcpy(m_pValues, pData + sizeof(StepHeader), sizeof(double)*m_numValues);
 }
 
 double Step::getValue(int i) const
@@ -74,32 +71,104 @@ double Step::getEpisodeRealTime() const
 	return m_header.episodeRealTime;
 }
 
+void Step::setHeader(__int64 stepIndex, double experimentRealTime, double episodeSimTime, double episodeRealTime)
+{
+	m_header.magicNumber = STEP_HEADER;
+	m_header.stepIndex = stepIndex;
+	m_header.experimentRealTime = experimentRealTime;
+	m_header.m_episodeSimTime = episodeSimTime;
+	m_header.episodeRealTime = episodeRealTime;
+}
+
 bool Step::bEnd()
 {
 	return m_header.magicNumber == EPISODE_END_HEADER;
 }
 
-void Episode::load(FILE* pFile)
+bool Episode::index(const MemoryMappedFile& log, const LogEpisodeIndexEntry& entry)
 {
-	size_t elementsRead = fread_s((void*)&m_header, sizeof(EpisodeHeader), sizeof(EpisodeHeader), 1, pFile);
-	if (elementsRead == 1)
+	m_header.episodeType = entry.episodeType;
+	m_header.episodeIndex = entry.episodeIndex;
+	m_header.episodeSubIndex = entry.episodeSubIndex;
+	m_header.numVariablesLogged = entry.numVariablesLogged;
+	m_numSteps = (size_t)entry.numSteps;
+	if (entry.offset < 0 || entry.numVariablesLogged < 0 || entry.numSteps < 0)
+		return false;
+
+	//all the steps have the same size, so the index tells us where each of them is
+	const size_t stepSize = sizeof(StepHeader) + sizeof(double) * (size_t)m_header.numVariablesLogged;
+	m_firstStepOffset = (size_t)entry.offset + sizeof(EpisodeHeader);
+	if (m_firstStepOffset + m_numSteps * stepSize > log.getSize())
+		return false;
+
+	if (m_numSteps > 0)
 	{
-		Step *pStep= new Step((int)m_header.numVariablesLogged);
-		pStep->load(pFile);
-		while (!pStep->bEnd())
-		{
-			m_pSteps.push_back(pStep);
+		StepHeader lastStep;
+		memcpy(&lastStep, log.getData() + m_firstStepOffset + (m_numSteps - 1) * stepSize, sizeof(StepHeader));
+		m_simTimeLength = lastStep.m_episodeSimTime;
+	}
+	return true;
+}
 
-			pStep = new Step((int)m_header.numVariablesLogged);
-			pStep->load(pFile);
-		}
+void Episode::index(const ColumnarLogReader& reader, size_t episode)
+{
+	const ColumnarEpisodeIndex& index = reader.getEpisodeInfo(episode).index;
+	m_header.episodeType = index.episodeType;
+	m_header.episodeIndex = index.episodeIndex;
+	m_header.episodeSubIndex = index.episodeSubIndex;
+	m_header.numVariablesLogged = index.numColumns - NumStepColumns;
+	m_numSteps = (size_t)index.numSteps;
+	if (m_numSteps > 0)
+		m_simTimeLength = reader.getSummary(episode, EpisodeSimTimeColumn).max;
+}
+
+void Episode::load(const MemoryMappedFile& log)
+{
+	const size_t stepSize = sizeof(StepHeader) + sizeof(double) * (size_t)m_header.numVariablesLogged;
+	m_pSteps.reserve(m_numSteps);
+	for (size_t i = 0; i < m_numSteps; ++i)
+	{
+		Step* pStep = new Step((int)m_header.numVariablesLogged);
+		pStep->load(log.getData() + m_firstStepOffset + i * stepSize);
+		m_pSteps.push_back(pStep);
 	}
+	m_bLoaded = true;
 }
 
-Episode::~Episode()
+bool Episode::load(ColumnarLogReader& reader, size_t episode)
+{
+	//the file is stored by columns, the viewer wants the steps
+	vector<vector<double>> columns(reader.getNumColumns(episode));
+	for (size_t column = 0; column < columns.size(); ++column)
+	{
+		if (!reader.readColumn(episode, column, columns[column]))
+			return false;
+	}
+
+	for (size_t i = 0; i < reader.getNumSteps(episode); ++i)
+	{
+		Step* pStep = new Step((int)m_header.numVariablesLogged);
+		pStep->setHeader((__int64)columns[StepIndexColumn][i], columns[ExperimentRealTimeColumn][i]
+			, columns[EpisodeSimTimeColumn][i], columns[EpisodeRealTimeColumn][i]);
+		for (int var = 0; var < (int)m_header.numVariablesLogged; ++var)
+			pStep->setValue(var, columns[NumStepColumns + var][i]);
+		m_pSteps.push_back(pStep);
+	}
+	m_bLoaded = true;
+	return true;
+}
+
+void Episode::unload()
 {
 	for (auto it = m_pSteps.begin(); it != m_pSteps.end(); ++it)
 		delete (*it);
+	m_pSteps.clear();
+	m_bLoaded = false;
+}
+
+Episode::~Episode()
+{
+	unload();
 }
 
 Step* Episode::getStep(int i)
@@ -159,25 +228,40 @@ bool ExperimentLog::load(string descriptorFile, string& outSceneFile)
 	}
 	else return false;
 
-	//Load the binary file from the same directory
-	FILE* pFile;
-
+	//Index the binary file from the same directory. The steps of each episode are loaded when it is viewed
 	string logDirectory = getDirectory(descriptorFile);
-	fopen_s(&pFile, (logDirectory + binaryFile).c_str(), "rb");
-	if (pFile)
+
+	//compressed columnar logs (version 3): the episodes are read from the index at the end of the file
+	if (ColumnarLogReader::getFileVersion((logDirectory + binaryFile).c_str()) == COLUMNAR_LOG_FILE_VERSION)
 	{
-		size_t elementsRead = fread_s((void*)&m_header, sizeof(ExperimentHeader), sizeof(ExperimentHeader), 1, pFile);
-		if (elementsRead == 1)
-		{
-			m_pEpisodes = new Episode[getNumEpisodes()];
-			for (int i = 0; i < getNumEpisodes(); ++i)
-			{
-				m_pEpisodes[i].load(pFile);
-			}
-		}
-		fclose(pFile);
+		if (!m_columnarLog.open((logDirectory + binaryFile).c_str()))
+			return false;
+		m_header.fileVersion = COLUMNAR_LOG_FILE_VERSION;
+		m_header.numEpisodes = m_columnarLog.getNumEpisodes();
+		m_pEpisodes = new Episode[getNumEpisodes()];
+		for (int i = 0; i < getNumEpisodes(); ++i)
+			m_pEpisodes[i].index(m_columnarLog, i);
+	}
+	else
+	{
+		//version 2 logs: the episodes are taken from the sidecar index written by the logger, or from the headers of the log
+		//if there is none. The steps are then copied from the mapped file when the episode is viewed
+		ExperimentLogReader logIndex;
+		if (!logIndex.open((logDirectory + binaryFile).c_str())
+			|| !m_logFile.open((logDirectory + binaryFile).c_str()) || m_logFile.getSize() < sizeof(ExperimentHeader))
+			return false;
+		memcpy(&m_header, m_logFile.getData(), sizeof(ExperimentHeader));
+		if (m_header.magicNumber != EXPERIMENT_HEADER)
+			return false;
+		m_logFile.setAccessPattern(MemoryMappedFile::Random);
+
+		m_pEpisodes = new Episode[logIndex.getNumEpisodes()];
+		int numEpisodes = 0;
+		while (numEpisodes < (int)logIndex.getNumEpisodes() && m_pEpisodes[numEpisodes].index(m_logFile, logIndex.getEpisode(numEpisodes)))
+			++numEpisodes;
+		//the experiment may not have finished
+		m_header.numEpisodes = numEpisodes;
 	}
-	else return false;
 
 	//Load the function log file from the same directory
 	if (!functionLogFile.empty())
@@ -191,6 +275,25 @@ ExperimentLog::~ExperimentLog()
 	if (m_pEpisodes) delete [] m_pEpisodes;
 }
 
+Episode* ExperimentLog::getEpisode(int i)
+{
+	if (i < 0 || i >= getNumEpisodes())
+		return nullptr;
+
+	if (!m_pEpisodes[i].isLoaded())
+	{
+		if (m_loadedEpisode >= 0)
+			m_pEpisodes[m_loadedEpisode].unload();
+
+		if (m_header.fileVersion == COLUMNAR_LOG_FILE_VERSION)
+			m_pEpisodes[i].load(m_columnarLog, i);
+		else
+			m_pEpisodes[i].load(m_logFile);
+		m_loadedEpisode = i;
+	}
+	return &m_pEpisodes[i];
+}
+
 int ExperimentLog::getVariableIndex(string variableName) const
 {
 	for (int i = 0; i < m_descriptor.size(); ++i)
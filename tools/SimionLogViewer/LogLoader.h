@@ -1,5 +1,8 @@
 #pragma once
 #include "../../RLSimion/Common/named-var-set.h"
+#include "../../RLSimion/Common/columnar-log.h"
+#include "../../RLSimion/Common/log-episode-index.h"
+#include "../System/MemoryMappedFile.h"
 #include <vector>
 #include <string>
 using namespace std;
@@ -43,7 +46,9 @@ public:
 	double getEpisodeSimTime() const;
 	double getEpisodeRealTime() const;
 
-	void load(FILE* pFile);
+	//copies the step from a mapped log
+	void load(const char* pData);
+	void setHeader(__int64 stepIndex, double experimentRealTime, double episodeSimTime, double episodeRealTime);
 	bool bEnd();
 };
 
@@ -65,19 +70,36 @@ struct EpisodeHeader
 	}
 };
 
+//Episodes are indexed when the log is opened (header, number of steps and where they are in the file) but
+//their steps are only loaded when the episode is viewed
 class Episode
 {
 	EpisodeHeader m_header;
+	size_t m_firstStepOffset = 0; //version 2 logs: offset of the first step in the file
+	size_t m_numSteps = 0;
+	double m_simTimeLength = 0.0;
+	bool m_bLoaded = false;
 	vector<Step*> m_pSteps;
 public:
 	Episode() { }
 	~Episode();
 
-	size_t getNumSteps() const { return m_pSteps.size(); }
+	size_t getNumSteps() const { return m_numSteps; }
 	Step* getStep(int i);
-	int getNumValuesPerStep() const { if (m_pSteps.size() == 0) return 0; return m_pSteps[0]->getNumValues(); }
-	double getSimTimeLength()const { if (m_pSteps.size() == 0) return 0.0; return m_pSteps[m_pSteps.size() - 1]->getEpisodeSimTime(); }
-	void load(FILE* pFile);
+	int getNumValuesPerStep() const { return (int) m_header.numVariablesLogged; }
+	double getSimTimeLength()const { return m_simTimeLength; }
+
+	//version 2 logs: takes the episode from the index of the log. Returns false if its steps aren't in the file
+	bool index(const MemoryMappedFile& log, const LogEpisodeIndexEntry& entry);
+	//version 3 logs: everything we need is in the index of the log
+	void index(const ColumnarLogReader& reader, size_t episode);
+
+	bool isLoaded() const { return m_bLoaded; }
+	void load(const MemoryMappedFile& log);
+	//version 3 logs
+	bool load(ColumnarLogReader& reader, size_t episode);
+	//frees the steps, but keeps the index
+	void unload();
 };
 
 
@@ -183,6 +205,11 @@ class ExperimentLog
 {
 	ExperimentHeader m_header;
 	Episode *m_pEpisodes = 0;
+	int m_loadedEpisode = -1;
+
+	//the log file is kept open while the viewer runs to load episodes on demand
+	MemoryMappedFile m_logFile; //version 2
+	ColumnarLogReader m_columnarLog; //version 3
 
 	Descriptor m_descriptor;
 
@@ -197,7 +224,9 @@ public:
 	~ExperimentLog();
 
 	int getNumEpisodes() const { return (int) m_header.numEpisodes; }
-	Episode* getEpisode(int i) { return &m_pEpisodes[i]; }
+	//loads the steps of the episode if needed. Only one episode is kept in memory, so the steps of the episode
+	//previously returned are freed
+	Episode* getEpisode(int i);
 
 	int getVariableIndex(string variableName) const;
 
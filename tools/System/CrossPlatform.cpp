@@ -26,6 +26,12 @@
 #include "CrossPlatform.h"
 #include <algorithm>
 #include <sstream>
+#ifdef _WIN32
+#define WINDOWS_MEAN_AND_LEAN
+#include <windows.h>
+#undef min
+#undef max
+#endif
 
 namespace CrossPlatform
 {
@@ -68,7 +74,33 @@ namespace CrossPlatform
 #endif
 	}
 
+	int Fseek64(FILE* stream, long long int offset, int origin)
+	{
+#ifdef _WIN32
+		return _fseeki64(stream, offset, origin);
+#else
+		return fseeko(stream, (off_t)offset, origin);
+#endif
+	}
 
+	long long int Ftell64(FILE* stream)
+	{
+#ifdef _WIN32
+		return _ftelli64(stream);
+#else
+		return (long long int) ftello(stream);
+#endif
+	}
+
+
+	bool RenameReplacing(const char* oldFilename, const char* newFilename)
+	{
+#ifdef _WIN32
+		return MoveFileExA(oldFilename, newFilename, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+		return rename(oldFilename, newFilename) == 0;
+#endif
+	}
 
 	char* Strcpy_s(char* dst, size_t dstSize, const char *src)
 	{
@@ -48,6 +48,14 @@ namespace CrossPlatform
 
 	size_t Fread_s(void *buffer, size_t bufferSize, size_t elementSize, size_t count, FILE *stream);
 
+	//64-bit versions of fseek/ftell, so that files bigger than 2Gb can be used in Windows too
+	int Fseek64(FILE* stream, long long int offset, int origin);
+	long long int Ftell64(FILE* stream);
+
+	//renames a file, replacing the destination if it exists (rename() doesn't replace files in Windows). The destination is
+	//never removed before the new file takes its place. Returns false if the file couldn't be renamed
+	bool RenameReplacing(const char* oldFilename, const char* newFilename);
+
 	char* Strcpy_s(char* dst, size_t dstSize, const char *src);
 
 	void Strcat_s(char* dst, size_t dstSize, const char* src);
@@ -104,7 +104,7 @@ bool changeWorkingDirectory(const string& directory)
 #endif
 }
 
-void getFilesInDirectory(const string& directory, vector<string>& outFiles)
+void getFilesInDirectory(const string& directory, vector<string>& outFiles, bool bRecursive)
 {
 #if defined(_WIN32)
 	HANDLE dir;
@@ -123,7 +123,11 @@ void getFilesInDirectory(const string& directory, vector<string>& outFiles)
 			continue;
 
 		if (is_directory)
+		{
+			if (bRecursive)
+				getFilesInDirectory(full_file_name, outFiles, true);
 			continue;
+		}
 
 		outFiles.push_back(full_file_name);
 	} while (FindNextFile(dir, &file_data));
@@ -136,6 +140,8 @@ void getFilesInDirectory(const string& directory, vector<string>& outFiles)
 	class stat st;
 
 	dir = opendir(directory.c_str());
+	if (dir == NULL)
+		return;
 	while ((ent = readdir(dir)) != NULL)
 	{
 		const string file_name = ent->d_name;
@@ -150,7 +156,11 @@ void getFilesInDirectory(const string& directory, vector<string>& outFiles)
 		const bool is_directory = (st.st_mode & S_IFDIR) != 0;
 
 		if (is_directory)
+		{
+			if (bRecursive)
+				getFilesInDirectory(full_file_name, outFiles, true);
 			continue;
+		}
 
 		outFiles.push_back(full_file_name);
 	}
@@ -11,4 +11,5 @@ string getFilename(const string& filepath);
 bool fileExists(const string& filename);
 
 bool changeWorkingDirectory(const string& directory);
-vector<string> getFilesInDirectory(const string& directory);
\ No newline at end of file
+//if bRecursive is set, files in subdirectories are also returned
+void getFilesInDirectory(const string& directory, vector<string>& outFiles, bool bRecursive = false);
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "MemoryMappedFile.h"
+#include <windows.h>
+
+//Windows version: CreateFileMapping() + MapViewOfFile()
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+
+bool MemoryMappedFile::open(const char* filename)
+{
+	close();
+
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING
+		, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	//empty files can't be mapped
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	const char* pData = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (pData == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_fileHandle = (unsigned long long int) file;
+	m_mappingHandle = (unsigned long long int) mapping;
+	m_pData = pData;
+	m_size = (size_t)size.QuadPart;
+	return true;
+}
+
+void MemoryMappedFile::close()
+{
+	if (m_pData)
+		UnmapViewOfFile(m_pData);
+	if (m_mappingHandle)
+		CloseHandle((HANDLE)m_mappingHandle);
+	if (m_fileHandle)
+		CloseHandle((HANDLE)m_fileHandle);
+	m_pData = nullptr;
+	m_mappingHandle = 0;
+	m_fileHandle = 0;
+	m_size = 0;
+}
+
+void MemoryMappedFile::setAccessPattern(AccessPattern pattern)
+{
+	//Windows has no per-mapping hint (the file would have to be opened with FILE_FLAG_RANDOM_ACCESS or
+	//FILE_FLAG_SEQUENTIAL_SCAN). The default read-ahead works well enough
+}
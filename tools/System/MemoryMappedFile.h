@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+
+//Read-only view of a whole file mapped in memory. Pages are read by the OS as they are touched, so
+//opening a file costs the same regardless of its size and data that isn't accessed is never read.
+//It is meant for big binary files (logs, sample files) that are read many times or not sequentially
+
+class MemoryMappedFile
+{
+	unsigned long long int m_fileHandle = 0;
+	unsigned long long int m_mappingHandle = 0;
+	const char* m_pData = nullptr;
+	size_t m_size = 0;
+public:
+	//how the mapped data will be accessed, so that the OS can prefetch pages (or not)
+	enum AccessPattern { Normal, Sequential, Random };
+
+	MemoryMappedFile() {}
+	virtual ~MemoryMappedFile();
+
+	bool open(const char* filename);
+	void close();
+	bool isOpen() const { return m_pData != nullptr; }
+
+	const char* getData() const { return m_pData; }
+	size_t getSize() const { return m_size; }
+
+	//hints the expected access pattern to the OS. Does nothing if the platform doesn't support it
+	void setAccessPattern(AccessPattern pattern);
+};
@@ -0,0 +1,340 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "SharedMemoryChannel.h"
+#include "CrossPlatform.h"
+
+#include <iostream>
+#include <string.h>
+#include <thread>
+#include <chrono>
+
+//number of times the value is checked before blocking. A round trip through FAST's controller takes only
+//a few microseconds, so most waits finish while spinning
+#define NUM_SPIN_ITERATIONS 20000
+#define CLIENT_CONNECTION_TIMEOUT_MS 60000
+
+SharedMemoryChannel::SharedMemoryChannel()
+{
+	m_handle = 0;
+	for (int i = 0; i < NumSignals; i++)
+		m_signalHandles[i] = 0;
+	m_fullName[0] = 0;
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+}
+
+void SharedMemoryChannel::logMessage(const char* message)
+{
+	if (m_bVerbose)
+	{
+		std::cout << message << "\n";
+	}
+}
+
+bool SharedMemoryChannel::isPeerAttached()
+{
+	if (m_bServer)
+		return m_pHeader->clientAttached.load() != 0;
+	return m_pHeader->serverAttached.load() != 0;
+}
+
+void SharedMemoryChannel::detach()
+{
+	if (!isConnected())
+		return;
+
+	if (m_bServer)
+		m_pHeader->serverAttached.store(0);
+	else
+		m_pHeader->clientAttached.store(0);
+
+	//wake up the peer if it is blocked so that it notices we are gone
+	sendSignal(ServerToClientData, m_pHeader->serverToClient.head);
+	sendSignal(ServerToClientSpace, m_pHeader->serverToClient.tail);
+	sendSignal(ClientToServerData, m_pHeader->clientToServer.head);
+	sendSignal(ClientToServerSpace, m_pHeader->clientToServer.tail);
+}
+
+bool SharedMemoryChannel::waitForChange(Signal signal, std::atomic<uint32_t>& value, uint32_t oldValue, std::atomic<uint32_t>& numWaiters)
+{
+	for (int i = 0; i < NUM_SPIN_ITERATIONS; i++)
+	{
+		if (value.load(std::memory_order_acquire) != oldValue)
+			return true;
+	}
+
+	while (true)
+	{
+		//the peer may have written its last bytes before leaving, so the value is checked once more
+		if (!isPeerAttached() || (m_isPeerAlive && !m_isPeerAlive()))
+			return value.load() != oldValue;
+
+		//the counter is incremented before checking the value again. The other side updates the value before
+		//reading the counter, so either we see the new value or it sees us waiting and sends the signal
+		numWaiters.fetch_add(1);
+		if (value.load() == oldValue)
+			waitForSignal(signal, value, oldValue);
+		numWaiters.fetch_sub(1);
+
+		if (value.load(std::memory_order_acquire) != oldValue)
+			return true;
+	}
+}
+
+int SharedMemoryChannel::writeBuffer(const void* pBuffer, int numBytes)
+{
+	if (!isConnected())
+	{
+		logMessage("Error: couldn't write on shared memory channel");
+		return 0;
+	}
+
+	SharedMemoryRing& ring = m_bServer ? m_pHeader->serverToClient : m_pHeader->clientToServer;
+	Signal dataSignal = m_bServer ? ServerToClientData : ClientToServerData;
+	Signal spaceSignal = m_bServer ? ServerToClientSpace : ClientToServerSpace;
+
+	const char* pSrc = (const char*)pBuffer;
+	int numBytesWritten = 0;
+	while (numBytesWritten < numBytes)
+	{
+		uint32_t head = ring.head.load(std::memory_order_relaxed);
+		uint32_t tail = ring.tail.load(std::memory_order_acquire);
+		uint32_t freeSpace = SHARED_MEMORY_RING_SIZE - (head - tail);
+		if (freeSpace == 0)
+		{
+			if (!waitForChange(spaceSignal, ring.tail, tail, ring.spaceWaiters))
+				break;
+			continue;
+		}
+		uint32_t numBytesToCopy = (uint32_t)(numBytes - numBytesWritten);
+		if (numBytesToCopy > freeSpace) numBytesToCopy = freeSpace;
+
+		uint32_t offset = head & (SHARED_MEMORY_RING_SIZE - 1);
+		uint32_t firstChunk = SHARED_MEMORY_RING_SIZE - offset;
+		if (firstChunk > numBytesToCopy) firstChunk = numBytesToCopy;
+		memcpy(ring.data + offset, pSrc + numBytesWritten, firstChunk);
+		memcpy(ring.data, pSrc + numBytesWritten + firstChunk, numBytesToCopy - firstChunk);
+
+		ring.head.store(head + numBytesToCopy);
+		if (ring.dataWaiters.load() > 0)
+			sendSignal(dataSignal, ring.head);
+		numBytesWritten += (int)numBytesToCopy;
+	}
+
+	if (m_bVerbose)
+	{
+		char msg[1024];
+		CrossPlatform::Sprintf_s(msg, 1024, "Written %d bytes on shared memory channel %s", numBytesWritten, m_fullName);
+		logMessage(msg);
+	}
+	return numBytesWritten;
+}
+
+int SharedMemoryChannel::readToBuffer(void* pBuffer, int numBytes)
+{
+	if (!isConnected())
+	{
+		logMessage("Error: couldn't read from shared memory channel because it's closed");
+		return 0;
+	}
+
+	SharedMemoryRing& ring = m_bServer ? m_pHeader->clientToServer : m_pHeader->serverToClient;
+	Signal dataSignal = m_bServer ? ClientToServerData : ServerToClientData;
+	Signal spaceSignal = m_bServer ? ClientToServerSpace : ServerToClientSpace;
+
+	char* pDst = (char*)pBuffer;
+	int numBytesRead = 0;
+	while (numBytesRead < numBytes)
+	{
+		uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+		uint32_t head = ring.head.load(std::memory_order_acquire);
+		uint32_t available = head - tail;
+		if (available == 0)
+		{
+			if (!waitForChange(dataSignal, ring.head, head, ring.dataWaiters))
+				break;
+			continue;
+		}
+		uint32_t numBytesToCopy = (uint32_t)(numBytes - numBytesRead);
+		if (numBytesToCopy > available) numBytesToCopy = available;
+
+		uint32_t offset = tail & (SHARED_MEMORY_RING_SIZE - 1);
+		uint32_t firstChunk = SHARED_MEMORY_RING_SIZE - offset;
+		if (firstChunk > numBytesToCopy) firstChunk = numBytesToCopy;
+		memcpy(pDst + numBytesRead, ring.data + offset, firstChunk);
+		memcpy(pDst + numBytesRead + firstChunk, ring.data, numBytesToCopy - firstChunk);
+
+		ring.tail.store(tail + numBytesToCopy);
+		if (ring.spaceWaiters.load() > 0)
+			sendSignal(spaceSignal, ring.tail);
+		numBytesRead += (int)numBytesToCopy;
+	}
+	if (numBytesRead < numBytes)
+		logMessage("Error: shared memory channel closed before the whole message was read");
+	return numBytesRead;
+}
+
+
+//SharedMemoryServer
+SharedMemoryServer::SharedMemoryServer()
+{
+	m_bServer = true;
+}
+
+SharedMemoryServer::~SharedMemoryServer()
+{
+	closeServer();
+}
+
+bool SharedMemoryServer::openServer(const char* name)
+{
+	setName(name, true);
+
+	if (!mapSharedMemory(true))
+	{
+		logMessage("Error: couldn't create shared memory server");
+		return false;
+	}
+	m_pHeader->serverAttached.store(1);
+	m_pHeader->magic.store(SHARED_MEMORY_MAGIC);
+	logMessage("Shared memory server created");
+	return true;
+}
+
+#define NUM_MAX_SHARED_MEMORY_SERVERS_PER_MACHINE 100
+bool SharedMemoryServer::openUniqueServer(const char* name)
+{
+	bool serverCreated = false;
+	int id = 0;
+	do
+	{
+		setName(name, true, id);
+
+		serverCreated = mapSharedMemory(true);
+
+		++id;
+
+	} while (!serverCreated && id < NUM_MAX_SHARED_MEMORY_SERVERS_PER_MACHINE);
+
+	if (!serverCreated)
+	{
+		logMessage("Error: couldn't create shared memory server");
+		return false;
+	}
+	m_pHeader->serverAttached.store(1);
+	m_pHeader->magic.store(SHARED_MEMORY_MAGIC);
+	logMessage("Shared memory server created");
+	return true;
+}
+
+bool SharedMemoryServer::waitForClientConnection()
+{
+	if (!isConnected())
+		return false;
+
+	auto start = std::chrono::steady_clock::now();
+	while (m_pHeader->clientAttached.load() == 0)
+	{
+		if (m_isPeerAlive && !m_isPeerAlive())
+			return false;
+		if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(CLIENT_CONNECTION_TIMEOUT_MS))
+		{
+			logMessage("Error: timeout waiting for a client to connect to the shared memory server");
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	logMessage("Client connected to shared memory server");
+	return true;
+}
+
+void SharedMemoryServer::closeServer()
+{
+	if (isConnected())
+	{
+		logMessage("Destroying shared memory server");
+		detach();
+		unmapSharedMemory();
+	}
+}
+
+
+//SharedMemoryClient
+SharedMemoryClient::SharedMemoryClient()
+{
+	m_bServer = false;
+}
+
+SharedMemoryClient::~SharedMemoryClient()
+{
+	closeConnection();
+}
+
+#define NUM_MAX_CONNECTION_ATTEMPTS 10
+bool SharedMemoryClient::connectToServer(const char* name, bool bAddPrefix)
+{
+	setName(name, bAddPrefix);
+
+	int numAttempts = 0;
+	bool bConnected = false;
+	do
+	{
+		bConnected = mapSharedMemory(false);
+		if (bConnected && m_pHeader->magic.load() != SHARED_MEMORY_MAGIC)
+		{
+			//the server hasn't finished initializing it yet
+			unmapSharedMemory();
+			bConnected = false;
+		}
+		numAttempts++;
+		if (!bConnected)
+		{
+			logMessage("Failed to connect to shared memory server");
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		}
+	} while (!bConnected && numAttempts < NUM_MAX_CONNECTION_ATTEMPTS);
+
+	if (!bConnected)
+	{
+		logMessage("Error: Client couldn't connect to shared memory server");
+		return false;
+	}
+	m_pHeader->clientAttached.store(1);
+	logMessage("Client connected to shared memory server");
+	return true;
+}
+
+void SharedMemoryClient::closeConnection()
+{
+	if (isConnected())
+	{
+		logMessage("Client closing connection to shared memory server");
+		detach();
+		unmapSharedMemory();
+	}
+}
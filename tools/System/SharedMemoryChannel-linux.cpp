@@ -0,0 +1,179 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "SharedMemoryChannel.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+//Linux version: the shared memory object lives in /dev/shm and blocked readers/writers sleep on a futex
+//placed on the same head/tail index they are waiting to change, so no additional objects are needed.
+//Objects outlive the processes that created them, so the server holds an exclusive flock() on its object
+//while it is open: if the server dies without unlinking it, the lock is released by the kernel and the
+//next server that wants the name removes the stale object
+
+#define FUTEX_WAIT_TIMEOUT_NS 100000000 //100ms
+
+void SharedMemoryChannel::setName(const char* name, bool bAddPrefix, int id)
+{
+	//shm_open() expects names like "/myName"
+	if (bAddPrefix)
+	{
+		if (id < 0)
+			sprintf(m_fullName, "/%s", name);
+		else
+			sprintf(m_fullName, "/%s-%d", name, id);
+	}
+	else
+	{
+		if (id < 0)
+			sprintf(m_fullName, "%s", name);
+		else
+			sprintf(m_fullName, "%s-%d", name, id);
+	}
+}
+
+//Removes the object with this name if it was initialized by a server that no longer holds its lock, i.e. a server that
+//crashed. Returns true if it was removed
+static bool unlinkStaleSharedMemory(const char* name)
+{
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+		return false;
+
+	bool bStale = false;
+	struct stat info;
+	if (fstat(fd, &info) == 0 && info.st_size >= (off_t) sizeof(SharedMemoryChannelHeader)
+		&& flock(fd, LOCK_EX | LOCK_NB) == 0)
+	{
+		//without the magic number, the server may not have locked it yet
+		void* pMemory = mmap(nullptr, sizeof(SharedMemoryChannelHeader), PROT_READ, MAP_SHARED, fd, 0);
+		if (pMemory != MAP_FAILED)
+		{
+			bStale = ((SharedMemoryChannelHeader*)pMemory)->magic.load() == SHARED_MEMORY_MAGIC;
+			munmap(pMemory, sizeof(SharedMemoryChannelHeader));
+		}
+		//another server may have removed it and created a new one with the same name since we opened it. While we hold
+		//the lock of the stale object, nobody else can remove it
+		int currentFd = shm_open(name, O_RDWR, 0);
+		struct stat currentInfo;
+		bStale = bStale && currentFd >= 0 && fstat(currentFd, &currentInfo) == 0
+			&& currentInfo.st_dev == info.st_dev && currentInfo.st_ino == info.st_ino;
+		if (currentFd >= 0)
+			close(currentFd);
+		if (bStale)
+			bStale = shm_unlink(name) == 0;
+	}
+	close(fd);
+	return bStale;
+}
+
+bool SharedMemoryChannel::mapSharedMemory(bool bCreate)
+{
+	int fd;
+	if (bCreate)
+	{
+		fd = shm_open(m_fullName, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if (fd < 0 && errno == EEXIST && unlinkStaleSharedMemory(m_fullName))
+			fd = shm_open(m_fullName, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	}
+	else
+		fd = shm_open(m_fullName, O_RDWR, 0);
+	if (fd < 0)
+		return false;
+
+	//the lock is taken before the magic number is set (see unlinkStaleSharedMemory())
+	if (bCreate && (flock(fd, LOCK_EX | LOCK_NB) != 0 || ftruncate(fd, sizeof(SharedMemoryChannelHeader)) != 0))
+	{
+		close(fd);
+		shm_unlink(m_fullName);
+		return false;
+	}
+	if (!bCreate)
+	{
+		//the server may not have set the size yet
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size < (off_t) sizeof(SharedMemoryChannelHeader))
+		{
+			close(fd);
+			return false;
+		}
+	}
+
+	void* pMemory = mmap(nullptr, sizeof(SharedMemoryChannelHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (pMemory == MAP_FAILED)
+	{
+		close(fd);
+		if (bCreate) shm_unlink(m_fullName);
+		return false;
+	}
+	//a newly created object is zero-filled, which is a valid initial state for all the atomics
+	m_pHeader = (SharedMemoryChannelHeader*)pMemory;
+	//the server keeps the descriptor open to hold the lock (+1, so that the handle isn't 0)
+	if (bCreate)
+		m_handle = (unsigned long long int) fd + 1;
+	else
+	{
+		close(fd);
+		m_handle = 1;
+	}
+	return true;
+}
+
+void SharedMemoryChannel::unmapSharedMemory()
+{
+	if (m_pHeader)
+		munmap(m_pHeader, sizeof(SharedMemoryChannelHeader));
+	if (m_bServer)
+	{
+		shm_unlink(m_fullName);
+		if (m_handle)
+			close((int)(m_handle - 1));
+	}
+	m_pHeader = nullptr;
+	m_handle = 0;
+}
+
+void SharedMemoryChannel::waitForSignal(Signal signal, std::atomic<uint32_t>& value, uint32_t oldValue)
+{
+	//the kernel only puts us to sleep if the value is still oldValue, so a wake-up can't be missed
+	struct timespec timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = FUTEX_WAIT_TIMEOUT_NS;
+	syscall(SYS_futex, (uint32_t*)&value, FUTEX_WAIT, oldValue, &timeout, nullptr, 0);
+}
+
+void SharedMemoryChannel::sendSignal(Signal signal, std::atomic<uint32_t>& value)
+{
+	syscall(SYS_futex, (uint32_t*)&value, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
@@ -0,0 +1,131 @@
+/*
+	SimionZoo: A framework for online model-free Reinforcement Learning on continuous
+	control problems
+
+	Copyright (c) 2016 SimionSoft. https://github.com/simionsoft
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "SharedMemoryChannel.h"
+#include <Windows.h>
+#include <stdio.h>
+
+//Windows version: a named file mapping backed by the paging file and one auto-reset event per signal,
+//named after the mapping so that the client can open them
+
+#define WAIT_SIGNAL_TIMEOUT_MS 100
+
+void SharedMemoryChannel::setName(const char* name, bool bAddPrefix, int id)
+{
+	//"Local\" keeps the objects in the session's namespace, so no special privileges are needed
+	if (bAddPrefix)
+	{
+		if (id < 0)
+			sprintf_s(m_fullName, "Local\\%s", name);
+		else
+			sprintf_s(m_fullName, "Local\\%s-%d", name, id);
+	}
+	else
+	{
+		if (id < 0)
+			sprintf_s(m_fullName, "%s", name);
+		else
+			sprintf_s(m_fullName, "%s-%d", name, id);
+	}
+}
+
+bool SharedMemoryChannel::mapSharedMemory(bool bCreate)
+{
+	HANDLE hMapping;
+	if (bCreate)
+	{
+		hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0
+			, (DWORD) sizeof(SharedMemoryChannelHeader), m_fullName);
+		if (hMapping != NULL && GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			//somebody else is using this name
+			CloseHandle(hMapping);
+			return false;
+		}
+	}
+	else
+		hMapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, m_fullName);
+	if (hMapping == NULL)
+		return false;
+
+	void* pMemory = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedMemoryChannelHeader));
+	if (pMemory == NULL)
+	{
+		CloseHandle(hMapping);
+		return false;
+	}
+
+	char eventName[MAX_SHARED_MEMORY_NAME_SIZE + 16];
+	for (int i = 0; i < NumSignals; i++)
+	{
+		sprintf_s(eventName, "%s-event-%d", m_fullName, i);
+		HANDLE hEvent = CreateEventA(NULL, FALSE, FALSE, eventName);
+		if (hEvent == NULL)
+		{
+			for (int j = 0; j < i; j++)
+			{
+				CloseHandle((HANDLE)m_signalHandles[j]);
+				m_signalHandles[j] = 0;
+			}
+			UnmapViewOfFile(pMemory);
+			CloseHandle(hMapping);
+			return false;
+		}
+		m_signalHandles[i] = (unsigned long long int)hEvent;
+	}
+
+	//a newly created mapping is zero-filled, which is a valid initial state for all the atomics
+	m_pHeader = (SharedMemoryChannelHeader*)pMemory;
+	m_handle = (unsigned long long int)hMapping;
+	return true;
+}
+
+void SharedMemoryChannel::unmapSharedMemory()
+{
+	if (m_pHeader)
+		UnmapViewOfFile(m_pHeader);
+	for (int i = 0; i < NumSignals; i++)
+	{
+		if (m_signalHandles[i])
+			CloseHandle((HANDLE)m_signalHandles[i]);
+		m_signalHandles[i] = 0;
+	}
+	//the mapping is destroyed by the system when the last handle is closed
+	if (m_handle)
+		CloseHandle((HANDLE)m_handle);
+	m_pHeader = nullptr;
+	m_handle = 0;
+}
+
+void SharedMemoryChannel::waitForSignal(Signal signal, std::atomic<uint32_t>& value, uint32_t oldValue)
+{
+	//events are auto-reset: a signal sent while nobody was waiting only causes an extra check of the value
+	WaitForSingleObject((HANDLE)m_signalHandles[signal], WAIT_SIGNAL_TIMEOUT_MS);
+}
+
+void SharedMemoryChannel::sendSignal(Signal signal, std::atomic<uint32_t>& value)
+{
+	SetEvent((HANDLE)m_signalHandles[signal]);
+}
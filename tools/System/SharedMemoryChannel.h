@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+
+#define MAX_SHARED_MEMORY_NAME_SIZE 1024
+
+//Duplex channel between two processes on the same machine using two ring buffers in shared memory.
+//It has the same read/write interface as NamedPipe, so the same messages can be sent through either
+//of them, but a message costs a memcpy instead of a system call. Readers and writers spin for a while
+//before blocking (futex in Linux, named events in Windows), so a peer answering within a few
+//microseconds never makes us sleep
+
+#define SHARED_MEMORY_RING_SIZE (64 * 1024) //must be a power of 2
+//set by the server once the channel is initialized
+#define SHARED_MEMORY_MAGIC 0x534d4348
+
+struct SharedMemoryRing
+{
+	//written by the producer
+	alignas(64) std::atomic<uint32_t> head;
+	std::atomic<uint32_t> spaceWaiters;
+	//written by the consumer
+	alignas(64) std::atomic<uint32_t> tail;
+	std::atomic<uint32_t> dataWaiters;
+
+	alignas(64) char data[SHARED_MEMORY_RING_SIZE];
+};
+
+struct SharedMemoryChannelHeader
+{
+	std::atomic<uint32_t> magic;
+	std::atomic<uint32_t> serverAttached;
+	std::atomic<uint32_t> clientAttached;
+
+	SharedMemoryRing serverToClient;
+	SharedMemoryRing clientToServer;
+};
+
+class SharedMemoryChannel
+{
+protected:
+	//signals used to wake up a blocked reader/writer
+	enum Signal { ServerToClientData = 0, ServerToClientSpace, ClientToServerData, ClientToServerSpace, NumSignals };
+
+	bool m_bVerbose = false;
+	bool m_bServer = false;
+
+	unsigned long long int m_handle;
+	unsigned long long int m_signalHandles[NumSignals];
+	SharedMemoryChannelHeader* m_pHeader = nullptr;
+
+	char m_fullName[MAX_SHARED_MEMORY_NAME_SIZE];
+
+	std::function<bool()> m_isPeerAlive;
+
+	//if bAddPrefix, this method prepends the platform's prefix to name. Leaves the result in m_fullName
+	void setName(const char* name, bool bAddPrefix = true, int id = -1);
+
+	void logMessage(const char* message);
+
+	//platform-dependent
+	bool mapSharedMemory(bool bCreate);
+	void unmapSharedMemory();
+	//blocks until value!=oldValue or signal is sent, with a timeout so that the caller can check if the peer is still alive
+	void waitForSignal(Signal signal, std::atomic<uint32_t>& value, uint32_t oldValue);
+	void sendSignal(Signal signal, std::atomic<uint32_t>& value);
+
+	//spins for a while and then blocks until value!=oldValue. Returns false if the peer is gone and value didn't change
+	bool waitForChange(Signal signal, std::atomic<uint32_t>& value, uint32_t oldValue, std::atomic<uint32_t>& numWaiters);
+
+	bool isPeerAttached();
+	void detach();
+public:
+	SharedMemoryChannel();
+	virtual ~SharedMemoryChannel();
+
+	//Blocking calls: they return once all the bytes have been written/read, or the number of bytes actually
+	//written/read if the other process closes the channel (or isPeerAlive returns false) in the meantime
+	int writeBuffer(const void* pBuffer, int numBytes);
+	int readToBuffer(void* pBuffer, int numBytes);
+
+	char* getFullName() { return m_fullName; }
+	bool isConnected() { return m_pHeader != nullptr; }
+
+	//Optional check used while waiting to find out whether the other process has died (i.e. Process::isRunning)
+	void setPeerAliveCheck(std::function<bool()> isPeerAlive) { m_isPeerAlive = isPeerAlive; }
+
+	void setVerbose(bool set) { m_bVerbose = set; }
+};
+
+class SharedMemoryServer : public SharedMemoryChannel
+{
+public:
+	SharedMemoryServer();
+	virtual ~SharedMemoryServer();
+
+	//Appends an identifier to the name given until an unused name is found. getFullName() should be used
+	//after to retrieve the actual name so that the client can connect to it
+	bool openUniqueServer(const char* name);
+	bool openServer(const char* name);
+
+	bool waitForClientConnection();
+	void closeServer();
+};
+
+class SharedMemoryClient : public SharedMemoryChannel
+{
+public:
+	SharedMemoryClient();
+	virtual ~SharedMemoryClient();
+
+	bool connectToServer(const char* name, bool bAddPrefix = true);
+	void closeConnection();
+};